@@ -749,6 +749,10 @@ class TestingTargetChecker:
     self._checker.check_art_test_data('art-gtest-jars-MainEmptyUncompressed.jar')
     self._checker.check_art_test_data('art-gtest-jars-Dex2oatVdexTestDex.jar')
     self._checker.check_art_test_data('art-gtest-jars-Dex2oatVdexPublicSdkDex.dex')
+    self._checker.check_art_test_data('art-gtest-jars-CompileCache.jar')
+    self._checker.check_art_test_data('art-gtest-jars-CompileCacheModified.jar')
+    self._checker.check_art_test_data('art-gtest-jars-CompileCacheString.jar')
+    self._checker.check_art_test_data('art-gtest-jars-CompileCacheStringModified.jar')
 
 
 class NoSuperfluousBinariesChecker:
@@ -26,6 +26,7 @@
 #include "compiled_method.h"
 #include "linker/linker_patch.h"
 #include "thread-current-inl.h"
+#include "utils/code_stream.h"
 #include "utils/dedupe_set-inl.h"
 #include "utils/swap_space.h"
 
@@ -51,6 +52,16 @@ void ReleaseArray(SwapSpace* swap_space, const LengthPrefixedArray<T>* array) {
   allocator.deallocate(const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(array)), size);
 }
 
+const LengthPrefixedArray<uint8_t>* StreamArray(CodeStream* code_stream,
+                                                const ArrayRef<const uint8_t>& array) {
+  DCHECK(!array.empty());
+  LengthPrefixedArray<uint8_t> header(array.size());
+  DCHECK_EQ(LengthPrefixedArray<uint8_t>::OffsetOfElement(0), sizeof(header));
+  const uint8_t* array_copy = code_stream->Append(
+      ArrayRef<const uint8_t>(reinterpret_cast<const uint8_t*>(&header), sizeof(header)), array);
+  return reinterpret_cast<const LengthPrefixedArray<uint8_t>*>(array_copy);
+}
+
 }  // anonymous namespace
 
 template <typename T, typename DedupeSetType>
@@ -104,6 +115,46 @@ class CompiledMethodStorage::LengthPrefixedArrayAlloc {
   SwapSpace* const swap_space_;
 };
 
+// Allocator for the code and stack maps. Uses the code stream if there is one, the swap space
+// otherwise. Arrays in the code stream are never freed.
+class CompiledMethodStorage::StreamedArrayAlloc {
+ public:
+  StreamedArrayAlloc(SwapSpace* swap_space, CodeStream* code_stream)
+      : swap_space_(swap_space), code_stream_(code_stream) {
+  }
+
+  const LengthPrefixedArray<uint8_t>* Copy(const ArrayRef<const uint8_t>& array) {
+    return (code_stream_ != nullptr) ? StreamArray(code_stream_, array)
+                                     : CopyArray(swap_space_, array);
+  }
+
+  void Destroy(const LengthPrefixedArray<uint8_t>* array) {
+    if (code_stream_ == nullptr) {
+      ReleaseArray(swap_space_, array);
+    }
+  }
+
+ private:
+  SwapSpace* const swap_space_;
+  CodeStream* const code_stream_;
+};
+
+const LengthPrefixedArray<uint8_t>* CompiledMethodStorage::AllocateOrDeduplicateStreamedArray(
+    const ArrayRef<const uint8_t>& data,
+    StreamedArrayDedupeSet* dedupe_set) {
+  if (code_stream_ == nullptr || data.empty() || DedupeEnabled()) {
+    return AllocateOrDeduplicateArray(data, dedupe_set);
+  }
+  return StreamArray(code_stream_.get(), data);
+}
+
+void CompiledMethodStorage::ReleaseStreamedArrayIfNotDeduplicated(
+    const LengthPrefixedArray<uint8_t>* array) {
+  if (code_stream_ == nullptr) {
+    ReleaseArrayIfNotDeduplicated(array);
+  }
+}
+
 class CompiledMethodStorage::ThunkMapKey {
  public:
   ThunkMapKey(linker::LinkerPatch::Type type, uint32_t custom_value1, uint32_t custom_value2)
@@ -144,12 +195,13 @@ class CompiledMethodStorage::ThunkMapValue {
   std::string debug_name_;
 };
 
-CompiledMethodStorage::CompiledMethodStorage(int swap_fd)
+CompiledMethodStorage::CompiledMethodStorage(int swap_fd, int code_stream_fd)
     : swap_space_(swap_fd == -1 ? nullptr : new SwapSpace(swap_fd, 10 * MB)),
+      code_stream_(code_stream_fd == -1 ? nullptr : new CodeStream(code_stream_fd)),
       dedupe_enabled_(true),
-      dedupe_code_("dedupe code", LengthPrefixedArrayAlloc<uint8_t>(swap_space_.get())),
+      dedupe_code_("dedupe code", StreamedArrayAlloc(swap_space_.get(), code_stream_.get())),
       dedupe_vmap_table_("dedupe vmap table",
-                         LengthPrefixedArrayAlloc<uint8_t>(swap_space_.get())),
+                         StreamedArrayAlloc(swap_space_.get(), code_stream_.get())),
       dedupe_cfi_info_("dedupe cfi info", LengthPrefixedArrayAlloc<uint8_t>(swap_space_.get())),
       dedupe_linker_patches_("dedupe cfi info",
                              LengthPrefixedArrayAlloc<linker::LinkerPatch>(swap_space_.get())),
@@ -166,6 +218,10 @@ void CompiledMethodStorage::DumpMemoryUsage(std::ostream& os, bool extended) con
     const size_t swap_size = swap_space_->GetSize();
     os << " swap=" << PrettySize(swap_size) << " (" << swap_size << "B)";
   }
+  if (code_stream_.get() != nullptr) {
+    const size_t code_stream_size = code_stream_->GetSize();
+    os << " code stream=" << PrettySize(code_stream_size) << " (" << code_stream_size << "B)";
+  }
   if (extended) {
     Thread* self = Thread::Current();
     os << "\nCode dedupe: " << dedupe_code_.DumpStats(self);
@@ -176,11 +232,11 @@ void CompiledMethodStorage::DumpMemoryUsage(std::ostream& os, bool extended) con
 
 const LengthPrefixedArray<uint8_t>* CompiledMethodStorage::DeduplicateCode(
     const ArrayRef<const uint8_t>& code) {
-  return AllocateOrDeduplicateArray(code, &dedupe_code_);
+  return AllocateOrDeduplicateStreamedArray(code, &dedupe_code_);
 }
 
 void CompiledMethodStorage::ReleaseCode(const LengthPrefixedArray<uint8_t>* code) {
-  ReleaseArrayIfNotDeduplicated(code);
+  ReleaseStreamedArrayIfNotDeduplicated(code);
 }
 
 size_t CompiledMethodStorage::UniqueCodeEntries() const {
@@ -190,11 +246,11 @@ size_t CompiledMethodStorage::UniqueCodeEntries() const {
 
 const LengthPrefixedArray<uint8_t>* CompiledMethodStorage::DeduplicateVMapTable(
     const ArrayRef<const uint8_t>& table) {
-  return AllocateOrDeduplicateArray(table, &dedupe_vmap_table_);
+  return AllocateOrDeduplicateStreamedArray(table, &dedupe_vmap_table_);
 }
 
 void CompiledMethodStorage::ReleaseVMapTable(const LengthPrefixedArray<uint8_t>* table) {
-  ReleaseArrayIfNotDeduplicated(table);
+  ReleaseStreamedArrayIfNotDeduplicated(table);
 }
 
 size_t CompiledMethodStorage::UniqueVMapTableEntries() const {
@@ -24,6 +24,7 @@
 #include "base/array_ref.h"
 #include "base/length_prefixed_array.h"
 #include "base/macros.h"
+#include "utils/code_stream.h"
 #include "utils/dedupe_set.h"
 #include "utils/swap_space.h"
 
@@ -35,7 +36,9 @@ class LinkerPatch;
 
 class CompiledMethodStorage {
  public:
-  explicit CompiledMethodStorage(int swap_fd);
+  // If `code_stream_fd` is not -1, compiled code and stack maps are appended to a CodeStream
+  // backed by that file instead of being allocated in memory or in the swap space.
+  explicit CompiledMethodStorage(int swap_fd, int code_stream_fd = -1);
   ~CompiledMethodStorage();
 
   void DumpMemoryUsage(std::ostream& os, bool extended) const;
@@ -105,6 +108,8 @@ class CompiledMethodStorage {
   template <typename T>
   class LengthPrefixedArrayAlloc;
 
+  class StreamedArrayAlloc;
+
   template <typename T>
   using ArrayDedupeSet = DedupeSet<ArrayRef<const T>,
                                    LengthPrefixedArray<T>,
@@ -113,14 +118,30 @@ class CompiledMethodStorage {
                                    DedupeHashFunc<const T>,
                                    4>;
 
+  using StreamedArrayDedupeSet = DedupeSet<ArrayRef<const uint8_t>,
+                                           LengthPrefixedArray<uint8_t>,
+                                           StreamedArrayAlloc,
+                                           size_t,
+                                           DedupeHashFunc<const uint8_t>,
+                                           4>;
+
+  const LengthPrefixedArray<uint8_t>* AllocateOrDeduplicateStreamedArray(
+      const ArrayRef<const uint8_t>& data,
+      StreamedArrayDedupeSet* dedupe_set);
+
+  void ReleaseStreamedArrayIfNotDeduplicated(const LengthPrefixedArray<uint8_t>* array);
+
   // Swap pool and allocator used for native allocations. May be file-backed. Needs to be first
   // as other fields rely on this.
   std::unique_ptr<SwapSpace> swap_space_;
 
+  // Optional append-only storage for code and stack maps. Needs to be before the dedupe sets.
+  std::unique_ptr<CodeStream> code_stream_;
+
   bool dedupe_enabled_;
 
-  ArrayDedupeSet<uint8_t> dedupe_code_;
-  ArrayDedupeSet<uint8_t> dedupe_vmap_table_;
+  StreamedArrayDedupeSet dedupe_code_;
+  StreamedArrayDedupeSet dedupe_vmap_table_;
   ArrayDedupeSet<uint8_t> dedupe_cfi_info_;
   ArrayDedupeSet<linker::LinkerPatch> dedupe_linker_patches_;
 
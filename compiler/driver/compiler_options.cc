@@ -43,6 +43,7 @@ CompilerOptions::CompilerOptions()
       large_method_threshold_(kDefaultLargeMethodThreshold),
       num_dex_methods_threshold_(kDefaultNumDexMethodsThreshold),
       inline_max_code_units_(kUnsetInlineMaxCodeUnits),
+      inlining_heuristics_(InliningHeuristics::kBudget),
       instruction_set_(kRuntimeISA == InstructionSet::kArm ? InstructionSet::kThumb2 : kRuntimeISA),
       instruction_set_features_(nullptr),
       no_inline_from_(),
@@ -81,7 +82,7 @@ CompilerOptions::CompilerOptions()
       resolve_startup_const_strings_(false),
       initialize_app_image_classes_(false),
       check_profiled_methods_(ProfileMethodsCheck::kNone),
-      max_image_block_size_(std::numeric_limits<uint32_t>::max()),
+      max_image_block_size_(kDefaultMaxImageBlockSize),
       register_allocation_strategy_(RegisterAllocator::kRegisterAllocatorDefault),
       passes_to_run_(nullptr) {
 }
@@ -47,6 +47,7 @@ class Arm64RelativePatcherTest;
 class DexFile;
 enum class InstructionSet;
 class InstructionSetFeatures;
+class OptimizingCompilerTest;
 class ProfileCompilationInfo;
 class VerificationResults;
 
@@ -57,6 +58,12 @@ enum class ProfileMethodsCheck : uint8_t {
   kAbort,
 };
 
+// Enum for GetInliningHeuristics. Outside CompilerOptions so it can be forward-declared.
+enum class InliningHeuristics : uint8_t {
+  kBudget,        // Fixed code unit, instruction and environment budgets.
+  kCostBenefit,   // Call site frequency and simplification payoff weighed against code growth.
+};
+
 class CompilerOptions final {
  public:
   // Guide heuristics to determine whether to compile method if profile data not available.
@@ -68,6 +75,9 @@ class CompilerOptions final {
   static const bool kDefaultGenerateMiniDebugInfo = true;
   static const size_t kDefaultInlineMaxCodeUnits = 32;
   static constexpr size_t kUnsetInlineMaxCodeUnits = -1;
+  // Compressed images are split into blocks of at most this size that can be decompressed
+  // independently. This matches the LZ4 match window, so the split barely affects the ratio.
+  static constexpr uint32_t kDefaultMaxImageBlockSize = 64 * KB;
 
   enum class CompilerType : uint8_t {
     kAotCompiler,             // AOT compiler.
@@ -149,6 +159,13 @@ class CompilerOptions final {
     inline_max_code_units_ = units;
   }
 
+  InliningHeuristics GetInliningHeuristics() const {
+    return inlining_heuristics_;
+  }
+  void SetInliningHeuristics(InliningHeuristics heuristics) {
+    inlining_heuristics_ = heuristics;
+  }
+
   double GetTopKProfileThreshold() const {
     return top_k_profile_threshold_;
   }
@@ -392,6 +409,7 @@ class CompilerOptions final {
   size_t large_method_threshold_;
   size_t num_dex_methods_threshold_;
   size_t inline_max_code_units_;
+  InliningHeuristics inlining_heuristics_;
 
   InstructionSet instruction_set_;
   std::unique_ptr<const InstructionSetFeatures> instruction_set_features_;
@@ -495,6 +513,7 @@ class CompilerOptions final {
   friend class CommonCompilerDriverTest;
   friend class CommonCompilerTestImpl;
   friend class jit::JitCompiler;
+  friend class OptimizingCompilerTest;
   friend class verifier::VerifierDepsTest;
   friend class linker::Arm64RelativePatcherTest;
 
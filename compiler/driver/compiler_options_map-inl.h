@@ -60,6 +60,7 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
   map.AssignIfExists(Base::LargeMethodMaxThreshold, &options->large_method_threshold_);
   map.AssignIfExists(Base::NumDexMethodsThreshold, &options->num_dex_methods_threshold_);
   map.AssignIfExists(Base::InlineMaxCodeUnitsThreshold, &options->inline_max_code_units_);
+  map.AssignIfExists(Base::InlineHeuristics, &options->inlining_heuristics_);
   map.AssignIfExists(Base::GenerateDebugInfo, &options->generate_debug_info_);
   map.AssignIfExists(Base::GenerateMiniDebugInfo, &options->generate_mini_debug_info_);
   map.AssignIfExists(Base::GenerateBuildID, &options->generate_build_id_);
@@ -148,6 +149,15 @@ inline void AddCompilerOptionsArgumentParserOptions(Builder& b) {
                     "A zero value will disable inlining. Honored only by Optimizing. Has priority\n"
                     "over the --compiler-filter option. Intended for development/experimental use.")
           .IntoKey(Map::InlineMaxCodeUnitsThreshold)
+      .Define("--inline-heuristics=_")
+          .template WithType<InliningHeuristics>()
+          .WithValueMap({{"budget", InliningHeuristics::kBudget},
+                         {"cost-benefit", InliningHeuristics::kCostBenefit}})
+          .WithHelp("budget|cost-benefit. Selects how Optimizing decides which calls to inline:\n"
+                    "with fixed size budgets, or by weighing the frequency of the call site and\n"
+                    "the expected simplifications against a per-method code growth budget.\n"
+                    "Defaults to budget.")
+          .IntoKey(Map::InlineHeuristics)
 
       .Define({"--generate-debug-info", "-g", "--no-generate-debug-info"})
           .WithValues({true, true, false})
@@ -254,7 +264,8 @@ inline void AddCompilerOptionsArgumentParserOptions(Builder& b) {
 
       .Define("--max-image-block-size=_")
           .template WithType<unsigned int>()
-          .WithHelp("Maximum solid block size for compressed images.")
+          .WithHelp("Maximum solid block size for compressed images. Blocks are aligned to\n"
+                    "their size within the image. Default: 64KB.")
           .IntoKey(Map::MaxImageBlockSize);
 }
 
@@ -26,6 +26,7 @@
 
 namespace art {
 
+enum class InliningHeuristics : uint8_t;
 enum class ProfileMethodsCheck : uint8_t;
 
 // Defines a type-safe heterogeneous key->value map. This is to be used as the base for
@@ -37,6 +37,9 @@
 namespace art {
 namespace jit {
 
+// Free arena memory kept resident in the JIT arena pool between compilations.
+static constexpr size_t kJitWarmArenaBytes = 2 * MB;
+
 JitCompiler* JitCompiler::Create() {
   return new JitCompiler();
 }
@@ -201,11 +204,12 @@ bool JitCompiler::CompileMethod(
     runtime->GetMetrics()->JitMethodCompileCount()->AddOne();
   }
 
-  // Trim maps to reduce memory usage.
+  // Trim maps to reduce memory usage, but keep the arenas a typical compilation needs
+  // resident so that back-to-back compilations do not fault the same pages in again.
   // TODO: move this to an idle phase.
   {
     TimingLogger::ScopedTiming t2("TrimMaps", &logger);
-    runtime->GetJitArenaPool()->TrimMaps();
+    runtime->GetJitArenaPool()->TrimColdMaps(kJitWarmArenaBytes);
   }
 
   runtime->GetJit()->AddTimingLogger(logger);
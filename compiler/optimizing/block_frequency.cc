@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "block_frequency.h"
+
+#include <algorithm>
+
+#include "base/scoped_arena_allocator.h"
+#include "base/scoped_arena_containers.h"
+
+namespace art {
+
+// Bounds on profiled branch probabilities, so that a branch never seen taken
+// still contributes a little.
+static constexpr float kMinProbability = 1.0f / 4096;
+
+// Static probability of a branch to a path that inevitably throws.
+static constexpr float kUnlikelyProbability = 1.0f / 1024;
+
+// Static probability of a branch that leaves a loop.
+static constexpr float kLoopExitProbability = 1.0f / 8;
+
+// Upper bound on the expected number of iterations of a loop per entry.
+static constexpr float kMaxLoopFactor = 1024.0f;
+
+float BlockFrequencyAnalysis::GetSuccessorProbability(HBasicBlock* block,
+                                                      size_t index,
+                                                      const ArenaBitVector& unlikely) const {
+  const ArenaVector<HBasicBlock*>& successors = block->GetSuccessors();
+  DCHECK_LT(index, successors.size());
+  HInstruction* last = block->GetLastInstruction();
+  if (last->IsTryBoundary()) {
+    // Exception handlers are at index one and above.
+    return index == 0u ? 1.0f : 0.0f;
+  } else if (!last->IsIf()) {
+    return 1.0f / successors.size();
+  }
+  HIf* if_instr = last->AsIf();
+  float true_probability = 0.5f;
+  uint32_t true_count = if_instr->GetTrueCount();
+  uint32_t total_count = true_count + if_instr->GetFalseCount();
+  if (total_count != 0u) {
+    true_probability = std::clamp(static_cast<float>(true_count) / total_count,
+                                  kMinProbability,
+                                  1.0f - kMinProbability);
+  } else {
+    HBasicBlock* true_successor = if_instr->IfTrueSuccessor();
+    HBasicBlock* false_successor = if_instr->IfFalseSuccessor();
+    bool true_unlikely = unlikely.IsBitSet(true_successor->GetBlockId());
+    bool false_unlikely = unlikely.IsBitSet(false_successor->GetBlockId());
+    HLoopInformation* loop = block->GetLoopInformation();
+    if (true_unlikely != false_unlikely) {
+      true_probability = true_unlikely ? kUnlikelyProbability : 1.0f - kUnlikelyProbability;
+    } else if (loop != nullptr) {
+      bool true_exits = !loop->Contains(*true_successor);
+      bool false_exits = !loop->Contains(*false_successor);
+      if (true_exits != false_exits) {
+        true_probability = true_exits ? kLoopExitProbability : 1.0f - kLoopExitProbability;
+      }
+    }
+  }
+  return index == 0u ? true_probability : 1.0f - true_probability;
+}
+
+bool BlockFrequencyAnalysis::Run() {
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  size_t number_of_blocks = graph_->GetBlocks().size();
+
+  // (1) Find the blocks from which every path ends in a throw. Successors are visited
+  //     before their predecessors in post order, except for loop headers, which
+  //     conservatively remain likely.
+  ArenaBitVector unlikely(&allocator, number_of_blocks, false, kArenaAllocBlockFrequency);
+  for (HBasicBlock* block : graph_->GetPostOrder()) {
+    if (block->GetLastInstruction()->IsThrow()) {
+      unlikely.SetBit(block->GetBlockId());
+    } else if (!block->IsExitBlock() && !block->GetSuccessors().empty()) {
+      bool all_unlikely = true;
+      for (HBasicBlock* successor : block->GetSuccessors()) {
+        all_unlikely = all_unlikely && unlikely.IsBitSet(successor->GetBlockId());
+      }
+      if (all_unlikely) {
+        unlikely.SetBit(block->GetBlockId());
+      }
+    }
+  }
+
+  // Adds the flow from `block` into each of its successors to `frequencies`.
+  ScopedArenaVector<float> frequencies(
+      number_of_blocks, 0.0f, allocator.Adapter(kArenaAllocBlockFrequency));
+  auto propagate = [&](HBasicBlock* block, HLoopInformation* restrict_to) {
+    const ArenaVector<HBasicBlock*>& successors = block->GetSuccessors();
+    for (size_t i = 0, e = successors.size(); i != e; ++i) {
+      HBasicBlock* successor = successors[i];
+      if (restrict_to != nullptr && !restrict_to->Contains(*successor)) {
+        continue;  // leaves the loop
+      } else if (successor->IsLoopHeader() &&
+                 successor->GetLoopInformation()->IsBackEdge(*block)) {
+        continue;  // back edges are accounted for by the loop factors
+      }
+      frequencies[successor->GetBlockId()] +=
+          frequencies[block->GetBlockId()] * GetSuccessorProbability(block, i, unlikely);
+    }
+  };
+
+  // (2) Compute the expected number of iterations of each loop per entry, from the
+  //     probability c of flowing from the header back to the header: 1 / (1 - c).
+  //     Inner loops come first in post order, so their factors are known when
+  //     the flow through an outer loop is computed.
+  ScopedArenaVector<float> loop_factors(
+      number_of_blocks, 1.0f, allocator.Adapter(kArenaAllocBlockFrequency));
+  for (HBasicBlock* header : graph_->GetPostOrder()) {
+    if (!header->IsLoopHeader()) {
+      continue;
+    }
+    HLoopInformation* loop = header->GetLoopInformation();
+    for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+      if (loop->Contains(*block)) {
+        frequencies[block->GetBlockId()] = 0.0f;
+      }
+    }
+    frequencies[header->GetBlockId()] = 1.0f;
+    float back_flow = 0.0f;
+    for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+      if (!loop->Contains(*block)) {
+        continue;
+      }
+      if (block != header && block->IsLoopHeader()) {
+        frequencies[block->GetBlockId()] *= loop_factors[block->GetBlockId()];
+      }
+      propagate(block, loop);
+      if (loop->IsBackEdge(*block)) {
+        const ArenaVector<HBasicBlock*>& successors = block->GetSuccessors();
+        for (size_t i = 0, e = successors.size(); i != e; ++i) {
+          if (successors[i] == header) {
+            back_flow +=
+                frequencies[block->GetBlockId()] * GetSuccessorProbability(block, i, unlikely);
+          }
+        }
+      }
+    }
+    back_flow = std::min(back_flow, 1.0f - 1.0f / kMaxLoopFactor);
+    loop_factors[header->GetBlockId()] = 1.0f / (1.0f - back_flow);
+  }
+
+  // (3) Propagate the flow through the whole method, in reverse post order so
+  //     that the forward predecessors of a block are done before the block.
+  std::fill(frequencies.begin(), frequencies.end(), 0.0f);
+  frequencies[graph_->GetEntryBlock()->GetBlockId()] = 1.0f;
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    if (block->IsLoopHeader()) {
+      frequencies[block->GetBlockId()] *= loop_factors[block->GetBlockId()];
+    }
+    block->SetFrequency(frequencies[block->GetBlockId()]);
+    propagate(block, /* restrict_to= */ nullptr);
+  }
+  return true;
+}
+
+}  // namespace art
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_BLOCK_FREQUENCY_H_
+#define ART_COMPILER_OPTIMIZING_BLOCK_FREQUENCY_H_
+
+#include "base/arena_bit_vector.h"
+#include "nodes.h"
+#include "optimization.h"
+
+namespace art {
+
+/**
+ * Estimates, for each basic block, how often it executes per execution of the method,
+ * and records the result with HBasicBlock::SetFrequency(). Branch probabilities come
+ * from the profile collected by baseline compiled code when available (see HIf),
+ * and from static heuristics otherwise: paths that inevitably throw and exception
+ * handlers are unlikely, and loops are more likely to iterate than to exit.
+ *
+ * The frequencies drive block layout (see linear_order.h) and the placement of
+ * split positions in the register allocator, so this analysis runs on the final
+ * graph, right before SSA liveness analysis.
+ */
+class BlockFrequencyAnalysis : public HOptimization {
+ public:
+  explicit BlockFrequencyAnalysis(HGraph* graph,
+                                  OptimizingCompilerStats* stats = nullptr,
+                                  const char* name = kBlockFrequencyPassName)
+      : HOptimization(graph, name, stats) {}
+
+  bool Run() override;
+
+  // Blocks that execute less often than this, relative to the method entry, are cold.
+  static constexpr float kColdFrequency = 1.0f / 64;
+
+  static bool IsCold(const HBasicBlock* block) {
+    return block->GetFrequency() < kColdFrequency;
+  }
+
+  static constexpr const char* kBlockFrequencyPassName = "block_frequency";
+
+ private:
+  // Probability that control flows from `block` to the successor at `index`.
+  float GetSuccessorProbability(HBasicBlock* block,
+                                size_t index,
+                                const ArenaBitVector& unlikely) const;
+
+  DISALLOW_COPY_AND_ASSIGN(BlockFrequencyAnalysis);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_BLOCK_FREQUENCY_H_
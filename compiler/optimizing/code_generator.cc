@@ -47,6 +47,7 @@
 #include "gc/space/image_space.h"
 #include "intern_table.h"
 #include "intrinsics.h"
+#include "jit/profiling_info.h"
 #include "mirror/array-inl.h"
 #include "mirror/object_array-inl.h"
 #include "mirror/object_reference.h"
@@ -304,6 +305,20 @@ uint32_t CodeGenerator::GetArrayDataOffset(HArrayGet* array_get) {
       : mirror::Array::DataOffset(DataType::Size(array_get->GetType())).Uint32Value();
 }
 
+BranchCache* CodeGenerator::GetBranchCacheForProfiling(HIf* if_instr,
+                                                       const CompilerOptions& compiler_options) {
+  HGraph* graph = if_instr->GetBlock()->GetGraph();
+  InstructionSet isa = compiler_options.GetInstructionSet();
+  // Only the x86-64 and arm64 code generators update branch caches.
+  if (!graph->IsCompilingBaseline() ||
+      graph->GetProfilingInfo() == nullptr ||
+      (isa != InstructionSet::kX86_64 && isa != InstructionSet::kArm64) ||
+      if_instr->InputAt(0)->IsConstant()) {
+    return nullptr;
+  }
+  return graph->GetProfilingInfo()->GetBranchCache(if_instr->GetDexPc());
+}
+
 bool CodeGenerator::GoesToNextBlock(HBasicBlock* current, HBasicBlock* next) const {
   DCHECK_EQ((*block_order_)[current_block_index_], current);
   return GetNextBlockToEmit() == FirstNonEmptyBlock(next);
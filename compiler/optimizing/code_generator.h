@@ -60,6 +60,7 @@ static constexpr ReadBarrierOption kCompilerReadBarrierOption =
     kEmitCompilerReadBarrier ? kWithReadBarrier : kWithoutReadBarrier;
 
 class Assembler;
+class BranchCache;
 class CodeGenerator;
 class CompilerOptions;
 class StackMapStream;
@@ -443,6 +444,12 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
   // accessing the String's `value` field in String intrinsics.
   static uint32_t GetArrayDataOffset(HArrayGet* array_get);
 
+  // Returns the branch cache that baseline compiled code updates for `if_instr`,
+  // or null if the branch is not profiled. Profiled branches index the cache with
+  // their materialized condition.
+  static BranchCache* GetBranchCacheForProfiling(HIf* if_instr,
+                                                 const CompilerOptions& compiler_options);
+
   void EmitParallelMoves(Location from1,
                          Location to1,
                          DataType::Type type1,
@@ -3720,6 +3720,27 @@ void LocationsBuilderARM64::VisitIf(HIf* if_instr) {
 }
 
 void InstructionCodeGeneratorARM64::VisitIf(HIf* if_instr) {
+  BranchCache* cache =
+      CodeGenerator::GetBranchCacheForProfiling(if_instr, codegen_->GetCompilerOptions());
+  if (cache != nullptr) {
+    static_assert(
+        BranchCache::TrueOffset().Int32Value() - BranchCache::FalseOffset().Int32Value() == 2,
+        "Unexpected offsets for BranchCache");
+    uint64_t address =
+        reinterpret_cast64<uint64_t>(cache) + BranchCache::FalseOffset().Int32Value();
+    vixl::aarch64::Label done;
+    UseScratchRegisterScope temps(GetVIXLAssembler());
+    Register temp = temps.AcquireX();
+    Register counter = temps.AcquireW();
+    Register condition = InputRegisterAt(if_instr, 0).X();
+    // Saturating increment of the counter selected by the 0/1 condition.
+    __ Mov(temp, address);
+    __ Ldrh(counter, MemOperand(temp, condition, LSL, 1));
+    __ Add(counter, counter, 1);
+    __ Tbnz(counter, 16, &done);
+    __ Strh(counter, MemOperand(temp, condition, LSL, 1));
+    __ Bind(&done);
+  }
   HBasicBlock* true_successor = if_instr->IfTrueSuccessor();
   HBasicBlock* false_successor = if_instr->IfFalseSuccessor();
   vixl::aarch64::Label* true_target = codegen_->GetLabelOf(true_successor);
@@ -4468,12 +4489,17 @@ void CodeGeneratorARM64::MaybeGenerateInlineCacheCheck(HInstruction* instruction
     DCHECK(info != nullptr);
     InlineCache* cache = info->GetInlineCache(instruction->GetDexPc());
     uint64_t address = reinterpret_cast64<uint64_t>(cache);
-    vixl::aarch64::Label done;
+    vixl::aarch64::Label done, update_cache;
     __ Mov(x8, address);
     __ Ldr(x9, MemOperand(x8, InlineCache::ClassesOffset().Int32Value()));
-    // Fast path for a monomorphic cache.
+    // Fast path for a monomorphic cache: only record the call in the first counter.
     __ Cmp(klass, x9);
-    __ B(eq, &done);
+    __ B(ne, &update_cache);
+    __ Ldr(w9, MemOperand(x8, InlineCache::CountsOffset().Int32Value()));
+    __ Add(w9, w9, 1);
+    __ Str(w9, MemOperand(x8, InlineCache::CountsOffset().Int32Value()));
+    __ B(&done);
+    __ Bind(&update_cache);
     InvokeRuntime(kQuickUpdateInlineCache, instruction, instruction->GetDexPc());
     __ Bind(&done);
   }
@@ -2036,13 +2036,18 @@ void InstructionCodeGeneratorX86_64::GenerateCompareTestAndBranch(HCondition* co
   }
 }
 
-static bool AreEflagsSetFrom(HInstruction* cond, HInstruction* branch) {
+static bool AreEflagsSetFrom(HInstruction* cond,
+                             HInstruction* branch,
+                             const CompilerOptions& compiler_options) {
   // Moves may affect the eflags register (move zero uses xorl), so the EFLAGS
   // are set only strictly before `branch`. We can't use the eflags on long
-  // conditions if they are materialized due to the complex branching.
+  // conditions if they are materialized due to the complex branching. The
+  // branch profiling update emitted by VisitIf() also clobbers the EFLAGS.
   return cond->IsCondition() &&
          cond->GetNext() == branch &&
-         !DataType::IsFloatingPointType(cond->InputAt(0)->GetType());
+         !DataType::IsFloatingPointType(cond->InputAt(0)->GetType()) &&
+         !(branch->IsIf() &&
+           CodeGenerator::GetBranchCacheForProfiling(branch->AsIf(), compiler_options) != nullptr);
 }
 
 template<class LabelType>
@@ -2079,7 +2084,7 @@ void InstructionCodeGeneratorX86_64::GenerateTestAndBranch(HInstruction* instruc
   //        - condition true => branch to true_target
   //        - branch to false_target
   if (IsBooleanValueOrMaterializedCondition(cond)) {
-    if (AreEflagsSetFrom(cond, instruction)) {
+    if (AreEflagsSetFrom(cond, instruction, codegen_->GetCompilerOptions())) {
       if (true_target == nullptr) {
         __ j(X86_64IntegerCondition(cond->AsCondition()->GetOppositeCondition()), false_target);
       } else {
@@ -2132,11 +2137,34 @@ void InstructionCodeGeneratorX86_64::GenerateTestAndBranch(HInstruction* instruc
 void LocationsBuilderX86_64::VisitIf(HIf* if_instr) {
   LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(if_instr);
   if (IsBooleanValueOrMaterializedCondition(if_instr->InputAt(0))) {
-    locations->SetInAt(0, Location::Any());
+    if (CodeGenerator::GetBranchCacheForProfiling(if_instr, codegen_->GetCompilerOptions()) !=
+            nullptr) {
+      locations->SetInAt(0, Location::RequiresRegister());
+    } else {
+      locations->SetInAt(0, Location::Any());
+    }
   }
 }
 
 void InstructionCodeGeneratorX86_64::VisitIf(HIf* if_instr) {
+  BranchCache* cache =
+      CodeGenerator::GetBranchCacheForProfiling(if_instr, codegen_->GetCompilerOptions());
+  if (cache != nullptr) {
+    static_assert(
+        BranchCache::TrueOffset().Int32Value() - BranchCache::FalseOffset().Int32Value() == 2,
+        "Unexpected offsets for BranchCache");
+    uint64_t address =
+        reinterpret_cast64<uint64_t>(cache) + BranchCache::FalseOffset().Int32Value();
+    CpuRegister condition = if_instr->GetLocations()->InAt(0).AsRegister<CpuRegister>();
+    Address counter(CpuRegister(TMP), condition, TIMES_2, 0);
+    NearLabel done;
+    // Saturating increment of the counter selected by the 0/1 condition.
+    __ movq(CpuRegister(TMP), Immediate(address));
+    __ cmpw(counter, Immediate(std::numeric_limits<uint16_t>::max()));
+    __ j(kEqual, &done);
+    __ addw(counter, Immediate(1));
+    __ Bind(&done);
+  }
   HBasicBlock* true_successor = if_instr->IfTrueSuccessor();
   HBasicBlock* false_successor = if_instr->IfFalseSuccessor();
   Label* true_target = codegen_->GoesToNextBlock(if_instr->GetBlock(), true_successor) ?
@@ -2235,7 +2263,7 @@ void InstructionCodeGeneratorX86_64::VisitSelect(HSelect* select) {
       if (!condition->IsEmittedAtUseSite()) {
         // This was a previously materialized condition.
         // Can we use the existing condition code?
-        if (AreEflagsSetFrom(condition, select)) {
+        if (AreEflagsSetFrom(condition, select, codegen_->GetCompilerOptions())) {
           // Materialization was the previous instruction.  Condition codes are right.
           cond = X86_64IntegerCondition(condition->GetCondition());
         } else {
@@ -2922,11 +2950,14 @@ void CodeGeneratorX86_64::MaybeGenerateInlineCacheCheck(HInstruction* instructio
     DCHECK(info != nullptr);
     InlineCache* cache = info->GetInlineCache(instruction->GetDexPc());
     uint64_t address = reinterpret_cast64<uint64_t>(cache);
-    NearLabel done;
+    NearLabel done, update_cache;
     __ movq(CpuRegister(TMP), Immediate(address));
-    // Fast path for a monomorphic cache.
+    // Fast path for a monomorphic cache: only record the call in the first counter.
     __ cmpl(Address(CpuRegister(TMP), InlineCache::ClassesOffset().Int32Value()), klass);
-    __ j(kEqual, &done);
+    __ j(kNotEqual, &update_cache);
+    __ addl(Address(CpuRegister(TMP), InlineCache::CountsOffset().Int32Value()), Immediate(1));
+    __ jmp(&done);
+    __ Bind(&update_cache);
     GenerateInvokeRuntime(
         GetThreadOffset<kX86_64PointerSize>(kQuickUpdateInlineCache).Int32Value());
     __ Bind(&done);
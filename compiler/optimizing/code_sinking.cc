@@ -22,6 +22,7 @@
 #include "base/logging.h"
 #include "base/scoped_arena_allocator.h"
 #include "base/scoped_arena_containers.h"
+#include "block_frequency.h"
 #include "common_dominator.h"
 #include "nodes.h"
 
@@ -33,8 +34,7 @@ bool CodeSinking::Run() {
     // Infinite loop, just bail.
     return false;
   }
-  // TODO(ngeoffray): we do not profile branches yet, so use throw instructions
-  // as an indicator of an uncommon branch.
+  // Throw instructions are an indicator of an uncommon branch.
   for (HBasicBlock* exit_predecessor : exit->GetPredecessors()) {
     HInstruction* last = exit_predecessor->GetLastInstruction();
     // Any predecessor of the exit that does not return, throws an exception.
@@ -42,9 +42,46 @@ bool CodeSinking::Run() {
       SinkCodeToUncommonBranch(exit_predecessor);
     }
   }
+  // So are branches that the profile shows to be rarely taken.
+  SinkCodeToRareBranches();
   return true;
 }
 
+void CodeSinking::SinkCodeToRareBranches() {
+  bool has_profiled_branch = false;
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    if (block->EndsWithIf() && IsProfiled(block->GetLastInstruction()->AsIf())) {
+      has_profiled_branch = true;
+      break;
+    }
+  }
+  if (!has_profiled_branch) {
+    return;
+  }
+  BlockFrequencyAnalysis(graph_).Run();
+  // Sinking moves instructions but does not change the control flow, so the
+  // frequencies remain valid throughout.
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    // We currently bail for loops: code sunk into a loop body would execute
+    // once per iteration, and an allocation would no longer be a single object.
+    if (block->IsInLoop() ||
+        !block->EndsWithIf() ||
+        !IsProfiled(block->GetLastInstruction()->AsIf()) ||
+        BlockFrequencyAnalysis::IsCold(block)) {
+      continue;
+    }
+    for (HBasicBlock* successor : block->GetSuccessors()) {
+      // Critical edges are split, so a successor with a single predecessor is
+      // only reached through this branch.
+      if (successor->GetPredecessors().size() == 1u &&
+          !successor->IsInLoop() &&
+          BlockFrequencyAnalysis::IsCold(successor)) {
+        SinkCodeToUncommonBranch(successor);
+      }
+    }
+  }
+}
+
 static bool IsInterestingInstruction(HInstruction* instruction) {
   // Instructions from the entry graph (for example constants) are never interesting to move.
   if (instruction->GetBlock() == instruction->GetBlock()->GetGraph()->GetEntryBlock()) {
@@ -311,9 +348,7 @@ void CodeSinking::SinkCodeToUncommonBranch(HBasicBlock* end_block) {
 
   // Step (1): Visit post order to get a subset of blocks post dominated by `end_block`.
   // TODO(ngeoffray): Getting the full set of post-dominated shoud be done by
-  // computint the post dominator tree, but that could be too time consuming. Also,
-  // we should start the analysis from blocks dominated by an uncommon branch, but we
-  // don't profile branches yet.
+  // computint the post dominator tree, but that could be too time consuming.
   bool found_block = false;
   for (HBasicBlock* block : graph_->GetPostOrder()) {
     if (block == end_block) {
@@ -24,7 +24,13 @@ namespace art {
 
 /**
  * Optimization pass to move instructions into uncommon branches,
- * when it is safe to do so.
+ * when it is safe to do so. Uncommon branches are those that end up
+ * throwing, and those that the branch profile collected by baseline
+ * compiled code shows to be rarely taken.
+ *
+ * Together with load-store elimination, which forwards the stored field
+ * values to the loads on the common path, this moves allocations that only
+ * escape on rare paths (for example, when reporting an error) to these paths.
  */
 class CodeSinking : public HOptimization {
  public:
@@ -42,6 +48,14 @@ class CodeSinking : public HOptimization {
   // blocks, to these blocks.
   void SinkCodeToUncommonBranch(HBasicBlock* end_block);
 
+  // Try to move code only used on branches that the profile shows to be cold
+  // to these branches.
+  void SinkCodeToRareBranches();
+
+  static bool IsProfiled(HIf* if_instr) {
+    return if_instr->GetTrueCount() + if_instr->GetFalseCount() != 0;
+  }
+
   DISALLOW_COPY_AND_ASSIGN(CodeSinking);
 };
 
@@ -16,15 +16,22 @@
 
 #include "inliner.h"
 
+#include <array>
+#include <numeric>
+
 #include "art_method-inl.h"
+#include "base/arena_bit_vector.h"
 #include "base/enums.h"
 #include "base/logging.h"
+#include "base/scoped_arena_allocator.h"
+#include "block_frequency.h"
 #include "builder.h"
 #include "class_linker.h"
 #include "class_root-inl.h"
 #include "constant_folding.h"
 #include "data_type-inl.h"
 #include "dead_code_elimination.h"
+#include "dex/dex_instruction_utils.h"
 #include "dex/inline_method_analyser.h"
 #include "driver/compiler_options.h"
 #include "driver/dex_compilation_unit.h"
@@ -69,9 +76,44 @@ static constexpr size_t kMaximumNumberOfRecursiveCalls = 4;
 // recursive calls at all.
 static constexpr size_t kMaximumNumberOfPolymorphicRecursiveCalls = 0;
 
+// With the cost/benefit heuristics, the instruction limit of a method is its own size
+// times this factor, so that large hot methods can keep inlining their call chains...
+static constexpr size_t kMaximumCodeGrowthFactor = 4;
+
+// ... within these bounds, to control memory.
+static constexpr size_t kMinimumNumberOfTotalInstructionsForCostBenefit =
+    kMaximumNumberOfTotalInstructions;
+static constexpr size_t kMaximumNumberOfTotalInstructionsForCostBenefit =
+    4 * kMaximumNumberOfTotalInstructions;
+
+// With the cost/benefit heuristics, call sites executing at least this many times per
+// execution of the outermost method can inline callees larger than the
+// --inline-max-code-units threshold, up to this factor.
+static constexpr float kMaximumCallSiteFrequencyFactor = 4.0f;
+
+// Extra code units allowed per constant argument or argument of exact type, relative to
+// the --inline-max-code-units threshold. Both typically fold branches and type checks
+// of the inlined body.
+static constexpr float kSimplifyingArgumentFactor = 0.25f;
+
+// Maximum number of code units of a method inlined at a cold call site, which does not
+// get much more than the removal of the call overhead out of inlining.
+static constexpr size_t kMaximumCodeUnitsForColdCallSite = 8;
+
 // Controls the use of inline caches in AOT mode.
 static constexpr bool kUseAOTInlineCaches = true;
 
+// Minimum number of calls recorded by the baseline compiled code at a megamorphic
+// call site before we trust its receiver distribution.
+static constexpr uint32_t kMinimumNumberOfMegamorphicCallSamples = 64;
+
+// Minimum percentage of the calls at a megamorphic call site a receiver class
+// must account for to get a guarded inlined copy of its target.
+static constexpr uint32_t kMinimumMegamorphicReceiverPercentage = 20;
+
+// Maximum number of targets we inline at a megamorphic call site.
+static constexpr size_t kMaximumNumberOfMegamorphicInlinedTargets = 2;
+
 // We check for line numbers to make sure the DepthString implementation
 // aligns the output nicely.
 #define LOG_INTERNAL(msg) \
@@ -120,14 +162,45 @@ static size_t CountNumberOfInstructions(HGraph* graph) {
 }
 
 void HInliner::UpdateInliningBudget() {
-  if (total_number_of_instructions_ >= kMaximumNumberOfTotalInstructions) {
+  if (total_number_of_instructions_ >= maximum_number_of_total_instructions_) {
     // Always try to inline small methods.
     inlining_budget_ = kMaximumNumberOfInstructionsForSmallMethod;
   } else {
     inlining_budget_ = std::max(
         kMaximumNumberOfInstructionsForSmallMethod,
-        kMaximumNumberOfTotalInstructions - total_number_of_instructions_);
+        maximum_number_of_total_instructions_ - total_number_of_instructions_);
+  }
+}
+
+bool HInliner::UseCostBenefitHeuristics() const {
+  return codegen_->GetCompilerOptions().GetInliningHeuristics() ==
+         InliningHeuristics::kCostBenefit;
+}
+
+size_t HInliner::GetMaximumInlinedCodeUnits(HInvoke* invoke_instruction) const {
+  size_t inline_max_code_units = codegen_->GetCompilerOptions().GetInlineMaxCodeUnits();
+  if (!UseCostBenefitHeuristics()) {
+    return inline_max_code_units;
+  }
+
+  float frequency = frequency_ * call_site_frequency_;
+  if (frequency < BlockFrequencyAnalysis::kColdFrequency) {
+    return std::min(inline_max_code_units, kMaximumCodeUnitsForColdCallSite);
+  }
+
+  size_t number_of_simplifying_arguments = 0;
+  for (size_t i = 0, e = invoke_instruction->GetNumberOfArguments(); i != e; ++i) {
+    HInstruction* argument = invoke_instruction->InputAt(i);
+    if (argument->IsConstant() ||
+        (argument->GetType() == DataType::Type::kReference &&
+         argument->GetReferenceTypeInfo().IsValid() &&
+         argument->GetReferenceTypeInfo().IsExact())) {
+      ++number_of_simplifying_arguments;
+    }
   }
+  float factor = std::clamp(frequency, 1.0f, kMaximumCallSiteFrequencyFactor) *
+                 (1.0f + kSimplifyingArgumentFactor * number_of_simplifying_arguments);
+  return static_cast<size_t>(inline_max_code_units * factor);
 }
 
 bool HInliner::Run() {
@@ -142,6 +215,7 @@ bool HInliner::Run() {
 
   bool did_inline = false;
   bool did_set_always_throws = false;
+  bool did_refine_return_type = false;
 
   // Initialize the number of instructions for the method being compiled. Recursive calls
   // to HInliner::Run have already updated the instruction count.
@@ -149,6 +223,23 @@ bool HInliner::Run() {
     total_number_of_instructions_ = CountNumberOfInstructions(graph_);
   }
 
+  if (parent_ != nullptr) {
+    maximum_number_of_total_instructions_ = parent_->maximum_number_of_total_instructions_;
+    frequency_ = parent_->frequency_ * parent_->call_site_frequency_;
+  } else if (UseCostBenefitHeuristics()) {
+    maximum_number_of_total_instructions_ =
+        std::clamp(kMaximumCodeGrowthFactor * total_number_of_instructions_,
+                   kMinimumNumberOfTotalInstructionsForCostBenefit,
+                   kMaximumNumberOfTotalInstructionsForCostBenefit);
+  } else {
+    maximum_number_of_total_instructions_ = kMaximumNumberOfTotalInstructions;
+  }
+  if (UseCostBenefitHeuristics()) {
+    // Weigh the call sites by how often they execute. The branch profile collected
+    // by baseline compiled code is used when available.
+    BlockFrequencyAnalysis(graph_).Run();
+  }
+
   UpdateInliningBudget();
   DCHECK_NE(total_number_of_instructions_, 0u);
   DCHECK_NE(inlining_budget_, 0u);
@@ -171,6 +262,8 @@ bool HInliner::Run() {
   // we just iterate over the blocks of the outer method.
   // This avoids doing the inlining work again on the inlined blocks.
   for (HBasicBlock* block : blocks) {
+    // Inlining splits `block`, so read its frequency before visiting its calls.
+    call_site_frequency_ = block->GetFrequency();
     for (HInstruction* instruction = block->GetFirstInstruction(); instruction != nullptr;) {
       HInstruction* next = instruction->GetNext();
       HInvoke* call = instruction->AsInvoke();
@@ -182,7 +275,7 @@ bool HInliner::Run() {
               call->GetMethodReference().PrettyMethod(/* with_signature= */ false);
           // Tests prevent inlining by having $noinline$ in their method names.
           if (callee_name.find("$noinline$") == std::string::npos) {
-            if (TryInline(call, &did_set_always_throws)) {
+            if (TryInline(call, &did_set_always_throws, &did_refine_return_type)) {
               did_inline = true;
             } else if (honor_inline_directives) {
               bool should_have_inlined = (callee_name.find("$inline$") != std::string::npos);
@@ -192,7 +285,7 @@ bool HInliner::Run() {
         } else {
           DCHECK(!honor_inline_directives);
           // Normal case: try to inline.
-          if (TryInline(call, &did_set_always_throws)) {
+          if (TryInline(call, &did_set_always_throws, &did_refine_return_type)) {
             did_inline = true;
           }
         }
@@ -201,7 +294,17 @@ bool HInliner::Run() {
     }
   }
 
-  return did_inline || did_set_always_throws;
+  if (did_refine_return_type) {
+    // Propagate the refined types and nullability to the users of all refined invokes at
+    // once, so that null checks and type checks of the results, and calls on them, can be
+    // simplified.
+    ReferenceTypePropagation(graph_,
+                             outer_compilation_unit_.GetClassLoader(),
+                             outer_compilation_unit_.GetDexCache(),
+                             /* is_first_run= */ false).Run();
+  }
+
+  return did_inline || did_set_always_throws || did_refine_return_type;
 }
 
 static bool IsMethodOrDeclaringClassFinal(ArtMethod* method)
@@ -283,6 +386,38 @@ static ArtMethod* FindVirtualOrInterfaceTarget(HInvoke* invoke)
   }
 }
 
+// Returns the method `invoke` dispatches to in the static type of its receiver, when
+// that type is a class more specific than the declaring class of the resolved method.
+// Its single-implementation status can then be used for devirtualization even if the
+// resolved method has several implementations, for example an interface method
+// implemented by unrelated class hierarchies.
+static ArtMethod* FindTargetInReceiverStaticType(HInvoke* invoke)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  DCHECK(invoke->IsInvokeVirtual() || invoke->IsInvokeInterface()) << invoke->DebugName();
+  ArtMethod* resolved_method = invoke->GetResolvedMethod();
+  HInstruction* receiver = invoke->InputAt(0);
+  if (receiver->IsNullCheck()) {
+    receiver = receiver->InputAt(0);
+  }
+  ReferenceTypeInfo info = receiver->GetReferenceTypeInfo();
+  if (!info.IsValid() ||
+      info.GetTypeHandle()->IsInterface() ||
+      info.GetTypeHandle()->IsErroneous() ||
+      info.GetTypeHandle().Get() == resolved_method->GetDeclaringClass() ||
+      !resolved_method->GetDeclaringClass()->IsAssignableFrom(info.GetTypeHandle().Get())) {
+    return nullptr;
+  }
+
+  PointerSize pointer_size = Runtime::Current()->GetClassLinker()->GetImagePointerSize();
+  ArtMethod* target = invoke->IsInvokeInterface()
+      ? info.GetTypeHandle()->FindVirtualMethodForInterface(resolved_method, pointer_size)
+      : info.GetTypeHandle()->FindVirtualMethodForVirtual(resolved_method, pointer_size);
+  if (target == nullptr || target == resolved_method) {
+    return nullptr;
+  }
+  return target;
+}
+
 static uint32_t FindMethodIndexIn(ArtMethod* method,
                                   const DexFile& dex_file,
                                   uint32_t name_and_signature_index)
@@ -436,7 +571,9 @@ static bool AlwaysThrows(ArtMethod* method)
   return throw_seen;
 }
 
-bool HInliner::TryInline(HInvoke* invoke_instruction, /*inout*/ bool* did_set_always_throws) {
+bool HInliner::TryInline(HInvoke* invoke_instruction,
+                         /*inout*/ bool* did_set_always_throws,
+                         /*inout*/ bool* did_refine_return_type) {
   MaybeRecordStat(stats_, MethodCompilationStat::kTryInline);
 
   // Don't bother to move further if we know the method is unresolved or the invocation is
@@ -492,6 +629,8 @@ bool HInliner::TryInline(HInvoke* invoke_instruction, /*inout*/ bool* did_set_al
       if (AlwaysThrows(actual_method)) {
         invoke_to_analyze->SetAlwaysThrows(true);
         *did_set_always_throws = true;
+      } else if (TryRefineReturnType(invoke_to_analyze, actual_method)) {
+        *did_refine_return_type = true;
       }
     }
     return result;
@@ -505,27 +644,162 @@ bool HInliner::TryInline(HInvoke* invoke_instruction, /*inout*/ bool* did_set_al
   return TryInlineFromInlineCache(invoke_instruction);
 }
 
+// Returns whether `instruction` writes its register vA.
+static bool WritesRegisterA(const Instruction& instruction) {
+  if (instruction.GetVerifyTypeArgumentA() == 0 ||
+      instruction.IsReturn() ||
+      instruction.IsBranch() ||
+      instruction.IsSwitch()) {
+    return false;
+  }
+  Instruction::Code opcode = instruction.Opcode();
+  return opcode != Instruction::THROW &&
+         opcode != Instruction::MONITOR_ENTER &&
+         opcode != Instruction::MONITOR_EXIT &&
+         opcode != Instruction::CHECK_CAST &&  // refines the type, keeps the value
+         opcode != Instruction::FILL_ARRAY_DATA &&
+         !IsInstructionIPut(opcode) &&
+         !IsInstructionSPut(opcode) &&
+         !IsInstructionAPut(opcode);
+}
+
+bool HInliner::ReturnsNewReference(ArtMethod* method,
+                                   /*out*/ ObjPtr<mirror::Class>* exact_class) const {
+  DCHECK(method != nullptr);
+  // Skip non-compilable and unverified methods.
+  if (!method->IsCompilable() || !IsMethodVerified(method)) {
+    return false;
+  }
+  // Skip native methods and methods that are too large.
+  CodeItemDataAccessor accessor(method->DexInstructionData());
+  if (!accessor.HasCodeItem() ||
+      accessor.InsnsSizeInCodeUnits() > kMaximumNumberOfTotalInstructions) {
+    return false;
+  }
+
+  // Find the registers holding the returned values. The incoming arguments are unknown.
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ArenaBitVector returned_registers(
+      &allocator, accessor.RegistersSize(), /* expandable= */ false, kArenaAllocMisc);
+  const uint32_t first_argument_register = accessor.RegistersSize() - accessor.InsSize();
+  bool return_seen = false;
+  for (const DexInstructionPcPair& pair : accessor) {
+    if (pair.Inst().Opcode() == Instruction::RETURN_OBJECT) {
+      uint32_t reg = pair.Inst().VRegA_11x();
+      if (reg >= first_argument_register) {
+        return false;
+      }
+      returned_registers.SetBit(reg);
+      return_seen = true;
+    }
+  }
+  if (!return_seen) {
+    return false;
+  }
+
+  // The verifier guarantees that these registers are defined on every path to a return,
+  // so they hold non-null values if all instructions writing them create new references.
+  ObjPtr<mirror::Class> common_class = nullptr;
+  bool same_class = true;
+  bool allocation_seen = false;
+  for (const DexInstructionPcPair& pair : accessor) {
+    const Instruction& instruction = pair.Inst();
+    if (!WritesRegisterA(instruction)) {
+      continue;
+    }
+    uint32_t reg = instruction.VRegA();
+    bool is_wide = (instruction.GetVerifyTypeArgumentA() & Instruction::kVerifyRegAWide) != 0;
+    if (!returned_registers.IsBitSet(reg) &&
+        !(is_wide && reg + 1u < accessor.RegistersSize() && returned_registers.IsBitSet(reg + 1u))) {
+      continue;
+    }
+    ObjPtr<mirror::Class> cls;
+    switch (instruction.Opcode()) {
+      case Instruction::NEW_INSTANCE:
+        cls = method->LookupResolvedClassFromTypeIndex(dex::TypeIndex(instruction.VRegB_21c()));
+        break;
+      case Instruction::NEW_ARRAY:
+        cls = method->LookupResolvedClassFromTypeIndex(dex::TypeIndex(instruction.VRegC_22c()));
+        break;
+      case Instruction::CONST_STRING:
+      case Instruction::CONST_STRING_JUMBO:
+        cls = GetClassRoot<mirror::String>();
+        break;
+      case Instruction::CONST_CLASS:
+        cls = GetClassRoot<mirror::Class>();
+        break;
+      default:
+        return false;
+    }
+    if (!allocation_seen) {
+      common_class = cls;
+      allocation_seen = true;
+    } else if (cls != common_class) {
+      same_class = false;
+    }
+  }
+  *exact_class = same_class ? common_class : nullptr;
+  return allocation_seen;
+}
+
+bool HInliner::TryRefineReturnType(HInvoke* invoke_instruction, ArtMethod* method) {
+  if (!invoke_instruction->CanBeNull()) {
+    return false;
+  }
+  ObjPtr<mirror::Class> exact_class = nullptr;
+  if (!ReturnsNewReference(method, &exact_class)) {
+    return false;
+  }
+  invoke_instruction->SetCanBeNull(false);
+  if (exact_class != nullptr && ReferenceTypePropagation::IsAdmissible(exact_class)) {
+    invoke_instruction->SetReferenceTypeInfo(ReferenceTypeInfo::Create(
+        graph_->GetHandleCache()->NewHandle(exact_class), /* is_exact= */ true));
+  }
+  LOG_NOTE() << "Refined the result of " << method->PrettyMethod();
+  MaybeRecordStat(stats_, MethodCompilationStat::kRefinedReturnType);
+  return true;
+}
+
 bool HInliner::TryInlineFromCHA(HInvoke* invoke_instruction) {
-  ArtMethod* method = FindMethodFromCHA(invoke_instruction->GetResolvedMethod());
+  // The method whose single-implementation status the devirtualization relies on.
+  ArtMethod* cha_method = invoke_instruction->GetResolvedMethod();
+  ArtMethod* method = FindMethodFromCHA(cha_method);
   if (method == nullptr) {
-    return false;
+    // The resolved method may have several implementations, but only one of them
+    // can be reached from the static type of the receiver.
+    cha_method = FindTargetInReceiverStaticType(invoke_instruction);
+    if (cha_method == nullptr) {
+      return false;
+    }
+    method = FindMethodFromCHA(cha_method);
+    if (method == nullptr) {
+      return false;
+    }
   }
   LOG_NOTE() << "Try CHA-based inlining of " << method->PrettyMethod();
 
   uint32_t dex_pc = invoke_instruction->GetDexPc();
   HInstruction* cursor = invoke_instruction->GetPrevious();
   HBasicBlock* bb_cursor = invoke_instruction->GetBlock();
-  if (!TryInlineAndReplace(invoke_instruction,
-                           method,
-                           ReferenceTypeInfo::CreateInvalid(),
-                           /* do_rtp= */ true)) {
-    return false;
+  if (TryInlineAndReplace(invoke_instruction,
+                          method,
+                          ReferenceTypeInfo::CreateInvalid(),
+                          /* do_rtp= */ true)) {
+    AddCHAGuard(invoke_instruction, dex_pc, cursor, bb_cursor);
+    MaybeRecordStat(stats_, MethodCompilationStat::kCHAInline);
+  } else {
+    // We could not inline the single implementation, but we can still avoid the
+    // virtual or interface dispatch by calling it directly.
+    HInvoke* replacement = nullptr;
+    if (!TryDevirtualize(invoke_instruction, method, &replacement)) {
+      return false;
+    }
+    AddCHAGuard(replacement, dex_pc, cursor, bb_cursor);
+    MaybeRecordStat(stats_, MethodCompilationStat::kCHADevirtualized);
   }
-  AddCHAGuard(invoke_instruction, dex_pc, cursor, bb_cursor);
-  // Add dependency due to devirtualization: we are assuming the resolved method
+  // Add dependency due to devirtualization: we are assuming `cha_method`
   // has a single implementation.
-  outermost_graph_->AddCHASingleImplementationDependency(invoke_instruction->GetResolvedMethod());
-  MaybeRecordStat(stats_, MethodCompilationStat::kCHAInline);
+  outermost_graph_->AddCHASingleImplementationDependency(cha_method);
   return true;
 }
 
@@ -601,11 +875,14 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
     }
 
     case kInlineCacheMegamorphic: {
+      MaybeRecordStat(stats_, MethodCompilationStat::kMegamorphicCall);
+      if (TryInlineMegamorphicCall(invoke_instruction)) {
+        return true;
+      }
       LOG_FAIL_NO_STAT()
           << "Interface or virtual call to "
           << invoke_instruction->GetMethodReference().PrettyMethod()
           << " is megamorphic and not inlined";
-      MaybeRecordStat(stats_, MethodCompilationStat::kMegamorphicCall);
       return false;
     }
 
@@ -923,13 +1200,80 @@ static void MaybeReplaceAndRemove(HInstruction* new_instruction, HInstruction* o
   old_instruction->GetBlock()->RemoveInstruction(old_instruction);
 }
 
+bool HInliner::TryInlineMegamorphicCall(HInvoke* invoke_instruction) {
+  DCHECK(invoke_instruction->IsInvokeVirtual() || invoke_instruction->IsInvokeInterface())
+      << invoke_instruction->DebugName();
+  // The receiver distribution is only recorded by baseline compiled code.
+  if (Runtime::Current()->IsAotCompiler() || Runtime::Current()->IsZygote()) {
+    return false;
+  }
+  ProfilingInfo* profiling_info = graph_->GetProfilingInfo();
+  if (profiling_info == nullptr) {
+    return false;
+  }
+
+  Thread* self = Thread::Current();
+  const InlineCache& cache = *profiling_info->GetInlineCache(invoke_instruction->GetDexPc());
+  StackHandleScope<InlineCache::kIndividualCacheSize> classes(self);
+  std::array<uint32_t, InlineCache::kIndividualCacheSize> counts;
+  Runtime::Current()->GetJit()->GetCodeCache()->CopyInlineCacheInto(cache, &classes, &counts);
+  uint8_t number_of_types = InlineCache::kIndividualCacheSize - classes.RemainingSlots();
+
+  uint64_t total_count = cache.GetMegamorphicCount();
+  for (size_t i = 0; i != number_of_types; ++i) {
+    total_count += counts[i];
+  }
+  if (total_count < kMinimumNumberOfMegamorphicCallSamples) {
+    LOG_FAIL_NO_STAT()
+        << "Megamorphic call to " << invoke_instruction->GetMethodReference().PrettyMethod()
+        << " does not have enough samples (" << total_count << ")";
+    return false;
+  }
+
+  // Sort the receivers by decreasing number of calls, and keep the ones that
+  // account for a large enough share of the calls.
+  std::array<size_t, InlineCache::kIndividualCacheSize> order;
+  std::iota(order.begin(), order.begin() + number_of_types, 0u);
+  std::stable_sort(order.begin(),
+                   order.begin() + number_of_types,
+                   [&counts](size_t lhs, size_t rhs) { return counts[lhs] > counts[rhs]; });
+  StackHandleScope<InlineCache::kIndividualCacheSize> dominant_classes(self);
+  for (size_t i = 0; i != number_of_types; ++i) {
+    uint32_t count = counts[order[i]];
+    if (dominant_classes.RemainingSlots() ==
+            InlineCache::kIndividualCacheSize - kMaximumNumberOfMegamorphicInlinedTargets ||
+        count * UINT64_C(100) < total_count * kMinimumMegamorphicReceiverPercentage) {
+      break;
+    }
+    dominant_classes.NewHandle(classes.GetReference(order[i])->AsClass());
+  }
+  if (dominant_classes.RemainingSlots() == InlineCache::kIndividualCacheSize) {
+    LOG_FAIL_NO_STAT()
+        << "Megamorphic call to " << invoke_instruction->GetMethodReference().PrettyMethod()
+        << " has no dominant receiver";
+    return false;
+  }
+
+  // The call site is megamorphic: keep the original invoke as the fallback for
+  // the receivers we do not inline, rather than deoptimizing.
+  if (!TryInlinePolymorphicCall(invoke_instruction,
+                                dominant_classes,
+                                /* allow_deoptimization= */ false)) {
+    return false;
+  }
+  MaybeRecordStat(stats_, MethodCompilationStat::kInlinedMegamorphicCall);
+  return true;
+}
+
 bool HInliner::TryInlinePolymorphicCall(
     HInvoke* invoke_instruction,
-    const StackHandleScope<InlineCache::kIndividualCacheSize>& classes) {
+    const StackHandleScope<InlineCache::kIndividualCacheSize>& classes,
+    bool allow_deoptimization) {
   DCHECK(invoke_instruction->IsInvokeVirtual() || invoke_instruction->IsInvokeInterface())
       << invoke_instruction->DebugName();
 
-  if (TryInlinePolymorphicCallToSameTarget(invoke_instruction, classes)) {
+  if (allow_deoptimization &&
+      TryInlinePolymorphicCallToSameTarget(invoke_instruction, classes)) {
     return true;
   }
 
@@ -961,9 +1305,11 @@ bool HInliner::TryInlinePolymorphicCall(
     HInstruction* return_replacement = nullptr;
 
     // In monomorphic cases when UseOnlyPolymorphicInliningWithNoDeopt() is true, we call
-    // `TryInlinePolymorphicCall` even though we are monomorphic.
+    // `TryInlinePolymorphicCall` even though we are monomorphic. Megamorphic call sites
+    // with a single dominant receiver also end up here.
     const bool actually_monomorphic = number_of_types == 1;
-    DCHECK_IMPLIES(actually_monomorphic, UseOnlyPolymorphicInliningWithNoDeopt());
+    DCHECK_IMPLIES(actually_monomorphic,
+                   UseOnlyPolymorphicInliningWithNoDeopt() || !allow_deoptimization);
 
     // We only want to limit recursive polymorphic cases, not monomorphic ones.
     const bool too_many_polymorphic_recursive_calls =
@@ -993,7 +1339,8 @@ bool HInliner::TryInlinePolymorphicCall(
 
       // If we have inlined all targets before, and this receiver is the last seen,
       // we deoptimize instead of keeping the original invoke instruction.
-      bool deoptimize = !UseOnlyPolymorphicInliningWithNoDeopt() &&
+      bool deoptimize = allow_deoptimization &&
+          !UseOnlyPolymorphicInliningWithNoDeopt() &&
           all_targets_inlined &&
           (i + 1 == number_of_types);
 
@@ -1417,7 +1764,8 @@ bool HInliner::IsInliningSupported(const HInvoke* invoke_instruction,
 }
 
 // Returns whether our resource limits allow inlining this method.
-bool HInliner::IsInliningBudgetAvailable(ArtMethod* method,
+bool HInliner::IsInliningBudgetAvailable(HInvoke* invoke_instruction,
+                                         ArtMethod* method,
                                          const CodeItemDataAccessor& accessor) const {
   if (CountRecursiveCallsOf(method) > kMaximumNumberOfRecursiveCalls) {
     LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedRecursiveBudget)
@@ -1427,8 +1775,17 @@ bool HInliner::IsInliningBudgetAvailable(ArtMethod* method,
     return false;
   }
 
-  size_t inline_max_code_units = codegen_->GetCompilerOptions().GetInlineMaxCodeUnits();
+  size_t inline_max_code_units = GetMaximumInlinedCodeUnits(invoke_instruction);
   if (accessor.InsnsSizeInCodeUnits() > inline_max_code_units) {
+    if (inline_max_code_units < codegen_->GetCompilerOptions().GetInlineMaxCodeUnits()) {
+      LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedColdCallSite)
+          << "Method " << method->PrettyMethod()
+          << " is not inlined because its code item is too big for a cold call site: "
+          << accessor.InsnsSizeInCodeUnits()
+          << " > "
+          << inline_max_code_units;
+      return false;
+    }
     LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedCodeItem)
         << "Method " << method->PrettyMethod()
         << " is not inlined because its code item is too big: "
@@ -1503,7 +1860,7 @@ bool HInliner::TryBuildAndInline(HInvoke* invoke_instruction,
     return false;
   }
 
-  if (!IsInliningBudgetAvailable(method, accessor)) {
+  if (!IsInliningBudgetAvailable(invoke_instruction, method, accessor)) {
     return false;
   }
 
@@ -54,6 +54,9 @@ class HInliner : public HOptimization {
         parent_(parent),
         depth_(depth),
         inlining_budget_(0),
+        maximum_number_of_total_instructions_(0),
+        frequency_(1.0f),
+        call_site_frequency_(1.0f),
         inline_stats_(nullptr) {}
 
   bool Run() override;
@@ -71,8 +74,11 @@ class HInliner : public HOptimization {
   };
 
   // We set `did_set_always_throws` as true if we analyzed `invoke_instruction` and it always
-  // throws.
-  bool TryInline(HInvoke* invoke_instruction, /*inout*/ bool* did_set_always_throws);
+  // throws, and `did_refine_return_type` as true if we analyzed `invoke_instruction` and
+  // refined the type or nullability of its result.
+  bool TryInline(HInvoke* invoke_instruction,
+                 /*inout*/ bool* did_set_always_throws,
+                 /*inout*/ bool* did_refine_return_type);
 
   // Try to inline `resolved_method` in place of `invoke_instruction`. `do_rtp` is whether
   // reference type propagation can run after the inlining. If the inlining is successful, this
@@ -133,9 +139,21 @@ class HInliner : public HOptimization {
   //
   // For example, this checks whether the function has grown too large and
   // inlining should be prevented.
-  bool IsInliningBudgetAvailable(art::ArtMethod* method, const CodeItemDataAccessor& accessor) const
+  bool IsInliningBudgetAvailable(HInvoke* invoke_instruction,
+                                 art::ArtMethod* method,
+                                 const CodeItemDataAccessor& accessor) const
     REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Whether the compiler options select the cost/benefit inlining heuristics
+  // over the fixed budgets.
+  bool UseCostBenefitHeuristics() const;
+
+  // Returns the maximum number of code units of a method inlined at `invoke_instruction`.
+  // With the cost/benefit heuristics, this grows with the frequency of the call site and
+  // with the number of arguments that let the inlined body simplify, and shrinks for
+  // cold call sites.
+  size_t GetMaximumInlinedCodeUnits(HInvoke* invoke_instruction) const;
+
   // Inspects the body of a method (callee_graph) and returns whether it can be
   // inlined.
   //
@@ -172,6 +190,18 @@ class HInliner : public HOptimization {
                        HInvoke** replacement)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // When we fail inlining `invoke_instruction`, we will try to refine the type and
+  // nullability of its result from the values returned by `method`, its single target.
+  // The caller is responsible for propagating the refined type to the users.
+  bool TryRefineReturnType(HInvoke* invoke_instruction, ArtMethod* method)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Returns whether every value returned by `method` is an object, string or class
+  // created by the method itself, and therefore not null. Sets `exact_class` to the
+  // class of these values if they all have the same resolved class, or to null otherwise.
+  bool ReturnsNewReference(ArtMethod* method, /*out*/ ObjPtr<mirror::Class>* exact_class) const
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Try getting the inline cache from JIT code cache.
   // Return true if the inline cache was successfully allocated and the
   // invoke info was found in the profile info.
@@ -201,9 +231,17 @@ class HInliner : public HOptimization {
                                 const StackHandleScope<InlineCache::kIndividualCacheSize>& classes)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
-  // Try to inline targets of a polymorphic call.
+  // Try to inline targets of a polymorphic call. If `allow_deoptimization` is false,
+  // the original invoke is always kept for receivers that are not inlined.
   bool TryInlinePolymorphicCall(HInvoke* invoke_instruction,
-                                const StackHandleScope<InlineCache::kIndividualCacheSize>& classes)
+                                const StackHandleScope<InlineCache::kIndividualCacheSize>& classes,
+                                bool allow_deoptimization = true)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Try to inline the targets of the receivers that dominate the call counts
+  // recorded at a megamorphic call site. The original invoke stays as the
+  // fallback for all other receivers.
+  bool TryInlineMegamorphicCall(HInvoke* invoke_instruction)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   bool TryInlinePolymorphicCallToSameTarget(
@@ -320,6 +358,15 @@ class HInliner : public HOptimization {
   // The budget left for inlining, in number of instructions.
   size_t inlining_budget_;
 
+  // The limit on the number of instructions of the outermost graph, inlined code included.
+  size_t maximum_number_of_total_instructions_;
+
+  // Estimated number of executions of `graph_` per execution of the outermost method.
+  float frequency_;
+
+  // Estimated number of executions of the call site being inlined per execution of `graph_`.
+  float call_site_frequency_;
+
   // Used to record stats about optimizations on the inlined graph.
   // If the inlining is successful, these stats are merged to the caller graph's stats.
   OptimizingCompilerStats* inline_stats_;
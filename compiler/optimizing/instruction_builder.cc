@@ -33,6 +33,7 @@
 #include "intrinsics.h"
 #include "intrinsics_utils.h"
 #include "jit/jit.h"
+#include "jit/profiling_info.h"
 #include "mirror/dex_cache.h"
 #include "oat_file.h"
 #include "optimizing_compiler_stats.h"
@@ -646,13 +647,27 @@ void HInstructionBuilder::InitializeParameters() {
   }
 }
 
+void HInstructionBuilder::AppendIf(HInstruction* condition, uint32_t dex_pc) {
+  HIf* if_instr = new (allocator_) HIf(condition, dex_pc);
+  // Baseline compiled code collects the profile, so only use it for later compilations.
+  ProfilingInfo* info = graph_->GetProfilingInfo();
+  if (info != nullptr && !graph_->IsCompilingBaseline()) {
+    BranchCache* cache = info->GetBranchCache(dex_pc);
+    if (cache != nullptr) {
+      if_instr->SetTrueCount(cache->GetTrueCount());
+      if_instr->SetFalseCount(cache->GetFalseCount());
+    }
+  }
+  AppendInstruction(if_instr);
+}
+
 template<typename T>
 void HInstructionBuilder::If_22t(const Instruction& instruction, uint32_t dex_pc) {
   HInstruction* first = LoadLocal(instruction.VRegA(), DataType::Type::kInt32);
   HInstruction* second = LoadLocal(instruction.VRegB(), DataType::Type::kInt32);
   T* comparison = new (allocator_) T(first, second, dex_pc);
   AppendInstruction(comparison);
-  AppendInstruction(new (allocator_) HIf(comparison, dex_pc));
+  AppendIf(comparison, dex_pc);
   current_block_ = nullptr;
 }
 
@@ -661,7 +676,7 @@ void HInstructionBuilder::If_21t(const Instruction& instruction, uint32_t dex_pc
   HInstruction* value = LoadLocal(instruction.VRegA(), DataType::Type::kInt32);
   T* comparison = new (allocator_) T(value, graph_->GetIntConstant(0, dex_pc), dex_pc);
   AppendInstruction(comparison);
-  AppendInstruction(new (allocator_) HIf(comparison, dex_pc));
+  AppendIf(comparison, dex_pc);
   current_block_ = nullptr;
 }
 
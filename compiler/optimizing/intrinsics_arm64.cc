@@ -59,6 +59,7 @@ using helpers::IsConstantZeroBitPattern;
 using helpers::OperandFrom;
 using helpers::RegisterFrom;
 using helpers::SRegisterFrom;
+using helpers::VRegisterFrom;
 using helpers::WRegisterFrom;
 using helpers::XRegisterFrom;
 using helpers::HRegisterFrom;
@@ -2805,6 +2806,602 @@ void IntrinsicCodeGeneratorARM64::VisitSystemArrayCopyChar(HInvoke* invoke) {
   __ Bind(slow_path->GetExitLabel());
 }
 
+// Compares the first `length` bytes at `a_ptr` and `b_ptr`. Falls through if they are equal;
+// otherwise sets `index` to the offset of the first differing byte and branches to `found`.
+// The bulk is compared 16 bytes at a time with NEON and the remainder with 8-byte, 4-byte and
+// 1-byte loads, so we never read past the end of the data.
+static void GenerateArrayDataMismatch(MacroAssembler* masm,
+                                      Register a_ptr,
+                                      Register b_ptr,
+                                      Register length,
+                                      Register index,
+                                      Register temp1,
+                                      Register temp2,
+                                      VRegister vtemp1,
+                                      VRegister vtemp2,
+                                      vixl::aarch64::Label* found) {
+  vixl::aarch64::Label loop, tail8, tail4, tail1, byte_loop, found_in_nibbles, found_in_word, done;
+
+  __ Mov(index, 0);
+  __ Cmp(length, 16);
+  __ B(lt, &tail8);
+
+  __ Bind(&loop);
+  __ Ldr(vtemp1.Q(), MemOperand(a_ptr, index));
+  __ Ldr(vtemp2.Q(), MemOperand(b_ptr, index));
+  __ Cmeq(vtemp1.V16B(), vtemp1.V16B(), vtemp2.V16B());
+  __ Not(vtemp1.V16B(), vtemp1.V16B());
+  // Narrow the byte mask to one nibble per byte so that it fits in a general register.
+  __ Shrn(vtemp1.V8B(), vtemp1.V8H(), 4);
+  __ Fmov(temp1, vtemp1.D());
+  __ Cbnz(temp1, &found_in_nibbles);
+  __ Add(index, index, 16);
+  __ Add(temp1, index, 16);
+  __ Cmp(temp1, length);
+  __ B(le, &loop);
+
+  __ Bind(&tail8);
+  __ Add(temp1, index, 8);
+  __ Cmp(temp1, length);
+  __ B(gt, &tail4);
+  __ Ldr(temp1, MemOperand(a_ptr, index));
+  __ Ldr(temp2, MemOperand(b_ptr, index));
+  __ Eor(temp1, temp1, temp2);
+  __ Cbnz(temp1, &found_in_word);
+  __ Add(index, index, 8);
+
+  __ Bind(&tail4);
+  __ Add(temp1, index, 4);
+  __ Cmp(temp1, length);
+  __ B(gt, &tail1);
+  __ Ldr(temp1.W(), MemOperand(a_ptr, index));
+  __ Ldr(temp2.W(), MemOperand(b_ptr, index));
+  __ Eor(temp1.W(), temp1.W(), temp2.W());
+  __ Cbnz(temp1, &found_in_word);
+  __ Add(index, index, 4);
+
+  __ Bind(&tail1);
+  __ Cmp(index, length);
+  __ B(ge, &done);
+  __ Bind(&byte_loop);
+  __ Ldrb(temp1.W(), MemOperand(a_ptr, index));
+  __ Ldrb(temp2.W(), MemOperand(b_ptr, index));
+  __ Cmp(temp1.W(), temp2.W());
+  __ B(ne, found);
+  __ Add(index, index, 1);
+  __ Cmp(index, length);
+  __ B(lt, &byte_loop);
+  __ B(&done);
+
+  // The lowest set bit falls into the first differing byte (nibble for the vector mask).
+  __ Bind(&found_in_nibbles);
+  __ Rbit(temp1, temp1);
+  __ Clz(temp1, temp1);
+  __ Add(index, index, Operand(temp1, LSR, 2));
+  __ B(found);
+  __ Bind(&found_in_word);
+  __ Rbit(temp1, temp1);
+  __ Clz(temp1, temp1);
+  __ Add(index, index, Operand(temp1, LSR, 3));
+  __ B(found);
+
+  __ Bind(&done);
+}
+
+static void CreateArraysEqualsLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  for (size_t i = 0; i != 5u; ++i) {
+    locations->AddTemp(Location::RequiresRegister());
+  }
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  // The output is used as the mismatch index while the inputs are still live.
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+static void GenerateArraysEquals(HInvoke* invoke, MacroAssembler* masm, DataType::Type type) {
+  LocationSummary* locations = invoke->GetLocations();
+  Register a = WRegisterFrom(locations->InAt(0));
+  Register b = WRegisterFrom(locations->InAt(1));
+  Register length = XRegisterFrom(locations->GetTemp(0));
+  Register a_ptr = XRegisterFrom(locations->GetTemp(1));
+  Register b_ptr = XRegisterFrom(locations->GetTemp(2));
+  Register temp1 = XRegisterFrom(locations->GetTemp(3));
+  Register temp2 = XRegisterFrom(locations->GetTemp(4));
+  VRegister vtemp1 = VRegisterFrom(locations->GetTemp(5));
+  VRegister vtemp2 = VRegisterFrom(locations->GetTemp(6));
+  Register out = XRegisterFrom(locations->Out());
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const uint32_t data_offset = mirror::Array::DataOffset(DataType::Size(type)).Uint32Value();
+
+  vixl::aarch64::Label return_true, return_false, end;
+
+  // The same array (or both null) is always equal.
+  __ Cmp(a, b);
+  __ B(eq, &return_true);
+
+  // Otherwise a null argument is never equal.
+  if (invoke->InputAt(0)->CanBeNull()) {
+    __ Cbz(a, &return_false);
+  }
+  if (invoke->InputAt(1)->CanBeNull()) {
+    __ Cbz(b, &return_false);
+  }
+
+  __ Ldr(length.W(), HeapOperand(a, length_offset));
+  __ Ldr(temp1.W(), HeapOperand(b, length_offset));
+  __ Cmp(length.W(), temp1.W());
+  __ B(ne, &return_false);
+  if (type == DataType::Type::kInt32) {
+    __ Lsl(length, length, 2);
+  }
+  __ Add(a_ptr, a.X(), data_offset);
+  __ Add(b_ptr, b.X(), data_offset);
+
+  GenerateArrayDataMismatch(
+      masm, a_ptr, b_ptr, length, out, temp1, temp2, vtemp1, vtemp2, &return_false);
+
+  __ Bind(&return_true);
+  __ Mov(out.W(), 1);
+  __ B(&end);
+
+  __ Bind(&return_false);
+  __ Mov(out.W(), 0);
+  __ Bind(&end);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitArraysEqualsByte(HInvoke* invoke) {
+  CreateArraysEqualsLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitArraysEqualsByte(HInvoke* invoke) {
+  GenerateArraysEquals(invoke, GetVIXLAssembler(), DataType::Type::kInt8);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitArraysEqualsInt(HInvoke* invoke) {
+  CreateArraysEqualsLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitArraysEqualsInt(HInvoke* invoke) {
+  GenerateArraysEquals(invoke, GetVIXLAssembler(), DataType::Type::kInt32);
+}
+
+static void CreateArraysSupportMismatchLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RequiresRegister());
+  for (size_t i = 0; i != 5u; ++i) {
+    locations->AddTemp(Location::RequiresRegister());
+  }
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+static void GenerateArraysSupportMismatch(HInvoke* invoke,
+                                          CodeGeneratorARM64* codegen,
+                                          DataType::Type type) {
+  MacroAssembler* masm = codegen->GetVIXLAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  Register a = WRegisterFrom(locations->InAt(0));
+  Register b = WRegisterFrom(locations->InAt(1));
+  Register length = WRegisterFrom(locations->InAt(2));
+  Register byte_length = XRegisterFrom(locations->GetTemp(0));
+  Register a_ptr = XRegisterFrom(locations->GetTemp(1));
+  Register b_ptr = XRegisterFrom(locations->GetTemp(2));
+  Register temp1 = XRegisterFrom(locations->GetTemp(3));
+  Register temp2 = XRegisterFrom(locations->GetTemp(4));
+  VRegister vtemp1 = VRegisterFrom(locations->GetTemp(5));
+  VRegister vtemp2 = VRegisterFrom(locations->GetTemp(6));
+  Register out = XRegisterFrom(locations->Out());
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const uint32_t data_offset = mirror::Array::DataOffset(DataType::Size(type)).Uint32Value();
+
+  SlowPathCodeARM64* slow_path =
+      new (codegen->GetScopedAllocator()) IntrinsicSlowPathARM64(invoke);
+  codegen->AddSlowPath(slow_path);
+
+  vixl::aarch64::Label found;
+
+  // Nothing to compare, no mismatch.
+  __ Mov(out.W(), -1);
+  __ Cmp(length, 0);
+  __ B(le, slow_path->GetExitLabel());
+
+  // Leave null arrays and out of range lengths to the managed code to report.
+  if (invoke->InputAt(0)->CanBeNull()) {
+    __ Cbz(a, slow_path->GetEntryLabel());
+  }
+  if (invoke->InputAt(1)->CanBeNull()) {
+    __ Cbz(b, slow_path->GetEntryLabel());
+  }
+  __ Ldr(temp1.W(), HeapOperand(a, length_offset));
+  __ Cmp(temp1.W(), length);
+  __ B(lt, slow_path->GetEntryLabel());
+  __ Ldr(temp1.W(), HeapOperand(b, length_offset));
+  __ Cmp(temp1.W(), length);
+  __ B(lt, slow_path->GetEntryLabel());
+
+  __ Mov(byte_length.W(), length);
+  if (type == DataType::Type::kInt32) {
+    __ Lsl(byte_length, byte_length, 2);
+  }
+  __ Add(a_ptr, a.X(), data_offset);
+  __ Add(b_ptr, b.X(), data_offset);
+
+  GenerateArrayDataMismatch(
+      masm, a_ptr, b_ptr, byte_length, out, temp1, temp2, vtemp1, vtemp2, &found);
+  __ Mov(out.W(), -1);
+  __ B(slow_path->GetExitLabel());
+
+  // Convert the byte offset of the mismatch to an element index.
+  __ Bind(&found);
+  if (type == DataType::Type::kInt32) {
+    __ Lsr(out.W(), out.W(), 2);
+  }
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderARM64::VisitArraysSupportMismatchByte(HInvoke* invoke) {
+  CreateArraysSupportMismatchLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitArraysSupportMismatchByte(HInvoke* invoke) {
+  GenerateArraysSupportMismatch(invoke, codegen_, DataType::Type::kInt8);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitArraysSupportMismatchInt(HInvoke* invoke) {
+  CreateArraysSupportMismatchLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitArraysSupportMismatchInt(HInvoke* invoke) {
+  GenerateArraysSupportMismatch(invoke, codegen_, DataType::Type::kInt32);
+}
+
+static void CreateArraysFillLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+}
+
+static void GenerateArraysFill(HInvoke* invoke,
+                               CodeGeneratorARM64* codegen,
+                               DataType::Type type) {
+  MacroAssembler* masm = codegen->GetVIXLAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  Register array = WRegisterFrom(locations->InAt(0));
+  Register value = WRegisterFrom(locations->InAt(1));
+  Register remaining = XRegisterFrom(locations->GetTemp(0));
+  Register ptr = XRegisterFrom(locations->GetTemp(1));
+  VRegister vpattern = VRegisterFrom(locations->GetTemp(2));
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const uint32_t data_offset = mirror::Array::DataOffset(DataType::Size(type)).Uint32Value();
+
+  SlowPathCodeARM64* slow_path =
+      new (codegen->GetScopedAllocator()) IntrinsicSlowPathARM64(invoke);
+  codegen->AddSlowPath(slow_path);
+
+  vixl::aarch64::Label loop, tail8, tail4, tail2;
+
+  if (invoke->InputAt(0)->CanBeNull()) {
+    __ Cbz(array, slow_path->GetEntryLabel());
+  }
+
+  __ Ldr(remaining.W(), HeapOperand(array, length_offset));
+  if (type == DataType::Type::kInt32) {
+    __ Lsl(remaining, remaining, 2);
+    __ Dup(vpattern.V4S(), value);
+  } else {
+    DCHECK_EQ(type, DataType::Type::kInt8);
+    __ Dup(vpattern.V16B(), value);
+  }
+  __ Add(ptr, array.X(), data_offset);
+
+  // Store 16 bytes at a time. `remaining` is kept biased by -16 so that its low four bits
+  // still select the tail stores below.
+  __ Subs(remaining, remaining, 16);
+  __ B(lt, &tail8);
+  __ Bind(&loop);
+  __ Str(vpattern.Q(), MemOperand(ptr, 16, PostIndex));
+  __ Subs(remaining, remaining, 16);
+  __ B(ge, &loop);
+
+  __ Bind(&tail8);
+  __ Tbz(remaining, 3, &tail4);
+  __ Str(vpattern.D(), MemOperand(ptr, 8, PostIndex));
+  __ Bind(&tail4);
+  __ Tbz(remaining, 2, &tail2);
+  __ Str(vpattern.S(), MemOperand(ptr, 4, PostIndex));
+  __ Bind(&tail2);
+  if (type == DataType::Type::kInt8) {
+    vixl::aarch64::Label tail1;
+    __ Tbz(remaining, 1, &tail1);
+    __ Str(vpattern.H(), MemOperand(ptr, 2, PostIndex));
+    __ Bind(&tail1);
+    __ Tbz(remaining, 0, slow_path->GetExitLabel());
+    __ Str(vpattern.B(), MemOperand(ptr));
+  }
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderARM64::VisitArraysFillByte(HInvoke* invoke) {
+  CreateArraysFillLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitArraysFillByte(HInvoke* invoke) {
+  GenerateArraysFill(invoke, codegen_, DataType::Type::kInt8);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitArraysFillInt(HInvoke* invoke) {
+  CreateArraysFillLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitArraysFillInt(HInvoke* invoke) {
+  GenerateArraysFill(invoke, codegen_, DataType::Type::kInt32);
+}
+
+static void CreateHashCodeLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  for (size_t i = 0; i != 4u; ++i) {
+    locations->AddTemp(Location::RequiresRegister());
+  }
+  for (size_t i = 0; i != 5u; ++i) {
+    locations->AddTemp(Location::RequiresFpuRegister());
+  }
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+// Computes `h = 31 * h + data[i]` for the `remaining` elements of type `type` at `ptr`, updating
+// `out` which holds the initial `h`. Eight elements are processed per iteration in two vector
+// accumulators, each lane multiplied by 31^8 per iteration; the lanes are folded back into `h`
+// with the remaining powers of 31 at the end. Clobbers `ptr` and `remaining`.
+static void GenerateHashCodeLoop(MacroAssembler* masm,
+                                 DataType::Type type,
+                                 Register ptr,
+                                 Register remaining,
+                                 Register temp1,
+                                 Register temp2,
+                                 VRegister vacc0,
+                                 VRegister vacc1,
+                                 VRegister vmul,
+                                 VRegister vdata0,
+                                 VRegister vdata1,
+                                 Register out) {
+  // 31^8, 31^4, 31^3 and 31^2, modulo 2^32.
+  constexpr int32_t kPow31_8 = -1807454463;
+  constexpr int32_t kPow31_4 = 923521;
+  constexpr int32_t kPow31_3 = 29791;
+  constexpr int32_t kPow31_2 = 961;
+
+  vixl::aarch64::Label loop, tail, tail_loop, done;
+
+  __ Cmp(remaining, 8);
+  __ B(lt, &tail);
+
+  __ Movi(vacc0.V16B(), 0);
+  __ Movi(vacc1.V16B(), 0);
+  __ Mov(temp1, kPow31_8);
+  __ Dup(vmul.V4S(), temp1);
+
+  __ Bind(&loop);
+  switch (type) {
+    case DataType::Type::kInt32:
+      __ Ldp(vdata0.Q(), vdata1.Q(), MemOperand(ptr, 32, PostIndex));
+      break;
+    case DataType::Type::kInt8:
+      __ Ldr(vdata0.D(), MemOperand(ptr, 8, PostIndex));
+      __ Sxtl(vdata0.V8H(), vdata0.V8B());
+      __ Sxtl2(vdata1.V4S(), vdata0.V8H());
+      __ Sxtl(vdata0.V4S(), vdata0.V4H());
+      break;
+    case DataType::Type::kUint8:
+      __ Ldr(vdata0.D(), MemOperand(ptr, 8, PostIndex));
+      __ Uxtl(vdata0.V8H(), vdata0.V8B());
+      __ Uxtl2(vdata1.V4S(), vdata0.V8H());
+      __ Uxtl(vdata0.V4S(), vdata0.V4H());
+      break;
+    case DataType::Type::kUint16:
+      __ Ldr(vdata0.Q(), MemOperand(ptr, 16, PostIndex));
+      __ Uxtl2(vdata1.V4S(), vdata0.V8H());
+      __ Uxtl(vdata0.V4S(), vdata0.V4H());
+      break;
+    default:
+      LOG(FATAL) << "Unexpected data type for hash code " << type;
+      UNREACHABLE();
+  }
+  __ Mul(vacc0.V4S(), vacc0.V4S(), vmul.V4S());
+  __ Mul(vacc1.V4S(), vacc1.V4S(), vmul.V4S());
+  __ Add(vacc0.V4S(), vacc0.V4S(), vdata0.V4S());
+  __ Add(vacc1.V4S(), vacc1.V4S(), vdata1.V4S());
+  __ Mul(out, out, temp1);
+  __ Sub(remaining, remaining, 8);
+  __ Cmp(remaining, 8);
+  __ B(ge, &loop);
+
+  // Fold the accumulators: h += sum(lane[i] * 31^(3 - i)) for vacc0 * 31^4 + vacc1.
+  __ Mov(temp1, kPow31_4);
+  __ Dup(vmul.V4S(), temp1);
+  __ Mul(vacc0.V4S(), vacc0.V4S(), vmul.V4S());
+  __ Add(vacc0.V4S(), vacc0.V4S(), vacc1.V4S());
+  __ Umov(temp1, vacc0.V4S(), 0);
+  __ Mov(temp2, kPow31_3);
+  __ Madd(out, temp1, temp2, out);
+  __ Umov(temp1, vacc0.V4S(), 1);
+  __ Mov(temp2, kPow31_2);
+  __ Madd(out, temp1, temp2, out);
+  __ Umov(temp1, vacc0.V4S(), 2);
+  __ Lsl(temp2, temp1, 5);
+  __ Sub(temp2, temp2, temp1);
+  __ Add(out, out, temp2);
+  __ Umov(temp1, vacc0.V4S(), 3);
+  __ Add(out, out, temp1);
+
+  __ Bind(&tail);
+  __ Cbz(remaining, &done);
+  __ Bind(&tail_loop);
+  switch (type) {
+    case DataType::Type::kInt32:
+      __ Ldr(temp1, MemOperand(ptr, 4, PostIndex));
+      break;
+    case DataType::Type::kInt8:
+      __ Ldrsb(temp1, MemOperand(ptr, 1, PostIndex));
+      break;
+    case DataType::Type::kUint8:
+      __ Ldrb(temp1, MemOperand(ptr, 1, PostIndex));
+      break;
+    default:
+      DCHECK_EQ(type, DataType::Type::kUint16);
+      __ Ldrh(temp1, MemOperand(ptr, 2, PostIndex));
+      break;
+  }
+  // h = 31 * h + data[i].
+  __ Lsl(temp2, out, 5);
+  __ Sub(out, temp2, out);
+  __ Add(out, out, temp1);
+  __ Subs(remaining, remaining, 1);
+  __ B(ne, &tail_loop);
+
+  __ Bind(&done);
+}
+
+static void GenerateArraysHashCode(HInvoke* invoke, MacroAssembler* masm, DataType::Type type) {
+  LocationSummary* locations = invoke->GetLocations();
+  Register array = WRegisterFrom(locations->InAt(0));
+  Register remaining = WRegisterFrom(locations->GetTemp(0));
+  Register ptr = XRegisterFrom(locations->GetTemp(1));
+  Register temp1 = WRegisterFrom(locations->GetTemp(2));
+  Register temp2 = WRegisterFrom(locations->GetTemp(3));
+  VRegister vacc0 = VRegisterFrom(locations->GetTemp(4));
+  VRegister vacc1 = VRegisterFrom(locations->GetTemp(5));
+  VRegister vmul = VRegisterFrom(locations->GetTemp(6));
+  VRegister vdata0 = VRegisterFrom(locations->GetTemp(7));
+  VRegister vdata1 = VRegisterFrom(locations->GetTemp(8));
+  Register out = WRegisterFrom(locations->Out());
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const uint32_t data_offset = mirror::Array::DataOffset(DataType::Size(type)).Uint32Value();
+
+  vixl::aarch64::Label done;
+
+  // The hash code of a null array is 0.
+  if (invoke->InputAt(0)->CanBeNull()) {
+    __ Mov(out, 0);
+    __ Cbz(array, &done);
+  }
+
+  __ Mov(out, 1);
+  __ Ldr(remaining, HeapOperand(array, length_offset));
+  __ Add(ptr, array.X(), data_offset);
+  GenerateHashCodeLoop(
+      masm, type, ptr, remaining, temp1, temp2, vacc0, vacc1, vmul, vdata0, vdata1, out);
+  __ Bind(&done);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitArraysHashCodeByte(HInvoke* invoke) {
+  CreateHashCodeLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitArraysHashCodeByte(HInvoke* invoke) {
+  GenerateArraysHashCode(invoke, GetVIXLAssembler(), DataType::Type::kInt8);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitArraysHashCodeInt(HInvoke* invoke) {
+  CreateHashCodeLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitArraysHashCodeInt(HInvoke* invoke) {
+  GenerateArraysHashCode(invoke, GetVIXLAssembler(), DataType::Type::kInt32);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitStringHashCode(HInvoke* invoke) {
+  CreateHashCodeLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitStringHashCode(HInvoke* invoke) {
+  MacroAssembler* masm = GetVIXLAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  Register str = WRegisterFrom(locations->InAt(0));
+  Register remaining = WRegisterFrom(locations->GetTemp(0));
+  Register ptr = XRegisterFrom(locations->GetTemp(1));
+  Register temp1 = WRegisterFrom(locations->GetTemp(2));
+  Register temp2 = WRegisterFrom(locations->GetTemp(3));
+  VRegister vacc0 = VRegisterFrom(locations->GetTemp(4));
+  VRegister vacc1 = VRegisterFrom(locations->GetTemp(5));
+  VRegister vmul = VRegisterFrom(locations->GetTemp(6));
+  VRegister vdata0 = VRegisterFrom(locations->GetTemp(7));
+  VRegister vdata1 = VRegisterFrom(locations->GetTemp(8));
+  Register out = WRegisterFrom(locations->Out());
+
+  const uint32_t count_offset = mirror::String::CountOffset().Uint32Value();
+  const uint32_t value_offset = mirror::String::ValueOffset().Uint32Value();
+  const uint32_t hash_code_offset = mirror::String::HashCodeOffset().Uint32Value();
+
+  // Note that the null check must have been done earlier.
+  DCHECK(!invoke->CanDoImplicitNullCheckOn(invoke->InputAt(0)));
+
+  vixl::aarch64::Label store, done;
+
+  // Return the cached hash code if it has already been computed.
+  __ Ldr(out, HeapOperand(str, hash_code_offset));
+  __ Cbnz(out, &done);
+
+  // Hash the characters starting from `out == 0`.
+  __ Ldr(remaining, HeapOperand(str, count_offset));
+  __ Add(ptr, str.X(), value_offset);
+  if (mirror::kUseStringCompression) {
+    static_assert(static_cast<uint32_t>(mirror::StringCompressionFlag::kCompressed) == 0u,
+                  "Expecting 0=compressed, 1=uncompressed");
+    vixl::aarch64::Label string_uncompressed;
+    __ Tbnz(remaining, 0, &string_uncompressed);
+    __ Lsr(remaining, remaining, 1);
+    GenerateHashCodeLoop(masm,
+                         DataType::Type::kUint8,
+                         ptr,
+                         remaining,
+                         temp1,
+                         temp2,
+                         vacc0,
+                         vacc1,
+                         vmul,
+                         vdata0,
+                         vdata1,
+                         out);
+    __ B(&store);
+    __ Bind(&string_uncompressed);
+    __ Lsr(remaining, remaining, 1);
+  }
+  GenerateHashCodeLoop(masm,
+                       DataType::Type::kUint16,
+                       ptr,
+                       remaining,
+                       temp1,
+                       temp2,
+                       vacc0,
+                       vacc1,
+                       vmul,
+                       vdata0,
+                       vdata1,
+                       out);
+
+  // Cache the hash code as String.hashCode() and the interpreter do. Racing threads store the
+  // same value and 0 means "not computed yet", so like the interpreter we treat this store as an
+  // idempotent cache and the intrinsic is declared as only reading memory.
+  __ Bind(&store);
+  __ Str(out, HeapOperand(str, hash_code_offset));
+  __ Bind(&done);
+}
+
 // We can choose to use the native implementation there for longer copy lengths.
 static constexpr int32_t kSystemArrayCopyThreshold = 128;
 
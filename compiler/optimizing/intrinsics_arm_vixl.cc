@@ -5570,6 +5570,7 @@ UNIMPLEMENTED_INTRINSIC(ARMVIXL, FP16Min)
 UNIMPLEMENTED_INTRINSIC(ARMVIXL, FP16Max)
 UNIMPLEMENTED_INTRINSIC(ARMVIXL, MathMultiplyHigh)
 
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, StringHashCode);
 UNIMPLEMENTED_INTRINSIC(ARMVIXL, StringStringIndexOf);
 UNIMPLEMENTED_INTRINSIC(ARMVIXL, StringStringIndexOfAfter);
 UNIMPLEMENTED_INTRINSIC(ARMVIXL, StringBufferAppend);
@@ -5604,6 +5605,15 @@ UNIMPLEMENTED_INTRINSIC(ARMVIXL, UnsafeGetAndSetObject)
 UNIMPLEMENTED_INTRINSIC(ARMVIXL, MethodHandleInvokeExact)
 UNIMPLEMENTED_INTRINSIC(ARMVIXL, MethodHandleInvoke)
 
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, ArraysEqualsByte)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, ArraysEqualsInt)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, ArraysFillByte)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, ArraysFillInt)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, ArraysHashCodeByte)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, ArraysHashCodeInt)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, ArraysSupportMismatchByte)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, ArraysSupportMismatchInt)
+
 // OpenJDK 11
 UNIMPLEMENTED_INTRINSIC(ARMVIXL, JdkUnsafeCASLong)      // High register pressure.
 UNIMPLEMENTED_INTRINSIC(ARMVIXL, JdkUnsafeGetAndAddInt)
@@ -4852,6 +4852,16 @@ UNIMPLEMENTED_INTRINSIC(X86, FP16Min)
 UNIMPLEMENTED_INTRINSIC(X86, FP16Max)
 UNIMPLEMENTED_INTRINSIC(X86, MathMultiplyHigh)
 
+UNIMPLEMENTED_INTRINSIC(X86, ArraysEqualsByte)
+UNIMPLEMENTED_INTRINSIC(X86, ArraysEqualsInt)
+UNIMPLEMENTED_INTRINSIC(X86, ArraysFillByte)
+UNIMPLEMENTED_INTRINSIC(X86, ArraysFillInt)
+UNIMPLEMENTED_INTRINSIC(X86, ArraysHashCodeByte)
+UNIMPLEMENTED_INTRINSIC(X86, ArraysHashCodeInt)
+UNIMPLEMENTED_INTRINSIC(X86, ArraysSupportMismatchByte)
+UNIMPLEMENTED_INTRINSIC(X86, ArraysSupportMismatchInt)
+
+UNIMPLEMENTED_INTRINSIC(X86, StringHashCode);
 UNIMPLEMENTED_INTRINSIC(X86, StringStringIndexOf);
 UNIMPLEMENTED_INTRINSIC(X86, StringStringIndexOfAfter);
 UNIMPLEMENTED_INTRINSIC(X86, StringBufferAppend);
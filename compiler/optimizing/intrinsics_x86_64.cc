@@ -833,6 +833,561 @@ void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopyInt(HInvoke* invoke) {
   CreateSystemArrayCopyLocations(invoke);
 }
 
+// Compares the first `length` bytes at offset `data_offset` of objects `a` and `b`.
+// Falls through if they are equal; otherwise sets `index` to the offset of the first differing
+// byte and jumps to `found`. The bulk is compared 16 bytes at a time with SSE2 and the remainder
+// with 8-byte, 4-byte and 1-byte accesses, so we never read past the end of the data.
+static void GenerateDataMismatch(X86_64Assembler* assembler,
+                                 uint32_t data_offset,
+                                 CpuRegister a,
+                                 CpuRegister b,
+                                 CpuRegister length,
+                                 CpuRegister index,
+                                 CpuRegister temp1,
+                                 CpuRegister temp2,
+                                 XmmRegister vtemp1,
+                                 XmmRegister vtemp2,
+                                 Label* found) {
+  // The exits jump over all the tails, which can be out of the range of a near jump.
+  NearLabel loop, tail8, tail4, tail1, byte_loop;
+  Label found_in_mask, found_in_word, done;
+
+  __ xorl(index, index);
+  __ cmpq(length, Immediate(16));
+  __ j(kLess, &tail8);
+
+  __ Bind(&loop);
+  __ movdqu(vtemp1, Address(a, index, TIMES_1, data_offset));
+  __ movdqu(vtemp2, Address(b, index, TIMES_1, data_offset));
+  __ pcmpeqb(vtemp1, vtemp2);
+  __ pmovmskb(temp1, vtemp1);
+  __ xorl(temp1, Immediate(0xffff));
+  __ j(kNotZero, &found_in_mask);
+  __ addq(index, Immediate(16));
+  __ leaq(temp1, Address(index, 16));
+  __ cmpq(temp1, length);
+  __ j(kLessEqual, &loop);
+
+  __ Bind(&tail8);
+  __ leaq(temp1, Address(index, 8));
+  __ cmpq(temp1, length);
+  __ j(kGreater, &tail4);
+  __ movq(temp1, Address(a, index, TIMES_1, data_offset));
+  __ xorq(temp1, Address(b, index, TIMES_1, data_offset));
+  __ j(kNotZero, &found_in_word);
+  __ addq(index, Immediate(8));
+
+  __ Bind(&tail4);
+  __ leaq(temp1, Address(index, 4));
+  __ cmpq(temp1, length);
+  __ j(kGreater, &tail1);
+  __ movl(temp1, Address(a, index, TIMES_1, data_offset));
+  __ xorl(temp1, Address(b, index, TIMES_1, data_offset));
+  __ j(kNotZero, &found_in_word);
+  __ addq(index, Immediate(4));
+
+  __ Bind(&tail1);
+  __ cmpq(index, length);
+  __ j(kGreaterEqual, &done);
+  __ Bind(&byte_loop);
+  __ movzxb(temp1, Address(a, index, TIMES_1, data_offset));
+  __ movzxb(temp2, Address(b, index, TIMES_1, data_offset));
+  __ cmpl(temp1, temp2);
+  __ j(kNotEqual, found);
+  __ addq(index, Immediate(1));
+  __ cmpq(index, length);
+  __ j(kLess, &byte_loop);
+  __ jmp(&done);
+
+  // The lowest set bit of the mask (or of the XOR-ed word) falls into the first differing byte.
+  __ Bind(&found_in_mask);
+  __ bsfl(temp1, temp1);
+  __ addq(index, temp1);
+  __ jmp(found);
+  __ Bind(&found_in_word);
+  __ bsfq(temp1, temp1);
+  __ shrq(temp1, Immediate(3));
+  __ addq(index, temp1);
+  __ jmp(found);
+
+  __ Bind(&done);
+}
+
+static void CreateArraysEqualsLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  // The output is used as the mismatch index while the inputs are still live.
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+static void GenerateArraysEquals(HInvoke* invoke,
+                                 X86_64Assembler* assembler,
+                                 DataType::Type type) {
+  LocationSummary* locations = invoke->GetLocations();
+  CpuRegister a = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister b = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister length = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister temp1 = locations->GetTemp(1).AsRegister<CpuRegister>();
+  CpuRegister temp2 = locations->GetTemp(2).AsRegister<CpuRegister>();
+  XmmRegister vtemp1 = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
+  XmmRegister vtemp2 = locations->GetTemp(4).AsFpuRegister<XmmRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const uint32_t data_offset = mirror::Array::DataOffset(DataType::Size(type)).Uint32Value();
+
+  Label return_true, return_false;
+  NearLabel end;
+
+  // The same array (or both null) is always equal.
+  __ cmpl(a, b);
+  __ j(kEqual, &return_true);
+
+  // Otherwise a null argument is never equal.
+  if (invoke->InputAt(0)->CanBeNull()) {
+    __ testl(a, a);
+    __ j(kEqual, &return_false);
+  }
+  if (invoke->InputAt(1)->CanBeNull()) {
+    __ testl(b, b);
+    __ j(kEqual, &return_false);
+  }
+
+  __ movl(length, Address(a, length_offset));
+  __ cmpl(length, Address(b, length_offset));
+  __ j(kNotEqual, &return_false);
+  if (type == DataType::Type::kInt32) {
+    __ shlq(length, Immediate(2));
+  }
+
+  GenerateDataMismatch(
+      assembler, data_offset, a, b, length, out, temp1, temp2, vtemp1, vtemp2, &return_false);
+
+  __ Bind(&return_true);
+  __ movl(out, Immediate(1));
+  __ jmp(&end);
+
+  __ Bind(&return_false);
+  __ xorl(out, out);
+  __ Bind(&end);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysEqualsByte(HInvoke* invoke) {
+  CreateArraysEqualsLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysEqualsByte(HInvoke* invoke) {
+  GenerateArraysEquals(invoke, GetAssembler(), DataType::Type::kInt8);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysEqualsInt(HInvoke* invoke) {
+  CreateArraysEqualsLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysEqualsInt(HInvoke* invoke) {
+  GenerateArraysEquals(invoke, GetAssembler(), DataType::Type::kInt32);
+}
+
+static void CreateArraysSupportMismatchLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+static void GenerateArraysSupportMismatch(HInvoke* invoke,
+                                          X86_64Assembler* assembler,
+                                          CodeGeneratorX86_64* codegen,
+                                          DataType::Type type) {
+  LocationSummary* locations = invoke->GetLocations();
+  CpuRegister a = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister b = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister length = locations->InAt(2).AsRegister<CpuRegister>();
+  CpuRegister byte_length = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister temp1 = locations->GetTemp(1).AsRegister<CpuRegister>();
+  CpuRegister temp2 = locations->GetTemp(2).AsRegister<CpuRegister>();
+  XmmRegister vtemp1 = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
+  XmmRegister vtemp2 = locations->GetTemp(4).AsFpuRegister<XmmRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const uint32_t data_offset = mirror::Array::DataOffset(DataType::Size(type)).Uint32Value();
+
+  SlowPathCode* slow_path = new (codegen->GetScopedAllocator()) IntrinsicSlowPathX86_64(invoke);
+  codegen->AddSlowPath(slow_path);
+
+  Label found;
+
+  // Nothing to compare, no mismatch.
+  __ movl(out, Immediate(-1));
+  __ testl(length, length);
+  __ j(kLessEqual, slow_path->GetExitLabel());
+
+  // Leave null arrays and out of range lengths to the managed code to report.
+  if (invoke->InputAt(0)->CanBeNull()) {
+    __ testl(a, a);
+    __ j(kEqual, slow_path->GetEntryLabel());
+  }
+  if (invoke->InputAt(1)->CanBeNull()) {
+    __ testl(b, b);
+    __ j(kEqual, slow_path->GetEntryLabel());
+  }
+  __ cmpl(Address(a, length_offset), length);
+  __ j(kLess, slow_path->GetEntryLabel());
+  __ cmpl(Address(b, length_offset), length);
+  __ j(kLess, slow_path->GetEntryLabel());
+
+  __ movl(byte_length, length);
+  if (type == DataType::Type::kInt32) {
+    __ shlq(byte_length, Immediate(2));
+  }
+
+  GenerateDataMismatch(
+      assembler, data_offset, a, b, byte_length, out, temp1, temp2, vtemp1, vtemp2, &found);
+  __ movl(out, Immediate(-1));
+  __ jmp(slow_path->GetExitLabel());
+
+  // Convert the byte offset of the mismatch to an element index.
+  __ Bind(&found);
+  if (type == DataType::Type::kInt32) {
+    __ shrl(out, Immediate(2));
+  }
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysSupportMismatchByte(HInvoke* invoke) {
+  CreateArraysSupportMismatchLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysSupportMismatchByte(HInvoke* invoke) {
+  GenerateArraysSupportMismatch(invoke, GetAssembler(), codegen_, DataType::Type::kInt8);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysSupportMismatchInt(HInvoke* invoke) {
+  CreateArraysSupportMismatchLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysSupportMismatchInt(HInvoke* invoke) {
+  GenerateArraysSupportMismatch(invoke, GetAssembler(), codegen_, DataType::Type::kInt32);
+}
+
+static void CreateArraysFillLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+}
+
+static void GenerateArraysFill(HInvoke* invoke,
+                               X86_64Assembler* assembler,
+                               CodeGeneratorX86_64* codegen,
+                               DataType::Type type) {
+  LocationSummary* locations = invoke->GetLocations();
+  CpuRegister array = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister value = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister remaining = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister index = locations->GetTemp(1).AsRegister<CpuRegister>();
+  CpuRegister pattern = locations->GetTemp(2).AsRegister<CpuRegister>();
+  XmmRegister vpattern = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const uint32_t data_offset = mirror::Array::DataOffset(DataType::Size(type)).Uint32Value();
+
+  SlowPathCode* slow_path = new (codegen->GetScopedAllocator()) IntrinsicSlowPathX86_64(invoke);
+  codegen->AddSlowPath(slow_path);
+
+  NearLabel loop, tail8, tail4, tail2;
+
+  if (invoke->InputAt(0)->CanBeNull()) {
+    __ testl(array, array);
+    __ j(kEqual, slow_path->GetEntryLabel());
+  }
+
+  __ movl(remaining, Address(array, length_offset));
+  if (type == DataType::Type::kInt32) {
+    __ shlq(remaining, Immediate(2));
+    __ movl(pattern, value);
+  } else {
+    DCHECK_EQ(type, DataType::Type::kInt8);
+    __ movzxb(pattern, value);
+    __ imull(pattern, pattern, Immediate(0x01010101));
+  }
+  __ movd(vpattern, pattern, /* is64bit= */ false);
+  __ pshufd(vpattern, vpattern, Immediate(0));
+  __ xorl(index, index);
+
+  // Store 16 bytes at a time. `remaining` is kept biased by -16 so that its low four bits
+  // still select the tail stores below.
+  __ subq(remaining, Immediate(16));
+  __ j(kLess, &tail8);
+  __ Bind(&loop);
+  __ movdqu(Address(array, index, TIMES_1, data_offset), vpattern);
+  __ addq(index, Immediate(16));
+  __ subq(remaining, Immediate(16));
+  __ j(kGreaterEqual, &loop);
+
+  __ Bind(&tail8);
+  __ testl(remaining, Immediate(8));
+  __ j(kZero, &tail4);
+  __ movsd(Address(array, index, TIMES_1, data_offset), vpattern);
+  __ addq(index, Immediate(8));
+  __ Bind(&tail4);
+  __ testl(remaining, Immediate(4));
+  __ j(kZero, &tail2);
+  __ movl(Address(array, index, TIMES_1, data_offset), pattern);
+  __ addq(index, Immediate(4));
+  __ Bind(&tail2);
+  if (type == DataType::Type::kInt8) {
+    NearLabel tail1;
+    __ testl(remaining, Immediate(2));
+    __ j(kZero, &tail1);
+    __ movw(Address(array, index, TIMES_1, data_offset), pattern);
+    __ addq(index, Immediate(2));
+    __ Bind(&tail1);
+    __ testl(remaining, Immediate(1));
+    __ j(kZero, slow_path->GetExitLabel());
+    __ movb(Address(array, index, TIMES_1, data_offset), pattern);
+  }
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysFillByte(HInvoke* invoke) {
+  CreateArraysFillLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysFillByte(HInvoke* invoke) {
+  GenerateArraysFill(invoke, GetAssembler(), codegen_, DataType::Type::kInt8);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysFillInt(HInvoke* invoke) {
+  CreateArraysFillLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysFillInt(HInvoke* invoke) {
+  GenerateArraysFill(invoke, GetAssembler(), codegen_, DataType::Type::kInt32);
+}
+
+static void CreateHashCodeLocations(ArenaAllocator* allocator,
+                                          HInvoke* invoke,
+                                          CodeGeneratorX86_64* codegen) {
+  // We need PMULLD.
+  if (!codegen->GetInstructionSetFeatures().HasSSE4_1()) {
+    return;
+  }
+
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  for (size_t i = 0; i != 5u; ++i) {
+    locations->AddTemp(Location::RequiresFpuRegister());
+  }
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+// Computes `h = 31 * h + data[i]` for the `length` elements of type `type` at `base + data_offset`,
+// updating `out` which holds the initial `h`. Eight elements are processed per iteration in two
+// vector accumulators, each lane multiplied by 31^8 per iteration; the lanes are folded back into
+// `h` with the remaining powers of 31 at the end. Clobbers `length`.
+static void GenerateHashCodeLoop(X86_64Assembler* assembler,
+                                 DataType::Type type,
+                                 CpuRegister base,
+                                 uint32_t data_offset,
+                                 CpuRegister length,
+                                 CpuRegister index,
+                                 CpuRegister temp,
+                                 XmmRegister vacc0,
+                                 XmmRegister vacc1,
+                                 XmmRegister vmul,
+                                 XmmRegister vdata0,
+                                 XmmRegister vdata1,
+                                 CpuRegister out) {
+  const ScaleFactor scale_factor = CodeGenerator::ScaleFactorForType(type);
+
+  // 31^8, 31^4, 31^3 and 31^2, modulo 2^32.
+  constexpr int32_t kPow31_8 = -1807454463;
+  constexpr int32_t kPow31_4 = 923521;
+  constexpr int32_t kPow31_3 = 29791;
+  constexpr int32_t kPow31_2 = 961;
+
+  // The jumps over the unrolled loop and the fold are too far for near labels.
+  NearLabel tail_loop;
+  Label loop, tail, done;
+
+  __ xorl(index, index);
+  __ cmpl(length, Immediate(8));
+  __ j(kLess, &tail);
+
+  __ pxor(vacc0, vacc0);
+  __ pxor(vacc1, vacc1);
+  __ movl(temp, Immediate(kPow31_8));
+  __ movd(vmul, temp, /* is64bit= */ false);
+  __ pshufd(vmul, vmul, Immediate(0));
+
+  __ Bind(&loop);
+  __ pmulld(vacc0, vmul);
+  __ pmulld(vacc1, vmul);
+  switch (type) {
+    case DataType::Type::kInt32:
+      __ movdqu(vdata0, Address(base, index, scale_factor, data_offset));
+      __ movdqu(vdata1, Address(base, index, scale_factor, data_offset + 16));
+      break;
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint8:
+      // Load eight bytes and extend them to two vectors of four ints: duplicate each byte
+      // into the high byte of its lane, then shift it back down.
+      __ movsd(vdata0, Address(base, index, scale_factor, data_offset));
+      __ punpcklbw(vdata0, vdata0);
+      __ movdqa(vdata1, vdata0);
+      __ punpcklwd(vdata0, vdata0);
+      __ punpckhwd(vdata1, vdata1);
+      if (type == DataType::Type::kInt8) {
+        __ psrad(vdata0, Immediate(24));
+        __ psrad(vdata1, Immediate(24));
+      } else {
+        __ psrld(vdata0, Immediate(24));
+        __ psrld(vdata1, Immediate(24));
+      }
+      break;
+    case DataType::Type::kUint16:
+      __ movdqu(vdata0, Address(base, index, scale_factor, data_offset));
+      __ movdqa(vdata1, vdata0);
+      __ punpcklwd(vdata0, vdata0);
+      __ punpckhwd(vdata1, vdata1);
+      __ psrld(vdata0, Immediate(16));
+      __ psrld(vdata1, Immediate(16));
+      break;
+    default:
+      LOG(FATAL) << "Unexpected data type for hash code " << type;
+      UNREACHABLE();
+  }
+  __ paddd(vacc0, vdata0);
+  __ paddd(vacc1, vdata1);
+  __ imull(out, out, Immediate(kPow31_8));
+  __ addl(index, Immediate(8));
+  __ leal(temp, Address(index, 8));
+  __ cmpl(temp, length);
+  __ j(kLessEqual, &loop);
+
+  // Fold the accumulators: h += sum(lane[i] * 31^(3 - i)) for vacc0 * 31^4 + vacc1.
+  __ movl(temp, Immediate(kPow31_4));
+  __ movd(vmul, temp, /* is64bit= */ false);
+  __ pshufd(vmul, vmul, Immediate(0));
+  __ pmulld(vacc0, vmul);
+  __ paddd(vacc0, vacc1);
+  __ movd(temp, vacc0, /* is64bit= */ false);
+  __ imull(temp, temp, Immediate(kPow31_3));
+  __ addl(out, temp);
+  __ pshufd(vdata0, vacc0, Immediate(0x55));
+  __ movd(temp, vdata0, /* is64bit= */ false);
+  __ imull(temp, temp, Immediate(kPow31_2));
+  __ addl(out, temp);
+  __ pshufd(vdata0, vacc0, Immediate(0xaa));
+  __ movd(temp, vdata0, /* is64bit= */ false);
+  __ imull(temp, temp, Immediate(31));
+  __ addl(out, temp);
+  __ pshufd(vdata0, vacc0, Immediate(0xff));
+  __ movd(temp, vdata0, /* is64bit= */ false);
+  __ addl(out, temp);
+
+  __ Bind(&tail);
+  __ cmpl(index, length);
+  __ j(kGreaterEqual, &done);
+  __ Bind(&tail_loop);
+  __ imull(out, out, Immediate(31));
+  switch (type) {
+    case DataType::Type::kInt32:
+      __ addl(out, Address(base, index, scale_factor, data_offset));
+      break;
+    case DataType::Type::kInt8:
+      __ movsxb(temp, Address(base, index, scale_factor, data_offset));
+      __ addl(out, temp);
+      break;
+    case DataType::Type::kUint8:
+      __ movzxb(temp, Address(base, index, scale_factor, data_offset));
+      __ addl(out, temp);
+      break;
+    default:
+      DCHECK_EQ(type, DataType::Type::kUint16);
+      __ movzxw(temp, Address(base, index, scale_factor, data_offset));
+      __ addl(out, temp);
+      break;
+  }
+  __ addl(index, Immediate(1));
+  __ cmpl(index, length);
+  __ j(kLess, &tail_loop);
+
+  __ Bind(&done);
+}
+
+static void GenerateArraysHashCode(HInvoke* invoke,
+                                   X86_64Assembler* assembler,
+                                   DataType::Type type) {
+  LocationSummary* locations = invoke->GetLocations();
+  CpuRegister array = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister length = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister index = locations->GetTemp(1).AsRegister<CpuRegister>();
+  CpuRegister temp = locations->GetTemp(2).AsRegister<CpuRegister>();
+  XmmRegister vacc0 = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
+  XmmRegister vacc1 = locations->GetTemp(4).AsFpuRegister<XmmRegister>();
+  XmmRegister vmul = locations->GetTemp(5).AsFpuRegister<XmmRegister>();
+  XmmRegister vdata0 = locations->GetTemp(6).AsFpuRegister<XmmRegister>();
+  XmmRegister vdata1 = locations->GetTemp(7).AsFpuRegister<XmmRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const uint32_t data_offset = mirror::Array::DataOffset(DataType::Size(type)).Uint32Value();
+
+  // The jump for a null array skips the whole hash code loop.
+  Label done;
+
+  // The hash code of a null array is 0.
+  if (invoke->InputAt(0)->CanBeNull()) {
+    __ xorl(out, out);
+    __ testl(array, array);
+    __ j(kEqual, &done);
+  }
+
+  __ movl(out, Immediate(1));
+  __ movl(length, Address(array, length_offset));
+  GenerateHashCodeLoop(
+      assembler, type, array, data_offset, length, index, temp, vacc0, vacc1, vmul, vdata0, vdata1,
+      out);
+  __ Bind(&done);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysHashCodeByte(HInvoke* invoke) {
+  CreateHashCodeLocations(allocator_, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysHashCodeByte(HInvoke* invoke) {
+  GenerateArraysHashCode(invoke, GetAssembler(), DataType::Type::kInt8);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysHashCodeInt(HInvoke* invoke) {
+  CreateHashCodeLocations(allocator_, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysHashCodeInt(HInvoke* invoke) {
+  GenerateArraysHashCode(invoke, GetAssembler(), DataType::Type::kInt32);
+}
+
 void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopy(HInvoke* invoke) {
   // The only read barrier implementation supporting the
   // SystemArrayCopy intrinsic is the Baker-style read barriers.
@@ -1260,13 +1815,13 @@ void IntrinsicLocationsBuilderX86_64::VisitStringEquals(HInvoke* invoke) {
       new (allocator_) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
   locations->SetInAt(0, Location::RequiresRegister());
   locations->SetInAt(1, Location::RequiresRegister());
-
-  // Request temporary registers, RCX and RDI needed for repe_cmpsq instruction.
-  locations->AddTemp(Location::RegisterLocation(RCX));
-  locations->AddTemp(Location::RegisterLocation(RDI));
-
-  // Set output, RSI needed for repe_cmpsq instruction anyways.
-  locations->SetOut(Location::RegisterLocation(RSI), Location::kOutputOverlap);
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  // The output is used as the mismatch index while the inputs are still live.
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
 }
 
 void IntrinsicCodeGeneratorX86_64::VisitStringEquals(HInvoke* invoke) {
@@ -1275,11 +1830,15 @@ void IntrinsicCodeGeneratorX86_64::VisitStringEquals(HInvoke* invoke) {
 
   CpuRegister str = locations->InAt(0).AsRegister<CpuRegister>();
   CpuRegister arg = locations->InAt(1).AsRegister<CpuRegister>();
-  CpuRegister rcx = locations->GetTemp(0).AsRegister<CpuRegister>();
-  CpuRegister rdi = locations->GetTemp(1).AsRegister<CpuRegister>();
-  CpuRegister rsi = locations->Out().AsRegister<CpuRegister>();
+  CpuRegister length = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister temp1 = locations->GetTemp(1).AsRegister<CpuRegister>();
+  CpuRegister temp2 = locations->GetTemp(2).AsRegister<CpuRegister>();
+  XmmRegister vtemp1 = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
+  XmmRegister vtemp2 = locations->GetTemp(4).AsFpuRegister<XmmRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
 
-  NearLabel end, return_true, return_false;
+  Label return_true, return_false;
+  NearLabel end;
 
   // Get offsets of count, value, and class fields within a string object.
   const uint32_t count_offset = mirror::String::CountOffset().Uint32Value();
@@ -1307,10 +1866,10 @@ void IntrinsicCodeGeneratorX86_64::VisitStringEquals(HInvoke* invoke) {
     AssertNonMovableStringClass();
     // Also, because we use the loaded class references only to compare them, we
     // don't need to unpoison them.
-    // /* HeapReference<Class> */ rcx = str->klass_
-    __ movl(rcx, Address(str, class_offset));
-    // if (rcx != /* HeapReference<Class> */ arg->klass_) return false
-    __ cmpl(rcx, Address(arg, class_offset));
+    // /* HeapReference<Class> */ length = str->klass_
+    __ movl(length, Address(str, class_offset));
+    // if (length != /* HeapReference<Class> */ arg->klass_) return false
+    __ cmpl(length, Address(arg, class_offset));
     __ j(kNotEqual, &return_false);
   }
 
@@ -1319,59 +1878,404 @@ void IntrinsicCodeGeneratorX86_64::VisitStringEquals(HInvoke* invoke) {
   __ j(kEqual, &return_true);
 
   // Load length and compression flag of receiver string.
-  __ movl(rcx, Address(str, count_offset));
+  __ movl(length, Address(str, count_offset));
   // Check if lengths and compressiond flags are equal, return false if they're not.
   // Two identical strings will always have same compression style since
   // compression style is decided on alloc.
-  __ cmpl(rcx, Address(arg, count_offset));
+  __ cmpl(length, Address(arg, count_offset));
   __ j(kNotEqual, &return_false);
   // Return true if both strings are empty. Even with string compression `count == 0` means empty.
   static_assert(static_cast<uint32_t>(mirror::StringCompressionFlag::kCompressed) == 0u,
                 "Expecting 0=compressed, 1=uncompressed");
-  __ jrcxz(&return_true);
+  __ testl(length, length);
+  __ j(kEqual, &return_true);
 
+  // Convert the count to the length of the string data in bytes.
   if (mirror::kUseStringCompression) {
-    NearLabel string_uncompressed;
+    NearLabel string_compressed;
     // Extract length and differentiate between both compressed or both uncompressed.
     // Different compression style is cut above.
-    __ shrl(rcx, Immediate(1));
-    __ j(kCarrySet, &string_uncompressed);
-    // Divide string length by 2, rounding up, and continue as if uncompressed.
-    // Merge clearing the compression flag with +1 for rounding.
-    __ addl(rcx, Immediate(1));
-    __ shrl(rcx, Immediate(1));
-    __ Bind(&string_uncompressed);
+    __ shrl(length, Immediate(1));
+    __ j(kCarryClear, &string_compressed);
+    __ shll(length, Immediate(1));
+    __ Bind(&string_compressed);
+  } else {
+    __ shll(length, Immediate(1));
   }
-  // Load starting addresses of string values into RSI/RDI as required for repe_cmpsq instruction.
-  __ leal(rsi, Address(str, value_offset));
-  __ leal(rdi, Address(arg, value_offset));
-
-  // Divide string length by 4 and adjust for lengths not divisible by 4.
-  __ addl(rcx, Immediate(3));
-  __ shrl(rcx, Immediate(2));
 
-  // Assertions that must hold in order to compare strings 4 characters (uncompressed)
-  // or 8 characters (compressed) at a time.
-  DCHECK_ALIGNED(value_offset, 8);
-  static_assert(IsAligned<8>(kObjectAlignment), "String is not zero padded");
-
-  // Loop to compare strings four characters at a time starting at the beginning of the string.
-  __ repe_cmpsq();
-  // If strings are not equal, zero flag will be cleared.
-  __ j(kNotEqual, &return_false);
+  // Compare the string data 16 bytes at a time, then the remaining tail.
+  GenerateDataMismatch(
+      assembler, value_offset, str, arg, length, out, temp1, temp2, vtemp1, vtemp2, &return_false);
 
   // Return true and exit the function.
-  // If loop does not result in returning false, we return true.
+  // If the comparison does not branch to return false, we return true.
   __ Bind(&return_true);
-  __ movl(rsi, Immediate(1));
+  __ movl(out, Immediate(1));
   __ jmp(&end);
 
   // Return false and exit the function.
   __ Bind(&return_false);
-  __ xorl(rsi, rsi);
+  __ xorl(out, out);
   __ Bind(&end);
 }
 
+void IntrinsicLocationsBuilderX86_64::VisitStringHashCode(HInvoke* invoke) {
+  CreateHashCodeLocations(allocator_, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitStringHashCode(HInvoke* invoke) {
+  X86_64Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  CpuRegister str = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister length = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister index = locations->GetTemp(1).AsRegister<CpuRegister>();
+  CpuRegister temp = locations->GetTemp(2).AsRegister<CpuRegister>();
+  XmmRegister vacc0 = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
+  XmmRegister vacc1 = locations->GetTemp(4).AsFpuRegister<XmmRegister>();
+  XmmRegister vmul = locations->GetTemp(5).AsFpuRegister<XmmRegister>();
+  XmmRegister vdata0 = locations->GetTemp(6).AsFpuRegister<XmmRegister>();
+  XmmRegister vdata1 = locations->GetTemp(7).AsFpuRegister<XmmRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+
+  const uint32_t count_offset = mirror::String::CountOffset().Uint32Value();
+  const uint32_t value_offset = mirror::String::ValueOffset().Uint32Value();
+  const uint32_t hash_code_offset = mirror::String::HashCodeOffset().Uint32Value();
+
+  // Note that the null check must have been done earlier.
+  DCHECK(!invoke->CanDoImplicitNullCheckOn(invoke->InputAt(0)));
+
+  Label store, done;
+
+  // Return the cached hash code if it has already been computed.
+  __ movl(out, Address(str, hash_code_offset));
+  __ testl(out, out);
+  __ j(kNotZero, &done);
+
+  // Hash the characters starting from `out == 0`.
+  __ movl(length, Address(str, count_offset));
+  if (mirror::kUseStringCompression) {
+    static_assert(static_cast<uint32_t>(mirror::StringCompressionFlag::kCompressed) == 0u,
+                  "Expecting 0=compressed, 1=uncompressed");
+    Label string_uncompressed;
+    __ shrl(length, Immediate(1));
+    __ j(kCarrySet, &string_uncompressed);
+    GenerateHashCodeLoop(assembler,
+                         DataType::Type::kUint8,
+                         str,
+                         value_offset,
+                         length,
+                         index,
+                         temp,
+                         vacc0,
+                         vacc1,
+                         vmul,
+                         vdata0,
+                         vdata1,
+                         out);
+    __ jmp(&store);
+    __ Bind(&string_uncompressed);
+  }
+  GenerateHashCodeLoop(assembler,
+                       DataType::Type::kUint16,
+                       str,
+                       value_offset,
+                       length,
+                       index,
+                       temp,
+                       vacc0,
+                       vacc1,
+                       vmul,
+                       vdata0,
+                       vdata1,
+                       out);
+
+  // Cache the hash code as String.hashCode() and the interpreter do. Racing threads store the
+  // same value and 0 means "not computed yet", so like the interpreter we treat this store as an
+  // idempotent cache and the intrinsic is declared as only reading memory.
+  __ Bind(&store);
+  __ movl(Address(str, hash_code_offset), out);
+  __ Bind(&done);
+}
+
+// Searches for `needle` in `haystack`, both strings with characters of type `type` (`kUint8` for
+// compressed strings, `kUint16` otherwise). `limit` holds the length of the haystack and
+// `needle_length` the length of the needle, 0 < needle_length <= limit. Jumps to `done` with
+// the index of the first match in `out`, or falls through with `out` set to -1.
+//
+// Blocks of candidate positions are filtered with SSE2 by comparing the first and the last
+// character of the needle at once; only positions matching both are compared in full.
+static void GenerateStringSearch(X86_64Assembler* assembler,
+                                 DataType::Type type,
+                                 CpuRegister haystack,
+                                 CpuRegister needle,
+                                 CpuRegister limit,
+                                 CpuRegister needle_length,
+                                 CpuRegister haystack_last,
+                                 CpuRegister position,
+                                 CpuRegister mask,
+                                 CpuRegister candidate,
+                                 CpuRegister index,
+                                 CpuRegister temp1,
+                                 CpuRegister temp2,
+                                 XmmRegister vfirst,
+                                 XmmRegister vlast,
+                                 XmmRegister vtemp1,
+                                 XmmRegister vtemp2,
+                                 CpuRegister out,
+                                 Label* done) {
+  DCHECK(type == DataType::Type::kUint8 || type == DataType::Type::kUint16) << type;
+  const uint32_t value_offset = mirror::String::ValueOffset().Uint32Value();
+  const bool is_compressed = (type == DataType::Type::kUint8);
+  const int32_t char_size = DataType::Size(type);
+  const ScaleFactor scale_factor = CodeGenerator::ScaleFactorForType(type);
+  const int32_t chars_per_block = 16 / char_size;
+
+  Label vector_loop, check_mask, next_block, scalar_loop, scalar_next, not_found;
+
+  // The last position where the needle can start.
+  __ subl(limit, needle_length);
+  // `haystack_last` addresses the characters aligned with the last character of the needle.
+  __ leaq(haystack_last, Address(haystack, needle_length, scale_factor, -char_size));
+
+  // Broadcast the first and the last character of the needle.
+  if (is_compressed) {
+    __ movzxb(temp1, Address(needle, value_offset));
+    __ imull(temp1, temp1, Immediate(0x01010101));
+    __ movzxb(temp2, Address(needle, needle_length, scale_factor, value_offset - char_size));
+    __ imull(temp2, temp2, Immediate(0x01010101));
+  } else {
+    __ movzxw(temp1, Address(needle, value_offset));
+    __ imull(temp1, temp1, Immediate(0x00010001));
+    __ movzxw(temp2, Address(needle, needle_length, scale_factor, value_offset - char_size));
+    __ imull(temp2, temp2, Immediate(0x00010001));
+    // From here on, the needle length is only used as the size of its data in bytes.
+    __ shll(needle_length, Immediate(1));
+  }
+  __ movd(vfirst, temp1, /* is64bit= */ false);
+  __ pshufd(vfirst, vfirst, Immediate(0));
+  __ movd(vlast, temp2, /* is64bit= */ false);
+  __ pshufd(vlast, vlast, Immediate(0));
+
+  __ xorl(position, position);
+  __ cmpl(limit, Immediate(chars_per_block - 1));
+  __ j(kLess, &scalar_loop);
+
+  __ Bind(&vector_loop);
+  __ movdqu(vtemp1, Address(haystack, position, scale_factor, value_offset));
+  __ movdqu(vtemp2, Address(haystack_last, position, scale_factor, value_offset));
+  if (is_compressed) {
+    __ pcmpeqb(vtemp1, vfirst);
+    __ pcmpeqb(vtemp2, vlast);
+  } else {
+    __ pcmpeqw(vtemp1, vfirst);
+    __ pcmpeqw(vtemp2, vlast);
+  }
+  __ pand(vtemp1, vtemp2);
+  __ pmovmskb(mask, vtemp1);
+
+  __ Bind(&check_mask);
+  __ testl(mask, mask);
+  __ j(kZero, &next_block);
+  // Take the lowest candidate and clear its bits from the mask (one bit per byte).
+  __ bsfl(temp1, mask);
+  __ leal(temp2, Address(mask, -1));
+  __ andl(mask, temp2);
+  if (!is_compressed) {
+    __ leal(temp2, Address(mask, -1));
+    __ andl(mask, temp2);
+    __ shrl(temp1, Immediate(1));
+  }
+  __ leal(out, Address(position, temp1, TIMES_1, 0));
+  __ leaq(candidate, Address(haystack, out, scale_factor, 0));
+  GenerateDataMismatch(assembler,
+                       value_offset,
+                       candidate,
+                       needle,
+                       needle_length,
+                       index,
+                       temp1,
+                       temp2,
+                       vtemp1,
+                       vtemp2,
+                       &check_mask);
+  __ jmp(done);
+
+  __ Bind(&next_block);
+  __ addl(position, Immediate(chars_per_block));
+  __ leal(temp1, Address(position, chars_per_block - 1));
+  __ cmpl(temp1, limit);
+  __ j(kLessEqual, &vector_loop);
+  // Finish with a block ending at `limit`. It overlaps positions that are already rejected,
+  // so the first match found in it is still the first match overall.
+  __ cmpl(position, limit);
+  __ j(kGreater, &not_found);
+  __ leal(position, Address(limit, -(chars_per_block - 1)));
+  __ jmp(&vector_loop);
+
+  // The haystack is too short for a full block, check the positions one by one.
+  __ Bind(&scalar_loop);
+  if (is_compressed) {
+    __ movzxb(temp1, Address(haystack, position, scale_factor, value_offset));
+    __ movzxb(temp2, Address(needle, value_offset));
+  } else {
+    __ movzxw(temp1, Address(haystack, position, scale_factor, value_offset));
+    __ movzxw(temp2, Address(needle, value_offset));
+  }
+  __ cmpl(temp1, temp2);
+  __ j(kNotEqual, &scalar_next);
+  __ movl(out, position);
+  __ leaq(candidate, Address(haystack, position, scale_factor, 0));
+  GenerateDataMismatch(assembler,
+                       value_offset,
+                       candidate,
+                       needle,
+                       needle_length,
+                       index,
+                       temp1,
+                       temp2,
+                       vtemp1,
+                       vtemp2,
+                       &scalar_next);
+  __ jmp(done);
+  __ Bind(&scalar_next);
+  __ addl(position, Immediate(1));
+  __ cmpl(position, limit);
+  __ j(kLessEqual, &scalar_loop);
+
+  __ Bind(&not_found);
+  __ movl(out, Immediate(-1));
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitStringStringIndexOf(HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  for (size_t i = 0; i != 9u; ++i) {
+    locations->AddTemp(Location::RequiresRegister());
+  }
+  for (size_t i = 0; i != 4u; ++i) {
+    locations->AddTemp(Location::RequiresFpuRegister());
+  }
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitStringStringIndexOf(HInvoke* invoke) {
+  X86_64Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  CpuRegister str = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister arg = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister limit = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister needle_length = locations->GetTemp(1).AsRegister<CpuRegister>();
+  CpuRegister haystack_last = locations->GetTemp(2).AsRegister<CpuRegister>();
+  CpuRegister position = locations->GetTemp(3).AsRegister<CpuRegister>();
+  CpuRegister mask = locations->GetTemp(4).AsRegister<CpuRegister>();
+  CpuRegister candidate = locations->GetTemp(5).AsRegister<CpuRegister>();
+  CpuRegister index = locations->GetTemp(6).AsRegister<CpuRegister>();
+  CpuRegister temp1 = locations->GetTemp(7).AsRegister<CpuRegister>();
+  CpuRegister temp2 = locations->GetTemp(8).AsRegister<CpuRegister>();
+  XmmRegister vfirst = locations->GetTemp(9).AsFpuRegister<XmmRegister>();
+  XmmRegister vlast = locations->GetTemp(10).AsFpuRegister<XmmRegister>();
+  XmmRegister vtemp1 = locations->GetTemp(11).AsFpuRegister<XmmRegister>();
+  XmmRegister vtemp2 = locations->GetTemp(12).AsFpuRegister<XmmRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+
+  const uint32_t count_offset = mirror::String::CountOffset().Uint32Value();
+
+  // Note that the null check must have been done earlier.
+  DCHECK(!invoke->CanDoImplicitNullCheckOn(invoke->InputAt(0)));
+
+  SlowPathCode* slow_path = new (codegen_->GetScopedAllocator()) IntrinsicSlowPathX86_64(invoke);
+  codegen_->AddSlowPath(slow_path);
+
+  Label done;
+
+  // Leave throwing the NullPointerException for a null argument to the managed code.
+  if (invoke->InputAt(1)->CanBeNull()) {
+    __ testl(arg, arg);
+    __ j(kEqual, slow_path->GetEntryLabel());
+  }
+
+  __ movl(limit, Address(str, count_offset));
+  __ movl(needle_length, Address(arg, count_offset));
+  if (mirror::kUseStringCompression) {
+    // Keep the compression flags in `temp1` (haystack) and `temp2` (needle).
+    __ movl(temp1, limit);
+    __ andl(temp1, Immediate(1));
+    __ movl(temp2, needle_length);
+    __ andl(temp2, Immediate(1));
+    __ shrl(limit, Immediate(1));
+    __ shrl(needle_length, Immediate(1));
+  }
+
+  // The empty string is found at index 0.
+  __ xorl(out, out);
+  __ testl(needle_length, needle_length);
+  __ j(kZero, &done);
+  // A needle longer than the haystack is not found.
+  __ movl(out, Immediate(-1));
+  __ cmpl(needle_length, limit);
+  __ j(kGreater, &done);
+
+  if (mirror::kUseStringCompression) {
+    Label haystack_uncompressed;
+    __ testl(temp1, temp1);
+    __ j(kNotZero, &haystack_uncompressed);
+    // Only ASCII strings are compressed and any string that can be compressed is, so an
+    // uncompressed needle cannot occur in a compressed haystack.
+    __ testl(temp2, temp2);
+    __ j(kNotZero, &done);
+    GenerateStringSearch(assembler,
+                         DataType::Type::kUint8,
+                         str,
+                         arg,
+                         limit,
+                         needle_length,
+                         haystack_last,
+                         position,
+                         mask,
+                         candidate,
+                         index,
+                         temp1,
+                         temp2,
+                         vfirst,
+                         vlast,
+                         vtemp1,
+                         vtemp2,
+                         out,
+                         &done);
+    __ jmp(&done);
+    __ Bind(&haystack_uncompressed);
+    // Searching for a compressed needle in an uncompressed haystack is left to the managed code.
+    __ testl(temp2, temp2);
+    __ j(kZero, slow_path->GetEntryLabel());
+  }
+  GenerateStringSearch(assembler,
+                       DataType::Type::kUint16,
+                       str,
+                       arg,
+                       limit,
+                       needle_length,
+                       haystack_last,
+                       position,
+                       mask,
+                       candidate,
+                       index,
+                       temp1,
+                       temp2,
+                       vfirst,
+                       vlast,
+                       vtemp1,
+                       vtemp2,
+                       out,
+                       &done);
+
+  __ Bind(&done);
+  __ Bind(slow_path->GetExitLabel());
+}
+
 static void CreateStringIndexOfLocations(HInvoke* invoke,
                                          ArenaAllocator* allocator,
                                          bool start_at_zero) {
@@ -5003,7 +5907,6 @@ UNIMPLEMENTED_INTRINSIC(X86_64, FP16Compare)
 UNIMPLEMENTED_INTRINSIC(X86_64, FP16Min)
 UNIMPLEMENTED_INTRINSIC(X86_64, FP16Max)
 
-UNIMPLEMENTED_INTRINSIC(X86_64, StringStringIndexOf);
 UNIMPLEMENTED_INTRINSIC(X86_64, StringStringIndexOfAfter);
 UNIMPLEMENTED_INTRINSIC(X86_64, StringBufferAppend);
 UNIMPLEMENTED_INTRINSIC(X86_64, StringBufferLength);
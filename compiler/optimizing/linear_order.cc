@@ -16,8 +16,12 @@
 
 #include "linear_order.h"
 
+#include <algorithm>
+
+#include "base/arena_bit_vector.h"
 #include "base/scoped_arena_allocator.h"
 #include "base/scoped_arena_containers.h"
+#include "block_frequency.h"
 
 namespace art {
 
@@ -87,7 +91,9 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
   DCHECK_EQ(linear_order.size(), graph->GetReversePostOrder().size());
   // Create a reverse post ordering with the following properties:
   // - Blocks in a loop are consecutive,
-  // - Back-edge is the last block before loop exits.
+  // - Back-edge is the last block before loop exits,
+  // - More frequent successors tend to follow their predecessor directly,
+  // - Cold blocks are at the end.
   //
   // (1): Record the number of forward predecessors for each block. This is to
   //      ensure the resulting order is reverse post order. We could use the
@@ -108,7 +114,10 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
   //      iterate over the successors. When all non-back edge predecessors of a
   //      successor block are visited, the successor block is added in the worklist
   //      following an order that satisfies the requirements to build our linear graph.
+  //      Among the successors that become ready together, the most frequent one is
+  //      added last, so that it is visited next.
   ScopedArenaVector<HBasicBlock*> worklist(allocator.Adapter(kArenaAllocLinearOrder));
+  ScopedArenaVector<HBasicBlock*> ready(allocator.Adapter(kArenaAllocLinearOrder));
   worklist.push_back(graph->GetEntryBlock());
   size_t num_added = 0u;
   do {
@@ -116,17 +125,65 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
     worklist.pop_back();
     linear_order[num_added] = current;
     ++num_added;
+    ready.clear();
     for (HBasicBlock* successor : current->GetSuccessors()) {
       int block_id = successor->GetBlockId();
       size_t number_of_remaining_predecessors = forward_predecessors[block_id];
       if (number_of_remaining_predecessors == 1) {
-        AddToListForLinearization(&worklist, successor);
+        ready.push_back(successor);
       }
       forward_predecessors[block_id] = number_of_remaining_predecessors - 1;
     }
+    std::stable_sort(ready.begin(), ready.end(), [](HBasicBlock* lhs, HBasicBlock* rhs) {
+      return lhs->GetFrequency() < rhs->GetFrequency();
+    });
+    for (HBasicBlock* successor : ready) {
+      AddToListForLinearization(&worklist, successor);
+    }
   } while (!worklist.empty());
   DCHECK_EQ(num_added, linear_order.size());
 
+  // (3): Move cold blocks out of line, behind all other blocks. A cold block only
+  //      moves if it is outside loops and all its successors move as well (the exit
+  //      block moves last), so that a block still follows its dominator and
+  //      the blocks of a loop remain consecutive.
+  HBasicBlock* exit_block = graph->GetExitBlock();
+  ArenaBitVector cold(&allocator, graph->GetBlocks().size(), false, kArenaAllocLinearOrder);
+  size_t num_cold = 0u;
+  for (HBasicBlock* block : ReverseRange(linear_order)) {
+    if (block == graph->GetEntryBlock() ||
+        block == exit_block ||
+        block->GetLoopInformation() != nullptr ||
+        !BlockFrequencyAnalysis::IsCold(block)) {
+      continue;
+    }
+    bool all_successors_cold = true;
+    for (HBasicBlock* successor : block->GetSuccessors()) {
+      all_successors_cold = all_successors_cold &&
+          (successor == exit_block || cold.IsBitSet(successor->GetBlockId()));
+    }
+    if (all_successors_cold) {
+      cold.SetBit(block->GetBlockId());
+      ++num_cold;
+    }
+  }
+  if (num_cold != 0u) {
+    if (exit_block != nullptr) {
+      cold.SetBit(exit_block->GetBlockId());
+    }
+    ScopedArenaVector<HBasicBlock*> cold_blocks(allocator.Adapter(kArenaAllocLinearOrder));
+    size_t num_hot = 0u;
+    for (HBasicBlock* block : linear_order) {
+      if (cold.IsBitSet(block->GetBlockId())) {
+        cold_blocks.push_back(block);
+      } else {
+        linear_order[num_hot] = block;
+        ++num_hot;
+      }
+    }
+    std::copy(cold_blocks.begin(), cold_blocks.end(), linear_order.begin() + num_hot);
+  }
+
   DCHECK(graph->HasIrreducibleLoops() || IsLinearOrderWellFormed(graph, linear_order));
 }
 
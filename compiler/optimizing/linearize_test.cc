@@ -17,6 +17,7 @@
 #include <fstream>
 
 #include "base/arena_allocator.h"
+#include "block_frequency.h"
 #include "builder.h"
 #include "code_generator.h"
 #include "dex/dex_file.h"
@@ -244,4 +245,39 @@ TEST_F(LinearizeTest, CFG7) {
   TestCode(data, blocks);
 }
 
+TEST_F(LinearizeTest, ColdBlocksLast) {
+  // Structure of this graph
+  //            Block0
+  //              |
+  //            Block1
+  //            /    \
+  //      (return)  (throw)
+  //            \    /
+  //            (exit)
+  //
+  const std::vector<uint16_t> data = ONE_REGISTER_CODE_ITEM(
+    Instruction::CONST_4 | 0 | 0,
+    Instruction::IF_EQZ, 3,
+    Instruction::THROW | 0 << 8,
+    Instruction::RETURN_VOID);
+
+  HGraph* graph = CreateCFG(data);
+  ASSERT_NE(graph, nullptr);
+  BlockFrequencyAnalysis(graph).Run();
+  std::unique_ptr<CompilerOptions> compiler_options =
+      CommonCompilerTest::CreateCompilerOptions(kRuntimeISA, "default");
+  std::unique_ptr<CodeGenerator> codegen = CodeGenerator::Create(graph, *compiler_options);
+  SsaLivenessAnalysis liveness(graph, codegen.get(), GetScopedAllocator());
+  liveness.Analyze();
+
+  // The throwing block is cold, and placed right before the exit block.
+  const ArenaVector<HBasicBlock*>& linear_order = graph->GetLinearOrder();
+  ASSERT_EQ(linear_order.size(), 5u);
+  EXPECT_TRUE(linear_order[2]->EndsWithReturn());
+  EXPECT_TRUE(linear_order[3]->GetLastInstruction()->IsThrow());
+  EXPECT_TRUE(BlockFrequencyAnalysis::IsCold(linear_order[3]));
+  EXPECT_FALSE(BlockFrequencyAnalysis::IsCold(linear_order[2]));
+  EXPECT_TRUE(linear_order[4]->IsExitBlock());
+}
+
 }  // namespace art
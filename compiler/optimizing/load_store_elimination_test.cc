@@ -22,6 +22,7 @@
 #include <variant>
 
 #include "base/iteration_range.h"
+#include "code_sinking.h"
 #include "compilation_kind.h"
 #include "dex/dex_file_types.h"
 #include "entrypoints/quick/quick_entrypoints.h"
@@ -8251,6 +8252,88 @@ TEST_F(LoadStoreEliminationTest, PartialIrreducibleLoop) {
   EXPECT_INS_EQ(pred_get->GetTarget()->InputAt(1), mat);
 }
 
+// Check that an allocation escaping only on a branch that the profile shows to
+// be rarely taken is sunk to that branch once its loads are eliminated.
+// // ENTRY
+// obj = new Obj();
+// obj.field = value;
+// a = obj.field;
+// if (param) {  // Rarely true.
+//   // LEFT
+//   escape(obj);
+// } else {
+//   // RIGHT
+// }
+// // BRETURN
+// return a;
+TEST_F(LoadStoreEliminationTest, SinkToRareBranch) {
+  ScopedObjectAccess soa(Thread::Current());
+  VariableSizedHandleScope vshs(soa.Self());
+  CreateGraph(&vshs);
+  AdjacencyListGraph blks(SetupFromAdjacencyList("entry",
+                                                 "exit",
+                                                 {{"entry", "left"},
+                                                  {"entry", "right"},
+                                                  {"left", "breturn"},
+                                                  {"right", "breturn"},
+                                                  {"breturn", "exit"}}));
+#define GET_BLOCK(name) HBasicBlock* name = blks.Get(#name)
+  GET_BLOCK(entry);
+  GET_BLOCK(exit);
+  GET_BLOCK(breturn);
+  GET_BLOCK(left);
+  GET_BLOCK(right);
+#undef GET_BLOCK
+  EnsurePredecessorOrder(breturn, {left, right});
+
+  HInstruction* bool_value = MakeParam(DataType::Type::kBool);
+  HInstruction* value = MakeParam(DataType::Type::kInt32);
+
+  HInstruction* cls = MakeClassLoad();
+  HInstruction* new_inst = MakeNewInstance(cls);
+  HInstruction* write_start = MakeIFieldSet(new_inst, value, MemberOffset(32));
+  HInstruction* read_start = MakeIFieldGet(new_inst, DataType::Type::kInt32, MemberOffset(32));
+  HIf* if_inst = new (GetAllocator()) HIf(bool_value);
+  if_inst->SetTrueCount(1u);
+  if_inst->SetFalseCount(1000u);
+  entry->AddInstruction(cls);
+  entry->AddInstruction(new_inst);
+  entry->AddInstruction(write_start);
+  entry->AddInstruction(read_start);
+  entry->AddInstruction(if_inst);
+  ManuallyBuildEnvFor(cls, {});
+  new_inst->CopyEnvironmentFrom(cls->GetEnvironment());
+
+  HInstruction* call_left = MakeInvoke(DataType::Type::kVoid, { new_inst });
+  HInstruction* goto_left = new (GetAllocator()) HGoto();
+  left->AddInstruction(call_left);
+  left->AddInstruction(goto_left);
+  call_left->CopyEnvironmentFrom(cls->GetEnvironment());
+
+  right->AddInstruction(new (GetAllocator()) HGoto());
+
+  HInstruction* return_exit = new (GetAllocator()) HReturn(read_start);
+  breturn->AddInstruction(return_exit);
+
+  SetupExit(exit);
+
+  // PerformLSE expects this to be empty.
+  graph_->ClearDominanceInformation();
+  LOG(INFO) << "Pre LSE " << blks;
+  PerformLSENoPartial();
+  CodeSinking sinking(graph_, /*stats=*/nullptr);
+  sinking.Run();
+  LOG(INFO) << "Post sinking " << blks;
+
+  EXPECT_INS_REMOVED(read_start);
+  EXPECT_INS_EQ(return_exit->InputAt(0), value);
+  EXPECT_INS_RETAINED(new_inst);
+  EXPECT_INS_RETAINED(write_start);
+  EXPECT_EQ(new_inst->GetBlock(), left);
+  EXPECT_EQ(write_start->GetBlock(), left);
+  EXPECT_TRUE(write_start->StrictlyDominates(call_left));
+}
+
 enum class UsesOrder { kDefaultOrder, kReverseOrder };
 std::ostream& operator<<(std::ostream& os, const UsesOrder& ord) {
   switch (ord) {
@@ -49,6 +49,17 @@ void LoopAnalysis::CalculateLoopBasicProperties(HLoopInformation* loop_info,
       }
     }
 
+    // Record the first branch which stays inside the loop for either outcome of an invariant
+    // condition; such a branch can be eliminated by loop unswitching.
+    HIf* hif = block->GetLastInstruction()->AsIf();
+    if (hif != nullptr &&
+        analysis_results->invariant_branch_ == nullptr &&
+        loop_info->Contains(*hif->IfTrueSuccessor()) &&
+        loop_info->Contains(*hif->IfFalseSuccessor()) &&
+        IsLoopInvariantCondition(loop_info, hif->InputAt(0))) {
+      analysis_results->invariant_branch_ = hif;
+    }
+
     for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
       HInstruction* instruction = it.Current();
       if (it.Current()->GetType() == DataType::Type::kInt64) {
@@ -73,6 +84,22 @@ int64_t LoopAnalysis::GetLoopTripCount(HLoopInformation* loop_info,
   return trip_count;
 }
 
+bool LoopAnalysis::IsLoopInvariantCondition(HLoopInformation* loop_info, HInstruction* cond) {
+  if (cond->IsConstant()) {
+    return false;
+  } else if (!loop_info->Contains(*cond->GetBlock())) {
+    return true;
+  } else if (!cond->IsCondition()) {
+    return false;
+  }
+  for (HInstruction* input : cond->GetInputs()) {
+    if (loop_info->Contains(*input->GetBlock())) {
+      return false;
+    }
+  }
+  return true;
+}
+
 // Default implementation of loop helper; used for all targets unless a custom implementation
 // is provided. Enables scalar loop peeling and unrolling with the most conservative heuristics.
 class ArchDefaultLoopHelper : public ArchNoOptsLoopHelper {
@@ -88,6 +115,10 @@ class ArchDefaultLoopHelper : public ArchNoOptsLoopHelper {
   static constexpr uint32_t kScalarHeuristicMaxBodySizeBlocks = 6;
   // Maximum number of instructions to be created as a result of full unrolling.
   static constexpr uint32_t kScalarHeuristicFullyUnrolledMaxInstrThreshold = 35;
+  // Loop's maximum instruction count. Loops with higher count will not be unswitched.
+  static constexpr uint32_t kScalarHeuristicMaxUnswitchedBodySizeInstr = 40;
+  // Loop's maximum basic block count. Loops with higher count will not be unswitched.
+  static constexpr uint32_t kScalarHeuristicMaxUnswitchedBodySizeBlocks = 12;
 
   bool IsLoopNonBeneficialForScalarOpts(LoopAnalysisInfo* analysis_info) const override {
     return analysis_info->HasLongTypeInstructions() ||
@@ -120,6 +151,13 @@ class ArchDefaultLoopHelper : public ArchNoOptsLoopHelper {
     return (trip_count * instr_num < kScalarHeuristicFullyUnrolledMaxInstrThreshold);
   }
 
+  bool IsLoopUnswitchingBeneficial(LoopAnalysisInfo* analysis_info) const override {
+    return analysis_info->GetInvariantBranch() != nullptr &&
+           !IsLoopTooBig(analysis_info,
+                         kScalarHeuristicMaxUnswitchedBodySizeInstr,
+                         kScalarHeuristicMaxUnswitchedBodySizeBlocks);
+  }
+
  protected:
   bool IsLoopTooBig(LoopAnalysisInfo* loop_analysis_info,
                     size_t instr_threshold,
@@ -42,6 +42,7 @@ class LoopAnalysisInfo : public ValueObject {
         has_instructions_preventing_scalar_peeling_(false),
         has_instructions_preventing_scalar_unrolling_(false),
         has_long_type_instructions_(false),
+        invariant_branch_(nullptr),
         loop_info_(loop_info) {}
 
   int64_t GetTripCount() const { return trip_count_; }
@@ -66,6 +67,8 @@ class LoopAnalysisInfo : public ValueObject {
     return has_long_type_instructions_;
   }
 
+  HIf* GetInvariantBranch() const { return invariant_branch_; }
+
   HLoopInformation* GetLoopInfo() const { return loop_info_; }
 
  private:
@@ -86,6 +89,9 @@ class LoopAnalysisInfo : public ValueObject {
   // Whether the loop has instructions of primitive long type; unrolling these loop will
   // likely introduce spill/fills on 32-bit targets.
   bool has_long_type_instructions_;
+  // An "if" inside the loop which is not a loop exit and whose condition is loop-invariant
+  // (see LoopAnalysis::IsLoopInvariantCondition); nullptr if there is none.
+  HIf* invariant_branch_;
 
   // Corresponding HLoopInformation.
   HLoopInformation* loop_info_;
@@ -107,6 +113,11 @@ class LoopAnalysis : public ValueObject {
   static int64_t GetLoopTripCount(HLoopInformation* loop_info,
                                   const InductionVarRange* induction_range);
 
+  // Returns whether the condition `cond` evaluates to the same non-constant value in every
+  // iteration of the loop: it is either defined outside of the loop or it is a comparison
+  // of values defined outside of the loop, which can be hoisted to the preheader.
+  static bool IsLoopInvariantCondition(HLoopInformation* loop_info, HInstruction* cond);
+
  private:
   // Returns whether an instruction makes scalar loop peeling/unrolling non-beneficial.
   //
@@ -169,6 +180,15 @@ class ArchNoOptsLoopHelper : public ArenaObject<kArenaAllocOptimization> {
     return false;
   }
 
+  // Returns whether it is beneficial to unswitch the loop on its invariant branch, that is
+  // to replace the loop by two copies specialized for either outcome of the branch.
+  //
+  // Returns 'false' by default, should be overridden by particular target loop helper.
+  virtual bool IsLoopUnswitchingBeneficial(
+      LoopAnalysisInfo* analysis_info ATTRIBUTE_UNUSED) const {
+    return false;
+  }
+
   // Returns optimal SIMD unrolling factor for the loop.
   //
   // Returns kNoUnrollingFactor by default, should be overridden by particular target loop helper.
@@ -32,6 +32,14 @@ namespace art {
 // Enables vectorization (SIMDization) in the loop optimizer.
 static constexpr bool kEnableVectorization = true;
 
+// Maximum number of runtime tests that may guard a vector loop against potential
+// data dependences; each test adds a compare and a select to the preheader.
+static constexpr size_t kMaxVectorRuntimeTests = 4;
+
+// Maximum known trip count for which the remainder iterations of a vector loop are
+// handled by an overlapping vector iteration rather than a scalar cleanup loop.
+static constexpr int64_t kMaxOverlappedTailTripCount = 64;
+
 //
 // Static helpers.
 //
@@ -478,8 +486,9 @@ HLoopOptimization::HLoopOptimization(HGraph* graph,
       vector_refs_(nullptr),
       vector_static_peeling_factor_(0),
       vector_dynamic_peeling_candidate_(nullptr),
-      vector_runtime_test_a_(nullptr),
-      vector_runtime_test_b_(nullptr),
+      vector_runtime_tests_(nullptr),
+      vector_overlapped_tail_(false),
+      vector_tail_index_(nullptr),
       vector_map_(nullptr),
       vector_permanent_map_(nullptr),
       vector_mode_(kSequential),
@@ -543,6 +552,7 @@ bool HLoopOptimization::LocalRun() {
   ScopedArenaSafeMap<HInstruction*, HInstruction*> reds(
       std::less<HInstruction*>(), loop_allocator_->Adapter(kArenaAllocLoopOptimization));
   ScopedArenaSet<ArrayReference> refs(loop_allocator_->Adapter(kArenaAllocLoopOptimization));
+  ScopedArenaVector<RuntimeTest> tests(loop_allocator_->Adapter(kArenaAllocLoopOptimization));
   ScopedArenaSafeMap<HInstruction*, HInstruction*> map(
       std::less<HInstruction*>(), loop_allocator_->Adapter(kArenaAllocLoopOptimization));
   ScopedArenaSafeMap<HInstruction*, HInstruction*> perm(
@@ -551,6 +561,7 @@ bool HLoopOptimization::LocalRun() {
   iset_ = &iset;
   reductions_ = &reds;
   vector_refs_ = &refs;
+  vector_runtime_tests_ = &tests;
   vector_map_ = &map;
   vector_permanent_map_ = &perm;
   // Traverse.
@@ -559,6 +570,7 @@ bool HLoopOptimization::LocalRun() {
   iset_ = nullptr;
   reductions_ = nullptr;
   vector_refs_ = nullptr;
+  vector_runtime_tests_ = nullptr;
   vector_map_ = nullptr;
   vector_permanent_map_ = nullptr;
   return did_loop_opt;
@@ -967,8 +979,8 @@ bool HLoopOptimization::ShouldVectorize(LoopNode* node, HBasicBlock* block, int6
   vector_refs_->clear();
   vector_static_peeling_factor_ = 0;
   vector_dynamic_peeling_candidate_ = nullptr;
-  vector_runtime_test_a_ =
-  vector_runtime_test_b_ = nullptr;
+  vector_runtime_tests_->clear();
+  vector_overlapped_tail_ = false;
 
   // Phis in the loop-body prevent vectorization.
   if (!block->GetPhis().IsEmpty()) {
@@ -1015,9 +1027,22 @@ bool HLoopOptimization::ShouldVectorize(LoopNode* node, HBasicBlock* block, int6
         HInstruction* y = j->offset;
         if (a == b) {
           // Found a[i+x] vs. a[i+y]. Accept if x == y (loop-independent data dependence).
-          // Conservatively assume a loop-carried data dependence otherwise, and reject.
+          // Otherwise, accept if the distance between the two references is at least
+          // the vector length, since then no dependence falls within a single vector
+          // operation and the vector loop preserves the order of the scalar loop. This
+          // is decided statically for constant offsets, or guarded by a runtime test.
           if (x != y) {
-            return false;
+            if (x->IsIntConstant() && y->IsIntConstant()) {
+              int64_t distance = static_cast<int64_t>(x->AsIntConstant()->GetValue()) -
+                                 static_cast<int64_t>(y->AsIntConstant()->GetValue());
+              if (std::abs(distance) < static_cast<int64_t>(vector_length_)) {
+                return false;  // dependence within a vector
+              }
+            } else if (x->GetType() != y->GetType() ||
+                       !TryAddRuntimeTest(x, y, /*is_distance=*/ true)) {
+              return false;  // too many runtime tests
+            }
+            continue;
           }
           // Count the number of references that have the same alignment (since
           // base and offset are the same) and where at least one is a write, so
@@ -1027,16 +1052,8 @@ bool HLoopOptimization::ShouldVectorize(LoopNode* node, HBasicBlock* block, int6
           // Found a[i+x] vs. b[i+y]. Accept if x == y (at worst loop-independent data dependence).
           // Conservatively assume a potential loop-carried data dependence otherwise, avoided by
           // generating an explicit a != b disambiguation runtime test on the two references.
-          if (x != y) {
-            // To avoid excessive overhead, we only accept one a != b test.
-            if (vector_runtime_test_a_ == nullptr) {
-              // First test found.
-              vector_runtime_test_a_ = a;
-              vector_runtime_test_b_ = b;
-            } else if ((vector_runtime_test_a_ != a || vector_runtime_test_b_ != b) &&
-                       (vector_runtime_test_a_ != b || vector_runtime_test_b_ != a)) {
-              return false;  // second test would be needed
-            }
+          if (x != y && !TryAddRuntimeTest(a, b, /*is_distance=*/ false)) {
+            return false;  // too many runtime tests
           }
         }
       }
@@ -1066,7 +1083,11 @@ bool HLoopOptimization::ShouldVectorize(LoopNode* node, HBasicBlock* block, int6
     }
   }  // for i
 
-  if (!IsInPredicatedVectorizationMode()) {
+  if (CanOverlapTail(trip_count)) {
+    // Overlapping the final vector iteration with the previous one does not
+    // preserve alignment, so there is no point in peeling for it.
+    vector_overlapped_tail_ = true;
+  } else if (!IsInPredicatedVectorizationMode()) {
     // Find a suitable alignment strategy.
     SetAlignmentStrategy(peeling_votes, peeling_candidate);
   }
@@ -1151,7 +1172,20 @@ void HLoopOptimization::Vectorize(LoopNode* node,
   // i = 0;
   HInstruction* stc = induction_range_.GenerateTripCount(node->loop_info, graph_, preheader);
   HInstruction* vtc = stc;
-  if (needs_cleanup) {
+  if (vector_overlapped_tail_) {
+    // Generate loop control for an overlapping final vector iteration:
+    // last = stc - VL;
+    // i = 0;
+    // The vector loop clamps its index to min(i, last), so that the final vector
+    // iteration redoes some of the previous iterations, which is harmless for the
+    // idempotent loop bodies accepted by CanOverlapTail(). No cleanup is needed,
+    // since the known trip count exceeds VL (see CanOverlapTail()).
+    DCHECK(ptc == nullptr);
+    DCHECK_GT(trip_count, static_cast<int64_t>(vector_length_));
+    vector_tail_index_ = Insert(preheader, new (global_allocator_) HSub(
+        induc_type, stc, graph_->GetConstant(induc_type, vector_length_)));
+    needs_cleanup = false;
+  } else if (needs_cleanup) {
     DCHECK(!IsInPredicatedVectorizationMode());
     DCHECK(IsPowerOfTwo(chunk));
     HInstruction* diff = stc;
@@ -1170,12 +1204,26 @@ void HLoopOptimization::Vectorize(LoopNode* node,
   }
   vector_index_ = graph_->GetConstant(induc_type, 0);
 
-  // Generate runtime disambiguation test:
+  // Generate runtime disambiguation tests, which send all iterations to the
+  // scalar cleanup loop whenever a potential data dependence materializes:
   // vtc = a != b ? vtc : 0;
-  if (vector_runtime_test_a_ != nullptr) {
-    HInstruction* rt = Insert(
-        preheader,
-        new (global_allocator_) HNotEqual(vector_runtime_test_a_, vector_runtime_test_b_));
+  // vtc = (unsigned) (x - y + (VL - 1)) > 2 * (VL - 1) ? vtc : 0;
+  for (const RuntimeTest& test : *vector_runtime_tests_) {
+    HInstruction* rt = nullptr;
+    if (test.is_distance) {
+      // Tests |x - y| >= VL without the overflow pitfalls of an absolute value.
+      DataType::Type type = test.lhs->GetType();
+      HInstruction* diff = Insert(
+          preheader, new (global_allocator_) HSub(type, test.lhs, test.rhs));
+      HInstruction* bias = Insert(
+          preheader,
+          new (global_allocator_) HAdd(type, diff, graph_->GetConstant(type, vector_length_ - 1)));
+      rt = Insert(preheader,
+                  new (global_allocator_)
+                  HAbove(bias, graph_->GetConstant(type, 2 * (vector_length_ - 1))));
+    } else {
+      rt = Insert(preheader, new (global_allocator_) HNotEqual(test.lhs, test.rhs));
+    }
     vtc = Insert(preheader,
                  new (global_allocator_)
                  HSelect(rt, vtc, graph_->GetConstant(induc_type, 0), kNoDexPc));
@@ -1213,12 +1261,13 @@ void HLoopOptimization::Vectorize(LoopNode* node,
                   graph_->GetConstant(induc_type, vector_length_),  // increment per unroll
                   unroll);
   HLoopInformation* vloop = vector_header_->GetLoopInformation();
+  vector_tail_index_ = nullptr;
 
   // Generate cleanup loop, if needed:
   // for ( ; i < stc; i += 1)
   //    <loop-body>
   if (needs_cleanup) {
-    DCHECK_IMPLIES(IsInPredicatedVectorizationMode(), vector_runtime_test_a_ != nullptr);
+    DCHECK_IMPLIES(IsInPredicatedVectorizationMode(), !vector_runtime_tests_->empty());
     vector_mode_ = kSequential;
     GenerateNewLoop(node,
                     block,
@@ -1309,6 +1358,12 @@ void HLoopOptimization::GenerateNewLoop(LoopNode* node,
   vector_index_ = phi;
   vector_permanent_map_->clear();  // preserved over unrolling
   for (uint32_t u = 0; u < unroll; u++) {
+    // Clamp the index for an overlapping final vector iteration, if needed.
+    HInstruction* index = vector_index_;
+    if (vector_mode_ == kVector && vector_tail_index_ != nullptr) {
+      vector_index_ = Insert(vector_body_, new (global_allocator_) HMin(
+          induc_type, index, vector_tail_index_, kNoDexPc));
+    }
     // Generate instruction map.
     vector_map_->clear();
     for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
@@ -1332,7 +1387,7 @@ void HLoopOptimization::GenerateNewLoop(LoopNode* node,
       }
     }
     // Generate the induction.
-    vector_index_ = new (global_allocator_) HAdd(induc_type, vector_index_, step);
+    vector_index_ = new (global_allocator_) HAdd(induc_type, index, step);
     Insert(vector_body_, vector_index_);
   }
   // Finalize phi inputs for the reductions (if any).
@@ -1864,7 +1919,10 @@ void HLoopOptimization::GenerateVecMem(HInstruction* org,
                                                 dex_pc);
     }
     // Known (forced/adjusted/original) alignment?
-    if (vector_dynamic_peeling_candidate_ != nullptr) {
+    if (vector_tail_index_ != nullptr) {
+      vector->AsVecMemoryOperation()->SetAlignment(  // clamped index, natural only
+          Alignment(DataType::Size(type), 0));
+    } else if (vector_dynamic_peeling_candidate_ != nullptr) {
       if (vector_dynamic_peeling_candidate_->offset == offset &&  // TODO: diffs too?
           DataType::Size(vector_dynamic_peeling_candidate_->type) == DataType::Size(type) &&
           vector_dynamic_peeling_candidate_->is_string_char_at == is_string_char_at) {
@@ -2388,6 +2446,52 @@ bool HLoopOptimization::IsVectorizationProfitable(int64_t trip_count) {
   return true;
 }
 
+bool HLoopOptimization::TryAddRuntimeTest(HInstruction* lhs, HInstruction* rhs, bool is_distance) {
+  // Both tests are symmetric, so (lhs, rhs) and (rhs, lhs) share the same test.
+  for (const RuntimeTest& test : *vector_runtime_tests_) {
+    if (test.is_distance == is_distance &&
+        ((test.lhs == lhs && test.rhs == rhs) || (test.lhs == rhs && test.rhs == lhs))) {
+      return true;  // already present
+    }
+  }
+  if (vector_runtime_tests_->size() >= kMaxVectorRuntimeTests) {
+    return false;  // avoid excessive overhead
+  }
+  vector_runtime_tests_->push_back(RuntimeTest(lhs, rhs, is_distance));
+  return true;
+}
+
+bool HLoopOptimization::CanOverlapTail(int64_t trip_count) {
+  // Only used for short loops with a known number of remainder iterations, where
+  // the scalar cleanup loop is relatively expensive, and only valid if redoing some
+  // iterations is harmless. That excludes reductions, and arrays that are both
+  // written and accessed otherwise in the loop. Arrays that may still be the same
+  // at runtime are disambiguated with a != b tests.
+  if (IsInPredicatedVectorizationMode() ||
+      !reductions_->empty() ||
+      trip_count <= static_cast<int64_t>(vector_length_) ||
+      trip_count > kMaxOverlappedTailTripCount ||
+      (trip_count % vector_length_) == 0) {
+    return false;
+  }
+  size_t num_tests = vector_runtime_tests_->size();
+  for (auto i = vector_refs_->begin(); i != vector_refs_->end(); ++i) {
+    if (!i->lhs) {
+      continue;
+    }
+    for (auto j = vector_refs_->begin(); j != vector_refs_->end(); ++j) {
+      if (i == j || i->type != j->type) {
+        continue;
+      } else if (i->base == j->base || !TryAddRuntimeTest(i->base, j->base, false)) {
+        vector_runtime_tests_->erase(vector_runtime_tests_->begin() + num_tests,
+                                     vector_runtime_tests_->end());
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 //
 // Helpers.
 //
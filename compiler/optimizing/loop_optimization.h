@@ -130,6 +130,18 @@ class HLoopOptimization : public HOptimization {
     bool is_string_char_at;  // compressed string read
   };
 
+  /*
+   * Representation of a runtime test that guards the vector loop against a potential
+   * loop-carried data dependence. The test is either a != b on two array bases, or
+   * |x - y| >= vector length on the offsets of two references into the same array.
+   */
+  struct RuntimeTest {
+    RuntimeTest(HInstruction* l, HInstruction* r, bool d) : lhs(l), rhs(r), is_distance(d) { }
+    HInstruction* lhs;  // array base or offset
+    HInstruction* rhs;  // array base or offset
+    bool is_distance;   // distance test on offsets
+  };
+
   //
   // Loop setup and traversal.
   //
@@ -258,6 +270,8 @@ class HLoopOptimization : public HOptimization {
                             const ArrayReference* peeling_candidate);
   uint32_t MaxNumberPeeled();
   bool IsVectorizationProfitable(int64_t trip_count);
+  bool TryAddRuntimeTest(HInstruction* lhs, HInstruction* rhs, bool is_distance);
+  bool CanOverlapTail(int64_t trip_count);
 
   //
   // Helpers.
@@ -338,9 +352,15 @@ class HLoopOptimization : public HOptimization {
   uint32_t vector_static_peeling_factor_;
   const ArrayReference* vector_dynamic_peeling_candidate_;
 
-  // Dynamic data dependence test of the form a != b.
-  HInstruction* vector_runtime_test_a_;
-  HInstruction* vector_runtime_test_b_;
+  // Dynamic data dependence tests of the form a != b or |x - y| >= vector length.
+  // Contents reside in phase-local heap memory.
+  ScopedArenaVector<RuntimeTest>* vector_runtime_tests_;
+
+  // Remainder iterations handled by one more vector iteration that overlaps the
+  // previous one, rather than by a scalar cleanup loop. During vector loop synthesis,
+  // the tail index stc - VL that clamps the vector index.
+  bool vector_overlapped_tail_;
+  HInstruction* vector_tail_index_;
 
   // Mapping used during vectorization synthesis for both the scalar peeling/cleanup
   // loop (mode is kSequential) and the actual vector loop (mode is kVector). The data
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "loop_unswitching.h"
+
+#include "base/scoped_arena_allocator.h"
+#include "base/scoped_arena_containers.h"
+#include "superblock_cloner.h"
+
+namespace art {
+
+HLoopUnswitching::HLoopUnswitching(HGraph* graph,
+                                   const CodeGenerator& codegen,
+                                   OptimizingCompilerStats* stats,
+                                   const char* name)
+    : HOptimization(graph, name, stats),
+      arch_loop_helper_(ArchNoOptsLoopHelper::Create(codegen, graph->GetAllocator())) {}
+
+bool HLoopUnswitching::Run() {
+  // Skip if there is no loop or the graph has irreducible loops. OSR entries are looked up
+  // by the dex pc of loop headers, which versioning would duplicate.
+  if (!graph_->HasLoops() || graph_->HasIrreducibleLoops() || graph_->IsCompilingOsr()) {
+    return false;
+  }
+
+  // Collect the loop headers first, as every transformation adds a loop and recomputes
+  // the block orders.
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ScopedArenaVector<HBasicBlock*> headers(allocator.Adapter(kArenaAllocOptimization));
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    if (block->IsLoopHeader()) {
+      headers.push_back(block);
+    }
+  }
+
+  bool did_unswitch = false;
+  for (HBasicBlock* header : headers) {
+    HLoopInformation* loop_info = header->GetLoopInformation();
+    if (loop_info->GetHeader() == header && IsInnermostLoop(loop_info)) {
+      did_unswitch |= TryUnswitching(loop_info);
+    }
+  }
+  return did_unswitch;
+}
+
+bool HLoopUnswitching::IsInnermostLoop(HLoopInformation* loop_info) {
+  if (loop_info->IsIrreducible()) {
+    return false;
+  }
+  for (HBlocksInLoopIterator it(*loop_info); !it.Done(); it.Advance()) {
+    if (it.Current()->GetLoopInformation() != loop_info) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool HLoopUnswitching::TryUnswitching(HLoopInformation* loop_info) {
+  LoopAnalysisInfo analysis_info(loop_info);
+  LoopAnalysis::CalculateLoopBasicProperties(
+      loop_info, &analysis_info, LoopAnalysisInfo::kUnknownTripCount);
+  if (!arch_loop_helper_->IsLoopUnswitchingBeneficial(&analysis_info)) {
+    return false;
+  }
+
+  // Run 'IsLoopClonable' the last as it might be time-consuming.
+  if (!LoopClonerHelper::IsLoopClonable(loop_info)) {
+    return false;
+  }
+
+  HIf* branch = analysis_info.GetInvariantBranch();
+  HInstruction* cond = branch->InputAt(0);
+  HBasicBlock* preheader = loop_info->GetPreHeader();
+  if (loop_info->Contains(*cond->GetBlock())) {
+    // A comparison of values defined outside of the loop: evaluate it once, in the
+    // preheader, so that both copies of the loop share it.
+    DCHECK(cond->IsCondition());
+    cond->MoveBefore(preheader->GetLastInstruction());
+  }
+
+  LoopClonerSimpleHelper helper(loop_info, /* induction_range= */ nullptr);
+  helper.DoVersioning();
+
+  // The former preheader now flows into both copies of the loop; select the copy with
+  // the invariant condition.
+  DCHECK_EQ(preheader->GetSuccessors().size(), 2u);
+  DCHECK(preheader->GetLastInstruction()->IsGoto());
+  HIf* hif = new (graph_->GetAllocator()) HIf(cond, branch->GetDexPc());
+  preheader->ReplaceAndRemoveInstructionWith(preheader->GetLastInstruction(), hif);
+  EvaluateConditionInSuccessors(hif);
+
+  MaybeRecordStat(stats_, MethodCompilationStat::kLoopUnswitched);
+  return true;
+}
+
+void HLoopUnswitching::EvaluateConditionInSuccessors(HIf* hif) {
+  // Both copies of the loop still test the condition; each copy is entered through a single
+  // successor of `hif`, in which the outcome of the condition is statically known.
+  // Dead code elimination removes the branches made constant.
+  HInstruction* cond = hif->InputAt(0);
+  HBasicBlock* true_succ = hif->IfTrueSuccessor();
+  HBasicBlock* false_succ = hif->IfFalseSuccessor();
+  DCHECK_EQ(true_succ->GetPredecessors().size(), 1u);
+  DCHECK_EQ(false_succ->GetPredecessors().size(), 1u);
+
+  const HUseList<HInstruction*>& uses = cond->GetUses();
+  for (auto it = uses.begin(), end = uses.end(); it != end; /* ++it below */) {
+    HInstruction* user = it->GetUser();
+    size_t index = it->GetIndex();
+    HBasicBlock* user_block = user->GetBlock();
+    // Increment `it` now because `*it` may disappear thanks to user->ReplaceInput().
+    ++it;
+    if (true_succ->Dominates(user_block)) {
+      user->ReplaceInput(graph_->GetIntConstant(1), index);
+    } else if (false_succ->Dominates(user_block)) {
+      user->ReplaceInput(graph_->GetIntConstant(0), index);
+    }
+  }
+}
+
+}  // namespace art
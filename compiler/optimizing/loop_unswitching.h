@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_LOOP_UNSWITCHING_H_
+#define ART_COMPILER_OPTIMIZING_LOOP_UNSWITCHING_H_
+
+#include "loop_analysis.h"
+#include "nodes.h"
+#include "optimization.h"
+
+namespace art {
+
+class CodeGenerator;
+
+/**
+ * Loop unswitching. A branch inside a loop whose condition does not change
+ * across iterations, as in
+ *
+ *   for (int i = 0; i < n; i++) {
+ *     if (flag) { a[i] += 1; } else { a[i] -= 1; }
+ *   }
+ *
+ * is hoisted out of the loop by versioning the loop (see LoopClonerHelper::DoVersioning)
+ * and branching on the condition in front of the two copies. Each copy is then specialized
+ * for one outcome, which leaves straight-line loop bodies for bounds check elimination and
+ * vectorization. The size of the loops considered is bounded by the target loop helper
+ * (see ArchNoOptsLoopHelper::IsLoopUnswitchingBeneficial).
+ *
+ * This pass runs before side effects analysis, LICM and BCE, so that all of these see
+ * both specialized loops.
+ */
+class HLoopUnswitching : public HOptimization {
+ public:
+  HLoopUnswitching(HGraph* graph,
+                   const CodeGenerator& codegen,
+                   OptimizingCompilerStats* stats,
+                   const char* name = kLoopUnswitchingPassName);
+
+  bool Run() override;
+
+  static constexpr const char* kLoopUnswitchingPassName = "loop_unswitching";
+
+ private:
+  // Unswitches the given innermost loop on its invariant branch, if beneficial.
+  // Returns whether the graph was changed.
+  bool TryUnswitching(HLoopInformation* loop_info);
+
+  // Returns whether the loop is an innermost natural loop.
+  static bool IsInnermostLoop(HLoopInformation* loop_info);
+
+  // Replaces the uses of `cond` dominated by either successor of `hif` with the
+  // corresponding constant.
+  void EvaluateConditionInSuccessors(HIf* hif);
+
+  // Target-specific heuristics.
+  ArchNoOptsLoopHelper* arch_loop_helper_;
+
+  DISALLOW_COPY_AND_ASSIGN(HLoopUnswitching);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_LOOP_UNSWITCHING_H_
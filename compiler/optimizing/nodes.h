@@ -1093,6 +1093,7 @@ class HBasicBlock : public ArenaObject<kArenaAllocBasicBlock> {
         dex_pc_(dex_pc),
         lifetime_start_(kNoLifetime),
         lifetime_end_(kNoLifetime),
+        frequency_(1.0f),
         try_catch_information_(nullptr) {
     predecessors_.reserve(kDefaultNumberOfPredecessors);
     successors_.reserve(kDefaultNumberOfSuccessors);
@@ -1425,6 +1426,11 @@ class HBasicBlock : public ArenaObject<kArenaAllocBasicBlock> {
   void SetLifetimeStart(size_t start) { lifetime_start_ = start; }
   void SetLifetimeEnd(size_t end) { lifetime_end_ = end; }
 
+  // Estimated number of executions of this block per execution of the method,
+  // as computed by BlockFrequencyAnalysis. All blocks are equally frequent until then.
+  float GetFrequency() const { return frequency_; }
+  void SetFrequency(float frequency) { frequency_ = frequency; }
+
   bool EndsWithControlFlowInstruction() const;
   bool EndsWithReturn() const;
   bool EndsWithIf() const;
@@ -1445,6 +1451,7 @@ class HBasicBlock : public ArenaObject<kArenaAllocBasicBlock> {
   const uint32_t dex_pc_;
   size_t lifetime_start_;
   size_t lifetime_end_;
+  float frequency_;
   TryCatchInformation* try_catch_information_;
 
   friend class HGraph;
@@ -3460,7 +3467,9 @@ class HDoubleConstant final : public HConstant {
 class HIf final : public HExpression<1> {
  public:
   explicit HIf(HInstruction* input, uint32_t dex_pc = kNoDexPc)
-      : HExpression(kIf, SideEffects::None(), dex_pc) {
+      : HExpression(kIf, SideEffects::None(), dex_pc),
+        true_count_(0u),
+        false_count_(0u) {
     SetRawInputAt(0, input);
   }
 
@@ -3475,10 +3484,22 @@ class HIf final : public HExpression<1> {
     return GetBlock()->GetSuccessors()[1];
   }
 
+  // Number of times each successor was taken at runtime, as profiled by
+  // baseline compiled code. Both are zero if no profile is available.
+  void SetTrueCount(uint16_t count) { true_count_ = count; }
+  uint16_t GetTrueCount() const { return true_count_; }
+
+  void SetFalseCount(uint16_t count) { false_count_ = count; }
+  uint16_t GetFalseCount() const { return false_count_; }
+
   DECLARE_INSTRUCTION(If);
 
  protected:
   DEFAULT_COPY_CONSTRUCTOR(If);
+
+ private:
+  uint16_t true_count_;
+  uint16_t false_count_;
 };
 
 
@@ -4702,6 +4723,12 @@ class HInvoke : public HVariableInputSizeInstruction {
 
   bool AlwaysThrows() const override { return GetPackedFlag<kFlagAlwaysThrows>(); }
 
+  // The inliner may prove that the callee never returns null (see HInliner::TryInline).
+  bool CanBeNull() const override {
+    return GetType() == DataType::Type::kReference && GetPackedFlag<kFlagCanBeNull>();
+  }
+  void SetCanBeNull(bool can_be_null) { SetPackedFlag<kFlagCanBeNull>(can_be_null); }
+
   bool CanBeMoved() const override { return IsIntrinsic() && !DoesAnyWrite(); }
 
   bool InstructionDataEquals(const HInstruction* other) const override {
@@ -4735,7 +4762,8 @@ class HInvoke : public HVariableInputSizeInstruction {
       MinimumBitsToStore(static_cast<size_t>(kMaxInvokeType));
   static constexpr size_t kFlagCanThrow = kFieldInvokeType + kFieldInvokeTypeSize;
   static constexpr size_t kFlagAlwaysThrows = kFlagCanThrow + 1;
-  static constexpr size_t kNumberOfInvokePackedBits = kFlagAlwaysThrows + 1;
+  static constexpr size_t kFlagCanBeNull = kFlagAlwaysThrows + 1;
+  static constexpr size_t kNumberOfInvokePackedBits = kFlagCanBeNull + 1;
   static_assert(kNumberOfInvokePackedBits <= kMaxNumberOfPackedBits, "Too many packed fields.");
   using InvokeTypeField = BitField<InvokeType, kFieldInvokeType, kFieldInvokeTypeSize>;
 
@@ -4764,6 +4792,7 @@ class HInvoke : public HVariableInputSizeInstruction {
       intrinsic_optimizations_(0) {
     SetPackedField<InvokeTypeField>(invoke_type);
     SetPackedFlag<kFlagCanThrow>(true);
+    SetPackedFlag<kFlagCanBeNull>(true);
     SetResolvedMethod(resolved_method);
   }
 
@@ -4977,7 +5006,7 @@ class HInvokeStaticOrDirect final : public HInvoke {
   }
 
   bool CanBeNull() const override {
-    return GetType() == DataType::Type::kReference && !IsStringInit();
+    return HInvoke::CanBeNull() && !IsStringInit();
   }
 
   MethodLoadKind GetMethodLoadKind() const { return dispatch_info_.method_load_kind; }
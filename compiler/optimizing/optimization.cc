@@ -51,10 +51,13 @@
 #include "licm.h"
 #include "load_store_elimination.h"
 #include "loop_optimization.h"
+#include "loop_unswitching.h"
+#include "partial_redundancy_elimination.h"
 #include "scheduler.h"
 #include "select_generator.h"
 #include "sharpening.h"
 #include "side_effects_analysis.h"
+#include "superword_vectorizer.h"
 
 // Decide between default or alternative pass name.
 
@@ -72,6 +75,8 @@ const char* OptimizationPassName(OptimizationPass pass) {
       return LICM::kLoopInvariantCodeMotionPassName;
     case OptimizationPass::kLoopOptimization:
       return HLoopOptimization::kLoopOptimizationPassName;
+    case OptimizationPass::kLoopUnswitching:
+      return HLoopUnswitching::kLoopUnswitchingPassName;
     case OptimizationPass::kBoundsCheckElimination:
       return BoundsCheckElimination::kBoundsCheckEliminationPassName;
     case OptimizationPass::kLoadStoreElimination:
@@ -93,8 +98,12 @@ const char* OptimizationPassName(OptimizationPass pass) {
       return CodeSinking::kCodeSinkingPassName;
     case OptimizationPass::kConstructorFenceRedundancyElimination:
       return ConstructorFenceRedundancyElimination::kCFREPassName;
+    case OptimizationPass::kPartialRedundancyElimination:
+      return PartialRedundancyElimination::kPartialRedundancyEliminationPassName;
     case OptimizationPass::kScheduling:
       return HInstructionScheduling::kInstructionSchedulingPassName;
+    case OptimizationPass::kSuperwordVectorizer:
+      return HSuperwordVectorizer::kSuperwordVectorizerPassName;
 #ifdef ART_ENABLE_CODEGEN_arm
     case OptimizationPass::kInstructionSimplifierArm:
       return arm::InstructionSimplifierArm::kInstructionSimplifierArmPassName;
@@ -141,9 +150,12 @@ OptimizationPass OptimizationPassByName(const std::string& pass_name) {
   X(OptimizationPass::kInvariantCodeMotion);
   X(OptimizationPass::kLoadStoreElimination);
   X(OptimizationPass::kLoopOptimization);
+  X(OptimizationPass::kLoopUnswitching);
+  X(OptimizationPass::kPartialRedundancyElimination);
   X(OptimizationPass::kScheduling);
   X(OptimizationPass::kSelectGenerator);
   X(OptimizationPass::kSideEffectsAnalysis);
+  X(OptimizationPass::kSuperwordVectorizer);
 #ifdef ART_ENABLE_CODEGEN_arm
   X(OptimizationPass::kInstructionSimplifierArm);
   X(OptimizationPass::kCriticalNativeAbiFixupArm);
@@ -267,10 +279,19 @@ ArenaVector<HOptimization*> ConstructOptimizations(
       case OptimizationPass::kLoadStoreElimination:
         opt = new (allocator) LoadStoreElimination(graph, stats, pass_name);
         break;
+      case OptimizationPass::kLoopUnswitching:
+        opt = new (allocator) HLoopUnswitching(graph, *codegen, stats, pass_name);
+        break;
+      case OptimizationPass::kPartialRedundancyElimination:
+        opt = new (allocator) PartialRedundancyElimination(graph, stats, pass_name);
+        break;
       case OptimizationPass::kScheduling:
         opt = new (allocator) HInstructionScheduling(
             graph, codegen->GetCompilerOptions().GetInstructionSet(), codegen, pass_name);
         break;
+      case OptimizationPass::kSuperwordVectorizer:
+        opt = new (allocator) HSuperwordVectorizer(graph, *codegen, stats, pass_name);
+        break;
       //
       // Arch-specific passes.
       //
@@ -80,9 +80,12 @@ enum class OptimizationPass {
   kInvariantCodeMotion,
   kLoadStoreElimination,
   kLoopOptimization,
+  kLoopUnswitching,
+  kPartialRedundancyElimination,
   kScheduling,
   kSelectGenerator,
   kSideEffectsAnalysis,
+  kSuperwordVectorizer,
 #ifdef ART_ENABLE_CODEGEN_arm
   kInstructionSimplifierArm,
   kCriticalNativeAbiFixupArm,
@@ -31,6 +31,7 @@
 #include "base/mutex.h"
 #include "base/scoped_arena_allocator.h"
 #include "base/timing_logger.h"
+#include "block_frequency.h"
 #include "builder.h"
 #include "code_generator.h"
 #include "compiled_method.h"
@@ -558,7 +559,8 @@ bool OptimizingCompiler::RunArchOptimizations(HGraph* graph,
         OptDef(OptimizationPass::kInstructionSimplifierX86_64),
         OptDef(OptimizationPass::kSideEffectsAnalysis),
         OptDef(OptimizationPass::kGlobalValueNumbering, "GVN$after_arch"),
-        OptDef(OptimizationPass::kX86MemoryOperandGeneration)
+        OptDef(OptimizationPass::kX86MemoryOperandGeneration),
+        OptDef(OptimizationPass::kScheduling)
       };
       return RunOptimizations(graph,
                               codegen,
@@ -583,6 +585,11 @@ static void AllocateRegisters(HGraph* graph,
                     pass_observer);
     PrepareForRegisterAllocation(graph, codegen->GetCompilerOptions(), stats).Run();
   }
+  {
+    // Block frequencies drive the block layout and the register allocator.
+    PassScope scope(BlockFrequencyAnalysis::kBlockFrequencyPassName, pass_observer);
+    BlockFrequencyAnalysis(graph, stats).Run();
+  }
   // Use local allocator shared by SSA liveness analysis and register allocator.
   // (Register allocator creates new objects in the liveness data.)
   ScopedArenaAllocator local_allocator(graph->GetArenaStack());
@@ -651,6 +658,7 @@ void OptimizingCompiler::RunOptimizations(HGraph* graph,
     OptDef(OptimizationPass::kSideEffectsAnalysis,
            "side_effects$before_gvn"),
     OptDef(OptimizationPass::kGlobalValueNumbering),
+    OptDef(OptimizationPass::kPartialRedundancyElimination),
     // Simplification (TODO: only if GVN occurred).
     OptDef(OptimizationPass::kSelectGenerator),
     OptDef(OptimizationPass::kConstantFolding,
@@ -659,6 +667,10 @@ void OptimizingCompiler::RunOptimizations(HGraph* graph,
            "instruction_simplifier$after_gvn"),
     OptDef(OptimizationPass::kDeadCodeElimination,
            "dead_code_elimination$after_gvn"),
+    OptDef(OptimizationPass::kLoopUnswitching),
+    OptDef(OptimizationPass::kDeadCodeElimination,
+           "dead_code_elimination$after_unswitching",
+           OptimizationPass::kLoopUnswitching),
     // High-level optimizations.
     OptDef(OptimizationPass::kSideEffectsAnalysis,
            "side_effects$before_licm"),
@@ -666,6 +678,7 @@ void OptimizingCompiler::RunOptimizations(HGraph* graph,
     OptDef(OptimizationPass::kInductionVarAnalysis),
     OptDef(OptimizationPass::kBoundsCheckElimination),
     OptDef(OptimizationPass::kLoopOptimization),
+    OptDef(OptimizationPass::kSuperwordVectorizer),
     // Simplification.
     OptDef(OptimizationPass::kConstantFolding,
            "constant_folding$after_bce"),
@@ -736,6 +749,21 @@ CompiledMethod* OptimizingCompiler::Emit(ArenaAllocator* allocator,
   return compiled_method;
 }
 
+static size_t ArenaBytesUsed(ArenaAllocator* allocator, ArenaStack* arena_stack) {
+  return allocator->BytesUsed() + arena_stack->ApproximatePeakBytes();
+}
+
+// Baseline compilations run few passes and are the fallback when the optimizing pipeline runs
+// out of memory, so only optimized and OSR JIT compilations are held to the budget.
+bool ExceedsJitArenaMemoryBudget(const CompilerOptions& compiler_options,
+                                 CompilationKind compilation_kind,
+                                 ArenaAllocator* allocator,
+                                 ArenaStack* arena_stack) {
+  return compiler_options.IsJitCompiler() &&
+         compilation_kind != CompilationKind::kBaseline &&
+         ArenaBytesUsed(allocator, arena_stack) > kJitArenaMemoryBudget;
+}
+
 CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
                                               ArenaStack* arena_stack,
                                               CodeVectorAllocator* code_allocator,
@@ -887,12 +915,24 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
     }
   }
 
+  if (ExceedsJitArenaMemoryBudget(compiler_options, compilation_kind, allocator, arena_stack)) {
+    MaybeRecordStat(compilation_stats_.get(), MethodCompilationStat::kJitOutOfArenaMemory);
+    return nullptr;
+  }
+
   if (compilation_kind == CompilationKind::kBaseline) {
     RunBaselineOptimizations(graph, codegen.get(), dex_compilation_unit, &pass_observer);
   } else {
     RunOptimizations(graph, codegen.get(), dex_compilation_unit, &pass_observer);
   }
 
+  // The register allocator and the code generator are the largest consumers of arena memory
+  // for big graphs, so check the budget again before running them.
+  if (ExceedsJitArenaMemoryBudget(compiler_options, compilation_kind, allocator, arena_stack)) {
+    MaybeRecordStat(compilation_stats_.get(), MethodCompilationStat::kJitOutOfArenaMemory);
+    return nullptr;
+  }
+
   RegisterAllocator::Strategy regalloc_strategy =
     compiler_options.GetRegisterAllocationStrategy();
   AllocateRegisters(graph,
@@ -1336,6 +1376,33 @@ bool OptimizingCompiler::JitCompile(Thread* self,
                    method,
                    compilation_kind,
                    &handles));
+    if (codegen.get() == nullptr &&
+        compilation_kind == CompilationKind::kOptimized &&
+        ExceedsJitArenaMemoryBudget(compiler_options, compilation_kind, &allocator, &arena_stack) &&
+        code_cache->GetProfilingInfo(method, self) != nullptr &&
+        !code_cache->ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
+      // The optimizing pipeline ran out of memory. Give the method baseline code rather
+      // than leaving it in the interpreter; the memory of the failed attempt stays in
+      // `allocator`, but baseline compilation needs only a small fraction of the budget.
+      //
+      // This only applies to methods without JIT code. A baseline method whose optimized
+      // recompilation runs over the budget keeps its baseline code, which requests the
+      // optimized compilation again each time its hotness counter expires. Such a method
+      // therefore costs one abandoned compilation per optimize threshold of invocations.
+      MaybeRecordStat(compilation_stats_.get(),
+                      MethodCompilationStat::kJitFallbackToBaselineForArenaMemory);
+      compilation_kind = CompilationKind::kBaseline;
+      codegen.reset(
+          TryCompile(&allocator,
+                     &arena_stack,
+                     &code_allocator,
+                     dex_compilation_unit,
+                     method,
+                     compilation_kind,
+                     &handles));
+    }
+    runtime->GetMetrics()->JitMethodCompileArenaPeakKb()->Add(
+        ArenaBytesUsed(&allocator, &arena_stack) / KB);
     if (codegen.get() == nullptr) {
       return false;
     }
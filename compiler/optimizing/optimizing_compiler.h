@@ -19,9 +19,12 @@
 
 #include "base/globals.h"
 #include "base/mutex.h"
+#include "compilation_kind.h"
 
 namespace art {
 
+class ArenaAllocator;
+class ArenaStack;
 class ArtMethod;
 class Compiler;
 class CompiledMethodStorage;
@@ -33,6 +36,17 @@ Compiler* CreateOptimizingCompiler(const CompilerOptions& compiler_options,
 
 bool EncodeArtMethodInInlineInfo(ArtMethod* method);
 
+// Arena memory an optimized or OSR JIT compilation may use before it is abandoned. Huge
+// methods can otherwise grow the JIT arena pool by hundreds of MB for a single compilation.
+static constexpr size_t kJitArenaMemoryBudget = 64 * MB;
+
+// Returns whether a compilation of kind `compilation_kind` went over its arena budget,
+// counting the memory of both `allocator` and `arena_stack`.
+bool ExceedsJitArenaMemoryBudget(const CompilerOptions& compiler_options,
+                                 CompilationKind compilation_kind,
+                                 ArenaAllocator* allocator,
+                                 ArenaStack* arena_stack);
+
 }  // namespace art
 
 #endif  // ART_COMPILER_OPTIMIZING_OPTIMIZING_COMPILER_H_
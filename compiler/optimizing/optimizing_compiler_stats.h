@@ -36,6 +36,7 @@ enum class MethodCompilationStat {
   kCompiledIntrinsic,
   kCompiledBytecode,
   kCHAInline,
+  kCHADevirtualized,
   kInlinedInvoke,
   kInlinedLastInvoke,
   kReplacedInvokeWithSimplePattern,
@@ -63,6 +64,7 @@ enum class MethodCompilationStat {
   kNotCompiledPhiEquivalentInOsr,
   kInlinedMonomorphicCall,
   kInlinedPolymorphicCall,
+  kInlinedMegamorphicCall,
   kMonomorphicCall,
   kPolymorphicCall,
   kMegamorphicCall,
@@ -71,6 +73,7 @@ enum class MethodCompilationStat {
   kLoopInvariantMoved,
   kLoopVectorized,
   kLoopVectorizedIdiom,
+  kSuperwordVectorized,
   kSelectGenerated,
   kRemovedInstanceOf,
   kInlinedInvokeVirtualOrInterface,
@@ -80,6 +83,8 @@ enum class MethodCompilationStat {
   kSimplifyIf,
   kSimplifyThrowingInvoke,
   kInstructionSunk,
+  kPartialRedundancyEliminated,
+  kLoopUnswitched,
   kNotInlinedUnresolvedEntrypoint,
   kNotInlinedBss,
   kNotInlinedDexCacheInaccessibleToCaller,
@@ -98,6 +103,7 @@ enum class MethodCompilationStat {
   kNotInlinedNotCompilable,
   kNotInlinedNotVerified,
   kNotInlinedCodeItem,
+  kNotInlinedColdCallSite,
   kNotInlinedWont,
   kNotInlinedRecursiveBudget,
   kNotInlinedPolymorphicRecursiveBudget,
@@ -113,6 +119,8 @@ enum class MethodCompilationStat {
   kConstructorFenceRemovedCFRE,
   kBitstringTypeCheck,
   kJitOutOfMemoryForCommit,
+  kJitOutOfArenaMemory,
+  kJitFallbackToBaselineForArenaMemory,
   kFullLSEAllocationRemoved,
   kFullLSEPossible,
   kNonPartialLoadRemoved,
@@ -122,6 +130,7 @@ enum class MethodCompilationStat {
   kPredicatedLoadAdded,
   kPredicatedStoreAdded,
   kDevirtualized,
+  kRefinedReturnType,
   kLastStat
 };
 std::ostream& operator<<(std::ostream& os, MethodCompilationStat rhs);
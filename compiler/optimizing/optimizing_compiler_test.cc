@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "optimizing_compiler.h"
+
+#include "base/arena_allocator.h"
+#include "base/common_art_test.h"
+#include "base/malloc_arena_pool.h"
+#include "base/scoped_arena_allocator.h"
+#include "driver/compiler_options.h"
+#include "gtest/gtest.h"
+
+namespace art {
+
+class OptimizingCompilerTest : public CommonArtTest {
+ protected:
+  static std::unique_ptr<CompilerOptions> CreateCompilerOptions(
+      CompilerOptions::CompilerType compiler_type) {
+    std::unique_ptr<CompilerOptions> compiler_options(new CompilerOptions());
+    compiler_options->compiler_type_ = compiler_type;
+    return compiler_options;
+  }
+};
+
+TEST_F(OptimizingCompilerTest, JitArenaMemoryBudget) {
+  std::unique_ptr<CompilerOptions> jit_options =
+      CreateCompilerOptions(CompilerOptions::CompilerType::kJitCompiler);
+  std::unique_ptr<CompilerOptions> aot_options =
+      CreateCompilerOptions(CompilerOptions::CompilerType::kAotCompiler);
+  MallocArenaPool pool;
+  ArenaAllocator allocator(&pool);
+  ArenaStack arena_stack(&pool);
+
+  // Half of the budget in each allocator stays within the budget.
+  allocator.Alloc(kJitArenaMemoryBudget / 2);
+  ScopedArenaAllocator scoped_allocator(&arena_stack);
+  scoped_allocator.Alloc(kJitArenaMemoryBudget / 2 - KB);
+  EXPECT_FALSE(ExceedsJitArenaMemoryBudget(
+      *jit_options, CompilationKind::kOptimized, &allocator, &arena_stack));
+
+  // The arena stack counts towards the budget as well.
+  scoped_allocator.Alloc(2 * KB);
+  EXPECT_TRUE(ExceedsJitArenaMemoryBudget(
+      *jit_options, CompilationKind::kOptimized, &allocator, &arena_stack));
+  EXPECT_TRUE(ExceedsJitArenaMemoryBudget(
+      *jit_options, CompilationKind::kOsr, &allocator, &arena_stack));
+
+  // Baseline compilation is the fallback once the budget is exceeded, and AOT
+  // compilation is not limited.
+  EXPECT_FALSE(ExceedsJitArenaMemoryBudget(
+      *jit_options, CompilationKind::kBaseline, &allocator, &arena_stack));
+  EXPECT_FALSE(ExceedsJitArenaMemoryBudget(
+      *aot_options, CompilationKind::kOptimized, &allocator, &arena_stack));
+}
+
+}  // namespace art
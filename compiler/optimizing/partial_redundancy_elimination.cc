@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "partial_redundancy_elimination.h"
+
+#include <algorithm>
+
+#include "base/scoped_arena_allocator.h"
+#include "base/scoped_arena_containers.h"
+#include "optimizing/optimizing_compiler_stats.h"
+#include "reference_type_propagation.h"
+
+namespace art {
+
+// Returns whether `instruction` computes a pure function of its inputs that
+// can be recomputed anywhere its inputs and heap state are available.
+static bool IsCandidate(HInstruction* instruction) {
+  return instruction->CanBeMoved() &&
+      instruction->IsClonable() &&
+      !instruction->CanThrow() &&
+      !instruction->NeedsEnvironment() &&
+      !instruction->IsBoundType() &&  // Only valid where its type guard holds.
+      instruction->GetType() != DataType::Type::kVoid;
+}
+
+// Returns the value of `input`, an input of an instruction in `block`, on the
+// edge from the predecessor at `predecessor_index`.
+static HInstruction* TranslateInput(HInstruction* input,
+                                    HBasicBlock* block,
+                                    size_t predecessor_index) {
+  return (input->IsPhi() && input->GetBlock() == block)
+      ? input->InputAt(predecessor_index)
+      : input;
+}
+
+// Returns whether all inputs of `instruction` are available on entry to its
+// block: they are either phis of the block or defined in a strict dominator.
+static bool InputsAreAvailableOnEntry(HInstruction* instruction) {
+  HBasicBlock* block = instruction->GetBlock();
+  for (HInstruction* input : instruction->GetInputs()) {
+    if (input->GetBlock() == block ? !input->IsPhi() : !input->GetBlock()->Dominates(block)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns whether `other` computes the value `instruction` would compute on
+// the edge from the predecessor at `predecessor_index`. See HInstruction::Equals().
+static bool IsEquivalentOnEdge(HInstruction* instruction,
+                               HInstruction* other,
+                               size_t predecessor_index) {
+  if (other->GetKind() != instruction->GetKind() ||
+      other->GetType() != instruction->GetType() ||
+      other->InputCount() != instruction->InputCount() ||
+      !instruction->InstructionDataEquals(other)) {
+    return false;
+  }
+  HBasicBlock* block = instruction->GetBlock();
+  for (size_t i = 0, e = instruction->InputCount(); i != e; ++i) {
+    if (other->InputAt(i) != TranslateInput(instruction->InputAt(i), block, predecessor_index)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+HInstruction* PartialRedundancyElimination::FindAvailableValue(HInstruction* instruction,
+                                                               size_t predecessor_index) const {
+  HBasicBlock* block = instruction->GetBlock();
+  HBasicBlock* dominator = block->GetDominator();
+  SideEffects side_effects = instruction->GetSideEffects();
+  // Walk up the chain of single predecessors to the dominator of the merge block.
+  // Values computed in the dominator, or before it, are the business of GVN.
+  for (HBasicBlock* current = block->GetPredecessors()[predecessor_index];
+       current != dominator;
+       current = current->GetSinglePredecessor()) {
+    for (HBackwardInstructionIterator it(current->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* other = it.Current();
+      if (IsEquivalentOnEdge(instruction, other, predecessor_index)) {
+        return other;
+      }
+      if (side_effects.MayDependOn(other->GetSideEffects())) {
+        return nullptr;
+      }
+    }
+    if (current->GetPredecessors().size() != 1u) {
+      return nullptr;
+    }
+  }
+  return nullptr;
+}
+
+bool PartialRedundancyElimination::TryReplaceWithPhi(HInstruction* instruction) {
+  HBasicBlock* block = instruction->GetBlock();
+  size_t number_of_predecessors = block->GetPredecessors().size();
+
+  // Local allocator to discard data structures created below at the end of this optimization.
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ScopedArenaVector<HInstruction*> values(
+      number_of_predecessors, nullptr, allocator.Adapter(kArenaAllocMisc));
+  size_t missing_index = number_of_predecessors;
+  for (size_t i = 0; i != number_of_predecessors; ++i) {
+    values[i] = FindAvailableValue(instruction, i);
+    if (values[i] == nullptr) {
+      if (missing_index != number_of_predecessors) {
+        // Only copy the instruction to one predecessor, to limit code growth.
+        return false;
+      }
+      missing_index = i;
+    }
+  }
+
+  // Compute the value on the edge where it is missing.
+  if (missing_index != number_of_predecessors) {
+    HBasicBlock* predecessor = block->GetPredecessors()[missing_index];
+    HInstruction* copy = instruction->Clone(graph_->GetAllocator());
+    for (size_t i = 0, e = instruction->InputCount(); i != e; ++i) {
+      copy->SetRawInputAt(i, TranslateInput(instruction->InputAt(i), block, missing_index));
+    }
+    predecessor->InsertInstructionBefore(copy, predecessor->GetLastInstruction());
+    values[missing_index] = copy;
+  }
+
+  HInstruction* replacement = values[0];
+  if (std::any_of(values.begin(), values.end(), [&](HInstruction* v) { return v != values[0]; })) {
+    ArenaAllocator* graph_allocator = graph_->GetAllocator();
+    HPhi* phi = new (graph_allocator) HPhi(graph_allocator,
+                                           kNoRegNumber,
+                                           number_of_predecessors,
+                                           HPhi::ToPhiType(instruction->GetType()));
+    for (size_t i = 0; i != number_of_predecessors; ++i) {
+      phi->SetRawInputAt(i, values[i]);
+    }
+    block->AddPhi(phi);
+    if (phi->GetType() == DataType::Type::kReference) {
+      // Update reference type information. Pass invalid handles, these are not used for Phis.
+      ReferenceTypePropagation rtp_fixup(graph_,
+                                         Handle<mirror::ClassLoader>(),
+                                         Handle<mirror::DexCache>(),
+                                         /* is_first_run= */ false);
+      rtp_fixup.Visit(phi);
+    }
+    replacement = phi;
+  }
+  instruction->ReplaceWith(replacement);
+  block->RemoveInstruction(instruction);
+  MaybeRecordStat(stats_, MethodCompilationStat::kPartialRedundancyEliminated);
+  return true;
+}
+
+bool PartialRedundancyElimination::VisitMergeBlock(HBasicBlock* block) {
+  bool replaced = false;
+  // Side effects of the instructions of `block` seen so far. An instruction is
+  // anticipated on entry to `block` only if it does not depend on them.
+  SideEffects side_effects = SideEffects::None();
+  for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+    if (IsCandidate(instruction) &&
+        !instruction->GetSideEffects().MayDependOn(side_effects) &&
+        InputsAreAvailableOnEntry(instruction) &&
+        TryReplaceWithPhi(instruction)) {
+      replaced = true;
+    } else {
+      side_effects = side_effects.Union(instruction->GetSideEffects());
+    }
+  }
+  return replaced;
+}
+
+bool PartialRedundancyElimination::Run() {
+  bool changed = false;
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    if (block->GetPredecessors().size() < 2u ||
+        block->IsLoopHeader() ||
+        block->IsCatchBlock()) {
+      continue;
+    }
+    // Critical edges are split, so each predecessor only flows into `block`.
+    // Bail if a predecessor enters or leaves a try block, since the value
+    // could not be computed on the edge.
+    bool all_gotos = true;
+    for (HBasicBlock* predecessor : block->GetPredecessors()) {
+      all_gotos = all_gotos && predecessor->GetLastInstruction()->IsGoto();
+    }
+    if (all_gotos && VisitMergeBlock(block)) {
+      changed = true;
+    }
+  }
+  return changed;
+}
+
+}  // namespace art
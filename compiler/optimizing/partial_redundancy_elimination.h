@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_PARTIAL_REDUNDANCY_ELIMINATION_H_
+#define ART_COMPILER_OPTIMIZING_PARTIAL_REDUNDANCY_ELIMINATION_H_
+
+#include "nodes.h"
+#include "optimization.h"
+
+namespace art {
+
+/**
+ * Partial redundancy elimination of movable instructions at control-flow merges,
+ * such as the field load and the array length in
+ *
+ *   if (cond) {
+ *     x = a.f;
+ *   } else {
+ *     ...
+ *   }
+ *   y = a.f;
+ *   n = y.length;
+ *
+ * An instruction at the start of a merge block whose value is already available at
+ * the end of some predecessors (computed there, with no conflicting side effects
+ * after it) is replaced by a phi of these values. The instruction is copied to the
+ * end of the predecessor where it is not available, if there is only one such
+ * predecessor, so that no path executes more instructions than before. Inputs that
+ * are phis of the merge block are translated to their value on each incoming edge,
+ * so chains of loads like the one above are eliminated together.
+ *
+ * Instructions redundant with a dominating one are left to GVN, and loop-invariant
+ * ones to LICM.
+ */
+class PartialRedundancyElimination : public HOptimization {
+ public:
+  PartialRedundancyElimination(HGraph* graph,
+                               OptimizingCompilerStats* stats,
+                               const char* name = kPartialRedundancyEliminationPassName)
+      : HOptimization(graph, name, stats) {}
+
+  bool Run() override;
+
+  static constexpr const char* kPartialRedundancyEliminationPassName = "PRE";
+
+ private:
+  // Tries to eliminate the instructions of the given merge block. Returns true
+  // if any instruction was replaced.
+  bool VisitMergeBlock(HBasicBlock* block);
+
+  // Tries to replace `instruction`, which is anticipated on entry to its block,
+  // by a phi. Returns true on success.
+  bool TryReplaceWithPhi(HInstruction* instruction);
+
+  // Returns an instruction computing the value of `instruction` on the edge
+  // from the predecessor at `predecessor_index`, or null if there is none.
+  HInstruction* FindAvailableValue(HInstruction* instruction, size_t predecessor_index) const;
+
+  DISALLOW_COPY_AND_ASSIGN(PartialRedundancyElimination);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_PARTIAL_REDUNDANCY_ELIMINATION_H_
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "partial_redundancy_elimination.h"
+
+#include "nodes.h"
+#include "optimizing_unit_test.h"
+
+namespace art {
+
+class PartialRedundancyEliminationTest : public OptimizingUnitTest {
+ protected:
+  // Builds the diamond
+  //
+  //     entry
+  //     /   \
+  //  left   right
+  //     \   /
+  //    breturn
+  //
+  // with a field load of `obj_` in `left` and in `breturn`.
+  void BuildDiamond() {
+    CreateGraph();
+    AdjacencyListGraph blks(SetupFromAdjacencyList("entry",
+                                                   "exit",
+                                                   {{"entry", "left"},
+                                                    {"entry", "right"},
+                                                    {"left", "breturn"},
+                                                    {"right", "breturn"},
+                                                    {"breturn", "exit"}}));
+    entry_ = blks.Get("entry");
+    left_ = blks.Get("left");
+    right_ = blks.Get("right");
+    breturn_ = blks.Get("breturn");
+    EnsurePredecessorOrder(breturn_, {left_, right_});
+
+    HInstruction* bool_value = MakeParam(DataType::Type::kBool);
+    obj_ = MakeParam(DataType::Type::kReference);
+    entry_->AddInstruction(new (GetAllocator()) HIf(bool_value));
+
+    left_get_ = MakeIFieldGet(obj_, DataType::Type::kInt32, MemberOffset(32));
+    left_->AddInstruction(left_get_);
+    left_->AddInstruction(new (GetAllocator()) HGoto());
+    right_->AddInstruction(new (GetAllocator()) HGoto());
+
+    get_ = MakeIFieldGet(obj_, DataType::Type::kInt32, MemberOffset(32));
+    breturn_->AddInstruction(get_);
+    breturn_->AddInstruction(new (GetAllocator()) HReturn(get_));
+    SetupExit(blks.Get("exit"));
+  }
+
+  void PerformPRE() {
+    graph_->BuildDominatorTree();
+    PartialRedundancyElimination(graph_, /* stats= */ nullptr).Run();
+    std::ostringstream oss;
+    EXPECT_TRUE(CheckGraphSkipRefTypeInfoChecks(oss)) << oss.str();
+  }
+
+  HBasicBlock* entry_;
+  HBasicBlock* left_;
+  HBasicBlock* right_;
+  HBasicBlock* breturn_;
+  HInstruction* obj_;
+  HInstruction* left_get_;
+  HInstruction* get_;
+};
+
+// if (param) {
+//   a = obj.field;
+// }
+// return obj.field;
+TEST_F(PartialRedundancyEliminationTest, PartiallyRedundantLoad) {
+  BuildDiamond();
+  HInstruction* ret = breturn_->GetLastInstruction();
+
+  PerformPRE();
+
+  EXPECT_EQ(get_->GetBlock(), nullptr);
+  ASSERT_TRUE(ret->InputAt(0)->IsPhi());
+  HInstruction* phi = ret->InputAt(0);
+  EXPECT_EQ(phi->GetBlock(), breturn_);
+  EXPECT_EQ(phi->InputAt(0), left_get_);
+  HInstruction* copy = phi->InputAt(1);
+  ASSERT_TRUE(copy->IsInstanceFieldGet());
+  EXPECT_EQ(copy->GetBlock(), right_);
+  EXPECT_EQ(copy->InputAt(0), obj_);
+}
+
+// if (param) {
+//   a = obj.field;
+//   obj.field = 1;
+// }
+// return obj.field;
+TEST_F(PartialRedundancyEliminationTest, KilledByStore) {
+  BuildDiamond();
+  HInstruction* store = MakeIFieldSet(obj_, graph_->GetIntConstant(1), MemberOffset(32));
+  left_->InsertInstructionBefore(store, left_->GetLastInstruction());
+
+  PerformPRE();
+
+  EXPECT_EQ(get_->GetBlock(), breturn_);
+  EXPECT_EQ(right_->GetFirstInstruction(), right_->GetLastInstruction());
+}
+
+// if (param) {
+//   a = obj.field + 1;
+// }
+// return obj.field + 1;
+TEST_F(PartialRedundancyEliminationTest, TranslatesPhiInputs) {
+  BuildDiamond();
+  HInstruction* one = graph_->GetIntConstant(1);
+  HInstruction* left_add = new (GetAllocator()) HAdd(DataType::Type::kInt32, left_get_, one);
+  left_->InsertInstructionBefore(left_add, left_->GetLastInstruction());
+  HInstruction* ret = breturn_->GetLastInstruction();
+  HInstruction* add = new (GetAllocator()) HAdd(DataType::Type::kInt32, get_, one);
+  breturn_->InsertInstructionBefore(add, ret);
+  ret->ReplaceInput(add, 0);
+
+  PerformPRE();
+
+  EXPECT_EQ(get_->GetBlock(), nullptr);
+  EXPECT_EQ(add->GetBlock(), nullptr);
+  ASSERT_TRUE(ret->InputAt(0)->IsPhi());
+  HInstruction* phi = ret->InputAt(0);
+  EXPECT_EQ(phi->InputAt(0), left_add);
+  HInstruction* add_copy = phi->InputAt(1);
+  ASSERT_TRUE(add_copy->IsAdd());
+  EXPECT_EQ(add_copy->GetBlock(), right_);
+  ASSERT_TRUE(add_copy->InputAt(0)->IsInstanceFieldGet());
+  EXPECT_EQ(add_copy->InputAt(0)->GetBlock(), right_);
+}
+
+}  // namespace art
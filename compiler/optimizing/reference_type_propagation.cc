@@ -902,6 +902,11 @@ void ReferenceTypePropagation::RTPVisitor::VisitInvoke(HInvoke* instr) {
   if (instr->GetType() != DataType::Type::kReference) {
     return;
   }
+  // We check if the existing type is exact: the inliner may have set it from the values
+  // returned by the callee.
+  if (instr->GetReferenceTypeInfo().IsValid() && instr->GetReferenceTypeInfo().IsExact()) {
+    return;
+  }
 
   ScopedObjectAccess soa(Thread::Current());
   // FIXME: Treat InvokePolymorphic separately, as we can get a more specific return type from
@@ -31,16 +31,12 @@ RegisterAllocationResolver::RegisterAllocationResolver(CodeGenerator* codegen,
 
 void RegisterAllocationResolver::Resolve(ArrayRef<HInstruction* const> safepoints,
                                          size_t reserved_out_slots,
-                                         size_t int_spill_slots,
-                                         size_t long_spill_slots,
-                                         size_t float_spill_slots,
-                                         size_t double_spill_slots,
+                                         size_t single_spill_slots,
+                                         size_t wide_spill_slots,
                                          size_t catch_phi_spill_slots,
                                          ArrayRef<LiveInterval* const> temp_intervals) {
-  size_t spill_slots = int_spill_slots
-                     + long_spill_slots
-                     + float_spill_slots
-                     + double_spill_slots
+  size_t spill_slots = single_spill_slots
+                     + wide_spill_slots
                      + catch_phi_spill_slots;
 
   // Update safepoints and calculate the size of the spills.
@@ -84,7 +80,7 @@ void RegisterAllocationResolver::Resolve(ArrayRef<HInstruction* const> safepoint
                     - catch_phi_spill_slots;
       current->SetSpillSlot(slot * kVRegSize);
     } else if (current->HasSpillSlot()) {
-      // Adjust the stack slot, now that we know the number of them for each type.
+      // Adjust the stack slot, now that we know the number of them for each size.
       // The way this implementation lays out the stack is the following:
       // [parameter slots       ]
       // [art method (caller)   ]
@@ -92,24 +88,18 @@ void RegisterAllocationResolver::Resolve(ArrayRef<HInstruction* const> safepoint
       // [entry spill (float)   ]
       // [should_deoptimize flag] (this is optional)
       // [catch phi spill slots ]
-      // [double spill slots    ]
-      // [long spill slots      ]
-      // [float spill slots     ]
-      // [int/ref values        ]
+      // [wide spill slots      ] (long, double and SIMD values)
+      // [single spill slots    ] (int, reference and float values)
       // [maximum out values    ] (number of arguments for calls)
       // [art method            ].
       size_t slot = current->GetSpillSlot();
       switch (current->GetType()) {
         case DataType::Type::kFloat64:
-          slot += long_spill_slots;
-          FALLTHROUGH_INTENDED;
         case DataType::Type::kUint64:
         case DataType::Type::kInt64:
-          slot += float_spill_slots;
+          slot += single_spill_slots;
           FALLTHROUGH_INTENDED;
         case DataType::Type::kFloat32:
-          slot += int_spill_slots;
-          FALLTHROUGH_INTENDED;
         case DataType::Type::kReference:
         case DataType::Type::kUint32:
         case DataType::Type::kInt32:
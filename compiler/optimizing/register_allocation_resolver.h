@@ -43,10 +43,8 @@ class RegisterAllocationResolver : ValueObject {
 
   void Resolve(ArrayRef<HInstruction* const> safepoints,
                size_t reserved_out_slots,  // Includes slot(s) for the art method.
-               size_t int_spill_slots,
-               size_t long_spill_slots,
-               size_t float_spill_slots,
-               size_t double_spill_slots,
+               size_t single_spill_slots,  // For int, reference and float values.
+               size_t wide_spill_slots,    // For long, double and SIMD values.
                size_t catch_phi_spill_slots,
                ArrayRef<LiveInterval* const> temp_intervals);
 
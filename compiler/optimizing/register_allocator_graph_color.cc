@@ -584,10 +584,8 @@ RegisterAllocatorGraphColor::RegisterAllocatorGraphColor(ScopedArenaAllocator* a
         safepoints_(allocator->Adapter(kArenaAllocRegisterAllocator)),
         physical_core_nodes_(allocator->Adapter(kArenaAllocRegisterAllocator)),
         physical_fp_nodes_(allocator->Adapter(kArenaAllocRegisterAllocator)),
-        num_int_spill_slots_(0),
-        num_double_spill_slots_(0),
-        num_float_spill_slots_(0),
-        num_long_spill_slots_(0),
+        num_single_spill_slots_(0),
+        num_wide_spill_slots_(0),
         catch_phi_spill_slot_counter_(0),
         reserved_art_method_slots_(ComputeReservedArtMethodSlots(*codegen)),
         reserved_out_slots_(codegen->GetGraph()->GetMaximumNumberOfOutVRegs()) {
@@ -718,10 +716,8 @@ void RegisterAllocatorGraphColor::AllocateRegisters() {
   RegisterAllocationResolver(codegen_, liveness_)
       .Resolve(ArrayRef<HInstruction* const>(safepoints_),
                reserved_art_method_slots_ + reserved_out_slots_,
-               num_int_spill_slots_,
-               num_long_spill_slots_,
-               num_float_spill_slots_,
-               num_double_spill_slots_,
+               num_single_spill_slots_,
+               num_wide_spill_slots_,
                catch_phi_spill_slot_counter_,
                ArrayRef<LiveInterval* const>(temp_intervals_));
 
@@ -762,10 +758,8 @@ bool RegisterAllocatorGraphColor::Validate(bool log_fatal_on_failure) {
       }
     }
 
-    size_t spill_slots = num_int_spill_slots_
-                       + num_long_spill_slots_
-                       + num_float_spill_slots_
-                       + num_double_spill_slots_
+    size_t spill_slots = num_single_spill_slots_
+                       + num_wide_spill_slots_
                        + catch_phi_spill_slot_counter_;
     bool ok = ValidateIntervals(ArrayRef<LiveInterval* const>(intervals),
                                 spill_slots,
@@ -1922,14 +1916,12 @@ bool ColoringIteration::ColorInterferenceGraph() {
 }
 
 void RegisterAllocatorGraphColor::AllocateSpillSlots(ArrayRef<InterferenceNode* const> nodes) {
-  // The register allocation resolver will organize the stack based on value type,
-  // so we assign stack slots for each value type separately.
+  // The register allocation resolver will organize the stack based on value size,
+  // so we assign stack slots for each value size separately.
   ScopedArenaAllocator allocator(allocator_->GetArenaStack());
   ScopedArenaAllocatorAdapter<void> adapter = allocator.Adapter(kArenaAllocRegisterAllocator);
-  ScopedArenaVector<LiveInterval*> double_intervals(adapter);
-  ScopedArenaVector<LiveInterval*> long_intervals(adapter);
-  ScopedArenaVector<LiveInterval*> float_intervals(adapter);
-  ScopedArenaVector<LiveInterval*> int_intervals(adapter);
+  ScopedArenaVector<LiveInterval*> wide_intervals(adapter);
+  ScopedArenaVector<LiveInterval*> single_intervals(adapter);
 
   // The set of parent intervals already handled.
   ScopedArenaSet<LiveInterval*> seen(adapter);
@@ -1964,14 +1956,10 @@ void RegisterAllocatorGraphColor::AllocateSpillSlots(ArrayRef<InterferenceNode*
       // worklist to be processed later.
       switch (node->GetInterval()->GetType()) {
         case DataType::Type::kFloat64:
-          double_intervals.push_back(parent);
-          break;
         case DataType::Type::kInt64:
-          long_intervals.push_back(parent);
+          wide_intervals.push_back(parent);
           break;
         case DataType::Type::kFloat32:
-          float_intervals.push_back(parent);
-          break;
         case DataType::Type::kReference:
         case DataType::Type::kInt32:
         case DataType::Type::kUint16:
@@ -1979,7 +1967,7 @@ void RegisterAllocatorGraphColor::AllocateSpillSlots(ArrayRef<InterferenceNode*
         case DataType::Type::kInt8:
         case DataType::Type::kBool:
         case DataType::Type::kInt16:
-          int_intervals.push_back(parent);
+          single_intervals.push_back(parent);
           break;
         case DataType::Type::kUint32:
         case DataType::Type::kUint64:
@@ -1990,11 +1978,9 @@ void RegisterAllocatorGraphColor::AllocateSpillSlots(ArrayRef<InterferenceNode*
     }
   }
 
-  // Color spill slots for each value type.
-  ColorSpillSlots(ArrayRef<LiveInterval* const>(double_intervals), &num_double_spill_slots_);
-  ColorSpillSlots(ArrayRef<LiveInterval* const>(long_intervals), &num_long_spill_slots_);
-  ColorSpillSlots(ArrayRef<LiveInterval* const>(float_intervals), &num_float_spill_slots_);
-  ColorSpillSlots(ArrayRef<LiveInterval* const>(int_intervals), &num_int_spill_slots_);
+  // Color spill slots for each value size.
+  ColorSpillSlots(ArrayRef<LiveInterval* const>(wide_intervals), &num_wide_spill_slots_);
+  ColorSpillSlots(ArrayRef<LiveInterval* const>(single_intervals), &num_single_spill_slots_);
 }
 
 void RegisterAllocatorGraphColor::ColorSpillSlots(ArrayRef<LiveInterval* const> intervals,
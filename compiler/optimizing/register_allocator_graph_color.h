@@ -172,10 +172,8 @@ class RegisterAllocatorGraphColor : public RegisterAllocator {
   ScopedArenaVector<InterferenceNode*> physical_fp_nodes_;
 
   // Allocated stack slot counters.
-  size_t num_int_spill_slots_;
-  size_t num_double_spill_slots_;
-  size_t num_float_spill_slots_;
-  size_t num_long_spill_slots_;
+  size_t num_single_spill_slots_;
+  size_t num_wide_spill_slots_;
   size_t catch_phi_spill_slot_counter_;
 
   // Number of stack slots needed for the pointer to the current method.
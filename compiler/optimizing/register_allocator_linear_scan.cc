@@ -53,10 +53,8 @@ RegisterAllocatorLinearScan::RegisterAllocatorLinearScan(ScopedArenaAllocator* a
         physical_core_register_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
         physical_fp_register_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
         temp_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
-        int_spill_slots_(allocator->Adapter(kArenaAllocRegisterAllocator)),
-        long_spill_slots_(allocator->Adapter(kArenaAllocRegisterAllocator)),
-        float_spill_slots_(allocator->Adapter(kArenaAllocRegisterAllocator)),
-        double_spill_slots_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        single_spill_slots_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        wide_spill_slots_(allocator->Adapter(kArenaAllocRegisterAllocator)),
         catch_phi_spill_slots_(0),
         safepoints_(allocator->Adapter(kArenaAllocRegisterAllocator)),
         processing_core_registers_(false),
@@ -66,10 +64,8 @@ RegisterAllocatorLinearScan::RegisterAllocatorLinearScan(ScopedArenaAllocator* a
         blocked_fp_registers_(codegen->GetBlockedFloatingPointRegisters()),
         reserved_out_slots_(0) {
   temp_intervals_.reserve(4);
-  int_spill_slots_.reserve(kDefaultNumberOfSpillSlots);
-  long_spill_slots_.reserve(kDefaultNumberOfSpillSlots);
-  float_spill_slots_.reserve(kDefaultNumberOfSpillSlots);
-  double_spill_slots_.reserve(kDefaultNumberOfSpillSlots);
+  single_spill_slots_.reserve(kDefaultNumberOfSpillSlots);
+  wide_spill_slots_.reserve(kDefaultNumberOfSpillSlots);
 
   codegen->SetupBlockedRegisters();
   physical_core_register_intervals_.resize(codegen->GetNumberOfCoreRegisters(), nullptr);
@@ -95,10 +91,8 @@ void RegisterAllocatorLinearScan::AllocateRegisters() {
   RegisterAllocationResolver(codegen_, liveness_)
       .Resolve(ArrayRef<HInstruction* const>(safepoints_),
                reserved_out_slots_,
-               int_spill_slots_.size(),
-               long_spill_slots_.size(),
-               float_spill_slots_.size(),
-               double_spill_slots_.size(),
+               single_spill_slots_.size(),
+               wide_spill_slots_.size(),
                catch_phi_spill_slots_,
                ArrayRef<LiveInterval* const>(temp_intervals_));
 
@@ -854,6 +848,50 @@ int RegisterAllocatorLinearScan::FindAvailableRegister(size_t* next_use, LiveInt
   return reg;
 }
 
+// Rematerializing a constant is cheaper than reloading a value from its stack slot.
+static constexpr float kRematerializationCostFactor = 0.25f;
+
+// Only deviate from evicting the register used the last if this saves most of the cost.
+static constexpr float kEvictionCostRatio = 0.5f;
+
+float RegisterAllocatorLinearScan::GetEvictionCost(size_t* next_use, int reg) const {
+  DCHECK_NE(next_use[reg], kMaxLifetimePosition);
+  // The reload happens in the block of the next use, so a value used next in a
+  // hot loop costs much more to evict than one used next on a cold path.
+  float cost = liveness_.GetBlockFromPosition(next_use[reg] / 2)->GetFrequency();
+  for (LiveInterval* active : active_) {
+    if (active->GetRegister() == reg && !active->IsFixed()) {
+      if (active->GetParent()->GetDefinedBy()->IsConstant()) {
+        cost *= kRematerializationCostFactor;
+      }
+      break;
+    }
+  }
+  return cost;
+}
+
+int RegisterAllocatorLinearScan::FindCheaperRegisterToEvict(size_t* next_use,
+                                                            size_t first_register_use,
+                                                            int reg) const {
+  if (next_use[reg] == kMaxLifetimePosition) {
+    // Nothing to evict.
+    return reg;
+  }
+  float best_cost = GetEvictionCost(next_use, reg) * kEvictionCostRatio;
+  int best_reg = reg;
+  for (size_t i = 0; i < number_of_registers_; ++i) {
+    if (IsBlocked(i) || first_register_use >= next_use[i]) {
+      continue;
+    }
+    float cost = GetEvictionCost(next_use, i);
+    if (cost < best_cost) {
+      best_cost = cost;
+      best_reg = i;
+    }
+  }
+  return best_reg;
+}
+
 // Remove interval and its other half if any. Return iterator to the following element.
 static ArenaVector<LiveInterval*>::iterator RemoveIntervalAndPotentialOtherHalf(
     ScopedArenaVector<LiveInterval*>* intervals, ScopedArenaVector<LiveInterval*>::iterator pos) {
@@ -903,7 +941,9 @@ bool RegisterAllocatorLinearScan::TrySplitNonPairOrUnalignedPairIntervalAt(size_
 
 // Find the register that is used the last, and spill the interval
 // that holds it. If the first use of `current` is after that register
-// we spill `current` instead.
+// we spill `current` instead. A register whose value is much cheaper to
+// reload, because its next use is on a colder path or the value is a
+// constant, is preferred over the one used the last.
 bool RegisterAllocatorLinearScan::AllocateBlockedReg(LiveInterval* current) {
   size_t first_register_use = current->FirstRegisterUse();
   if (current->HasRegister()) {
@@ -984,6 +1024,9 @@ bool RegisterAllocatorLinearScan::AllocateBlockedReg(LiveInterval* current) {
     DCHECK(!current->IsHighInterval());
     reg = FindAvailableRegister(next_use, current);
     should_spill = (first_register_use >= next_use[reg]);
+    if (!should_spill) {
+      reg = FindCheaperRegisterToEvict(next_use, first_register_use, reg);
+    }
   }
 
   DCHECK_NE(reg, kNoRegister);
@@ -1149,14 +1192,10 @@ void RegisterAllocatorLinearScan::AllocateSpillSlotFor(LiveInterval* interval) {
   ScopedArenaVector<size_t>* spill_slots = nullptr;
   switch (interval->GetType()) {
     case DataType::Type::kFloat64:
-      spill_slots = &double_spill_slots_;
-      break;
     case DataType::Type::kInt64:
-      spill_slots = &long_spill_slots_;
+      spill_slots = &wide_spill_slots_;
       break;
     case DataType::Type::kFloat32:
-      spill_slots = &float_spill_slots_;
-      break;
     case DataType::Type::kReference:
     case DataType::Type::kInt32:
     case DataType::Type::kUint16:
@@ -1164,7 +1203,7 @@ void RegisterAllocatorLinearScan::AllocateSpillSlotFor(LiveInterval* interval) {
     case DataType::Type::kInt8:
     case DataType::Type::kBool:
     case DataType::Type::kInt16:
-      spill_slots = &int_spill_slots_;
+      spill_slots = &single_spill_slots_;
       break;
     case DataType::Type::kUint32:
     case DataType::Type::kUint64:
@@ -1200,7 +1239,7 @@ void RegisterAllocatorLinearScan::AllocateSpillSlotFor(LiveInterval* interval) {
   }
 
   // Note that the exact spill slot location will be computed when we resolve,
-  // that is when we know the number of spill slots for each type.
+  // that is when we know the number of spill slots for each size.
   parent->SetSpillSlot(slot);
 }
 
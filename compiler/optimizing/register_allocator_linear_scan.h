@@ -56,10 +56,8 @@ class RegisterAllocatorLinearScan : public RegisterAllocator {
   }
 
   size_t GetNumberOfSpillSlots() const {
-    return int_spill_slots_.size()
-        + long_spill_slots_.size()
-        + float_spill_slots_.size()
-        + double_spill_slots_.size()
+    return single_spill_slots_.size()
+        + wide_spill_slots_.size()
         + catch_phi_spill_slots_;
   }
 
@@ -98,6 +96,14 @@ class RegisterAllocatorLinearScan : public RegisterAllocator {
   int FindAvailableRegister(size_t* next_use, LiveInterval* current) const;
   bool IsCallerSaveRegister(int reg) const;
 
+  // Returns the estimated cost of evicting the value currently held in `reg`, that is
+  // of reloading or rematerializing it for its next use.
+  float GetEvictionCost(size_t* next_use, int reg) const;
+
+  // Returns a register that can be taken from its current holder until after
+  // `first_register_use` and is much cheaper to evict than `reg`, or `reg` if none is.
+  int FindCheaperRegisterToEvict(size_t* next_use, size_t first_register_use, int reg) const;
+
   // If any inputs require specific registers, block those registers
   // at the position of this instruction.
   void CheckForFixedInputs(HInstruction* instruction);
@@ -159,14 +165,13 @@ class RegisterAllocatorLinearScan : public RegisterAllocator {
   // where an instruction requires a temporary.
   ScopedArenaVector<LiveInterval*> temp_intervals_;
 
-  // The spill slots allocated for live intervals. We ensure spill slots
-  // are typed to avoid (1) doing moves and swaps between two different kinds
-  // of registers, and (2) swapping between a single stack slot and a double
-  // stack slot. This simplifies the parallel move resolver.
-  ScopedArenaVector<size_t> int_spill_slots_;
-  ScopedArenaVector<size_t> long_spill_slots_;
-  ScopedArenaVector<size_t> float_spill_slots_;
-  ScopedArenaVector<size_t> double_spill_slots_;
+  // The spill slots allocated for live intervals, indexed by slot and holding the
+  // end position of their last user. We ensure spill slots are sized to avoid
+  // swapping between a single stack slot and a double stack slot, which simplifies
+  // the parallel move resolver. Values of different types but of the same size
+  // share the slots whenever their lifetimes are disjoint, which keeps frames small.
+  ScopedArenaVector<size_t> single_spill_slots_;
+  ScopedArenaVector<size_t> wide_spill_slots_;
 
   // Spill slots allocated to catch phis. This category is special-cased because
   // (1) slots are allocated prior to linear scan and in reverse linear order,
@@ -195,6 +200,8 @@ class RegisterAllocatorLinearScan : public RegisterAllocator {
 
   ART_FRIEND_TEST(RegisterAllocatorTest, FreeUntil);
   ART_FRIEND_TEST(RegisterAllocatorTest, SpillInactive);
+  ART_FRIEND_TEST(RegisterAllocatorTest, SharedSpillSlots);
+  ART_FRIEND_TEST(RegisterAllocatorTest, EvictColdInterval);
 
   DISALLOW_COPY_AND_ASSIGN(RegisterAllocatorLinearScan);
 };
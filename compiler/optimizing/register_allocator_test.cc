@@ -941,4 +941,102 @@ TEST_F(RegisterAllocatorTest, SpillInactive) {
   ASSERT_TRUE(ValidateIntervals(intervals, codegen));
 }
 
+// Test that values of different types but of the same size share spill slots
+// when their lifetimes are disjoint, which keeps the frame small.
+// This test only applies to the linear scan allocator.
+TEST_F(RegisterAllocatorTest, SharedSpillSlots) {
+  HGraph* graph = CreateGraph();
+  HBasicBlock* entry = new (GetAllocator()) HBasicBlock(graph);
+  graph->AddBlock(entry);
+  graph->SetEntryBlock(entry);
+  HInstruction* parameter = new (GetAllocator()) HParameterValue(
+      graph->GetDexFile(), dex::TypeIndex(0), 0, DataType::Type::kInt32);
+  entry->AddInstruction(parameter);
+
+  x86::CodeGeneratorX86 codegen(graph, *compiler_options_);
+  SsaLivenessAnalysis liveness(graph, &codegen, GetScopedAllocator());
+  RegisterAllocatorLinearScan register_allocator(GetScopedAllocator(), &codegen, liveness);
+
+  auto make_interval = [&](DataType::Type type, size_t start, size_t end) {
+    HInstruction* value = new (GetAllocator()) HAdd(type, parameter, parameter);
+    LiveInterval* interval = LiveInterval::MakeInterval(GetScopedAllocator(), type, value);
+    value->SetLiveInterval(interval);
+    interval->AddRange(start, end);
+    return interval;
+  };
+
+  // Spill slots are allocated in the order of the interval starts.
+  LiveInterval* int_value = make_interval(DataType::Type::kInt32, 2, 10);
+  LiveInterval* long_value = make_interval(DataType::Type::kInt64, 2, 10);
+  LiveInterval* overlapping_float = make_interval(DataType::Type::kFloat32, 6, 16);
+  LiveInterval* float_value = make_interval(DataType::Type::kFloat32, 12, 20);
+  LiveInterval* double_value = make_interval(DataType::Type::kFloat64, 12, 20);
+  for (LiveInterval* interval :
+       {int_value, long_value, overlapping_float, float_value, double_value}) {
+    register_allocator.AllocateSpillSlotFor(interval);
+  }
+
+  ASSERT_EQ(0, int_value->GetSpillSlot());
+  ASSERT_EQ(1, overlapping_float->GetSpillSlot());
+  ASSERT_EQ(0, float_value->GetSpillSlot());
+  ASSERT_EQ(0, long_value->GetSpillSlot());
+  ASSERT_EQ(0, double_value->GetSpillSlot());
+  ASSERT_EQ(2u, register_allocator.single_spill_slots_.size());
+  ASSERT_EQ(2u, register_allocator.wide_spill_slots_.size());
+  // This is the number of slots the frame is sized for.
+  ASSERT_EQ(4u, register_allocator.GetNumberOfSpillSlots());
+}
+
+// Test that the register whose value is used next on a cold path is evicted
+// rather than the one used the last, if that one is used next on a hot path.
+// This test only applies to the linear scan allocator.
+TEST_F(RegisterAllocatorTest, EvictColdInterval) {
+  HGraph* graph = CreateGraph();
+  HBasicBlock* entry = new (GetAllocator()) HBasicBlock(graph);
+  graph->AddBlock(entry);
+  graph->SetEntryBlock(entry);
+  HInstruction* parameter = new (GetAllocator()) HParameterValue(
+      graph->GetDexFile(), dex::TypeIndex(0), 0, DataType::Type::kInt32);
+  entry->AddInstruction(parameter);
+  HBasicBlock* cold = new (GetAllocator()) HBasicBlock(graph);
+  graph->AddBlock(cold);
+  entry->AddSuccessor(cold);
+  cold->AddInstruction(new (GetAllocator()) HGoto());
+  cold->SetFrequency(0.1f);
+  HBasicBlock* hot = new (GetAllocator()) HBasicBlock(graph);
+  graph->AddBlock(hot);
+  cold->AddSuccessor(hot);
+  hot->AddInstruction(new (GetAllocator()) HExit());
+  hot->SetFrequency(10.0f);
+
+  x86::CodeGeneratorX86 codegen(graph, *compiler_options_);
+  SsaLivenessAnalysis liveness(graph, &codegen, GetScopedAllocator());
+  // Lifetime positions [0, 20( are in the cold block and [20, 40( in the hot block.
+  for (size_t i = 0; i < 10; ++i) {
+    liveness.instructions_from_lifetime_position_.push_back(cold->GetLastInstruction());
+  }
+  for (size_t i = 0; i < 10; ++i) {
+    liveness.instructions_from_lifetime_position_.push_back(hot->GetLastInstruction());
+  }
+
+  RegisterAllocatorLinearScan register_allocator(GetScopedAllocator(), &codegen, liveness);
+  register_allocator.number_of_registers_ = 2;
+  register_allocator.processing_core_registers_ = true;
+  ASSERT_FALSE(register_allocator.IsBlocked(0));
+  ASSERT_FALSE(register_allocator.IsBlocked(1));
+
+  // Register 1 is used the last, but in the hot block.
+  size_t next_use[] = { 12u, 30u };
+  ASSERT_FLOAT_EQ(0.1f, register_allocator.GetEvictionCost(next_use, 0));
+  ASSERT_FLOAT_EQ(10.0f, register_allocator.GetEvictionCost(next_use, 1));
+  ASSERT_EQ(0, register_allocator.FindCheaperRegisterToEvict(next_use, 4u, 1));
+
+  // Register 0 cannot be evicted if it is needed before the first use of `current`.
+  ASSERT_EQ(1, register_allocator.FindCheaperRegisterToEvict(next_use, 14u, 1));
+
+  // Both next uses in blocks of the same frequency: keep the register used the last.
+  next_use[0] = 22u;
+  ASSERT_EQ(1, register_allocator.FindCheaperRegisterToEvict(next_use, 4u, 1));
+}
+
 }  // namespace art
@@ -0,0 +1,290 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scheduler_x86_64.h"
+
+#include "arch/x86_64/instruction_set_features_x86_64.h"
+#include "code_generator.h"
+#include "code_generator_utils.h"
+#include "driver/compiler_options.h"
+
+namespace art {
+namespace x86_64 {
+
+// Haswell and later Intel cores (Skylake, Kaby Lake, ...) and AMD Zen cores,
+// which all support AVX2.
+static constexpr X86_64SchedulingModel kX86_64RecentCoreModel = {
+  /* integer_op_latency= */ 1,
+  /* mul_integer_latency= */ 3,
+  /* mul_long_latency= */ 3,
+  /* div_integer_latency= */ 26,
+  /* div_long_latency= */ 42,
+  /* floating_point_op_latency= */ 4,
+  /* mul_floating_point_latency= */ 4,
+  /* div_float_latency= */ 11,
+  /* div_double_latency= */ 14,
+  /* type_conversion_floating_point_integer_latency= */ 6,
+  /* memory_load_latency= */ 5,
+  /* memory_store_latency= */ 1,
+  /* call_latency= */ 5,
+  /* call_internal_latency= */ 10,
+};
+
+// Sandy Bridge and Ivy Bridge cores, which support AVX but not AVX2.
+static constexpr X86_64SchedulingModel kX86_64SandyBridgeModel = {
+  /* integer_op_latency= */ 1,
+  /* mul_integer_latency= */ 3,
+  /* mul_long_latency= */ 3,
+  /* div_integer_latency= */ 26,
+  /* div_long_latency= */ 60,
+  /* floating_point_op_latency= */ 3,
+  /* mul_floating_point_latency= */ 5,
+  /* div_float_latency= */ 14,
+  /* div_double_latency= */ 22,
+  /* type_conversion_floating_point_integer_latency= */ 5,
+  /* memory_load_latency= */ 5,
+  /* memory_store_latency= */ 1,
+  /* call_latency= */ 5,
+  /* call_internal_latency= */ 10,
+};
+
+// Silvermont and Goldmont cores, which support SSE4 but not AVX.
+static constexpr X86_64SchedulingModel kX86_64SilvermontModel = {
+  /* integer_op_latency= */ 1,
+  /* mul_integer_latency= */ 3,
+  /* mul_long_latency= */ 5,
+  /* div_integer_latency= */ 25,
+  /* div_long_latency= */ 50,
+  /* floating_point_op_latency= */ 3,
+  /* mul_floating_point_latency= */ 5,
+  /* div_float_latency= */ 19,
+  /* div_double_latency= */ 34,
+  /* type_conversion_floating_point_integer_latency= */ 4,
+  /* memory_load_latency= */ 3,
+  /* memory_store_latency= */ 1,
+  /* call_latency= */ 5,
+  /* call_internal_latency= */ 12,
+};
+
+// Bonnell (Atom) cores, which do not support SSE4. These cores are in order,
+// so they benefit the most from scheduling.
+static constexpr X86_64SchedulingModel kX86_64AtomModel = {
+  /* integer_op_latency= */ 1,
+  /* mul_integer_latency= */ 5,
+  /* mul_long_latency= */ 14,
+  /* div_integer_latency= */ 50,
+  /* div_long_latency= */ 130,
+  /* floating_point_op_latency= */ 5,
+  /* mul_floating_point_latency= */ 5,
+  /* div_float_latency= */ 30,
+  /* div_double_latency= */ 60,
+  /* type_conversion_floating_point_integer_latency= */ 7,
+  /* memory_load_latency= */ 3,
+  /* memory_store_latency= */ 1,
+  /* call_latency= */ 5,
+  /* call_internal_latency= */ 15,
+};
+
+const X86_64SchedulingModel& GetSchedulingModel(const X86_64InstructionSetFeatures* features) {
+  if (features == nullptr || features->HasAVX2()) {
+    return kX86_64RecentCoreModel;
+  } else if (features->HasAVX()) {
+    return kX86_64SandyBridgeModel;
+  } else if (features->HasSSE4_1()) {
+    return kX86_64SilvermontModel;
+  } else {
+    return kX86_64AtomModel;
+  }
+}
+
+SchedulingLatencyVisitorX86_64::SchedulingLatencyVisitorX86_64(CodeGenerator* codegen)
+    : model_(GetSchedulingModel(
+          codegen != nullptr
+              ? codegen->GetCompilerOptions().GetInstructionSetFeatures()
+                    ->AsX86_64InstructionSetFeatures()
+              : nullptr)) {}
+
+void SchedulingLatencyVisitorX86_64::VisitBinaryOperation(HBinaryOperation* instr) {
+  last_visited_latency_ = DataType::IsFloatingPointType(instr->GetResultType())
+      ? model_.floating_point_op_latency
+      : model_.integer_op_latency;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitArrayGet(HArrayGet* ATTRIBUTE_UNUSED) {
+  // The address computation is folded into the addressing mode of the load.
+  last_visited_latency_ = model_.memory_load_latency;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitArrayLength(HArrayLength* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = model_.memory_load_latency;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitArraySet(HArraySet* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = model_.memory_store_latency;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitBoundsCheck(HBoundsCheck* ATTRIBUTE_UNUSED) {
+  last_visited_internal_latency_ = model_.integer_op_latency;
+  // Users do not use any data results.
+  last_visited_latency_ = 0;
+}
+
+void SchedulingLatencyVisitorX86_64::HandleDivRemByConstant(HBinaryOperation* instruction,
+                                                            int64_t imm) {
+  DCHECK(instruction->IsDiv() || instruction->IsRem());
+  bool is_long = instruction->GetResultType() == DataType::Type::kInt64;
+  if (imm == 0) {
+    // The division always throws.
+    last_visited_internal_latency_ = 0;
+    last_visited_latency_ = 0;
+  } else if (imm == 1 || imm == -1) {
+    last_visited_internal_latency_ = 0;
+    last_visited_latency_ = model_.integer_op_latency;
+  } else if (IsPowerOfTwo(AbsOrMin(imm))) {
+    // Adjustment of negative dividends with `lea`, `test` and `cmov`, then a shift.
+    last_visited_internal_latency_ = 3 * model_.integer_op_latency;
+    last_visited_latency_ = model_.integer_op_latency;
+  } else {
+    // Multiplication by a magic number, followed by shifts and a correction.
+    DCHECK(imm <= -2 || imm >= 2);
+    last_visited_internal_latency_ =
+        (is_long ? model_.mul_long_latency : model_.mul_integer_latency) +
+        2 * model_.integer_op_latency;
+    last_visited_latency_ = model_.integer_op_latency;
+  }
+  if (instruction->IsRem() && last_visited_latency_ != 0u) {
+    // The quotient is multiplied back and subtracted from the dividend.
+    last_visited_internal_latency_ += last_visited_latency_ +
+        (is_long ? model_.mul_long_latency : model_.mul_integer_latency);
+    last_visited_latency_ = model_.integer_op_latency;
+  }
+}
+
+void SchedulingLatencyVisitorX86_64::VisitDiv(HDiv* instr) {
+  DataType::Type type = instr->GetResultType();
+  switch (type) {
+    case DataType::Type::kFloat32:
+      last_visited_latency_ = model_.div_float_latency;
+      break;
+    case DataType::Type::kFloat64:
+      last_visited_latency_ = model_.div_double_latency;
+      break;
+    default:
+      if (instr->GetRight()->IsConstant()) {
+        HandleDivRemByConstant(instr, Int64FromConstant(instr->GetRight()->AsConstant()));
+      } else {
+        last_visited_latency_ = (type == DataType::Type::kInt64)
+            ? model_.div_long_latency
+            : model_.div_integer_latency;
+      }
+      break;
+  }
+}
+
+void SchedulingLatencyVisitorX86_64::VisitInstanceFieldGet(HInstanceFieldGet* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = model_.memory_load_latency;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitInstanceOf(HInstanceOf* ATTRIBUTE_UNUSED) {
+  last_visited_internal_latency_ = model_.call_internal_latency;
+  last_visited_latency_ = model_.integer_op_latency;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitInvoke(HInvoke* ATTRIBUTE_UNUSED) {
+  last_visited_internal_latency_ = model_.call_internal_latency;
+  last_visited_latency_ = model_.call_latency;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitLoadString(HLoadString* ATTRIBUTE_UNUSED) {
+  last_visited_internal_latency_ = model_.memory_load_latency;
+  last_visited_latency_ = model_.memory_load_latency;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitMul(HMul* instr) {
+  switch (instr->GetResultType()) {
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      last_visited_latency_ = model_.mul_floating_point_latency;
+      break;
+    case DataType::Type::kInt64:
+      last_visited_latency_ = model_.mul_long_latency;
+      break;
+    default:
+      last_visited_latency_ = model_.mul_integer_latency;
+      break;
+  }
+}
+
+void SchedulingLatencyVisitorX86_64::VisitNewArray(HNewArray* ATTRIBUTE_UNUSED) {
+  last_visited_internal_latency_ = model_.integer_op_latency + model_.call_internal_latency;
+  last_visited_latency_ = model_.call_latency;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitNewInstance(HNewInstance* instruction) {
+  if (instruction->IsStringAlloc()) {
+    last_visited_internal_latency_ = model_.memory_load_latency + model_.call_internal_latency;
+  } else {
+    last_visited_internal_latency_ = model_.call_internal_latency;
+  }
+  last_visited_latency_ = model_.call_latency;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitRem(HRem* instruction) {
+  DataType::Type type = instruction->GetResultType();
+  if (DataType::IsFloatingPointType(type)) {
+    // Code generation uses an x87 `fprem` loop.
+    last_visited_internal_latency_ = (type == DataType::Type::kFloat64)
+        ? model_.div_double_latency
+        : model_.div_float_latency;
+    last_visited_latency_ = model_.memory_load_latency;
+  } else if (instruction->GetRight()->IsConstant()) {
+    HandleDivRemByConstant(instruction,
+                           Int64FromConstant(instruction->GetRight()->AsConstant()));
+  } else {
+    // `idiv` produces the remainder along with the quotient.
+    last_visited_latency_ = (type == DataType::Type::kInt64)
+        ? model_.div_long_latency
+        : model_.div_integer_latency;
+  }
+}
+
+void SchedulingLatencyVisitorX86_64::VisitStaticFieldGet(HStaticFieldGet* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = model_.memory_load_latency;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitSuspendCheck(HSuspendCheck* instruction) {
+  HBasicBlock* block = instruction->GetBlock();
+  DCHECK_IMPLIES(block->GetLoopInformation() == nullptr,
+                 block->IsEntryBlock() && instruction->GetNext()->IsGoto());
+  // Users do not use any data results.
+  last_visited_latency_ = 0;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitTypeConversion(HTypeConversion* instr) {
+  if (DataType::IsFloatingPointType(instr->GetResultType()) ||
+      DataType::IsFloatingPointType(instr->GetInputType())) {
+    if (DataType::IsIntegralType(instr->GetResultType())) {
+      // Conversions to integral types check for NaN and for overflow.
+      last_visited_internal_latency_ = 2 * model_.floating_point_op_latency;
+    }
+    last_visited_latency_ = model_.type_conversion_floating_point_integer_latency;
+  } else {
+    last_visited_latency_ = model_.integer_op_latency;
+  }
+}
+
+}  // namespace x86_64
+}  // namespace art
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_SCHEDULER_X86_64_H_
+#define ART_COMPILER_OPTIMIZING_SCHEDULER_X86_64_H_
+
+#include "scheduler.h"
+
+namespace art {
+
+class CodeGenerator;
+class X86_64InstructionSetFeatures;
+
+namespace x86_64 {
+
+// Instruction latencies of a family of x86-64 cores, in cycles.
+//
+// The out-of-order cores hide most of the single-cycle latencies, so the model is
+// only detailed for the long latency operations that form the critical path of
+// dependency chains: multiplications, divisions, memory loads, floating point
+// arithmetic and conversions.
+struct X86_64SchedulingModel {
+  uint32_t integer_op_latency;
+  uint32_t mul_integer_latency;
+  uint32_t mul_long_latency;
+  uint32_t div_integer_latency;
+  uint32_t div_long_latency;
+  uint32_t floating_point_op_latency;
+  uint32_t mul_floating_point_latency;
+  uint32_t div_float_latency;
+  uint32_t div_double_latency;
+  uint32_t type_conversion_floating_point_integer_latency;
+  uint32_t memory_load_latency;
+  uint32_t memory_store_latency;
+  uint32_t call_latency;
+  uint32_t call_internal_latency;
+};
+
+// Returns the model of the cores supporting `features`, which may be null when
+// they are not known.
+const X86_64SchedulingModel& GetSchedulingModel(const X86_64InstructionSetFeatures* features);
+
+class SchedulingLatencyVisitorX86_64 : public SchedulingLatencyVisitor {
+ public:
+  // The model is picked from the instruction set features of the code generator,
+  // if any, and is the one of recent cores otherwise.
+  explicit SchedulingLatencyVisitorX86_64(CodeGenerator* codegen);
+
+  // Default visitor for instructions not handled specifically below.
+  void VisitInstruction(HInstruction* ATTRIBUTE_UNUSED) override {
+    last_visited_latency_ = model_.integer_op_latency;
+  }
+
+// We add a second unused parameter to be able to use this macro like the others
+// defined in `nodes.h`.
+#define FOR_EACH_SCHEDULED_X86_64_INSTRUCTION(M)     \
+  M(ArrayGet             , unused)                   \
+  M(ArrayLength          , unused)                   \
+  M(ArraySet             , unused)                   \
+  M(BoundsCheck          , unused)                   \
+  M(Div                  , unused)                   \
+  M(InstanceFieldGet     , unused)                   \
+  M(InstanceOf           , unused)                   \
+  M(LoadString           , unused)                   \
+  M(Mul                  , unused)                   \
+  M(NewArray             , unused)                   \
+  M(NewInstance          , unused)                   \
+  M(Rem                  , unused)                   \
+  M(StaticFieldGet       , unused)                   \
+  M(SuspendCheck         , unused)                   \
+  M(TypeConversion       , unused)
+
+#define FOR_EACH_SCHEDULED_X86_64_ABSTRACT_INSTRUCTION(M) \
+  M(BinaryOperation      , unused)                        \
+  M(Invoke               , unused)
+
+#define DECLARE_VISIT_INSTRUCTION(type, unused)  \
+  void Visit##type(H##type* instruction) override;
+
+  FOR_EACH_SCHEDULED_X86_64_INSTRUCTION(DECLARE_VISIT_INSTRUCTION)
+  FOR_EACH_SCHEDULED_X86_64_ABSTRACT_INSTRUCTION(DECLARE_VISIT_INSTRUCTION)
+
+#undef DECLARE_VISIT_INSTRUCTION
+
+ private:
+  // Follows the code paths used by code generation for an integer division or
+  // remainder by a constant.
+  void HandleDivRemByConstant(HBinaryOperation* instruction, int64_t imm);
+
+  const X86_64SchedulingModel& model_;
+};
+
+class HSchedulerX86_64 : public HScheduler {
+ public:
+  HSchedulerX86_64(SchedulingNodeSelector* selector,
+                   SchedulingLatencyVisitorX86_64* x86_64_latency_visitor)
+      : HScheduler(x86_64_latency_visitor, selector) {}
+  ~HSchedulerX86_64() override {}
+
+  // Vector instructions are not scheduled, for the same lack of notion of SIMD
+  // registers around calls that makes them scheduling barriers on ARM64.
+  bool IsSchedulable(const HInstruction* instruction) const override {
+#define CASE_INSTRUCTION_KIND(type, unused) case \
+  HInstruction::InstructionKind::k##type:
+    switch (instruction->GetKind()) {
+      FOR_EACH_CONCRETE_INSTRUCTION_X86_COMMON(CASE_INSTRUCTION_KIND)
+        return true;
+      default:
+        return HScheduler::IsSchedulable(instruction);
+    }
+#undef CASE_INSTRUCTION_KIND
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(HSchedulerX86_64);
+};
+
+}  // namespace x86_64
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_SCHEDULER_X86_64_H_
@@ -1327,6 +1327,7 @@ class SsaLivenessAnalysis : public ValueObject {
 
   ART_FRIEND_TEST(RegisterAllocatorTest, SpillInactive);
   ART_FRIEND_TEST(RegisterAllocatorTest, FreeUntil);
+  ART_FRIEND_TEST(RegisterAllocatorTest, EvictColdInterval);
 
   DISALLOW_COPY_AND_ASSIGN(SsaLivenessAnalysis);
 };
@@ -0,0 +1,557 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "superword_vectorizer.h"
+
+#include <algorithm>
+
+#include "arch/instruction_set.h"
+#include "arch/x86/instruction_set_features_x86.h"
+#include "code_generator.h"
+#include "driver/compiler_options.h"
+
+namespace art {
+
+// Maximum depth of the expression trees that are packed.
+static constexpr size_t kMaxPackDepth = 8;
+
+// Blocks with more candidate stores are not vectorized. This bounds the search for
+// adjacent stores, which is quadratic in the number of candidates, and the number of
+// times a block is rescanned after each pack.
+static constexpr size_t kMaxCandidateStores = 128;
+
+//
+// Static helpers.
+//
+
+// Splits an array index into base + offset for a constant offset. The base
+// is nullptr for a constant index.
+static void DecomposeIndex(HInstruction* index,
+                           /*out*/ HInstruction** base,
+                           /*out*/ int64_t* offset) {
+  int64_t value = 0;
+  if (IsInt64AndGet(index, &value)) {
+    *base = nullptr;
+    *offset = value;
+    return;
+  } else if (index->IsAdd() || index->IsSub()) {
+    HBinaryOperation* operation = index->AsBinaryOperation();
+    if (IsInt64AndGet(operation->GetRight(), &value)) {
+      *base = operation->GetLeft();
+      *offset = index->IsAdd() ? value : -value;
+      return;
+    } else if (index->IsAdd() && IsInt64AndGet(operation->GetLeft(), &value)) {
+      *base = operation->GetRight();
+      *offset = value;
+      return;
+    }
+  }
+  *base = index;
+  *offset = 0;
+}
+
+// Returns true if the array references (array gets or sets, one per lane) access
+// adjacent elements of the same array in lane order. Since bounds check elimination
+// has proven every index in range, adjacent symbolic indices are adjacent values.
+static bool IsAdjacent(HInstruction* const refs[], size_t length) {
+  HInstruction* base0 = nullptr;
+  int64_t offset0 = 0;
+  DecomposeIndex(refs[0]->InputAt(1), &base0, &offset0);
+  for (size_t k = 1; k < length; ++k) {
+    HInstruction* base = nullptr;
+    int64_t offset = 0;
+    DecomposeIndex(refs[k]->InputAt(1), &base, &offset);
+    if (refs[k]->InputAt(0) != refs[0]->InputAt(0) ||
+        base != base0 ||
+        offset != offset0 + static_cast<int64_t>(k)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns true if the packed references starting at ref1 and ref2 never access
+// different elements of the same array. This exploits the property that two
+// references either point to the same array or to two completely disjoint arrays,
+// so equal indices or index ranges that are at least `length` apart suffice.
+static bool IsIndependent(HInstruction* ref1, HInstruction* ref2, size_t length) {
+  HInstruction* base1 = nullptr;
+  HInstruction* base2 = nullptr;
+  int64_t offset1 = 0;
+  int64_t offset2 = 0;
+  DecomposeIndex(ref1->InputAt(1), &base1, &offset1);
+  DecomposeIndex(ref2->InputAt(1), &base2, &offset2);
+  return base1 == base2 &&
+         (offset1 == offset2 || std::abs(offset1 - offset2) >= static_cast<int64_t>(length));
+}
+
+// Collects input `i` of each lane.
+static void GetLaneInputs(HInstruction* const lanes[],
+                          size_t length,
+                          size_t i,
+                          /*out*/ HInstruction* inputs[]) {
+  for (size_t k = 0; k < length; ++k) {
+    inputs[k] = lanes[k]->InputAt(i);
+  }
+}
+
+//
+// Public methods.
+//
+
+HSuperwordVectorizer::HSuperwordVectorizer(HGraph* graph,
+                                           const CodeGenerator& codegen,
+                                           OptimizingCompilerStats* stats,
+                                           const char* name)
+    : HOptimization(graph, name, stats),
+      codegen_(codegen),
+      packed_type_(DataType::Type::kVoid),
+      vector_length_(0),
+      restrictions_(kNone),
+      stores_(nullptr),
+      members_(nullptr) {
+}
+
+bool HSuperwordVectorizer::Run() {
+  // Predicated SIMD (e.g. arm64 SVE) requires governing predicates on every
+  // vector operation, which is left to the loop vectorizer for now.
+  if (codegen_.SupportsPredicatedSIMD()) {
+    return false;
+  }
+  bool did_vectorize = false;
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    // Each pack rewrites the block, so repeat until no more packs are found.
+    while (VectorizeBlock(block)) {
+      did_vectorize = true;
+    }
+  }
+  if (did_vectorize) {
+    graph_->SetHasSIMD(true);  // flag SIMD usage
+  }
+  return did_vectorize;
+}
+
+//
+// Packing.
+//
+
+bool HSuperwordVectorizer::VectorizeBlock(HBasicBlock* block) {
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ScopedArenaVector<HInstruction*> instructions(
+      allocator.Adapter(kArenaAllocSuperwordVectorizer));
+  ScopedArenaSafeMap<HInstruction*, size_t> positions(
+      std::less<HInstruction*>(), allocator.Adapter(kArenaAllocSuperwordVectorizer));
+  ScopedArenaVector<HInstruction*> candidates(allocator.Adapter(kArenaAllocSuperwordVectorizer));
+  ScopedArenaVector<HInstruction*> members(allocator.Adapter(kArenaAllocSuperwordVectorizer));
+
+  // Number the instructions and collect the candidate stores, viz. primitive
+  // array stores that are no longer guarded by a bounds check.
+  for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+    positions.Put(instruction, instructions.size());
+    instructions.push_back(instruction);
+    if (instruction->IsArraySet() &&
+        instruction->AsArraySet()->GetComponentType() != DataType::Type::kReference &&
+        !instruction->AsArraySet()->GetIndex()->IsBoundsCheck()) {
+      candidates.push_back(instruction);
+    }
+  }
+  if (candidates.size() > kMaxCandidateStores) {
+    return false;
+  }
+
+  // Find each run of stores to adjacent elements that fills a vector.
+  bool did_vectorize = false;
+  members_ = &members;
+  for (HInstruction* seed : candidates) {
+    if (!TrySetVectorType(seed->AsArraySet()->GetComponentType()) ||
+        candidates.size() < vector_length_) {
+      continue;
+    }
+    HInstruction* seed_base = nullptr;
+    int64_t seed_offset = 0;
+    DecomposeIndex(seed->InputAt(1), &seed_base, &seed_offset);
+    HInstruction* stores[kMaxLanes];
+    stores[0] = seed;
+    size_t length = 1;
+    for (; length < vector_length_; ++length) {
+      stores[length] = nullptr;
+      for (HInstruction* candidate : candidates) {
+        HInstruction* base = nullptr;
+        int64_t offset = 0;
+        DecomposeIndex(candidate->InputAt(1), &base, &offset);
+        if (candidate->InputAt(0) == seed->InputAt(0) &&
+            candidate->AsArraySet()->GetComponentType() == packed_type_ &&
+            base == seed_base &&
+            offset == seed_offset + static_cast<int64_t>(length)) {
+          stores[length] = candidate;
+          break;
+        }
+      }
+      if (stores[length] == nullptr) {
+        break;
+      }
+    }
+    if (length == vector_length_ && TryPackStores(stores, instructions, positions)) {
+      did_vectorize = true;
+      break;  // block changed
+    }
+  }
+  members_ = nullptr;
+  return did_vectorize;
+}
+
+bool HSuperwordVectorizer::TryPackStores(
+    HInstruction* const stores[],
+    const ScopedArenaVector<HInstruction*>& instructions,
+    const ScopedArenaSafeMap<HInstruction*, size_t>& positions) {
+  // Analyze the stored values as a pack.
+  HInstruction* values[kMaxLanes];
+  GetLaneInputs(stores, vector_length_, 2, values);
+  stores_ = stores;
+  members_->clear();
+  if (!CanPack(values, /*depth=*/ 0)) {
+    return false;
+  }
+
+  // All stores sink to the last one, and all packed loads sink to just before it.
+  // Before the first store, this is only safe if no other instruction writes memory.
+  // From the first store onwards, no other instruction may access memory or throw,
+  // since that would observe the stores out of order.
+  size_t first_store = positions.Get(stores[0]);
+  size_t last = first_store;
+  for (size_t k = 1; k < vector_length_; ++k) {
+    size_t position = positions.Get(stores[k]);
+    first_store = std::min(first_store, position);
+    last = std::max(last, position);
+  }
+  size_t first = first_store;
+  for (HInstruction* member : *members_) {
+    if (member->IsArrayGet()) {
+      first = std::min(first, positions.Get(member));
+    }
+  }
+  for (size_t i = first; i < last; ++i) {
+    HInstruction* instruction = instructions[i];
+    if (std::find(stores, stores + vector_length_, instruction) != stores + vector_length_ ||
+        std::find(members_->begin(), members_->end(), instruction) != members_->end()) {
+      continue;
+    } else if (i < first_store) {
+      if (instruction->GetSideEffects().DoesAnyWrite()) {
+        return false;
+      }
+    } else if (!instruction->GetSideEffects().DoesNothing() || instruction->CanThrow()) {
+      return false;
+    }
+  }
+
+  // Generate the vector code just before the last store.
+  HInstruction* cursor = instructions[last];
+  HInstruction* vector = GeneratePack(values, cursor);
+  ArenaAllocator* allocator = graph_->GetAllocator();
+  Insert(cursor, new (allocator) HVecStore(allocator,
+                                           stores[0]->InputAt(0),
+                                           stores[0]->InputAt(1),
+                                           vector,
+                                           packed_type_,
+                                           stores[0]->GetSideEffects(),
+                                           vector_length_,
+                                           stores[0]->GetDexPc()));
+
+  // Remove the scalar stores and the scalar code that computed their values
+  // (members are recorded users first, so each one is dead when removed).
+  for (size_t k = 0; k < vector_length_; ++k) {
+    stores[k]->GetBlock()->RemoveInstruction(stores[k]);
+  }
+  for (HInstruction* member : *members_) {
+    member->GetBlock()->RemoveInstruction(member);
+  }
+  MaybeRecordStat(stats_, MethodCompilationStat::kSuperwordVectorized);
+  return true;
+}
+
+bool HSuperwordVectorizer::CanPack(HInstruction* const lanes[], size_t depth) {
+  if (depth > kMaxPackDepth) {
+    return false;
+  }
+  HInstruction* org = lanes[0];
+
+  // Accept the same scalar in every lane, which is replicated.
+  if (std::all_of(lanes, lanes + vector_length_, [&](HInstruction* i) { return i == org; })) {
+    return IsPackedType(org->GetType());
+  }
+
+  // Otherwise, accept isomorphic instructions in this block that are used only
+  // by the pack above (so that they can be removed afterwards).
+  HBasicBlock* block = stores_[0]->GetBlock();
+  for (size_t k = 0; k < vector_length_; ++k) {
+    HInstruction* lane = lanes[k];
+    if (lane->GetKind() != org->GetKind() ||
+        lane->GetType() != org->GetType() ||
+        lane->GetBlock() != block ||
+        !lane->HasOnlyOneNonEnvironmentUse()) {
+      return false;
+    }
+  }
+  if (!IsPackedType(org->GetType())) {
+    return false;
+  }
+  members_->insert(members_->end(), lanes, lanes + vector_length_);
+
+  HInstruction* inputs[kMaxLanes];
+  switch (org->GetKind()) {
+    case HInstruction::kArrayGet: {
+      // Accept adjacent loads. Loads from an array of the same type as the stores
+      // may alias with them, unless each lane loads exactly the element it stores
+      // or loads and stores never overlap. Signedness does not tell arrays apart:
+      // `a[i] & 0xff` is a Uint8 load from the same byte[] as an Int8 store.
+      if (org->AsArrayGet()->IsStringCharAt() ||
+          org->AsArrayGet()->GetIndex()->IsBoundsCheck() ||
+          DataType::Size(org->GetType()) != DataType::Size(packed_type_) ||
+          !IsAdjacent(lanes, vector_length_)) {
+        return false;
+      } else if (DataType::ToSigned(org->GetType()) ==
+                     DataType::ToSigned(stores_[0]->AsArraySet()->GetComponentType()) &&
+                 !IsIndependent(org, stores_[0], vector_length_)) {
+        return false;
+      }
+      return true;
+    }
+    case HInstruction::kTypeConversion:
+      // Conversions only matter for higher order bits, which are not kept
+      // in narrow lanes anyway.
+      if (!HasVectorRestrictions(kNoHiBits) ||
+          !IsPackedType(org->InputAt(0)->GetType())) {
+        return false;
+      }
+      GetLaneInputs(lanes, vector_length_, 0, inputs);
+      return CanPack(inputs, depth + 1);
+    case HInstruction::kAbs:
+      if (HasVectorRestrictions(kNoAbs | kNoHiBits)) {
+        return false;
+      }
+      FALLTHROUGH_INTENDED;
+    case HInstruction::kNeg:
+    case HInstruction::kNot:
+      GetLaneInputs(lanes, vector_length_, 0, inputs);
+      return CanPack(inputs, depth + 1);
+    case HInstruction::kMul:
+      if (HasVectorRestrictions(kNoMul)) {
+        return false;
+      }
+      FALLTHROUGH_INTENDED;
+    case HInstruction::kAdd:
+    case HInstruction::kSub:
+    case HInstruction::kAnd:
+    case HInstruction::kOr:
+    case HInstruction::kXor:
+      GetLaneInputs(lanes, vector_length_, 0, inputs);
+      if (!CanPack(inputs, depth + 1)) {
+        return false;
+      }
+      GetLaneInputs(lanes, vector_length_, 1, inputs);
+      return CanPack(inputs, depth + 1);
+    case HInstruction::kShl:
+    case HInstruction::kShr:
+    case HInstruction::kUShr: {
+      if (HasVectorRestrictions(kNoShift) ||
+          (org->IsShr() && HasVectorRestrictions(kNoShr)) ||
+          (!org->IsShl() && HasVectorRestrictions(kNoHiBits))) {
+        return false;
+      }
+      // Accept the same constant shift distance in every lane, restricted
+      // to the packed data type width.
+      HInstruction* distance = org->InputAt(1);
+      int64_t value = 0;
+      if (!IsInt64AndGet(distance, &value) ||
+          value < 0 ||
+          value >= static_cast<int64_t>(DataType::Size(packed_type_) * 8)) {
+        return false;
+      }
+      for (size_t k = 1; k < vector_length_; ++k) {
+        if (lanes[k]->InputAt(1) != distance) {
+          return false;
+        }
+      }
+      GetLaneInputs(lanes, vector_length_, 0, inputs);
+      return CanPack(inputs, depth + 1);
+    }
+    default:
+      return false;
+  }
+}
+
+HInstruction* HSuperwordVectorizer::GeneratePack(HInstruction* const lanes[],
+                                                 HInstruction* cursor) {
+  ArenaAllocator* allocator = graph_->GetAllocator();
+  HInstruction* org = lanes[0];
+  uint32_t dex_pc = org->GetDexPc();
+  if (std::all_of(lanes, lanes + vector_length_, [&](HInstruction* i) { return i == org; })) {
+    return Insert(cursor, new (allocator) HVecReplicateScalar(
+        allocator, org, packed_type_, vector_length_, dex_pc));
+  }
+  HInstruction* inputs[kMaxLanes];
+  GetLaneInputs(lanes, vector_length_, 0, inputs);
+  switch (org->GetKind()) {
+    case HInstruction::kArrayGet:
+      return Insert(cursor, new (allocator) HVecLoad(allocator,
+                                                     org->InputAt(0),
+                                                     org->InputAt(1),
+                                                     packed_type_,
+                                                     org->GetSideEffects(),
+                                                     vector_length_,
+                                                     /*is_string_char_at=*/ false,
+                                                     dex_pc));
+    case HInstruction::kTypeConversion:
+      return GeneratePack(inputs, cursor);
+    default:
+      break;
+  }
+  HInstruction* opa = GeneratePack(inputs, cursor);
+  HInstruction* opb = nullptr;
+  if (org->IsShl() || org->IsShr() || org->IsUShr()) {
+    opb = org->InputAt(1);  // scalar shift distance
+  } else if (org->IsBinaryOperation()) {
+    GetLaneInputs(lanes, vector_length_, 1, inputs);
+    opb = GeneratePack(inputs, cursor);
+  }
+  HInstruction* vector = nullptr;
+  switch (org->GetKind()) {
+    case HInstruction::kNeg:
+      vector = new (allocator) HVecNeg(allocator, opa, packed_type_, vector_length_, dex_pc);
+      break;
+    case HInstruction::kNot:
+      vector = new (allocator) HVecNot(allocator, opa, packed_type_, vector_length_, dex_pc);
+      break;
+    case HInstruction::kAbs:
+      vector = new (allocator) HVecAbs(allocator, opa, packed_type_, vector_length_, dex_pc);
+      break;
+    case HInstruction::kAdd:
+      vector = new (allocator) HVecAdd(allocator, opa, opb, packed_type_, vector_length_, dex_pc);
+      break;
+    case HInstruction::kSub:
+      vector = new (allocator) HVecSub(allocator, opa, opb, packed_type_, vector_length_, dex_pc);
+      break;
+    case HInstruction::kMul:
+      vector = new (allocator) HVecMul(allocator, opa, opb, packed_type_, vector_length_, dex_pc);
+      break;
+    case HInstruction::kAnd:
+      vector = new (allocator) HVecAnd(allocator, opa, opb, packed_type_, vector_length_, dex_pc);
+      break;
+    case HInstruction::kOr:
+      vector = new (allocator) HVecOr(allocator, opa, opb, packed_type_, vector_length_, dex_pc);
+      break;
+    case HInstruction::kXor:
+      vector = new (allocator) HVecXor(allocator, opa, opb, packed_type_, vector_length_, dex_pc);
+      break;
+    case HInstruction::kShl:
+      vector = new (allocator) HVecShl(allocator, opa, opb, packed_type_, vector_length_, dex_pc);
+      break;
+    case HInstruction::kShr:
+      vector = new (allocator) HVecShr(allocator, opa, opb, packed_type_, vector_length_, dex_pc);
+      break;
+    case HInstruction::kUShr:
+      vector = new (allocator) HVecUShr(allocator, opa, opb, packed_type_, vector_length_, dex_pc);
+      break;
+    default:
+      break;
+  }
+  CHECK(vector != nullptr) << "Unsupported SIMD operator";
+  return Insert(cursor, vector);
+}
+
+//
+// Helpers.
+//
+
+bool HSuperwordVectorizer::TrySetVectorType(DataType::Type type) {
+  const InstructionSetFeatures* features =
+      codegen_.GetCompilerOptions().GetInstructionSetFeatures();
+  restrictions_ = kNone;
+  size_t vector_size = 0;
+  switch (codegen_.GetCompilerOptions().GetInstructionSet()) {
+    case InstructionSet::kArm64:
+      // Android assumes that ARMv8 AArch64 always supports advanced SIMD (128-bit SIMD).
+      vector_size = 16;
+      if (type == DataType::Type::kInt64) {
+        restrictions_ |= kNoMul;
+      }
+      break;
+    case InstructionSet::kX86:
+    case InstructionSet::kX86_64:
+      // Allow vectorization for SSE4.1-enabled X86 devices only (128-bit SIMD).
+      if (!features->AsX86InstructionSetFeatures()->HasSSE4_1()) {
+        return false;
+      }
+      vector_size = 16;
+      switch (type) {
+        case DataType::Type::kUint8:
+        case DataType::Type::kInt8:
+          restrictions_ |= kNoMul | kNoShift | kNoAbs;
+          break;
+        case DataType::Type::kUint16:
+        case DataType::Type::kInt16:
+          restrictions_ |= kNoAbs;
+          break;
+        case DataType::Type::kInt64:
+          restrictions_ |= kNoMul | kNoShr | kNoAbs;
+          break;
+        default:
+          break;
+      }
+      break;
+    default:
+      return false;
+  }
+  switch (type) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+      // Narrow lanes are computed in int precision in the scalar code.
+      restrictions_ |= kNoHiBits;
+      break;
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      break;
+    default:
+      return false;
+  }
+  packed_type_ = type;
+  vector_length_ = vector_size / DataType::Size(type);
+  DCHECK_LE(vector_length_, kMaxLanes);
+  return true;
+}
+
+bool HSuperwordVectorizer::IsPackedType(DataType::Type type) const {
+  if (HasVectorRestrictions(kNoHiBits)) {
+    // Any int-or-narrower integral value that keeps all bits of the lanes.
+    return DataType::IsIntegralType(type) &&
+           type != DataType::Type::kBool &&
+           DataType::Size(type) >= DataType::Size(packed_type_) &&
+           DataType::Size(type) <= DataType::Size(DataType::Type::kInt32);
+  }
+  return type == packed_type_;
+}
+
+HInstruction* HSuperwordVectorizer::Insert(HInstruction* cursor, HInstruction* instruction) {
+  cursor->GetBlock()->InsertInstructionBefore(instruction, cursor);
+  return instruction;
+}
+
+}  // namespace art
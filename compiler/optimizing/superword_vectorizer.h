@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_SUPERWORD_VECTORIZER_H_
+#define ART_COMPILER_OPTIMIZING_SUPERWORD_VECTORIZER_H_
+
+#include "base/scoped_arena_allocator.h"
+#include "base/scoped_arena_containers.h"
+#include "nodes.h"
+#include "optimization.h"
+
+namespace art {
+
+class CodeGenerator;
+
+/**
+ * Superword-level parallelism (SLP) vectorization of straight-line code. Within each
+ * basic block, stores to adjacent elements of the same array, as in
+ *
+ *   a[i + 0] = b[i + 0] + c[i + 0];
+ *   a[i + 1] = b[i + 1] + c[i + 1];
+ *   a[i + 2] = b[i + 2] + c[i + 2];
+ *   a[i + 3] = b[i + 3] + c[i + 3];
+ *
+ * are packed into a single vector store whenever the stored values are computed by
+ * isomorphic expression trees over adjacent array loads and common scalars. The
+ * packed trees are rewritten into the same HVec* nodes used by loop vectorization,
+ * so that the existing vector code generators apply.
+ *
+ * This pass runs after bounds check elimination, since only references without
+ * remaining bounds checks can be packed.
+ */
+class HSuperwordVectorizer : public HOptimization {
+ public:
+  HSuperwordVectorizer(HGraph* graph,
+                       const CodeGenerator& codegen,
+                       OptimizingCompilerStats* stats,
+                       const char* name = kSuperwordVectorizerPassName);
+
+  bool Run() override;
+
+  static constexpr const char* kSuperwordVectorizerPassName = "superword_vectorizer";
+
+  // Maximum number of lanes in a pack (byte elements in a 128-bit SIMD register).
+  static constexpr size_t kMaxLanes = 16;
+
+ private:
+  // Vector restrictions, a subset of those of the loop vectorizer.
+  enum VectorRestrictions {
+    kNone     = 0,        // no restrictions
+    kNoMul    = 1 << 0,   // no multiplication
+    kNoShift  = 1 << 1,   // no shift
+    kNoShr    = 1 << 2,   // no arithmetic shift right
+    kNoAbs    = 1 << 3,   // no absolute value
+    kNoHiBits = 1 << 4,   // "wider" operations cannot bring in higher order bits
+  };
+
+  // Packs stores in the given block. Returns true if any pack was generated.
+  bool VectorizeBlock(HBasicBlock* block);
+
+  // Tries to pack the stores (one per lane) into a single vector store, given the
+  // instructions of the block in order and the position of each instruction.
+  bool TryPackStores(HInstruction* const stores[],
+                     const ScopedArenaVector<HInstruction*>& instructions,
+                     const ScopedArenaSafeMap<HInstruction*, size_t>& positions);
+
+  // Analysis and synthesis of a pack of isomorphic instructions, one per lane.
+  bool CanPack(HInstruction* const lanes[], size_t depth);
+  HInstruction* GeneratePack(HInstruction* const lanes[], HInstruction* cursor);
+
+  // Helpers.
+  bool TrySetVectorType(DataType::Type type);
+  bool HasVectorRestrictions(uint64_t restrictions) const {
+    return (restrictions_ & restrictions) != 0;
+  }
+  bool IsPackedType(DataType::Type type) const;
+  HInstruction* Insert(HInstruction* cursor, HInstruction* instruction);
+
+  // Target properties.
+  const CodeGenerator& codegen_;
+
+  // Properties of the pack under consideration.
+  DataType::Type packed_type_;
+  size_t vector_length_;
+  uint64_t restrictions_;
+  HInstruction* const* stores_;
+
+  // Scalar instructions replaced by the pack under consideration.
+  // Contents reside in phase-local heap memory.
+  ScopedArenaVector<HInstruction*>* members_;
+
+  DISALLOW_COPY_AND_ASSIGN(HSuperwordVectorizer);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_SUPERWORD_VECTORIZER_H_
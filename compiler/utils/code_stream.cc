@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "code_stream.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include <android-base/logging.h>
+
+#include "base/bit_utils.h"
+#include "base/globals.h"
+#include "thread-current-inl.h"
+
+namespace art {
+
+// The chunk size by which the code stream file is increased and mapped.
+static constexpr size_t kMinimumSegmentSize = 16 * MB;
+
+static void PWriteFully(int fd, ArrayRef<const uint8_t> data, size_t file_offset) {
+  const uint8_t* ptr = data.data();
+  size_t remaining = data.size();
+  while (remaining != 0u) {
+    ssize_t written = TEMP_FAILURE_RETRY(pwrite64(fd, ptr, remaining, file_offset));
+    if (written <= 0) {
+      PLOG(FATAL) << "Unable to write to code stream file at offset " << file_offset;
+    }
+    ptr += written;
+    remaining -= static_cast<size_t>(written);
+    file_offset += static_cast<size_t>(written);
+  }
+}
+
+CodeStream::CodeStream(int fd)
+    : fd_(fd),
+      last_segment_used_(0u),
+      file_size_(0u),
+      lock_("CodeStream lock", static_cast<LockLevel>(LockLevel::kDefaultMutexLevel - 1)) {
+  // Assume that the file is unlinked.
+}
+
+CodeStream::~CodeStream() {
+  for (const Segment& segment : segments_) {
+    if (munmap(segment.begin, segment.size) != 0) {
+      PLOG(ERROR) << "Failed to unmap code stream segment at "
+          << static_cast<const void*>(segment.begin) << " size=" << segment.size;
+    }
+  }
+  close(fd_);
+}
+
+const uint8_t* CodeStream::Append(ArrayRef<const uint8_t> header, ArrayRef<const uint8_t> data) {
+  size_t size = RoundUp(header.size() + data.size(), 8u);
+  uint8_t* result;
+  size_t file_offset;
+  {
+    MutexLock lock(Thread::Current(), lock_);
+    if (segments_.empty() || segments_.back().size - last_segment_used_ < size) {
+      if (!segments_.empty()) {
+        StartWriteback(segments_.back());
+      }
+      segments_.push_back(NewSegment(size));
+      last_segment_used_ = 0u;
+    }
+    const Segment& segment = segments_.back();
+    result = segment.begin + last_segment_used_;
+    file_offset = segment.file_offset + last_segment_used_;
+    last_segment_used_ += size;
+  }
+  // The space is reserved, write the data without holding the lock. The file was already
+  // extended to cover the segment, so the padding reads as zeros.
+  PWriteFully(fd_, header, file_offset);
+  PWriteFully(fd_, data, file_offset + header.size());
+  return result;
+}
+
+size_t CodeStream::GetSize() {
+  MutexLock lock(Thread::Current(), lock_);
+  return segments_.empty() ? 0u : segments_.back().file_offset + last_segment_used_;
+}
+
+CodeStream::Segment CodeStream::NewSegment(size_t min_size) {
+#if !defined(__APPLE__)
+  size_t size = std::max(RoundUp(min_size, kPageSize), RoundUp(kMinimumSegmentSize, kPageSize));
+  int result = TEMP_FAILURE_RETRY(ftruncate64(fd_, file_size_ + size));
+  if (result != 0) {
+    PLOG(FATAL) << "Unable to increase code stream file.";
+  }
+  uint8_t* ptr = reinterpret_cast<uint8_t*>(
+      mmap(nullptr, size, PROT_READ, MAP_SHARED, fd_, file_size_));
+  if (ptr == MAP_FAILED) {
+    PLOG(FATAL) << "Unable to mmap new code stream segment. Current size: " << file_size_
+        << " requested: " << size << "/" << min_size;
+  }
+  Segment segment = { ptr, file_size_, size };
+  file_size_ += size;
+  return segment;
+#else
+  UNUSED(min_size, kMinimumSegmentSize);
+  LOG(FATAL) << "No code stream support on the Mac.";
+  UNREACHABLE();
+#endif
+}
+
+void CodeStream::StartWriteback(const Segment& segment) {
+#if defined(__linux__)
+  // Ask the kernel to start writing out the full segment now, so that its pages become clean
+  // and can be dropped under memory pressure instead of waiting for the periodic writeback.
+  // Writes that are still in flight on other threads are simply flushed later.
+  if (sync_file_range(fd_, segment.file_offset, segment.size, SYNC_FILE_RANGE_WRITE) != 0) {
+    PLOG(WARNING) << "Failed to start writeback of code stream segment.";
+  }
+#else
+  UNUSED(segment);
+#endif
+}
+
+}  // namespace art
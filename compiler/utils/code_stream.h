@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_UTILS_CODE_STREAM_H_
+#define ART_COMPILER_UTILS_CODE_STREAM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "base/array_ref.h"
+#include "base/macros.h"
+#include "base/mutex.h"
+
+namespace art {
+
+// Append-only storage for compiled code and stack maps, backed by an unlinked file.
+//
+// Unlike the SwapSpace, the data is never written through a writable mapping. It is appended
+// to the file with pwrite() as soon as a method is compiled and read back through read-only
+// shared mappings of the file. Written data is flushed to the file in the background, so the
+// compiled code of the whole app lives in clean page cache pages that the kernel can drop at
+// any time, rather than in dirty memory that adds up until the oat file is written.
+//
+// There is no Free(), the space of released data is not reused.
+class CodeStream {
+ public:
+  // Takes ownership of `fd`, which must refer to an empty file.
+  explicit CodeStream(int fd);
+  ~CodeStream();
+
+  // Appends `header` followed by `data` and returns the address of the mapped copy of
+  // `header`. The result is aligned to 8 bytes and stays valid until the stream is destroyed.
+  const uint8_t* Append(ArrayRef<const uint8_t> header, ArrayRef<const uint8_t> data)
+      REQUIRES(!lock_);
+
+  // Returns the number of bytes appended so far, including padding.
+  size_t GetSize() REQUIRES(!lock_);
+
+ private:
+  // A read-only mapping of a part of the file.
+  struct Segment {
+    uint8_t* begin;
+    size_t file_offset;
+    size_t size;
+  };
+
+  Segment NewSegment(size_t min_size) REQUIRES(lock_);
+  void StartWriteback(const Segment& segment) REQUIRES(lock_);
+
+  const int fd_;
+
+  // Segments mapped so far. Data is appended to the last one.
+  std::vector<Segment> segments_ GUARDED_BY(lock_);
+  // Number of bytes used in the last segment.
+  size_t last_segment_used_ GUARDED_BY(lock_);
+  // Size of the file, i.e. the end of the last segment.
+  size_t file_size_ GUARDED_BY(lock_);
+
+  Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+
+  DISALLOW_COPY_AND_ASSIGN(CodeStream);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_UTILS_CODE_STREAM_H_
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/code_stream.h"
+
+#include <unistd.h>
+
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "base/bit_utils.h"
+#include "common_runtime_test.h"
+
+namespace art {
+
+class CodeStreamTest : public CommonRuntimeTest {
+};
+
+TEST_F(CodeStreamTest, Append) {
+  ScratchFile scratch;
+  int fd = dup(scratch.GetFd());
+  ASSERT_NE(fd, -1);
+  unlink(scratch.GetFilename().c_str());
+
+  CodeStream stream(fd);
+  EXPECT_EQ(0u, stream.GetSize());
+
+  // Enough data to need several segments, including one larger than the default segment size.
+  std::vector<std::vector<uint8_t>> data;
+  std::vector<const uint8_t*> copies;
+  for (size_t i = 0; i != 20; ++i) {
+    size_t size = (i == 10u) ? 40 * MB : (i * 997u) % (3 * MB) + 1u;
+    data.emplace_back(size);
+    for (size_t j = 0; j != size; ++j) {
+      data.back()[j] = static_cast<uint8_t>(i * 31u + j);
+    }
+    uint32_t header = static_cast<uint32_t>(size);
+    const uint8_t* copy = stream.Append(
+        ArrayRef<const uint8_t>(reinterpret_cast<const uint8_t*>(&header), sizeof(header)),
+        ArrayRef<const uint8_t>(data.back()));
+    ASSERT_TRUE(IsAligned<8u>(copy));
+    copies.push_back(copy);
+  }
+
+  // Verify contents after all appends, some of them are in earlier segments.
+  for (size_t i = 0; i != data.size(); ++i) {
+    uint32_t header;
+    memcpy(&header, copies[i], sizeof(header));
+    ASSERT_EQ(data[i].size(), header);
+    EXPECT_EQ(0, memcmp(data[i].data(), copies[i] + sizeof(header), data[i].size())) << i;
+  }
+  EXPECT_GE(stream.GetSize(), 40 * MB);
+
+  scratch.Close();
+}
+
+}  // namespace art
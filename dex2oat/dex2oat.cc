@@ -77,6 +77,8 @@
 #include "dex/verification_results.h"
 #include "dex2oat_options.h"
 #include "dexlayout.h"
+#include "driver/compile_cache.h"
+#include "driver/compile_cache_store.h"
 #include "driver/compiler_driver.h"
 #include "driver/compiler_options.h"
 #include "driver/compiler_options_map-inl.h"
@@ -187,11 +189,12 @@ static std::string StrippedCommandLine() {
 
     // However, we prefer to drop this when we saw --zip-fd.
     if (saw_zip_fd) {
-      // Drop anything --zip-X, --dex-X, --oat-X, --swap-X, or --app-image-X
+      // Drop anything --zip-X, --dex-X, --oat-X, --swap-X, --code-stream-X, or --app-image-X
       if (android::base::StartsWith(original_argv[i], "--zip-") ||
           android::base::StartsWith(original_argv[i], "--dex-") ||
           android::base::StartsWith(original_argv[i], "--oat-") ||
           android::base::StartsWith(original_argv[i], "--swap-") ||
+          android::base::StartsWith(original_argv[i], "--code-stream-") ||
           android::base::StartsWith(original_argv[i], "--app-image-")) {
         continue;
       }
@@ -726,6 +729,13 @@ class Dex2Oat final {
       Usage("Input must be supplied with either --dex-file or --zip-fd");
     }
 
+    if (!incremental_cache_path_.empty() +
+            !compile_cache_dir_.empty() +
+            !compile_cache_socket_.empty() > 1) {
+      Usage("Only one of --incremental-cache, --compile-cache-dir and --compile-cache-socket "
+            "can be used");
+    }
+
     if (!dex_filenames_.empty() && zip_fd_ != -1) {
       Usage("--dex-file should not be used with --zip-fd");
     }
@@ -1080,6 +1090,8 @@ class Dex2Oat final {
     AssignIfExists(args, M::SwapFileFd, &swap_fd_);
     AssignIfExists(args, M::SwapDexSizeThreshold, &min_dex_file_cumulative_size_for_swap_);
     AssignIfExists(args, M::SwapDexCountThreshold, &min_dex_files_for_swap_);
+    AssignIfExists(args, M::CodeStreamFile, &code_stream_file_name_);
+    AssignIfExists(args, M::CodeStreamFd, &code_stream_fd_);
     AssignIfExists(args, M::VeryLargeAppThreshold, &very_large_threshold_);
     AssignIfExists(args, M::AppImageFile, &app_image_file_name_);
     AssignIfExists(args, M::AppImageFileFd, &app_image_fd_);
@@ -1093,6 +1105,9 @@ class Dex2Oat final {
     AssignTrueIfExists(args, M::CrashOnLinkageViolation, &crash_on_linkage_violation_);
     AssignTrueIfExists(args, M::ForceAllowOjInlines, &force_allow_oj_inlines_);
     AssignIfExists(args, M::PublicSdk, &public_sdk_);
+    AssignIfExists(args, M::IncrementalCache, &incremental_cache_path_);
+    AssignIfExists(args, M::CompileCacheDir, &compile_cache_dir_);
+    AssignIfExists(args, M::CompileCacheSocket, &compile_cache_socket_);
     AssignIfExists(args, M::ApexVersions, &apex_versions_argument_);
 
     AssignIfExists(args, M::Backend, &compiler_kind_);
@@ -1383,6 +1398,18 @@ class Dex2Oat final {
       unlink(swap_file_name_.c_str());
     }
 
+    // Code stream file handling, the same as for the swap file. Unlike swap, the code stream is
+    // used regardless of the size of the input.
+    if (code_stream_fd_ == -1 && !code_stream_file_name_.empty()) {
+      std::unique_ptr<File> code_stream_file(OS::CreateEmptyFile(code_stream_file_name_.c_str()));
+      if (code_stream_file.get() == nullptr) {
+        PLOG(ERROR) << "Failed to create code stream file: " << code_stream_file_name_;
+        return false;
+      }
+      code_stream_fd_ = code_stream_file->Release();
+      unlink(code_stream_file_name_.c_str());
+    }
+
     return true;
   }
 
@@ -1701,6 +1728,7 @@ class Dex2Oat final {
       }
     }
     // Note that dex2oat won't close the swap_fd_. The compiler driver's swap space will do that.
+    // The same goes for the code_stream_fd_.
 
     if (!IsBootImage() && !IsBootImageExtension()) {
       constexpr bool kSaveDexInput = false;
@@ -1878,10 +1906,16 @@ class Dex2Oat final {
     }
     compiler_options_->profile_compilation_info_ = profile_compilation_info_.get();
 
+    if (compiler_options_->IsAnyCompilationEnabled()) {
+      OpenCompileCache();
+    }
+
     driver_.reset(new CompilerDriver(compiler_options_.get(),
                                      compiler_kind_,
                                      thread_count_,
-                                     swap_fd_));
+                                     swap_fd_,
+                                     code_stream_fd_));
+    driver_->SetCompileCache(compile_cache_.get());
 
     driver_->PrepareDexFilesForOatFile(timings_);
 
@@ -1915,6 +1949,57 @@ class Dex2Oat final {
     return CompileDexFiles(dex_files);
   }
 
+  // Open the cache given by --incremental-cache, --compile-cache-dir or --compile-cache-socket,
+  // if any. A cache that cannot be used only means that all methods are compiled.
+  void OpenCompileCache() {
+    TimingLogger::ScopedTiming t("Open compile cache", timings_);
+    std::unique_ptr<CompileCacheStore> store;
+    std::string error_msg;
+    if (!incremental_cache_path_.empty()) {
+      store = CompileCacheStore::CreateFileStore(incremental_cache_path_, &error_msg);
+    } else if (!compile_cache_dir_.empty()) {
+      store = CompileCacheStore::CreateDirectoryStore(compile_cache_dir_, &error_msg);
+    } else if (!compile_cache_socket_.empty()) {
+      store = CompileCacheStore::CreateSocketStore(compile_cache_socket_, &error_msg);
+    } else {
+      return;
+    }
+    if (store != nullptr) {
+      std::vector<const DexFile*> class_path_files;
+      if (!IsBootImage() && !IsBootImageExtension()) {
+        class_path_files = class_loader_context_->FlattenOpenedDexFiles();
+      }
+      compile_cache_ = CompileCache::Create(*compiler_options_,
+                                            *key_value_store_,
+                                            Runtime::Current()->GetClassLinker()->GetBootClassPath(),
+                                            class_path_files,
+                                            public_sdk_,
+                                            std::move(store),
+                                            &error_msg);
+    }
+    if (compile_cache_ == nullptr) {
+      LOG(WARNING) << "Not using compile cache: " << error_msg;
+    }
+  }
+
+  // Make the methods of this compilation available to the next ones. A failure only
+  // means that they will not reuse them.
+  void SaveCompileCache() {
+    if (compile_cache_ == nullptr) {
+      return;
+    }
+    TimingLogger::ScopedTiming t("Save compile cache", timings_);
+    LOG(INFO) << "Compile cache: " << compile_cache_->GetNumberOfHits()
+              << " methods reused, " << compile_cache_->GetNumberOfMisses()
+              << " methods compiled";
+    std::string error_msg;
+    if (!compile_cache_->Save(&error_msg)) {
+      LOG(WARNING) << "Failed to save compile cache: " << error_msg;
+    }
+    driver_->SetCompileCache(nullptr);
+    compile_cache_.reset();
+  }
+
   // Create the class loader, use it to compile, and return.
   jobject CompileDexFiles(const std::vector<const DexFile*>& dex_files) {
     ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
@@ -2956,6 +3041,7 @@ class Dex2Oat final {
   std::vector<std::unique_ptr<OutputStream>> vdex_out_;
   std::unique_ptr<linker::ImageWriter> image_writer_;
   std::unique_ptr<CompilerDriver> driver_;
+  std::unique_ptr<CompileCache> compile_cache_;
 
   std::vector<MemMap> opened_dex_files_maps_;
   std::vector<std::unique_ptr<const DexFile>> opened_dex_files_;
@@ -2966,6 +3052,8 @@ class Dex2Oat final {
   int swap_fd_;
   size_t min_dex_files_for_swap_ = kDefaultMinDexFilesForSwap;
   size_t min_dex_file_cumulative_size_for_swap_ = kDefaultMinDexFileCumulativeSizeForSwap;
+  std::string code_stream_file_name_;
+  int code_stream_fd_ = File::kInvalidFd;
   size_t very_large_threshold_ = std::numeric_limits<size_t>::max();
   std::string app_image_file_name_;
   int app_image_fd_;
@@ -3007,6 +3095,13 @@ class Dex2Oat final {
   // The classpath that determines if a given symbol should be resolved at compile time or not.
   std::string public_sdk_;
 
+  // The file keeping compiled code across compilations, if any.
+  std::string incremental_cache_path_;
+
+  // The directory or daemon socket keeping compiled code shared by compilations, if any.
+  std::string compile_cache_dir_;
+  std::string compile_cache_socket_;
+
   // The apex versions of jars in the boot classpath. Set through command line
   // argument.
   std::string apex_versions_argument_;
@@ -3061,6 +3156,8 @@ static dex2oat::ReturnCode DoCompilation(Dex2Oat& dex2oat) {
   // process.
   ScopedGlobalRef global_ref(class_loader);
 
+  dex2oat.SaveCompileCache();
+
   if (!dex2oat.WriteOutputFiles(class_loader)) {
     dex2oat.EraseOutputFiles();
     return dex2oat::ReturnCode::kOther;
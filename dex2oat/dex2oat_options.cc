@@ -233,7 +233,18 @@ static void AddSwapMappings(Builder& builder) {
       .Define("--swap-dex-count-threshold=_")
           .WithType<unsigned int>()
           .WithHelp("specifies the minimum number of dex file to allow the use of swap.")
-          .IntoKey(M::SwapDexCountThreshold);
+          .IntoKey(M::SwapDexCountThreshold)
+      .Define("--code-stream-file=_")
+          .WithType<std::string>()
+          .WithHelp("Specify a file to stream the compiled code and stack maps to as methods are\n"
+                    "compiled, instead of keeping them in memory until the oat file is written.\n"
+                    "Lowers the peak memory use for large apps.\n"
+                    "Eg: --code-stream-file=/data/tmp/code")
+          .IntoKey(M::CodeStreamFile)
+      .Define("--code-stream-fd=_")
+          .WithType<int>()
+          .WithHelp("Same as --code-stream-file, by file-descriptor. Eg: --code-stream-fd=3")
+          .IntoKey(M::CodeStreamFd);
 }
 
 static void AddCompilerMappings(Builder& builder) {
@@ -439,6 +450,30 @@ Parser CreateDex2oatArgumentParser() {
       .Define("--public-sdk=_")
           .WithType<std::string>()
           .IntoKey(M::PublicSdk)
+      .Define("--incremental-cache=_")
+          .WithType<std::string>()
+          .WithHelp("Specify a file that keeps the compiled code of the methods across\n"
+                    "compilations. Methods whose code and dependencies did not change since the\n"
+                    "previous compilation with the same file reuse its compiled code.\n"
+                    "Not supported when compiling images.\n"
+                    "Example: --incremental-cache=/data/local/tmp/app.cache")
+          .IntoKey(M::IncrementalCache)
+      .Define("--compile-cache-dir=_")
+          .WithType<std::string>()
+          .WithHelp("Specify a directory that keeps the compiled code of the methods, shared by\n"
+                    "all the compilations using it. Methods with the same code and dependencies\n"
+                    "in a dex file with the same identifiers, such as an unchanged dex file of\n"
+                    "an app, reuse the compiled code. The compiled code is not verified, the\n"
+                    "directory must only be writable by trusted compilations.\n"
+                    "Not supported when compiling images.\n"
+                    "Example: --compile-cache-dir=/build/dex2oat-cache")
+          .IntoKey(M::CompileCacheDir)
+      .Define("--compile-cache-socket=_")
+          .WithType<std::string>()
+          .WithHelp("Like --compile-cache-dir, but using a cache daemon listening on the given\n"
+                    "local socket, see compile_cache_store.h for the protocol.\n"
+                    "Example: --compile-cache-socket=/run/dex2oat-cache.sock")
+          .IntoKey(M::CompileCacheSocket)
       .Define("--apex-versions=_")
           .WithType<std::string>()
           .WithHelp("Versions of apexes in the boot classpath, separated by '/'")
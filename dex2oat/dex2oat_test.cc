@@ -14,19 +14,28 @@
  * limitations under the License.
  */
 
+#include <dirent.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
 #include <algorithm>
+#include <array>
 #include <iterator>
+#include <map>
 #include <regex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include "android-base/file.h"
 #include "android-base/logging.h"
 #include "android-base/macros.h"
 #include "android-base/stringprintf.h"
+#include "android-base/unique_fd.h"
 #include "arch/instruction_set_features.h"
 #include "base/macros.h"
 #include "base/mutex-inl.h"
@@ -203,6 +212,20 @@ class Dex2oatTest : public Dex2oatEnvironmentTest {
     EXPECT_EQ(expected, actual);
   }
 
+  // Returns whether dex2oat logged the number of methods whose compiled code it reused from
+  // the compile cache and the number of methods it compiled. The logs are only captured on
+  // the host.
+  bool ParseCompileCacheStats(/*out*/ size_t* hits, /*out*/ size_t* misses) {
+    std::regex stats_regex("Compile cache: ([0-9]+) methods reused, ([0-9]+) methods compiled");
+    std::smatch stats_match;
+    if (!std::regex_search(output_, stats_match, stats_regex)) {
+      return false;
+    }
+    *hits = std::stoul(stats_match[1].str());
+    *misses = std::stoul(stats_match[2].str());
+    return true;
+  }
+
   std::string output_ = "";
   std::string error_msg_ = "";
 };
@@ -320,6 +343,15 @@ TEST_F(Dex2oatSwapTest, DoUseSwapSingleSmall) {
           { "--swap-dex-size-threshold=0", "--swap-dex-count-threshold=0" });
 }
 
+TEST_F(Dex2oatSwapTest, UseCodeStream) {
+  std::string code_stream_location = GetOdexDir() + "/Dex2OatSwapTest.odex.code";
+  RunTest(/*use_fd=*/ false,
+          /*expect_use=*/ false,
+          { "--code-stream-file=" + code_stream_location });
+  // The code stream file is unlinked right after it is created.
+  EXPECT_FALSE(OS::FileExists(code_stream_location.c_str()));
+}
+
 class Dex2oatSwapUseTest : public Dex2oatSwapTest {
  protected:
   void CheckHostResult(bool expect_use) override {
@@ -1562,6 +1594,398 @@ TEST_F(Dex2oatDedupeCode, DedupeTest) {
   EXPECT_LT(dedupe_size, no_dedupe_size);
 }
 
+TEST_F(Dex2oatTest, IncrementalCache) {
+  std::unique_ptr<const DexFile> dex(OpenTestDexFile("ManyMethods"));
+  std::string out_dir = GetScratchDir();
+  const std::string base_oat_name = out_dir + "/base.oat";
+  const std::string first_oat_name = out_dir + "/first.oat";
+  const std::string cache_name = out_dir + "/base.cache";
+  const std::vector<std::string> args = {
+      "--force-determinism", "--avoid-storing-invocation", "--incremental-cache=" + cache_name };
+  ASSERT_TRUE(GenerateOdexForTest(dex->GetLocation(),
+                                  base_oat_name,
+                                  CompilerFilter::Filter::kSpeed,
+                                  args));
+  std::unique_ptr<File> first_cache(OS::OpenFileForReading(cache_name.c_str()));
+  ASSERT_TRUE(first_cache != nullptr);
+  EXPECT_FALSE(OS::FileExists((cache_name + ".tmp").c_str()));
+  Copy(base_oat_name, first_oat_name);
+  size_t hits = 0u;
+  size_t misses = 0u;
+  if (!kIsTargetBuild) {
+    ASSERT_TRUE(ParseCompileCacheStats(&hits, &misses)) << output_;
+    EXPECT_EQ(hits, 0u);
+    EXPECT_NE(misses, 0u);
+  }
+  const size_t number_of_compiled_methods = misses;
+
+  // The second compilation reuses the compiled code of all methods, and must produce the
+  // same oat file and cache.
+  output_ = "";
+  ASSERT_TRUE(GenerateOdexForTest(dex->GetLocation(),
+                                  base_oat_name,
+                                  CompilerFilter::Filter::kSpeed,
+                                  args));
+  if (!kIsTargetBuild) {
+    ASSERT_TRUE(ParseCompileCacheStats(&hits, &misses)) << output_;
+    EXPECT_EQ(hits, number_of_compiled_methods);
+    EXPECT_EQ(misses, 0u);
+  }
+  std::unique_ptr<File> second_cache(OS::OpenFileForReading(cache_name.c_str()));
+  ASSERT_TRUE(second_cache != nullptr);
+  EXPECT_EQ(first_cache->GetLength(), second_cache->GetLength());
+  std::unique_ptr<File> first_oat(OS::OpenFileForReading(first_oat_name.c_str()));
+  std::unique_ptr<File> second_oat(OS::OpenFileForReading(base_oat_name.c_str()));
+  ASSERT_TRUE(first_oat != nullptr);
+  ASSERT_TRUE(second_oat != nullptr);
+  EXPECT_EQ(first_oat->Compare(second_oat.get()), 0) << first_oat_name << " " << base_oat_name;
+}
+
+// A corrupt entry is compiled again, and is not counted as a hit nor kept in the cache.
+TEST_F(Dex2oatTest, IncrementalCacheCorruptEntry) {
+  std::unique_ptr<const DexFile> dex(OpenTestDexFile("ManyMethods"));
+  std::string out_dir = GetScratchDir();
+  const std::string base_oat_name = out_dir + "/base.oat";
+  const std::string cache_name = out_dir + "/base.cache";
+  const std::vector<std::string> args = {
+      "--force-determinism", "--avoid-storing-invocation", "--incremental-cache=" + cache_name };
+  ASSERT_TRUE(GenerateOdexForTest(dex->GetLocation(),
+                                  base_oat_name,
+                                  CompilerFilter::Filter::kSpeed,
+                                  args));
+  size_t hits = 0u;
+  size_t misses = 0u;
+  if (!kIsTargetBuild) {
+    ASSERT_TRUE(ParseCompileCacheStats(&hits, &misses)) << output_;
+  }
+  const size_t number_of_compiled_methods = misses;
+
+  // The last byte of the file is part of the checksum of the last entry.
+  int64_t cache_length;
+  {
+    std::unique_ptr<File> file(OS::OpenFileReadWrite(cache_name.c_str()));
+    ASSERT_TRUE(file != nullptr);
+    cache_length = file->GetLength();
+    ASSERT_GT(cache_length, 0);
+    uint8_t last_byte;
+    ASSERT_TRUE(file->PreadFully(&last_byte, sizeof(last_byte), cache_length - 1));
+    last_byte ^= 1u;
+    ASSERT_TRUE(file->PwriteFully(&last_byte, sizeof(last_byte), cache_length - 1));
+    ASSERT_EQ(file->FlushClose(), 0);
+  }
+
+  output_ = "";
+  ASSERT_TRUE(GenerateOdexForTest(dex->GetLocation(),
+                                  base_oat_name,
+                                  CompilerFilter::Filter::kSpeed,
+                                  args));
+  if (!kIsTargetBuild) {
+    ASSERT_TRUE(ParseCompileCacheStats(&hits, &misses)) << output_;
+    EXPECT_EQ(hits, number_of_compiled_methods - 1u);
+    EXPECT_EQ(misses, 1u);
+  }
+  // The corrupt entry was replaced by the recompiled method, not kept in addition to it.
+  std::unique_ptr<File> cache(OS::OpenFileForReading(cache_name.c_str()));
+  ASSERT_TRUE(cache != nullptr);
+  EXPECT_EQ(cache->GetLength(), cache_length);
+
+  output_ = "";
+  ASSERT_TRUE(GenerateOdexForTest(dex->GetLocation(),
+                                  base_oat_name,
+                                  CompilerFilter::Filter::kSpeed,
+                                  args));
+  if (!kIsTargetBuild) {
+    ASSERT_TRUE(ParseCompileCacheStats(&hits, &misses)) << output_;
+    EXPECT_EQ(hits, number_of_compiled_methods);
+    EXPECT_EQ(misses, 0u);
+  }
+}
+
+// Only the methods of a changed class and of the classes that depend on it are compiled
+// again, and the oat file is the same as without the cache.
+TEST_F(Dex2oatTest, IncrementalCacheChangedClass) {
+  std::string out_dir = GetScratchDir();
+  const std::string dex_location = out_dir + "/CompileCache.jar";
+  const std::string base_oat_name = out_dir + "/base.oat";
+  const std::string cached_oat_name = out_dir + "/cached.oat";
+  const std::string cache_name = out_dir + "/base.cache";
+  const std::vector<std::string> args = { "--force-determinism", "--avoid-storing-invocation" };
+  std::vector<std::string> cache_args = args;
+  cache_args.push_back("--incremental-cache=" + cache_name);
+  Copy(GetTestDexFileName("CompileCache"), dex_location);
+  ASSERT_TRUE(GenerateOdexForTest(dex_location,
+                                  base_oat_name,
+                                  CompilerFilter::Filter::kSpeed,
+                                  cache_args));
+
+  // The modified dex file has the same classes and identifiers, and only differs in the code
+  // of Constant.get(), which User.use() calls. Independent does not depend on either.
+  Copy(GetTestDexFileName("CompileCacheModified"), dex_location);
+  output_ = "";
+  ASSERT_TRUE(GenerateOdexForTest(dex_location,
+                                  base_oat_name,
+                                  CompilerFilter::Filter::kSpeed,
+                                  cache_args));
+  if (!kIsTargetBuild) {
+    size_t hits = 0u;
+    size_t misses = 0u;
+    ASSERT_TRUE(ParseCompileCacheStats(&hits, &misses)) << output_;
+    // Independent.<init>() and Independent.value().
+    EXPECT_EQ(hits, 2u);
+    // The constructors of Constant and User, Constant.get() and User.use().
+    EXPECT_EQ(misses, 4u);
+  }
+  Copy(base_oat_name, cached_oat_name);
+
+  // No stale code: the oat file is the same as the one compiled without a cache.
+  ASSERT_TRUE(GenerateOdexForTest(dex_location,
+                                  base_oat_name,
+                                  CompilerFilter::Filter::kSpeed,
+                                  args));
+  std::unique_ptr<File> cached_oat(OS::OpenFileForReading(cached_oat_name.c_str()));
+  std::unique_ptr<File> uncached_oat(OS::OpenFileForReading(base_oat_name.c_str()));
+  ASSERT_TRUE(cached_oat != nullptr);
+  ASSERT_TRUE(uncached_oat != nullptr);
+  EXPECT_EQ(cached_oat->Compare(uncached_oat.get()), 0) << cached_oat_name << " " << base_oat_name;
+}
+
+// A string added to one class shifts the string indexes embedded in the compiled code of
+// the others, which must not be reused.
+TEST_F(Dex2oatTest, IncrementalCacheNewString) {
+  std::string out_dir = GetScratchDir();
+  const std::string dex_location = out_dir + "/CompileCacheString.jar";
+  const std::string base_oat_name = out_dir + "/base.oat";
+  const std::string cached_oat_name = out_dir + "/cached.oat";
+  const std::string cache_name = out_dir + "/base.cache";
+  const std::vector<std::string> args = { "--force-determinism", "--avoid-storing-invocation" };
+  std::vector<std::string> cache_args = args;
+  cache_args.push_back("--incremental-cache=" + cache_name);
+  Copy(GetTestDexFileName("CompileCacheString"), dex_location);
+  ASSERT_TRUE(GenerateOdexForTest(dex_location,
+                                  base_oat_name,
+                                  CompilerFilter::Filter::kSpeed,
+                                  cache_args));
+
+  // The modified dex file only differs in Other.value(), which returns a new string "a".
+  // Greeting.get() does not change, but the index of its string "b" does.
+  Copy(GetTestDexFileName("CompileCacheStringModified"), dex_location);
+  output_ = "";
+  ASSERT_TRUE(GenerateOdexForTest(dex_location,
+                                  base_oat_name,
+                                  CompilerFilter::Filter::kSpeed,
+                                  cache_args));
+  if (!kIsTargetBuild) {
+    size_t hits = 0u;
+    size_t misses = 0u;
+    ASSERT_TRUE(ParseCompileCacheStats(&hits, &misses)) << output_;
+    EXPECT_EQ(hits, 0u);
+    // The constructors of Greeting and Other, Greeting.get() and Other.value().
+    EXPECT_EQ(misses, 4u);
+  }
+  Copy(base_oat_name, cached_oat_name);
+
+  ASSERT_TRUE(GenerateOdexForTest(dex_location,
+                                  base_oat_name,
+                                  CompilerFilter::Filter::kSpeed,
+                                  args));
+  std::unique_ptr<File> cached_oat(OS::OpenFileForReading(cached_oat_name.c_str()));
+  std::unique_ptr<File> uncached_oat(OS::OpenFileForReading(base_oat_name.c_str()));
+  ASSERT_TRUE(cached_oat != nullptr);
+  ASSERT_TRUE(uncached_oat != nullptr);
+  EXPECT_EQ(cached_oat->Compare(uncached_oat.get()), 0) << cached_oat_name << " " << base_oat_name;
+}
+
+TEST_F(Dex2oatTest, CompileCacheDir) {
+  std::unique_ptr<const DexFile> dex(OpenTestDexFile("ManyMethods"));
+  std::string out_dir = GetScratchDir();
+  const std::string base_oat_name = out_dir + "/base.oat";
+  const std::string first_oat_name = out_dir + "/first.oat";
+  const std::string cache_dir = out_dir + "/cache";
+  ASSERT_EQ(0, mkdir(cache_dir.c_str(), 0700));
+  const std::vector<std::string> args = {
+      "--force-determinism", "--avoid-storing-invocation", "--compile-cache-dir=" + cache_dir };
+  ASSERT_TRUE(GenerateOdexForTest(dex->GetLocation(),
+                                  base_oat_name,
+                                  CompilerFilter::Filter::kSpeed,
+                                  args));
+  Copy(base_oat_name, first_oat_name);
+  size_t number_of_entries = 0u;
+  DIR* dir = opendir(cache_dir.c_str());
+  ASSERT_TRUE(dir != nullptr);
+  for (dirent* e = readdir(dir); e != nullptr; e = readdir(dir)) {
+    if (strcmp(e->d_name, ".") != 0 && strcmp(e->d_name, "..") != 0) {
+      ++number_of_entries;
+    }
+  }
+  closedir(dir);
+  EXPECT_NE(number_of_entries, 0u);
+  size_t hits = 0u;
+  size_t misses = 0u;
+  if (!kIsTargetBuild) {
+    ASSERT_TRUE(ParseCompileCacheStats(&hits, &misses)) << output_;
+    EXPECT_EQ(hits, 0u);
+    EXPECT_NE(misses, 0u);
+  }
+  const size_t number_of_compiled_methods = misses;
+
+  // The second compilation reuses the compiled code of all methods, and must produce the
+  // same oat file.
+  output_ = "";
+  ASSERT_TRUE(GenerateOdexForTest(dex->GetLocation(),
+                                  base_oat_name,
+                                  CompilerFilter::Filter::kSpeed,
+                                  args));
+  if (!kIsTargetBuild) {
+    ASSERT_TRUE(ParseCompileCacheStats(&hits, &misses)) << output_;
+    EXPECT_EQ(hits, number_of_compiled_methods);
+    EXPECT_EQ(misses, 0u);
+  }
+  std::unique_ptr<File> first_oat(OS::OpenFileForReading(first_oat_name.c_str()));
+  std::unique_ptr<File> second_oat(OS::OpenFileForReading(base_oat_name.c_str()));
+  ASSERT_TRUE(first_oat != nullptr);
+  ASSERT_TRUE(second_oat != nullptr);
+  EXPECT_EQ(first_oat->Compare(second_oat.get()), 0) << first_oat_name << " " << base_oat_name;
+}
+
+// Serves the protocol of CompileCacheStore::CreateSocketStore() from memory, one connection
+// at a time. With `corrupt`, flips a bit of every entry that it sends back.
+class FakeCompileCacheDaemon {
+ public:
+  FakeCompileCacheDaemon(const std::string& path, bool corrupt) : corrupt_(corrupt) {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    CHECK_LT(path.size(), sizeof(address.sun_path)) << path;
+    strcpy(address.sun_path, path.c_str());
+    listen_fd_.reset(socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, /*protocol=*/ 0));
+    CHECK_NE(listen_fd_.get(), -1) << strerror(errno);
+    CHECK_EQ(bind(listen_fd_.get(), reinterpret_cast<const sockaddr*>(&address), sizeof(address)),
+             0) << strerror(errno);
+    CHECK_EQ(listen(listen_fd_.get(), /*backlog=*/ 1), 0) << strerror(errno);
+    thread_ = std::thread([this]() { Serve(); });
+  }
+
+  ~FakeCompileCacheDaemon() {
+    // Makes accept() fail.
+    shutdown(listen_fd_.get(), SHUT_RDWR);
+    thread_.join();
+  }
+
+ private:
+  void Serve() {
+    while (true) {
+      android::base::unique_fd fd(
+          TEMP_FAILURE_RETRY(accept4(listen_fd_.get(), nullptr, nullptr, SOCK_CLOEXEC)));
+      if (fd.get() == -1) {
+        return;
+      }
+      while (HandleRequest(fd.get())) {}
+    }
+  }
+
+  // Returns false when the compilation closed the connection.
+  bool HandleRequest(int fd) {
+    uint8_t opcode;
+    std::array<uint8_t, 32u> key;
+    if (!android::base::ReadFully(fd, &opcode, sizeof(opcode)) ||
+        !android::base::ReadFully(fd, key.data(), key.size())) {
+      return false;
+    }
+    if (opcode == 'P') {
+      uint32_t size;
+      if (!android::base::ReadFully(fd, &size, sizeof(size))) {
+        return false;
+      }
+      std::vector<uint8_t> data(size);
+      if (!android::base::ReadFully(fd, data.data(), size)) {
+        return false;
+      }
+      entries_[key] = std::move(data);
+      return true;
+    }
+    CHECK(opcode == 'G') << static_cast<int>(opcode);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+      uint8_t status = 'N';
+      return android::base::WriteFully(fd, &status, sizeof(status));
+    }
+    std::vector<uint8_t> data = it->second;
+    if (corrupt_ && !data.empty()) {
+      data[data.size() / 2u] ^= 1u;
+    }
+    uint8_t status = 'Y';
+    uint32_t size = data.size();
+    return android::base::WriteFully(fd, &status, sizeof(status)) &&
+           android::base::WriteFully(fd, &size, sizeof(size)) &&
+           android::base::WriteFully(fd, data.data(), data.size());
+  }
+
+  const bool corrupt_;
+  android::base::unique_fd listen_fd_;
+  std::thread thread_;
+  // Only accessed by `thread_`.
+  std::map<std::array<uint8_t, 32u>, std::vector<uint8_t>> entries_;
+};
+
+class Dex2oatCompileCacheSocketTest : public Dex2oatTest {
+ protected:
+  // Compiles ManyMethods twice with a fake cache daemon, and checks that the second
+  // compilation reuses all the methods of the first one, unless the daemon corrupts them,
+  // and that both produce the same oat file.
+  void RunTest(bool corrupt) {
+    std::unique_ptr<const DexFile> dex(OpenTestDexFile("ManyMethods"));
+    std::string out_dir = GetScratchDir();
+    const std::string base_oat_name = out_dir + "/base.oat";
+    const std::string first_oat_name = out_dir + "/first.oat";
+    const std::string socket_name = out_dir + "/cache.sock";
+    if (socket_name.size() >= sizeof(sockaddr_un::sun_path)) {
+      printf("WARNING: TEST DISABLED FOR A LONG SCRATCH DIRECTORY PATH\n");
+      return;
+    }
+    FakeCompileCacheDaemon daemon(socket_name, corrupt);
+    const std::vector<std::string> args = { "--force-determinism",
+                                            "--avoid-storing-invocation",
+                                            "--compile-cache-socket=" + socket_name };
+    ASSERT_TRUE(GenerateOdexForTest(dex->GetLocation(),
+                                    base_oat_name,
+                                    CompilerFilter::Filter::kSpeed,
+                                    args));
+    Copy(base_oat_name, first_oat_name);
+    size_t hits = 0u;
+    size_t misses = 0u;
+    if (!kIsTargetBuild) {
+      ASSERT_TRUE(ParseCompileCacheStats(&hits, &misses)) << output_;
+      EXPECT_EQ(hits, 0u);
+      EXPECT_NE(misses, 0u);
+    }
+    const size_t number_of_compiled_methods = misses;
+
+    output_ = "";
+    ASSERT_TRUE(GenerateOdexForTest(dex->GetLocation(),
+                                    base_oat_name,
+                                    CompilerFilter::Filter::kSpeed,
+                                    args));
+    if (!kIsTargetBuild) {
+      ASSERT_TRUE(ParseCompileCacheStats(&hits, &misses)) << output_;
+      // Corrupt entries fail their checksum and the methods are compiled again.
+      EXPECT_EQ(hits, corrupt ? 0u : number_of_compiled_methods);
+      EXPECT_EQ(misses, corrupt ? number_of_compiled_methods : 0u);
+    }
+    std::unique_ptr<File> first_oat(OS::OpenFileForReading(first_oat_name.c_str()));
+    std::unique_ptr<File> second_oat(OS::OpenFileForReading(base_oat_name.c_str()));
+    ASSERT_TRUE(first_oat != nullptr);
+    ASSERT_TRUE(second_oat != nullptr);
+    EXPECT_EQ(first_oat->Compare(second_oat.get()), 0) << first_oat_name << " " << base_oat_name;
+  }
+};
+
+TEST_F(Dex2oatCompileCacheSocketTest, CompileCacheSocket) {
+  RunTest(/*corrupt=*/ false);
+}
+
+TEST_F(Dex2oatCompileCacheSocketTest, CompileCacheSocketCorruptEntries) {
+  RunTest(/*corrupt=*/ true);
+}
+
 TEST_F(Dex2oatTest, UncompressedTest) {
   std::unique_ptr<const DexFile> dex(OpenTestDexFile("MainUncompressedAligned"));
   std::string out_dir = GetScratchDir();
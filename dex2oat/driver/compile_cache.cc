@@ -0,0 +1,1053 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "compile_cache.h"
+
+#include <dlfcn.h>
+#include <openssl/sha.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+#include "android-base/logging.h"
+#include "android-base/stringprintf.h"
+#include "arch/instruction_set_features.h"
+#include "base/logging.h"  // For VLOG.
+#include "base/os.h"
+#include "base/stl_util.h"
+#include "base/utils.h"
+#include "base/unix_file/fd_file.h"
+#include "compiled_method-inl.h"
+#include "compiler.h"
+#include "dex/class_accessor-inl.h"
+#include "dex/code_item_accessors-inl.h"
+#include "dex/dex_file-inl.h"
+#include "dex/dex_file_annotations.h"
+#include "dex/dex_file_exception_helpers.h"
+#include "dex/dex_instruction-inl.h"
+#include "dex/method_reference.h"
+#include "driver/compiled_method_storage.h"
+#include "driver/compiler_options.h"
+#include "linker/linker_patch.h"
+#include "oat.h"
+#include "profile/profile_compilation_info.h"
+#include "stack_map.h"
+
+namespace art {
+
+using android::base::StringPrintf;
+using linker::LinkerPatch;
+
+// The version of the keys and of the encoding of the compiled methods.
+static constexpr uint8_t kCompileCacheVersion[] = { '0', '0', '4', '\0' };
+
+static_assert(sizeof(CompileCache::Key) == SHA256_DIGEST_LENGTH, "Unexpected key size");
+
+// Mark patch targets that are not in a dex file, or in the dex file of the compiled method.
+static constexpr uint32_t kNoDexFile = static_cast<uint32_t>(-1);
+static constexpr uint32_t kOwnDexFile = static_cast<uint32_t>(-2);
+
+namespace {
+
+class Hasher {
+ public:
+  Hasher() {
+    SHA256_Init(&ctx_);
+  }
+
+  void Update(const void* data, size_t size) {
+    SHA256_Update(&ctx_, data, size);
+  }
+
+  template <typename T>
+  void UpdateValue(T value) {
+    static_assert(std::is_trivially_copyable<T>::value, "Unexpected type");
+    Update(&value, sizeof(value));
+  }
+
+  void UpdateString(std::string_view str) {
+    UpdateValue<uint32_t>(str.size());
+    Update(str.data(), str.size());
+  }
+
+  void UpdateKey(const CompileCache::Key& key) {
+    Update(key.data(), key.size());
+  }
+
+  CompileCache::Key Finish() {
+    CompileCache::Key key;
+    SHA256_Final(key.data(), &ctx_);
+    return key;
+  }
+
+ private:
+  SHA256_CTX ctx_;
+};
+
+// Reads the values written by `Encode()`.
+class Reader {
+ public:
+  explicit Reader(ArrayRef<const uint8_t> data) : data_(data), pos_(0u) {}
+
+  bool ReadByte(/*out*/ uint8_t* value) {
+    if (pos_ == data_.size()) {
+      return false;
+    }
+    *value = data_[pos_];
+    ++pos_;
+    return true;
+  }
+
+  bool ReadUint32(/*out*/ uint32_t* value) {
+    if (data_.size() - pos_ < sizeof(uint32_t)) {
+      return false;
+    }
+    memcpy(value, data_.data() + pos_, sizeof(uint32_t));
+    pos_ += sizeof(uint32_t);
+    return true;
+  }
+
+  bool ReadArray(/*out*/ ArrayRef<const uint8_t>* array) {
+    uint32_t size;
+    if (!ReadUint32(&size) || data_.size() - pos_ < size) {
+      return false;
+    }
+    *array = data_.SubArray(pos_, size);
+    pos_ += size;
+    return true;
+  }
+
+  bool IsAtEnd() const {
+    return pos_ == data_.size();
+  }
+
+ private:
+  const ArrayRef<const uint8_t> data_;
+  size_t pos_;
+};
+
+}  // namespace
+
+static void PutUint32(uint32_t value, /*inout*/ std::vector<uint8_t>* data) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+  data->insert(data->end(), bytes, bytes + sizeof(value));
+}
+
+static void PutArray(ArrayRef<const uint8_t> array, /*inout*/ std::vector<uint8_t>* data) {
+  PutUint32(array.size(), data);
+  data->insert(data->end(), array.begin(), array.end());
+}
+
+static uint32_t ComputeChecksum(ArrayRef<const uint8_t> data) {
+  uint32_t checksum = adler32(0L, Z_NULL, 0);
+  return adler32(checksum, data.data(), data.size());
+}
+
+// Returns whether the stack maps describe code of `code_size` bytes. Only the header is
+// decoded, from a copy padded to its maximum size so that a truncated table is not read
+// past its end: seven varints of four bits, each followed by up to four bytes, and room
+// for word-sized loads.
+static bool IsValidVmapTable(ArrayRef<const uint8_t> vmap_table, size_t code_size) {
+  if (vmap_table.empty()) {
+    return false;
+  }
+  alignas(uint64_t) uint8_t header[48] = {};
+  memcpy(header, vmap_table.data(), std::min(vmap_table.size(), sizeof(header)));
+  return CodeInfo::DecodeCodeSize(header) == code_size;
+}
+
+static bool HashFileContents(const std::string& filename,
+                             /*inout*/ Hasher* hasher,
+                             std::string* error_msg) {
+  std::unique_ptr<File> file(OS::OpenFileForReading(filename.c_str()));
+  if (file == nullptr) {
+    *error_msg = StringPrintf("Could not open '%s' for hashing", filename.c_str());
+    return false;
+  }
+  constexpr size_t kBufferSize = 64 * KB;
+  std::vector<char> buffer(kBufferSize);
+  int64_t offset = 0;
+  while (true) {
+    int64_t bytes_read = file->Read(buffer.data(), kBufferSize, offset);
+    if (bytes_read < 0) {
+      *error_msg = StringPrintf("Could not read '%s' for hashing", filename.c_str());
+      return false;
+    } else if (bytes_read == 0) {
+      return true;
+    }
+    hasher->Update(buffer.data(), bytes_read);
+    offset += bytes_read;
+  }
+}
+
+// Hashes the executable and the shared libraries that make up the compiler. A rebuilt
+// compiler may generate different code without any change of the oat version.
+static bool HashCompilerBinaries(/*inout*/ Hasher* hasher, std::string* error_msg) {
+  std::vector<std::string> binaries = { "/proc/self/exe" };
+  const void* const addresses[] = {
+      reinterpret_cast<const void*>(&Compiler::Create),   // libart-compiler.
+      reinterpret_cast<const void*>(&OatHeader::Create),  // libart.
+      reinterpret_cast<const void*>(&HashCompilerBinaries),
+  };
+  for (const void* address : addresses) {
+    Dl_info info;
+    if (dladdr(address, &info) != 0 &&
+        info.dli_fname != nullptr &&
+        !ContainsElement(binaries, info.dli_fname)) {
+      binaries.push_back(info.dli_fname);
+    }
+  }
+  for (const std::string& binary : binaries) {
+    if (!HashFileContents(binary, hasher, error_msg)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Hashes the strings and the identifiers of the types, fields, methods and prototypes of
+// `dex_file`. Their indexes are embedded in compiled code, stack maps and linker patches,
+// and the compiler may look up identifiers that are not referenced by the compiled method
+// itself, for instance to refer to an inlined method from the dex file of the outer method.
+// A string added anywhere in the dex file shifts the indexes of the strings after it.
+static CompileCache::Key HashDexFileLayout(const DexFile& dex_file) {
+  Hasher hasher;
+  hasher.UpdateValue<uint32_t>(dex_file.NumStringIds());
+  for (uint32_t i = 0; i != dex_file.NumStringIds(); ++i) {
+    hasher.UpdateString(dex_file.StringViewByIdx(dex::StringIndex(i)));
+  }
+  hasher.UpdateValue<uint32_t>(dex_file.NumTypeIds());
+  for (uint32_t i = 0; i != dex_file.NumTypeIds(); ++i) {
+    hasher.UpdateString(dex_file.StringByTypeIdx(dex::TypeIndex(i)));
+  }
+  hasher.UpdateValue<uint32_t>(dex_file.NumProtoIds());
+  for (uint32_t i = 0; i != dex_file.NumProtoIds(); ++i) {
+    const dex::ProtoId& proto_id = dex_file.GetProtoId(dex::ProtoIndex(i));
+    hasher.UpdateString(dex_file.GetProtoSignature(proto_id).ToString());
+  }
+  hasher.UpdateValue<uint32_t>(dex_file.NumFieldIds());
+  for (uint32_t i = 0; i != dex_file.NumFieldIds(); ++i) {
+    const dex::FieldId& field_id = dex_file.GetFieldId(i);
+    hasher.UpdateString(dex_file.GetFieldDeclaringClassDescriptor(field_id));
+    hasher.UpdateString(dex_file.GetFieldName(field_id));
+    hasher.UpdateString(dex_file.GetFieldTypeDescriptor(field_id));
+  }
+  hasher.UpdateValue<uint32_t>(dex_file.NumMethodIds());
+  for (uint32_t i = 0; i != dex_file.NumMethodIds(); ++i) {
+    const dex::MethodId& method_id = dex_file.GetMethodId(i);
+    hasher.UpdateString(dex_file.GetMethodDeclaringClassDescriptor(method_id));
+    hasher.UpdateString(dex_file.GetMethodName(method_id));
+    hasher.UpdateString(dex_file.GetMethodSignature(method_id).ToString());
+  }
+  hasher.UpdateValue<uint32_t>(dex_file.NumMethodHandles());
+  for (uint32_t i = 0; i != dex_file.NumMethodHandles(); ++i) {
+    const dex::MethodHandleItem& item = dex_file.GetMethodHandle(i);
+    hasher.UpdateValue(item.method_handle_type_);
+    hasher.UpdateValue(item.field_or_method_idx_);
+  }
+  hasher.UpdateValue<uint32_t>(dex_file.NumCallSiteIds());
+  // Whether a referenced class is defined in the same dex file affects the compiled code.
+  hasher.UpdateValue<uint32_t>(dex_file.NumClassDefs());
+  for (uint32_t i = 0; i != dex_file.NumClassDefs(); ++i) {
+    hasher.UpdateValue(dex_file.GetClassDef(i).class_idx_.index_);
+  }
+  return hasher.Finish();
+}
+
+// Returns, for each class, a hash of its contents and of the contents of all the classes
+// it transitively depends on. The strongly connected components of the dependency graph
+// are found with Tarjan's algorithm, which completes each component after all the
+// components it depends on, so that the hash of a component can include theirs.
+static std::vector<CompileCache::Key> HashClosures(
+    const std::vector<CompileCache::Key>& contents,
+    const std::vector<std::vector<uint32_t>>& dependencies) {
+  static constexpr uint32_t kUnvisited = static_cast<uint32_t>(-1);
+  size_t number_of_classes = contents.size();
+  std::vector<uint32_t> index(number_of_classes, kUnvisited);
+  std::vector<uint32_t> low_link(number_of_classes, kUnvisited);
+  std::vector<uint32_t> component(number_of_classes, kUnvisited);
+  std::vector<CompileCache::Key> component_hashes;
+  std::vector<uint32_t> stack;
+  std::vector<bool> on_stack(number_of_classes, false);
+  // Pairs of a class being visited and the position of its next dependency to visit.
+  std::vector<std::pair<uint32_t, size_t>> worklist;
+  uint32_t next_index = 0u;
+
+  auto visit = [&](uint32_t class_id) {
+    index[class_id] = next_index;
+    low_link[class_id] = next_index;
+    ++next_index;
+    stack.push_back(class_id);
+    on_stack[class_id] = true;
+    worklist.emplace_back(class_id, 0u);
+  };
+
+  for (uint32_t root = 0; root != number_of_classes; ++root) {
+    if (index[root] != kUnvisited) {
+      continue;
+    }
+    visit(root);
+    while (!worklist.empty()) {
+      uint32_t class_id = worklist.back().first;
+      if (worklist.back().second != dependencies[class_id].size()) {
+        uint32_t dependency = dependencies[class_id][worklist.back().second];
+        ++worklist.back().second;
+        if (index[dependency] == kUnvisited) {
+          visit(dependency);
+        } else if (on_stack[dependency]) {
+          low_link[class_id] = std::min(low_link[class_id], index[dependency]);
+        }
+        continue;
+      }
+      worklist.pop_back();
+      if (!worklist.empty()) {
+        uint32_t parent = worklist.back().first;
+        low_link[parent] = std::min(low_link[parent], low_link[class_id]);
+      }
+      if (low_link[class_id] != index[class_id]) {
+        continue;
+      }
+      // `class_id` is the root of a component made of the classes above it on the stack.
+      uint32_t component_id = component_hashes.size();
+      std::vector<uint32_t> members;
+      uint32_t member;
+      do {
+        member = stack.back();
+        stack.pop_back();
+        on_stack[member] = false;
+        component[member] = component_id;
+        members.push_back(member);
+      } while (member != class_id);
+      std::vector<CompileCache::Key> member_contents;
+      std::vector<CompileCache::Key> dependency_hashes;
+      for (uint32_t m : members) {
+        member_contents.push_back(contents[m]);
+        for (uint32_t dependency : dependencies[m]) {
+          if (component[dependency] != component_id) {
+            DCHECK_LT(component[dependency], component_id);
+            dependency_hashes.push_back(component_hashes[component[dependency]]);
+          }
+        }
+      }
+      std::sort(member_contents.begin(), member_contents.end());
+      std::sort(dependency_hashes.begin(), dependency_hashes.end());
+      dependency_hashes.erase(std::unique(dependency_hashes.begin(), dependency_hashes.end()),
+                              dependency_hashes.end());
+      Hasher hasher;
+      hasher.UpdateValue<uint32_t>(member_contents.size());
+      for (const CompileCache::Key& key : member_contents) {
+        hasher.UpdateKey(key);
+      }
+      hasher.UpdateValue<uint32_t>(dependency_hashes.size());
+      for (const CompileCache::Key& key : dependency_hashes) {
+        hasher.UpdateKey(key);
+      }
+      component_hashes.push_back(hasher.Finish());
+    }
+  }
+
+  std::vector<CompileCache::Key> closures;
+  closures.reserve(number_of_classes);
+  for (uint32_t class_id = 0; class_id != number_of_classes; ++class_id) {
+    closures.push_back(component_hashes[component[class_id]]);
+  }
+  return closures;
+}
+
+// Returns whether the stack maps of `compiled_method` refer to methods of other dex files
+// of the oat file, which happens when they are inlined.
+static bool HasInlinedMethodsOfOtherOatDexFiles(const CompiledMethod* compiled_method) {
+  CodeInfo code_info(compiled_method->GetVmapTable().data());
+  if (!code_info.HasInlineInfo()) {
+    return false;
+  }
+  for (StackMap stack_map : code_info.GetStackMaps()) {
+    for (InlineInfo inline_info : code_info.GetInlineInfosOf(stack_map)) {
+      if (inline_info.EncodesArtMethod()) {
+        continue;
+      }
+      MethodInfo method_info = code_info.GetMethodInfoOf(inline_info);
+      if (method_info.GetDexFileIndexKind() == MethodInfo::kKindNonBCP &&
+          method_info.GetDexFileIndex() != MethodInfo::kSameDexFile) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+struct CompileCache::DexFileInfo {
+  Key layout_hash;
+  // The hash of each class def and of the classes it transitively depends on.
+  std::vector<Key> class_hashes;
+};
+
+std::unique_ptr<CompileCache> CompileCache::Create(
+    const CompilerOptions& compiler_options,
+    const SafeMap<std::string, std::string>& key_value_store,
+    const std::vector<const DexFile*>& boot_class_path,
+    const std::vector<const DexFile*>& class_path,
+    const std::string& public_sdk,
+    std::unique_ptr<CompileCacheStore> store,
+    std::string* error_msg) {
+  // Images embed the state of the heap, which the keys do not account for. Native debug
+  // info and the debugging options need every method to be compiled.
+  if (compiler_options.IsGeneratingImage()) {
+    *error_msg = "Cannot reuse compiled code when generating an image";
+    return nullptr;
+  } else if (compiler_options.GetNativeDebuggable()) {
+    *error_msg = "Cannot reuse compiled code when compiling native debuggable code";
+    return nullptr;
+  } else if (compiler_options.GetPassesToRun() != nullptr ||
+             !compiler_options.GetDumpCfgFileName().empty()) {
+    *error_msg = "Cannot reuse compiled code when debugging the compiler";
+    return nullptr;
+  }
+  std::unique_ptr<CompileCache> cache(new CompileCache(
+      compiler_options.GetDexFilesForOatFile(), boot_class_path, class_path, std::move(store)));
+  Hasher hasher;
+  if (!HashCompilerBinaries(&hasher, error_msg)) {
+    return nullptr;
+  }
+  // The public SDK restricts which classes and members the oat file can resolve.
+  std::vector<std::string> public_sdk_files;
+  Split(public_sdk, ':', &public_sdk_files);
+  hasher.UpdateValue<uint32_t>(public_sdk_files.size());
+  for (const std::string& public_sdk_file : public_sdk_files) {
+    if (!HashFileContents(public_sdk_file, &hasher, error_msg)) {
+      return nullptr;
+    }
+  }
+  cache->ComputeHashes(hasher.Finish(), compiler_options, key_value_store);
+  return cache;
+}
+
+CompileCache::CompileCache(const std::vector<const DexFile*>& oat_dex_files,
+                           const std::vector<const DexFile*>& boot_class_path,
+                           const std::vector<const DexFile*>& class_path,
+                           std::unique_ptr<CompileCacheStore> store)
+    : dex_files_([&]() {
+        std::vector<const DexFile*> all_dex_files = boot_class_path;
+        all_dex_files.insert(all_dex_files.end(), oat_dex_files.begin(), oat_dex_files.end());
+        all_dex_files.insert(all_dex_files.end(), class_path.begin(), class_path.end());
+        return all_dex_files;
+      }()),
+      number_of_boot_class_path_dex_files_(boot_class_path.size()),
+      number_of_oat_dex_files_(oat_dex_files.size()),
+      store_(std::move(store)),
+      hits_(0u),
+      misses_(0u) {
+  for (size_t i = 0; i != dex_files_.size(); ++i) {
+    // A dex file may be both compiled and on a class path; the first index wins.
+    if (dex_file_indexes_.find(dex_files_[i]) == dex_file_indexes_.end()) {
+      dex_file_indexes_.Put(dex_files_[i], i);
+    }
+  }
+}
+
+CompileCache::~CompileCache() {}
+
+void CompileCache::ComputeHashes(const Key& files_hash,
+                                 const CompilerOptions& compiler_options,
+                                 const SafeMap<std::string, std::string>& key_value_store) {
+  // (1) The environment: the compiler, its options and the dependencies outside of the oat
+  //     file, that is the boot class path and class loader context with their checksums,
+  //     and the public SDK.
+  Hasher hasher;
+  hasher.UpdateKey(files_hash);
+  hasher.Update(kCompileCacheVersion, sizeof(kCompileCacheVersion));
+  hasher.Update(OatHeader::kOatVersion.data(), OatHeader::kOatVersion.size());
+  hasher.UpdateString(GetInstructionSetString(compiler_options.GetInstructionSet()));
+  hasher.UpdateString(compiler_options.GetInstructionSetFeatures()->GetFeatureString());
+  hasher.UpdateValue(compiler_options.GetCompilerFilter());
+  hasher.UpdateValue(compiler_options.IsBaseline());
+  hasher.UpdateValue(compiler_options.GetDebuggable());
+  hasher.UpdateValue(compiler_options.GetGenerateDebugInfo());
+  hasher.UpdateValue(compiler_options.GetGenerateMiniDebugInfo());
+  hasher.UpdateValue(compiler_options.GetImplicitNullChecks());
+  hasher.UpdateValue(compiler_options.GetImplicitStackOverflowChecks());
+  hasher.UpdateValue(compiler_options.GetImplicitSuspendChecks());
+  hasher.UpdateValue(compiler_options.GetCompilePic());
+  hasher.UpdateValue(compiler_options.CompileArtTest());
+  hasher.UpdateValue<uint64_t>(compiler_options.GetInlineMaxCodeUnits());
+  hasher.UpdateValue(compiler_options.GetInliningHeuristics());
+  hasher.UpdateValue<uint64_t>(compiler_options.GetHugeMethodThreshold());
+  hasher.UpdateValue<uint64_t>(compiler_options.GetLargeMethodThreshold());
+  hasher.UpdateValue(compiler_options.GetTopKProfileThreshold());
+  hasher.UpdateValue(compiler_options.CountHotnessInCompiledCode());
+  hasher.UpdateValue(compiler_options.IsCheckLinkageConditions());
+  hasher.UpdateValue(compiler_options.GetRegisterAllocationStrategy());
+  hasher.UpdateValue<uint32_t>(compiler_options.GetNoInlineFromDexFile().size());
+  for (const DexFile* dex_file : compiler_options.GetNoInlineFromDexFile()) {
+    hasher.UpdateString(dex_file->GetLocation());
+    hasher.UpdateValue(dex_file->GetLocationChecksum());
+  }
+  for (const auto& entry : key_value_store) {
+    if (entry.first == OatHeader::kDex2OatCmdLineKey ||
+        entry.first == OatHeader::kCompilationReasonKey) {
+      continue;  // Does not affect the generated code.
+    }
+    hasher.UpdateString(entry.first);
+    hasher.UpdateString(entry.second);
+  }
+  const ProfileCompilationInfo* profile = compiler_options.GetProfileCompilationInfo();
+  hasher.UpdateValue(profile != nullptr);
+  environment_hash_ = hasher.Finish();
+
+  // (2) The classes of the oat file, numbered across its dex files. A descriptor defined
+  //     more than once resolves to its first definition, like with the class loader.
+  ArrayRef<const DexFile* const> oat_dex_files =
+      ArrayRef<const DexFile* const>(dex_files_).SubArray(number_of_boot_class_path_dex_files_,
+                                                         number_of_oat_dex_files_);
+  std::vector<uint32_t> first_class_ids;
+  std::unordered_map<std::string_view, uint32_t> class_ids;
+  uint32_t number_of_classes = 0u;
+  for (const DexFile* dex_file : oat_dex_files) {
+    first_class_ids.push_back(number_of_classes);
+    for (uint32_t class_def_idx = 0; class_def_idx != dex_file->NumClassDefs(); ++class_def_idx) {
+      const dex::ClassDef& class_def = dex_file->GetClassDef(class_def_idx);
+      class_ids.emplace(dex_file->GetClassDescriptor(class_def), number_of_classes);
+      ++number_of_classes;
+    }
+  }
+
+  // (3) The contents of each class and the classes of the oat file it refers to. Changes in
+  //     other classes may change the resolution, verification, layout and inlining of the
+  //     referenced classes and members, so any reference is a dependency. The contents do
+  //     not include the position of the dex file in the oat file.
+  std::vector<Key> contents;
+  contents.reserve(number_of_classes);
+  std::vector<std::vector<uint32_t>> dependencies(number_of_classes);
+  dex_file_infos_.resize(number_of_oat_dex_files_);
+  Hasher oat_dex_files_hasher;
+  for (size_t i = 0; i != number_of_oat_dex_files_; ++i) {
+    const DexFile& dex_file = *oat_dex_files[i];
+    const Key& layout_hash = dex_file_infos_[i].layout_hash = HashDexFileLayout(dex_file);
+    oat_dex_files_hasher.UpdateKey(layout_hash);
+    for (uint32_t class_def_idx = 0; class_def_idx != dex_file.NumClassDefs(); ++class_def_idx) {
+      uint32_t class_id = first_class_ids[i] + class_def_idx;
+      std::vector<uint32_t>& class_dependencies = dependencies[class_id];
+      auto add_dependency = [&](const char* descriptor) {
+        while (*descriptor == '[') {
+          ++descriptor;
+        }
+        auto it = class_ids.find(descriptor);
+        if (it != class_ids.end() && it->second != class_id) {
+          class_dependencies.push_back(it->second);
+        }
+      };
+      auto add_type_dependency = [&](dex::TypeIndex type_idx) {
+        add_dependency(dex_file.StringByTypeIdx(type_idx));
+      };
+      auto add_proto_dependencies = [&](dex::ProtoIndex proto_idx) {
+        const dex::ProtoId& proto_id = dex_file.GetProtoId(proto_idx);
+        add_type_dependency(proto_id.return_type_idx_);
+        const dex::TypeList* parameters = dex_file.GetProtoParameters(proto_id);
+        if (parameters != nullptr) {
+          for (uint32_t p = 0; p != parameters->Size(); ++p) {
+            add_type_dependency(parameters->GetTypeItem(p).type_idx_);
+          }
+        }
+      };
+      auto add_method_dependencies = [&](uint32_t method_idx) {
+        const dex::MethodId& method_id = dex_file.GetMethodId(method_idx);
+        add_type_dependency(method_id.class_idx_);
+        add_proto_dependencies(method_id.proto_idx_);
+      };
+      auto add_field_dependencies = [&](uint32_t field_idx) {
+        const dex::FieldId& field_id = dex_file.GetFieldId(field_idx);
+        add_type_dependency(field_id.class_idx_);
+        add_type_dependency(field_id.type_idx_);
+      };
+
+      const dex::ClassDef& class_def = dex_file.GetClassDef(class_def_idx);
+      Hasher class_hasher;
+      class_hasher.UpdateKey(layout_hash);
+      class_hasher.UpdateValue(class_def.class_idx_.index_);
+      class_hasher.UpdateValue(class_def.access_flags_);
+      class_hasher.UpdateValue(class_def.superclass_idx_.index_);
+      if (class_def.superclass_idx_.IsValid()) {
+        add_type_dependency(class_def.superclass_idx_);
+      }
+      const dex::TypeList* interfaces = dex_file.GetInterfacesList(class_def);
+      uint32_t number_of_interfaces = (interfaces != nullptr) ? interfaces->Size() : 0u;
+      class_hasher.UpdateValue(number_of_interfaces);
+      for (uint32_t k = 0; k != number_of_interfaces; ++k) {
+        dex::TypeIndex interface_idx = interfaces->GetTypeItem(k).type_idx_;
+        class_hasher.UpdateValue(interface_idx.index_);
+        add_type_dependency(interface_idx);
+      }
+      class_hasher.UpdateValue(annotations::HasDeadReferenceSafeAnnotation(dex_file, class_def));
+      class_hasher.UpdateValue(
+          profile != nullptr && profile->ContainsClass(dex_file, class_def.class_idx_));
+
+      ClassAccessor accessor(dex_file, class_def);
+      for (const ClassAccessor::Field& field : accessor.GetFields()) {
+        class_hasher.UpdateValue(field.GetIndex());
+        class_hasher.UpdateValue(field.GetAccessFlags());
+        class_hasher.UpdateValue(
+            annotations::FieldIsReachabilitySensitive(dex_file, class_def, field.GetIndex()));
+        add_type_dependency(dex_file.GetFieldId(field.GetIndex()).type_idx_);
+      }
+      for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+        uint32_t method_idx = method.GetIndex();
+        class_hasher.UpdateValue(method_idx);
+        class_hasher.UpdateValue(method.GetAccessFlags());
+        class_hasher.UpdateValue(annotations::MethodIsNeverCompile(dex_file, class_def, method_idx));
+        class_hasher.UpdateValue(
+            annotations::GetNativeMethodAnnotationAccessFlags(dex_file, class_def, method_idx));
+        class_hasher.UpdateValue(
+            annotations::MethodIsReachabilitySensitive(dex_file, class_def, method_idx));
+        class_hasher.UpdateValue(
+            annotations::MethodContainsRSensitiveAccess(dex_file, class_def, method_idx));
+        add_method_dependencies(method_idx);
+
+        CodeItemDataAccessor code(method.GetInstructionsAndData());
+        class_hasher.UpdateValue(code.HasCodeItem());
+        if (code.HasCodeItem()) {
+          class_hasher.UpdateValue(code.RegistersSize());
+          class_hasher.UpdateValue(code.InsSize());
+          class_hasher.UpdateValue(code.OutsSize());
+          class_hasher.UpdateValue(code.InsnsSizeInCodeUnits());
+          class_hasher.Update(code.Insns(), code.InsnsSizeInCodeUnits() * sizeof(uint16_t));
+          class_hasher.UpdateValue(code.TriesSize());
+          for (const dex::TryItem& try_item : code.TryItems()) {
+            class_hasher.UpdateValue(try_item.start_addr_);
+            class_hasher.UpdateValue(try_item.insn_count_);
+            for (CatchHandlerIterator it(code, try_item); it.HasNext(); it.Next()) {
+              dex::TypeIndex type_idx = it.GetHandlerTypeIndex();
+              class_hasher.UpdateValue(type_idx.index_);
+              class_hasher.UpdateValue(it.GetHandlerAddress());
+              if (type_idx.IsValid()) {
+                add_type_dependency(type_idx);
+              }
+            }
+          }
+          for (const DexInstructionPcPair& inst : code) {
+            Instruction::Code opcode = inst->Opcode();
+            Instruction::IndexType index_type = Instruction::IndexTypeOf(opcode);
+            if (index_type == Instruction::kIndexNone || index_type == Instruction::kIndexUnknown) {
+              continue;
+            }
+            // Type and field references are in vC for the 22c format, and in vB otherwise.
+            uint32_t index = (Instruction::FormatOf(opcode) == Instruction::k22c)
+                ? inst->VRegC()
+                : inst->VRegB();
+            switch (index_type) {
+              case Instruction::kIndexTypeRef:
+                add_type_dependency(dex::TypeIndex(index));
+                break;
+              case Instruction::kIndexStringRef:
+                // The strings are part of the layout hash.
+                break;
+              case Instruction::kIndexFieldRef:
+                add_field_dependencies(index);
+                break;
+              case Instruction::kIndexMethodRef:
+                add_method_dependencies(index);
+                break;
+              case Instruction::kIndexMethodAndProtoRef:
+                add_method_dependencies(index);
+                add_proto_dependencies(dex::ProtoIndex(inst->VRegH()));
+                break;
+              case Instruction::kIndexProtoRef:
+                add_proto_dependencies(dex::ProtoIndex(index));
+                break;
+              case Instruction::kIndexMethodHandleRef: {
+                const dex::MethodHandleItem& item = dex_file.GetMethodHandle(index);
+                if (static_cast<DexFile::MethodHandleType>(item.method_handle_type_) <=
+                        DexFile::MethodHandleType::kInstanceGet) {
+                  add_field_dependencies(item.field_or_method_idx_);
+                } else {
+                  add_method_dependencies(item.field_or_method_idx_);
+                }
+                break;
+              }
+              default:
+                break;
+            }
+          }
+        }
+
+        // The profile guides inlining and the compilation of the method and its callers.
+        if (profile != nullptr) {
+          ProfileCompilationInfo::MethodHotness hotness =
+              profile->GetMethodHotness(MethodReference(&dex_file, method_idx));
+          class_hasher.UpdateValue(hotness.GetFlags());
+          const ProfileCompilationInfo::InlineCacheMap* inline_caches =
+              hotness.GetInlineCacheMap();
+          if (inline_caches != nullptr) {
+            class_hasher.UpdateValue<uint32_t>(inline_caches->size());
+            for (const auto& entry : *inline_caches) {
+              class_hasher.UpdateValue(entry.first);
+              class_hasher.UpdateValue(entry.second.is_missing_types);
+              class_hasher.UpdateValue(entry.second.is_megamorphic);
+              class_hasher.UpdateValue<uint32_t>(entry.second.classes.size());
+              for (dex::TypeIndex type_index : entry.second.classes) {
+                const char* descriptor = profile->GetTypeDescriptor(&dex_file, type_index);
+                class_hasher.UpdateString(descriptor);
+                add_dependency(descriptor);
+              }
+            }
+          }
+        }
+      }
+      contents.push_back(class_hasher.Finish());
+
+      std::sort(class_dependencies.begin(), class_dependencies.end());
+      class_dependencies.erase(
+          std::unique(class_dependencies.begin(), class_dependencies.end()),
+          class_dependencies.end());
+    }
+  }
+
+  oat_dex_files_hash_ = oat_dex_files_hasher.Finish();
+
+  // (4) The hashes of the transitive closures, per dex file.
+  std::vector<Key> closures = HashClosures(contents, dependencies);
+  for (size_t i = 0; i != number_of_oat_dex_files_; ++i) {
+    auto begin = closures.begin() + first_class_ids[i];
+    dex_file_infos_[i].class_hashes.assign(begin, begin + oat_dex_files[i]->NumClassDefs());
+  }
+}
+
+CompileCache::Key CompileCache::GetMethodKey(const DexFile& dex_file,
+                                             uint16_t class_def_idx,
+                                             uint32_t method_idx,
+                                             uint32_t access_flags,
+                                             InvokeType invoke_type) const {
+  auto it = dex_file_indexes_.find(&dex_file);
+  DCHECK(it != dex_file_indexes_.end());
+  size_t oat_index = it->second - number_of_boot_class_path_dex_files_;
+  DCHECK_LT(oat_index, number_of_oat_dex_files_);
+  const DexFileInfo& info = dex_file_infos_[oat_index];
+  DCHECK_LT(class_def_idx, info.class_hashes.size());
+  Hasher hasher;
+  hasher.UpdateKey(environment_hash_);
+  hasher.UpdateValue(method_idx);
+  hasher.UpdateValue(access_flags);
+  hasher.UpdateValue<uint32_t>(invoke_type);
+  hasher.UpdateKey(info.class_hashes[class_def_idx]);
+  return hasher.Finish();
+}
+
+CompileCache::Key CompileCache::GetLocalKey(const DexFile& dex_file, const Key& key) const {
+  auto it = dex_file_indexes_.find(&dex_file);
+  DCHECK(it != dex_file_indexes_.end());
+  Hasher hasher;
+  hasher.UpdateKey(key);
+  hasher.UpdateKey(oat_dex_files_hash_);
+  hasher.UpdateValue<uint32_t>(it->second - number_of_boot_class_path_dex_files_);
+  return hasher.Finish();
+}
+
+bool CompileCache::Encode(const DexFile& dex_file,
+                          const CompiledMethod* compiled_method,
+                          /*out*/ std::vector<uint8_t>* data,
+                          /*out*/ bool* is_local) const {
+  data->clear();
+  *is_local = false;
+  if (compiled_method == nullptr) {
+    data->push_back(0u);
+    PutUint32(ComputeChecksum(ArrayRef<const uint8_t>(*data)), data);
+    return true;
+  }
+  *is_local = HasInlinedMethodsOfOtherOatDexFiles(compiled_method);
+  data->push_back(1u);
+  data->push_back(static_cast<uint8_t>(compiled_method->GetInstructionSet()));
+  data->push_back(compiled_method->IsIntrinsic() ? 1u : 0u);
+  PutArray(compiled_method->GetQuickCode(), data);
+  PutArray(compiled_method->GetVmapTable(), data);
+  PutArray(compiled_method->GetCFIInfo(), data);
+  ArrayRef<const LinkerPatch> patches = compiled_method->GetPatches();
+  PutUint32(patches.size(), data);
+  for (const LinkerPatch& patch : patches) {
+    const DexFile* target_dex_file = nullptr;
+    uint32_t data1 = 0u;
+    uint32_t data2 = 0u;
+    switch (patch.GetType()) {
+      case LinkerPatch::Type::kIntrinsicReference:
+        data1 = patch.PcInsnOffset();
+        data2 = patch.IntrinsicData();
+        break;
+      case LinkerPatch::Type::kDataBimgRelRo:
+        data1 = patch.PcInsnOffset();
+        data2 = patch.BootImageOffset();
+        break;
+      case LinkerPatch::Type::kMethodRelative:
+      case LinkerPatch::Type::kMethodBssEntry:
+      case LinkerPatch::Type::kJniEntrypointRelative:
+        target_dex_file = patch.TargetMethod().dex_file;
+        data1 = patch.PcInsnOffset();
+        data2 = patch.TargetMethod().index;
+        break;
+      case LinkerPatch::Type::kCallRelative:
+        target_dex_file = patch.TargetMethod().dex_file;
+        data2 = patch.TargetMethod().index;
+        break;
+      case LinkerPatch::Type::kTypeRelative:
+      case LinkerPatch::Type::kTypeBssEntry:
+      case LinkerPatch::Type::kPublicTypeBssEntry:
+      case LinkerPatch::Type::kPackageTypeBssEntry:
+        target_dex_file = patch.TargetTypeDexFile();
+        data1 = patch.PcInsnOffset();
+        data2 = patch.TargetTypeIndex().index_;
+        break;
+      case LinkerPatch::Type::kStringRelative:
+      case LinkerPatch::Type::kStringBssEntry:
+        target_dex_file = patch.TargetStringDexFile();
+        data1 = patch.PcInsnOffset();
+        data2 = patch.TargetStringIndex().index_;
+        break;
+      case LinkerPatch::Type::kCallEntrypoint:
+        data1 = patch.EntrypointOffset();
+        break;
+      case LinkerPatch::Type::kBakerReadBarrierBranch:
+        data1 = patch.GetBakerCustomValue1();
+        data2 = patch.GetBakerCustomValue2();
+        break;
+    }
+    uint32_t target_dex_file_index = kNoDexFile;
+    if (target_dex_file == &dex_file) {
+      target_dex_file_index = kOwnDexFile;
+    } else if (target_dex_file != nullptr) {
+      auto it = dex_file_indexes_.find(target_dex_file);
+      if (it == dex_file_indexes_.end()) {
+        return false;  // The dex file may not be the same in the next compilation.
+      }
+      target_dex_file_index = it->second;
+      if (target_dex_file_index >= number_of_boot_class_path_dex_files_) {
+        *is_local = true;
+      }
+    }
+    PutUint32(static_cast<uint32_t>(patch.GetType()), data);
+    PutUint32(patch.LiteralOffset(), data);
+    PutUint32(target_dex_file_index, data);
+    PutUint32(data1, data);
+    PutUint32(data2, data);
+  }
+  PutUint32(ComputeChecksum(ArrayRef<const uint8_t>(*data)), data);
+  return true;
+}
+
+bool CompileCache::Decode(const DexFile& dex_file,
+                          ArrayRef<const uint8_t> data,
+                          CompiledMethodStorage* storage,
+                          /*out*/ CompiledMethod** compiled_method) const {
+  // The checksum detects entries that were corrupted in the store. The checks below only
+  // keep the entries of a trusted store from being misinterpreted, see CompileCacheStore.
+  uint32_t checksum;
+  if (data.size() < sizeof(checksum)) {
+    return false;
+  }
+  memcpy(&checksum, data.data() + data.size() - sizeof(checksum), sizeof(checksum));
+  data = data.SubArray(0u, data.size() - sizeof(checksum));
+  if (checksum != ComputeChecksum(data)) {
+    return false;
+  }
+  Reader reader(data);
+  uint8_t present;
+  if (!reader.ReadByte(&present)) {
+    return false;
+  } else if (present == 0u) {
+    *compiled_method = nullptr;
+    return reader.IsAtEnd();
+  }
+  uint8_t instruction_set;
+  uint8_t is_intrinsic;
+  ArrayRef<const uint8_t> code;
+  ArrayRef<const uint8_t> vmap_table;
+  ArrayRef<const uint8_t> cfi_info;
+  uint32_t number_of_patches;
+  if (!reader.ReadByte(&instruction_set) ||
+      instruction_set > static_cast<uint8_t>(InstructionSet::kLast) ||
+      !reader.ReadByte(&is_intrinsic) ||
+      !reader.ReadArray(&code) ||
+      !reader.ReadArray(&vmap_table) ||
+      !reader.ReadArray(&cfi_info) ||
+      !reader.ReadUint32(&number_of_patches) ||
+      !IsValidVmapTable(vmap_table, code.size())) {
+    return false;
+  }
+  std::vector<LinkerPatch> patches;
+  patches.reserve(number_of_patches);
+  for (uint32_t i = 0; i != number_of_patches; ++i) {
+    uint32_t type;
+    uint32_t literal_offset;
+    uint32_t target_dex_file_index;
+    uint32_t data1;
+    uint32_t data2;
+    if (!reader.ReadUint32(&type) ||
+        !reader.ReadUint32(&literal_offset) ||
+        !reader.ReadUint32(&target_dex_file_index) ||
+        !reader.ReadUint32(&data1) ||
+        !reader.ReadUint32(&data2) ||
+        // Patches rewrite a 32-bit literal or instruction.
+        code.size() < sizeof(uint32_t) ||
+        literal_offset > code.size() - sizeof(uint32_t) ||
+        (target_dex_file_index != kNoDexFile &&
+         target_dex_file_index != kOwnDexFile &&
+         target_dex_file_index >= dex_files_.size())) {
+      return false;
+    }
+    const DexFile* target_dex_file =
+        (target_dex_file_index == kOwnDexFile)
+            ? &dex_file
+            : (target_dex_file_index != kNoDexFile) ? dex_files_[target_dex_file_index] : nullptr;
+    // The method, type and string indexes must be valid in the target dex file, and the
+    // PC-relative patches must be anchored in the code.
+    bool valid = true;
+    switch (static_cast<LinkerPatch::Type>(type)) {
+      case LinkerPatch::Type::kIntrinsicReference:
+      case LinkerPatch::Type::kDataBimgRelRo:
+        valid = data1 < code.size();
+        break;
+      case LinkerPatch::Type::kMethodRelative:
+      case LinkerPatch::Type::kMethodBssEntry:
+      case LinkerPatch::Type::kJniEntrypointRelative:
+        valid = data1 < code.size() &&
+                target_dex_file != nullptr &&
+                data2 < target_dex_file->NumMethodIds();
+        break;
+      case LinkerPatch::Type::kCallRelative:
+        valid = target_dex_file != nullptr && data2 < target_dex_file->NumMethodIds();
+        break;
+      case LinkerPatch::Type::kTypeRelative:
+      case LinkerPatch::Type::kTypeBssEntry:
+      case LinkerPatch::Type::kPublicTypeBssEntry:
+      case LinkerPatch::Type::kPackageTypeBssEntry:
+        valid = data1 < code.size() &&
+                target_dex_file != nullptr &&
+                data2 < target_dex_file->NumTypeIds();
+        break;
+      case LinkerPatch::Type::kStringRelative:
+      case LinkerPatch::Type::kStringBssEntry:
+        valid = data1 < code.size() &&
+                target_dex_file != nullptr &&
+                data2 < target_dex_file->NumStringIds();
+        break;
+      default:
+        break;
+    }
+    if (!valid) {
+      return false;
+    }
+    switch (static_cast<LinkerPatch::Type>(type)) {
+      case LinkerPatch::Type::kIntrinsicReference:
+        patches.push_back(LinkerPatch::IntrinsicReferencePatch(literal_offset, data1, data2));
+        break;
+      case LinkerPatch::Type::kDataBimgRelRo:
+        patches.push_back(LinkerPatch::DataBimgRelRoPatch(literal_offset, data1, data2));
+        break;
+      case LinkerPatch::Type::kMethodRelative:
+        patches.push_back(LinkerPatch::RelativeMethodPatch(literal_offset, target_dex_file, data1, data2));
+        break;
+      case LinkerPatch::Type::kMethodBssEntry:
+        patches.push_back(LinkerPatch::MethodBssEntryPatch(literal_offset, target_dex_file, data1, data2));
+        break;
+      case LinkerPatch::Type::kJniEntrypointRelative:
+        patches.push_back(
+            LinkerPatch::RelativeJniEntrypointPatch(literal_offset, target_dex_file, data1, data2));
+        break;
+      case LinkerPatch::Type::kCallRelative:
+        patches.push_back(LinkerPatch::RelativeCodePatch(literal_offset, target_dex_file, data2));
+        break;
+      case LinkerPatch::Type::kTypeRelative:
+        patches.push_back(LinkerPatch::RelativeTypePatch(literal_offset, target_dex_file, data1, data2));
+        break;
+      case LinkerPatch::Type::kTypeBssEntry:
+        patches.push_back(LinkerPatch::TypeBssEntryPatch(literal_offset, target_dex_file, data1, data2));
+        break;
+      case LinkerPatch::Type::kPublicTypeBssEntry:
+        patches.push_back(
+            LinkerPatch::PublicTypeBssEntryPatch(literal_offset, target_dex_file, data1, data2));
+        break;
+      case LinkerPatch::Type::kPackageTypeBssEntry:
+        patches.push_back(
+            LinkerPatch::PackageTypeBssEntryPatch(literal_offset, target_dex_file, data1, data2));
+        break;
+      case LinkerPatch::Type::kStringRelative:
+        patches.push_back(LinkerPatch::RelativeStringPatch(literal_offset, target_dex_file, data1, data2));
+        break;
+      case LinkerPatch::Type::kStringBssEntry:
+        patches.push_back(LinkerPatch::StringBssEntryPatch(literal_offset, target_dex_file, data1, data2));
+        break;
+      case LinkerPatch::Type::kCallEntrypoint:
+        patches.push_back(LinkerPatch::CallEntrypointPatch(literal_offset, data1));
+        break;
+      case LinkerPatch::Type::kBakerReadBarrierBranch:
+        patches.push_back(LinkerPatch::BakerReadBarrierBranchPatch(literal_offset, data1, data2));
+        break;
+      default:
+        return false;
+    }
+  }
+  if (!reader.IsAtEnd()) {
+    return false;
+  }
+  *compiled_method = CompiledMethod::SwapAllocCompiledMethod(
+      storage,
+      static_cast<InstructionSet>(instruction_set),
+      code,
+      vmap_table,
+      cfi_info,
+      ArrayRef<const LinkerPatch>(patches));
+  if (is_intrinsic != 0u) {
+    (*compiled_method)->MarkAsIntrinsic();
+  }
+  return true;
+}
+
+bool CompileCache::Lookup(const DexFile& dex_file,
+                          const Key& key,
+                          CompiledMethodStorage* storage,
+                          /*out*/ CompiledMethod** compiled_method) {
+  std::vector<uint8_t> data;
+  Key stored_key = key;
+  bool found = store_->Get(stored_key, &data);
+  if (!found) {
+    stored_key = GetLocalKey(dex_file, key);
+    found = store_->Get(stored_key, &data);
+  }
+  // Only a valid entry counts as a hit and is kept by the store.
+  if (found && Decode(dex_file, ArrayRef<const uint8_t>(data), storage, compiled_method)) {
+    store_->MarkUsed(stored_key);
+    hits_.fetch_add(1u, std::memory_order_relaxed);
+    return true;
+  }
+  misses_.fetch_add(1u, std::memory_order_relaxed);
+  return false;
+}
+
+void CompileCache::Insert(const DexFile& dex_file,
+                          const Key& key,
+                          const CompiledMethod* compiled_method) {
+  std::vector<uint8_t> data;
+  bool is_local;
+  if (!Encode(dex_file, compiled_method, &data, &is_local)) {
+    return;
+  }
+  store_->Put(is_local ? GetLocalKey(dex_file, key) : key, ArrayRef<const uint8_t>(data));
+}
+
+bool CompileCache::Save(std::string* error_msg) {
+  return store_->Flush(error_msg);
+}
+
+}  // namespace art
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_DEX2OAT_DRIVER_COMPILE_CACHE_H_
+#define ART_DEX2OAT_DRIVER_COMPILE_CACHE_H_
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/array_ref.h"
+#include "base/macros.h"
+#include "base/safe_map.h"
+#include "driver/compile_cache_store.h"
+#include "dex/invoke_type.h"
+
+namespace art {
+
+class CompiledMethod;
+class CompiledMethodStorage;
+class CompilerOptions;
+class DexFile;
+
+// Compiled code of the methods of previous compilations, for incremental compilation and
+// for sharing the code of identical dex files between compilations.
+//
+// A method is keyed by a hash of everything its compiled code may depend on: the compiler
+// binaries and options, the boot class path and class loader context (as recorded in the
+// oat header key-value store), the public SDK, the contents of the method's class and the
+// contents of all the classes of the oat file that it transitively references. A method
+// whose key is found reuses the code, stack maps, CFI and linker patches of the previous
+// compilation instead of being compiled again.
+//
+// The contents of a class include the strings and identifiers of its whole dex file, which
+// compiled code embeds as indexes (see HashDexFileLayout()). Most changes of any class of
+// the dex file change them, so entries are reused by recompilations of a dex file whose
+// classes only changed in their code, without new strings or references, and by
+// compilations of the same dex file in different oat files with the same class loader
+// context. A library whose classes are merged into the dex file of each app does not share
+// entries between apps.
+//
+// The key does not depend on the other dex files of the oat file. Compiled code that refers
+// to another dex file of the oat file, through a linker patch or an inlined method, is only
+// valid for the same set of dex files and is stored under a key that includes them.
+class CompileCache {
+ public:
+  using Key = CompileCacheStore::Key;
+
+  // Returns null and sets `error_msg` if the compilation cannot use a cache. Linker patches
+  // of the cached methods may refer to the `boot_class_path` and `class_path` dex files.
+  // `public_sdk` is the colon-separated list of dex files given by --public-sdk, if any.
+  static std::unique_ptr<CompileCache> Create(
+      const CompilerOptions& compiler_options,
+      const SafeMap<std::string, std::string>& key_value_store,
+      const std::vector<const DexFile*>& boot_class_path,
+      const std::vector<const DexFile*>& class_path,
+      const std::string& public_sdk,
+      std::unique_ptr<CompileCacheStore> store,
+      std::string* error_msg);
+
+  ~CompileCache();
+
+  Key GetMethodKey(const DexFile& dex_file,
+                   uint16_t class_def_idx,
+                   uint32_t method_idx,
+                   uint32_t access_flags,
+                   InvokeType invoke_type) const;
+
+  // Looks up the method of `dex_file` with the given `key`. Returns whether it was found,
+  // in which case `compiled_method` is set to the compiled method, or to null if the
+  // compiler declined to compile the method.
+  bool Lookup(const DexFile& dex_file,
+              const Key& key,
+              CompiledMethodStorage* storage,
+              /*out*/ CompiledMethod** compiled_method);
+
+  // Records the result of compiling the method of `dex_file` with the given `key`, which
+  // may be null.
+  void Insert(const DexFile& dex_file, const Key& key, const CompiledMethod* compiled_method);
+
+  // Makes the methods inserted so far available to the next compilations.
+  bool Save(std::string* error_msg);
+
+  size_t GetNumberOfHits() const {
+    return hits_.load(std::memory_order_relaxed);
+  }
+
+  size_t GetNumberOfMisses() const {
+    return misses_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct DexFileInfo;
+
+  CompileCache(const std::vector<const DexFile*>& oat_dex_files,
+               const std::vector<const DexFile*>& boot_class_path,
+               const std::vector<const DexFile*>& class_path,
+               std::unique_ptr<CompileCacheStore> store);
+
+  // Computes the hash of the compilation environment, and of the transitive closure
+  // of the classes of each dex file. `files_hash` is the hash of the compiler binaries
+  // and of the public SDK.
+  void ComputeHashes(const Key& files_hash,
+                     const CompilerOptions& compiler_options,
+                     const SafeMap<std::string, std::string>& key_value_store);
+
+  // Returns the key of compiled code that is only valid with the same oat dex files.
+  Key GetLocalKey(const DexFile& dex_file, const Key& key) const;
+
+  // Returns false if the method cannot be cached. Sets `is_local` if the compiled code refers
+  // to other dex files of the oat file.
+  bool Encode(const DexFile& dex_file,
+              const CompiledMethod* compiled_method,
+              /*out*/ std::vector<uint8_t>* data,
+              /*out*/ bool* is_local) const;
+  bool Decode(const DexFile& dex_file,
+              ArrayRef<const uint8_t> data,
+              CompiledMethodStorage* storage,
+              /*out*/ CompiledMethod** compiled_method) const;
+
+  // The boot class path, followed by the dex files of the oat file and the class path.
+  const std::vector<const DexFile*> dex_files_;
+  const size_t number_of_boot_class_path_dex_files_;
+  const size_t number_of_oat_dex_files_;
+  SafeMap<const DexFile*, size_t> dex_file_indexes_;
+  // Indexed by the position in the oat file.
+  std::vector<DexFileInfo> dex_file_infos_;
+
+  Key environment_hash_;
+  // The hash of the layouts of the oat dex files, in order.
+  Key oat_dex_files_hash_;
+
+  const std::unique_ptr<CompileCacheStore> store_;
+
+  std::atomic<size_t> hits_;
+  std::atomic<size_t> misses_;
+
+  DISALLOW_COPY_AND_ASSIGN(CompileCache);
+};
+
+}  // namespace art
+
+#endif  // ART_DEX2OAT_DRIVER_COMPILE_CACHE_H_
@@ -0,0 +1,433 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "compile_cache_store.h"
+
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "android-base/logging.h"
+#include "android-base/stringprintf.h"
+#include "android-base/unique_fd.h"
+#include "base/logging.h"  // For VLOG.
+#include "base/mem_map.h"
+#include "base/mutex.h"
+#include "base/os.h"
+#include "base/safe_map.h"
+#include "base/unix_file/fd_file.h"
+#include "base/utils.h"
+#include "thread-current-inl.h"
+
+namespace art {
+
+using android::base::StringPrintf;
+
+static constexpr uint8_t kCompileCacheMagic[] = { 'a', 'c', 'c', '\n' };
+static constexpr uint8_t kCompileCacheVersion[] = { '0', '0', '2', '\0' };
+static constexpr size_t kCompileCacheHeaderSize =
+    sizeof(kCompileCacheMagic) + sizeof(kCompileCacheVersion);
+
+// Larger entries from a cache directory or daemon are assumed to be corrupt.
+static constexpr uint32_t kMaxEntrySize = 256 * MB;
+
+static bool WriteHeader(File* file) {
+  return file->WriteFully(kCompileCacheMagic, sizeof(kCompileCacheMagic)) &&
+         file->WriteFully(kCompileCacheVersion, sizeof(kCompileCacheVersion));
+}
+
+static bool IsValidHeader(const uint8_t* data) {
+  return memcmp(data, kCompileCacheMagic, sizeof(kCompileCacheMagic)) == 0 &&
+         memcmp(data + sizeof(kCompileCacheMagic),
+                kCompileCacheVersion,
+                sizeof(kCompileCacheVersion)) == 0;
+}
+
+namespace {
+
+// The entries of the previous compilation are mapped from the cache file, and the entries
+// of the current compilation are appended to a temporary file that replaces it on Flush().
+//
+// File format: header, followed by entries made of the key, a 32-bit size and the data.
+class FileStore final : public CompileCacheStore {
+ public:
+  explicit FileStore(const std::string& path)
+      : path_(path),
+        temporary_path_(path + ".tmp"),
+        lock_("compile cache file lock"),
+        write_failed_(false) {}
+
+  ~FileStore() override {
+    MutexLock mu(Thread::Current(), lock_);
+    if (new_file_ != nullptr) {
+      // Not flushed, do not leave a partial cache behind.
+      if (!new_file_->Erase(/*unlink=*/ true)) {
+        PLOG(WARNING) << "Could not remove unsaved compile cache " << temporary_path_;
+      }
+    }
+  }
+
+  // A missing or unreadable previous file is not an error and starts an empty cache.
+  bool Open(std::string* error_msg) {
+    std::unique_ptr<File> file(OS::OpenFileForReading(path_.c_str()));
+    int64_t length = (file != nullptr) ? file->GetLength() : -1;
+    if (length >= static_cast<int64_t>(kCompileCacheHeaderSize)) {
+      std::string map_error_msg;
+      previous_file_ = MemMap::MapFile(length,
+                                       PROT_READ,
+                                       MAP_PRIVATE,
+                                       file->Fd(),
+                                       /*start=*/ 0,
+                                       /*low_4gb=*/ false,
+                                       path_.c_str(),
+                                       &map_error_msg);
+      if (!previous_file_.IsValid()) {
+        LOG(WARNING) << "Could not map compile cache: " << map_error_msg;
+      }
+    }
+    if (previous_file_.IsValid()) {
+      ArrayRef<const uint8_t> data(previous_file_.Begin(), previous_file_.Size());
+      if (!IsValidHeader(data.data())) {
+        VLOG(compiler) << "Ignoring compile cache " << path_ << " with an unknown version";
+      } else {
+        size_t pos = kCompileCacheHeaderSize;
+        while (data.size() - pos >= sizeof(Key) + sizeof(uint32_t)) {
+          Key key;
+          memcpy(key.data(), data.data() + pos, sizeof(Key));
+          uint32_t size;
+          memcpy(&size, data.data() + pos + sizeof(Key), sizeof(uint32_t));
+          pos += sizeof(Key) + sizeof(uint32_t);
+          if (data.size() - pos < size) {
+            break;  // Truncated.
+          }
+          previous_entries_.Overwrite(key, data.SubArray(pos, size));
+          pos += size;
+        }
+        VLOG(compiler) << "Loaded " << previous_entries_.size() << " entries from compile cache "
+                       << path_;
+      }
+    }
+
+    MutexLock mu(Thread::Current(), lock_);
+    new_file_.reset(OS::CreateEmptyFileWriteOnly(temporary_path_.c_str()));
+    if (new_file_ == nullptr) {
+      *error_msg = StringPrintf("Could not create compile cache '%s'", temporary_path_.c_str());
+      return false;
+    }
+    if (!WriteHeader(new_file_.get())) {
+      *error_msg = StringPrintf("Could not write compile cache '%s'", temporary_path_.c_str());
+      return false;
+    }
+    return true;
+  }
+
+  bool Get(const Key& key, /*out*/ std::vector<uint8_t>* data) override REQUIRES(!lock_) {
+    auto it = previous_entries_.find(key);
+    if (it == previous_entries_.end()) {
+      return false;
+    }
+    data->assign(it->second.begin(), it->second.end());
+    return true;
+  }
+
+  // Keeps the entries that are still used. Entries that CompileCache rejected are dropped.
+  void MarkUsed(const Key& key) override REQUIRES(!lock_) {
+    auto it = previous_entries_.find(key);
+    DCHECK(it != previous_entries_.end());
+    MutexLock mu(Thread::Current(), lock_);
+    Write(key, it->second);
+  }
+
+  void Put(const Key& key, ArrayRef<const uint8_t> data) override REQUIRES(!lock_) {
+    MutexLock mu(Thread::Current(), lock_);
+    Write(key, data);
+  }
+
+  bool Flush(std::string* error_msg) override REQUIRES(!lock_) {
+    MutexLock mu(Thread::Current(), lock_);
+    if (new_file_ == nullptr) {
+      *error_msg = "Compile cache already saved";
+      return false;
+    } else if (write_failed_) {
+      if (!new_file_->Erase(/*unlink=*/ true)) {
+        PLOG(WARNING) << "Could not remove compile cache " << temporary_path_;
+      }
+      new_file_.reset();
+      *error_msg = StringPrintf("Could not write compile cache '%s'", temporary_path_.c_str());
+      return false;
+    }
+    std::unique_ptr<File> file = std::move(new_file_);
+    if (file->FlushCloseOrErase() != 0) {
+      unlink(temporary_path_.c_str());
+      *error_msg = StringPrintf("Could not flush compile cache '%s'", temporary_path_.c_str());
+      return false;
+    }
+    if (rename(temporary_path_.c_str(), path_.c_str()) != 0) {
+      *error_msg = StringPrintf("Could not rename '%s' to '%s': %s",
+                                temporary_path_.c_str(),
+                                path_.c_str(),
+                                strerror(errno));
+      unlink(temporary_path_.c_str());
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  void Write(const Key& key, ArrayRef<const uint8_t> data) REQUIRES(lock_) {
+    if (new_file_ == nullptr || write_failed_) {
+      return;
+    }
+    uint32_t size = data.size();
+    write_failed_ = !new_file_->WriteFully(key.data(), key.size()) ||
+                    !new_file_->WriteFully(&size, sizeof(size)) ||
+                    !new_file_->WriteFully(data.data(), data.size());
+  }
+
+  const std::string path_;
+  const std::string temporary_path_;
+  MemMap previous_file_;
+  SafeMap<Key, ArrayRef<const uint8_t>> previous_entries_;
+
+  Mutex lock_;
+  std::unique_ptr<File> new_file_ GUARDED_BY(lock_);
+  bool write_failed_ GUARDED_BY(lock_);
+};
+
+// Each entry is a file `<dir>/<first two hex digits of the key>/<hex key>` with the header
+// followed by the data. Entries are written to a temporary file that is renamed into place,
+// so that readers never see partial entries and concurrent writers of the same entry, which
+// write the same data, do not conflict.
+class DirectoryStore final : public CompileCacheStore {
+ public:
+  explicit DirectoryStore(const std::string& path) : path_(path) {}
+
+  bool Get(const Key& key, /*out*/ std::vector<uint8_t>* data) override {
+    std::string entry_path = GetEntryPath(key);
+    std::unique_ptr<File> file(OS::OpenFileForReading(entry_path.c_str()));
+    if (file == nullptr) {
+      return false;
+    }
+    int64_t length = file->GetLength();
+    uint8_t header[kCompileCacheHeaderSize];
+    if (length < static_cast<int64_t>(kCompileCacheHeaderSize) ||
+        length - kCompileCacheHeaderSize > kMaxEntrySize ||
+        !file->ReadFully(header, sizeof(header)) ||
+        !IsValidHeader(header)) {
+      VLOG(compiler) << "Ignoring invalid compile cache entry " << entry_path;
+      return false;
+    }
+    data->resize(length - kCompileCacheHeaderSize);
+    if (!file->ReadFully(data->data(), data->size())) {
+      VLOG(compiler) << "Could not read compile cache entry " << entry_path;
+      return false;
+    }
+    return true;
+  }
+
+  void MarkUsed(const Key& key ATTRIBUTE_UNUSED) override {}
+
+  void Put(const Key& key, ArrayRef<const uint8_t> data) override {
+    std::string entry_path = GetEntryPath(key);
+    if (OS::FileExists(entry_path.c_str())) {
+      return;  // Stored by another compilation.
+    }
+    std::string subdirectory = entry_path.substr(0, entry_path.rfind('/'));
+    if (mkdir(subdirectory.c_str(), 0777) != 0 && errno != EEXIST) {
+      VLOG(compiler) << "Could not create compile cache directory " << subdirectory;
+      return;
+    }
+    std::string temporary_path =
+        StringPrintf("%s.%d.%u.tmp", entry_path.c_str(), getpid(), GetTid());
+    std::unique_ptr<File> file(OS::CreateEmptyFileWriteOnly(temporary_path.c_str()));
+    if (file == nullptr) {
+      VLOG(compiler) << "Could not create compile cache entry " << temporary_path;
+      return;
+    }
+    if (!WriteHeader(file.get()) || !file->WriteFully(data.data(), data.size())) {
+      if (!file->Erase(/*unlink=*/ true)) {
+        PLOG(WARNING) << "Could not remove compile cache entry " << temporary_path;
+      }
+      return;
+    }
+    if (file->FlushCloseOrErase() != 0 ||
+        rename(temporary_path.c_str(), entry_path.c_str()) != 0) {
+      unlink(temporary_path.c_str());
+    }
+  }
+
+  bool Flush(std::string* error_msg ATTRIBUTE_UNUSED) override {
+    return true;  // Entries are available as soon as they are stored.
+  }
+
+ private:
+  std::string GetEntryPath(const Key& key) const {
+    static constexpr char kHexDigits[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(2u * key.size());
+    for (uint8_t byte : key) {
+      hex.push_back(kHexDigits[byte >> 4]);
+      hex.push_back(kHexDigits[byte & 0xfu]);
+    }
+    return path_ + "/" + hex.substr(0u, 2u) + "/" + hex;
+  }
+
+  const std::string path_;
+};
+
+// All requests are serialized by `lock_`, see CreateSocketStore().
+class SocketStore final : public CompileCacheStore {
+ public:
+  SocketStore(const std::string& path, android::base::unique_fd fd)
+      : path_(path),
+        lock_("compile cache socket lock"),
+        fd_(std::move(fd)) {}
+
+  bool Get(const Key& key, /*out*/ std::vector<uint8_t>* data) override REQUIRES(!lock_) {
+    MutexLock mu(Thread::Current(), lock_);
+    if (fd_.get() == -1) {
+      return false;
+    }
+    uint8_t opcode = 'G';
+    uint8_t status;
+    if (!Send(&opcode, sizeof(opcode)) ||
+        !Send(key.data(), key.size()) ||
+        !Receive(&status, sizeof(status))) {
+      return false;
+    }
+    if (status == 'N') {
+      return false;
+    }
+    uint32_t size;
+    if (status != 'Y' || !Receive(&size, sizeof(size)) || size > kMaxEntrySize) {
+      Disconnect("Invalid reply");
+      return false;
+    }
+    data->resize(size);
+    return Receive(data->data(), size);
+  }
+
+  void MarkUsed(const Key& key ATTRIBUTE_UNUSED) override {}
+
+  void Put(const Key& key, ArrayRef<const uint8_t> data) override REQUIRES(!lock_) {
+    MutexLock mu(Thread::Current(), lock_);
+    if (fd_.get() == -1) {
+      return;
+    }
+    uint8_t opcode = 'P';
+    uint32_t size = data.size();
+    // The daemon does not acknowledge the entry.
+    if (Send(&opcode, sizeof(opcode)) &&
+        Send(key.data(), key.size()) &&
+        Send(&size, sizeof(size))) {
+      Send(data.data(), data.size());
+    }
+  }
+
+  bool Flush(std::string* error_msg ATTRIBUTE_UNUSED) override {
+    return true;  // The daemon makes the entries available.
+  }
+
+ private:
+  bool Send(const void* buffer, size_t size) REQUIRES(lock_) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(buffer);
+    while (size != 0u) {
+      // Do not let a closed connection raise SIGPIPE.
+      ssize_t sent = TEMP_FAILURE_RETRY(send(fd_.get(), bytes, size, MSG_NOSIGNAL));
+      if (sent <= 0) {
+        Disconnect("Could not send");
+        return false;
+      }
+      bytes += sent;
+      size -= sent;
+    }
+    return true;
+  }
+
+  bool Receive(void* buffer, size_t size) REQUIRES(lock_) {
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(buffer);
+    while (size != 0u) {
+      ssize_t received = TEMP_FAILURE_RETRY(recv(fd_.get(), bytes, size, /*flags=*/ 0));
+      if (received <= 0) {
+        Disconnect("Could not receive");
+        return false;
+      }
+      bytes += received;
+      size -= received;
+    }
+    return true;
+  }
+
+  // The rest of the compilation behaves as if the cache was empty.
+  void Disconnect(const char* reason) REQUIRES(lock_) {
+    PLOG(WARNING) << reason << " on compile cache socket " << path_
+                  << ", not using the compile cache";
+    fd_.reset();
+  }
+
+  const std::string path_;
+  Mutex lock_;
+  android::base::unique_fd fd_ GUARDED_BY(lock_);
+};
+
+}  // namespace
+
+std::unique_ptr<CompileCacheStore> CompileCacheStore::CreateFileStore(const std::string& path,
+                                                                      std::string* error_msg) {
+  std::unique_ptr<FileStore> store(new FileStore(path));
+  if (!store->Open(error_msg)) {
+    return nullptr;
+  }
+  return store;
+}
+
+std::unique_ptr<CompileCacheStore> CompileCacheStore::CreateDirectoryStore(
+    const std::string& path, std::string* error_msg) {
+  if (!OS::DirectoryExists(path.c_str())) {
+    *error_msg = StringPrintf("Compile cache directory '%s' does not exist", path.c_str());
+    return nullptr;
+  }
+  return std::make_unique<DirectoryStore>(path);
+}
+
+std::unique_ptr<CompileCacheStore> CompileCacheStore::CreateSocketStore(const std::string& path,
+                                                                        std::string* error_msg) {
+  sockaddr_un address = {};
+  address.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address.sun_path)) {
+    *error_msg = StringPrintf("Compile cache socket path '%s' is too long", path.c_str());
+    return nullptr;
+  }
+  strcpy(address.sun_path, path.c_str());
+  android::base::unique_fd fd(socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, /*protocol=*/ 0));
+  if (fd.get() == -1) {
+    *error_msg = StringPrintf("Could not create socket: %s", strerror(errno));
+    return nullptr;
+  }
+  if (TEMP_FAILURE_RETRY(connect(
+          fd.get(), reinterpret_cast<const sockaddr*>(&address), sizeof(address))) != 0) {
+    *error_msg = StringPrintf("Could not connect to compile cache socket '%s': %s",
+                              path.c_str(),
+                              strerror(errno));
+    return nullptr;
+  }
+  return std::make_unique<SocketStore>(path, std::move(fd));
+}
+
+}  // namespace art
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_DEX2OAT_DRIVER_COMPILE_CACHE_STORE_H_
+#define ART_DEX2OAT_DRIVER_COMPILE_CACHE_STORE_H_
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/array_ref.h"
+
+namespace art {
+
+// Storage of the entries of a CompileCache: opaque data addressed by a hash of the inputs of
+// the compilation that produced it, see CompileCache.
+//
+// The entries are not authenticated. CompileCache rejects entries that were corrupted in the
+// store, but the compiled code of an entry ends up in the oat file as is, so a store that is
+// shared between compilations must only be writable by trusted compilations.
+class CompileCacheStore {
+ public:
+  using Key = std::array<uint8_t, 32u>;  // SHA-256 digest.
+
+  // A single file, rewritten by each compilation with the entries it used. For recompiling
+  // the same app, see --incremental-cache.
+  static std::unique_ptr<CompileCacheStore> CreateFileStore(const std::string& path,
+                                                            std::string* error_msg);
+
+  // A directory with a file per entry. It may be shared by concurrent compilations, also
+  // on different hosts over a network file system. Entries are never removed, the size of
+  // the directory needs to be managed externally, e.g. by access time.
+  static std::unique_ptr<CompileCacheStore> CreateDirectoryStore(const std::string& path,
+                                                                 std::string* error_msg);
+
+  // A connection to a cache daemon listening on the local socket at `path`. Each request is
+  // a one byte opcode followed by a key, sizes are 32-bit little-endian:
+  //   'G' <key>                       Replies 'Y' <size> <data> if found, 'N' otherwise.
+  //   'P' <key> <size> <data>         No reply.
+  // A failed connection is reported once, and then behaves as an empty cache.
+  //
+  // The requests of all the compiler threads go through a single connection, one at a time,
+  // and a method that is not found costs two 'G' round trips, as CompileCache also looks up
+  // its key for the current oat dex files. The daemon should reply without blocking.
+  static std::unique_ptr<CompileCacheStore> CreateSocketStore(const std::string& path,
+                                                              std::string* error_msg);
+
+  virtual ~CompileCacheStore() {}
+
+  // Returns whether there is an entry for `key`, and sets `data` to it. Thread-safe.
+  virtual bool Get(const Key& key, /*out*/ std::vector<uint8_t>* data) = 0;
+
+  // Records that the entry returned by Get() for `key` was valid and used. Thread-safe.
+  virtual void MarkUsed(const Key& key) = 0;
+
+  // Stores `data` for `key`. Thread-safe. A failure only loses the entry.
+  virtual void Put(const Key& key, ArrayRef<const uint8_t> data) = 0;
+
+  // Makes the entries stored so far available to the next compilations.
+  virtual bool Flush(std::string* error_msg) = 0;
+};
+
+}  // namespace art
+
+#endif  // ART_DEX2OAT_DRIVER_COMPILE_CACHE_STORE_H_
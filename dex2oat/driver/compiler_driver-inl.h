@@ -99,6 +99,31 @@ inline std::pair<bool, bool> CompilerDriver::IsFastInstanceField(
   return std::make_pair(fast_get, fast_put);
 }
 
+template <typename Methods, typename Fn>
+inline void CompilerDriver::ForEachMethodOfWorkItem(const Methods& methods,
+                                                    const CompileWorkItem& work_item,
+                                                    Fn fn) {
+  int64_t previous_method_idx = -1;
+  uint32_t position = 0u;
+  for (const auto& method : methods) {
+    if (position == work_item.method_end) {
+      break;
+    }
+    const uint32_t method_idx = method.GetIndex();
+    const bool in_work_item = (position >= work_item.method_begin);
+    ++position;
+    if (method_idx == previous_method_idx) {
+      // smali can create dex files with two encoded_methods sharing the same method_idx
+      // http://code.google.com/p/smali/issues/detail?id=119
+      continue;
+    }
+    previous_method_idx = method_idx;
+    if (in_work_item) {
+      fn(method);
+    }
+  }
+}
+
 }  // namespace art
 
 #endif  // ART_DEX2OAT_DRIVER_COMPILER_DRIVER_INL_H_
@@ -22,6 +22,7 @@
 #include <malloc.h>  // For mallinfo
 #endif
 
+#include <algorithm>
 #include <string_view>
 #include <vector>
 
@@ -53,6 +54,7 @@
 #include "dex/dex_file_annotations.h"
 #include "dex/dex_instruction-inl.h"
 #include "dex/verification_results.h"
+#include "driver/compile_cache.h"
 #include "driver/compiler_options.h"
 #include "driver/dex_compilation_unit.h"
 #include "gc/accounting/card_table-inl.h"
@@ -254,7 +256,8 @@ CompilerDriver::CompilerDriver(
     const CompilerOptions* compiler_options,
     Compiler::Kind compiler_kind,
     size_t thread_count,
-    int swap_fd)
+    int swap_fd,
+    int code_stream_fd)
     : compiler_options_(compiler_options),
       compiler_(),
       compiler_kind_(compiler_kind),
@@ -262,7 +265,8 @@ CompilerDriver::CompilerDriver(
       had_hard_verifier_failure_(false),
       parallel_thread_count_(thread_count),
       stats_(new AOTCompilationStats),
-      compiled_method_storage_(swap_fd),
+      compiled_method_storage_(swap_fd, code_stream_fd),
+      compile_cache_(nullptr),
       max_arena_alloc_(0) {
   DCHECK(compiler_options_ != nullptr);
 
@@ -505,15 +509,29 @@ static void CompileMethodQuick(
       compile = compile && ShouldCompileBasedOnProfile(compiler_options, profile_index, method_ref);
 
       if (compile) {
-        // NOTE: if compiler declines to compile this method, it will return null.
-        compiled_method = driver->GetCompiler()->Compile(code_item,
-                                                         access_flags,
-                                                         invoke_type,
-                                                         class_def_idx,
-                                                         method_idx,
-                                                         class_loader,
-                                                         dex_file,
-                                                         dex_cache);
+        CompileCache* compile_cache = driver->GetCompileCache();
+        CompileCache::Key cache_key;
+        bool cached = false;
+        if (compile_cache != nullptr) {
+          cache_key = compile_cache->GetMethodKey(
+              dex_file, class_def_idx, method_idx, access_flags, invoke_type);
+          cached = compile_cache->Lookup(
+              dex_file, cache_key, driver->GetCompiledMethodStorage(), &compiled_method);
+        }
+        if (!cached) {
+          // NOTE: if compiler declines to compile this method, it will return null.
+          compiled_method = driver->GetCompiler()->Compile(code_item,
+                                                           access_flags,
+                                                           invoke_type,
+                                                           class_def_idx,
+                                                           method_idx,
+                                                           class_loader,
+                                                           dex_file,
+                                                           dex_cache);
+          if (compile_cache != nullptr) {
+            compile_cache->Insert(dex_file, cache_key, compiled_method);
+          }
+        }
         ProfileMethodsCheck check_type = compiler_options.CheckProfiledMethodsCompiled();
         if (UNLIKELY(check_type != ProfileMethodsCheck::kNone)) {
           DCHECK(ShouldCompileBasedOnProfile(compiler_options, profile_index, method_ref));
@@ -1358,14 +1376,17 @@ class ParallelCompilationManager {
                              CompilerDriver* compiler,
                              const DexFile* dex_file,
                              const std::vector<const DexFile*>& dex_files,
-                             ThreadPool* thread_pool)
+                             ThreadPool* thread_pool,
+                             TimingLogger* timings)
     : index_(0),
+      first_idle_time_(0u),
       class_linker_(class_linker),
       class_loader_(class_loader),
       compiler_(compiler),
       dex_file_(dex_file),
       dex_files_(dex_files),
-      thread_pool_(thread_pool) {}
+      thread_pool_(thread_pool),
+      timings_(timings) {}
 
   ClassLinker* GetClassLinker() const {
     CHECK(class_linker_ != nullptr);
@@ -1403,6 +1424,7 @@ class ParallelCompilationManager {
     CHECK_GT(work_units, 0U);
 
     index_.store(begin, std::memory_order_relaxed);
+    first_idle_time_.store(0u, std::memory_order_relaxed);
     for (size_t i = 0; i < work_units; ++i) {
       thread_pool_->AddTask(self, new ForAllClosureLambda<Fn>(this, end, fn));
     }
@@ -1415,6 +1437,13 @@ class ParallelCompilationManager {
     // Wait for all the worker threads to finish.
     thread_pool_->Wait(self, true, false);
 
+    // Record the tail of the phase, from the time the first worker ran out of work to
+    // the time the last one finished, during which some of the threads are idle.
+    uint64_t first_idle_time = first_idle_time_.load(std::memory_order_relaxed);
+    if (timings_ != nullptr && work_units > 1u && first_idle_time != 0u) {
+      timings_->AddTiming("Parallel tail", first_idle_time, NanoTime());
+    }
+
     // And stop the workers accepting jobs.
     thread_pool_->StopWorkers(self);
   }
@@ -1423,6 +1452,12 @@ class ParallelCompilationManager {
     return index_.fetch_add(1, std::memory_order_seq_cst);
   }
 
+  // Called by the workers when they find no more work to do.
+  void RecordIdle() {
+    uint64_t expected = 0u;
+    first_idle_time_.compare_exchange_strong(expected, NanoTime(), std::memory_order_relaxed);
+  }
+
  private:
   template <typename Fn>
   class ForAllClosureLambda : public Task {
@@ -1436,6 +1471,7 @@ class ParallelCompilationManager {
       while (true) {
         const size_t index = manager_->NextIndex();
         if (UNLIKELY(index >= end_)) {
+          manager_->RecordIdle();
           break;
         }
         fn_(index);
@@ -1454,12 +1490,14 @@ class ParallelCompilationManager {
   };
 
   AtomicInteger index_;
+  Atomic<uint64_t> first_idle_time_;
   ClassLinker* const class_linker_;
   const jobject class_loader_;
   CompilerDriver* const compiler_;
   const DexFile* const dex_file_;
   const std::vector<const DexFile*>& dex_files_;
   ThreadPool* const thread_pool_;
+  TimingLogger* const timings_;
 
   DISALLOW_COPY_AND_ASSIGN(ParallelCompilationManager);
 };
@@ -1599,7 +1637,7 @@ void CompilerDriver::ResolveDexFile(jobject class_loader,
   //       and method names.
 
   ParallelCompilationManager context(class_linker, class_loader, this, &dex_file, dex_files,
-                                     thread_pool);
+                                     thread_pool, timings);
   // For boot images we resolve all referenced types, such as arrays,
   // whereas for applications just those with classdefs.
   if (GetCompilerOptions().IsBootImage() || GetCompilerOptions().IsBootImageExtension()) {
@@ -1652,6 +1690,7 @@ static void LoadAndUpdateStatus(const ClassAccessor& accessor,
 
 bool CompilerDriver::FastVerify(jobject jclass_loader,
                                 const std::vector<const DexFile*>& dex_files,
+                                /*out*/ std::vector<std::vector<bool>>* classes_to_verify,
                                 TimingLogger* timings) {
   verifier::VerifierDeps* verifier_deps =
       Runtime::Current()->GetCompilerCallbacks()->GetVerifierDeps();
@@ -1667,13 +1706,20 @@ bool CompilerDriver::FastVerify(jobject jclass_loader,
       hs.NewHandle(soa.Decode<mirror::ClassLoader>(jclass_loader)));
   std::string error_msg;
 
-  if (!verifier_deps->ValidateDependencies(
+  // Dependencies are checked class by class. Only the classes whose dependencies changed,
+  // typically because of a boot classpath or shared library update, and the classes that
+  // extend or implement them need to go through the verifier again.
+  size_t num_classes_to_verify = verifier_deps->InvalidateStaleClasses(
       soa.Self(),
       class_loader,
       dex_files,
-      &error_msg)) {
-    LOG(WARNING) << "Fast verification failed: " << error_msg;
-    return false;
+      classes_to_verify,
+      &error_msg);
+  if (num_classes_to_verify != 0u) {
+    LOG(INFO) << "Fast verification needs to verify " << num_classes_to_verify
+              << " classes again: " << error_msg;
+  } else {
+    classes_to_verify->clear();
   }
 
   bool compiler_only_verifies =
@@ -1685,11 +1731,16 @@ bool CompilerDriver::FastVerify(jobject jclass_loader,
   // could not be fully verified; we could try again, but that would hurt verification
   // time. So instead we assume these classes still need to be verified at
   // runtime.
-  for (const DexFile* dex_file : dex_files) {
+  for (size_t i = 0; i != dex_files.size(); ++i) {
+    const DexFile* dex_file = dex_files[i];
     // Fetch the list of verified classes.
     const std::vector<bool>& verified_classes = verifier_deps->GetVerifiedClasses(*dex_file);
     DCHECK_EQ(verified_classes.size(), dex_file->NumClassDefs());
     for (ClassAccessor accessor : dex_file->GetClasses()) {
+      if (!classes_to_verify->empty() && (*classes_to_verify)[i][accessor.GetClassDefIndex()]) {
+        // The class is verified again by the caller.
+        continue;
+      }
       if (verified_classes[accessor.GetClassDefIndex()]) {
         if (compiler_only_verifies) {
           // Just update the compiled_classes_ map. The compiler doesn't need to resolve
@@ -1721,7 +1772,9 @@ bool CompilerDriver::FastVerify(jobject jclass_loader,
 void CompilerDriver::Verify(jobject jclass_loader,
                             const std::vector<const DexFile*>& dex_files,
                             TimingLogger* timings) {
-  if (FastVerify(jclass_loader, dex_files, timings)) {
+  std::vector<std::vector<bool>> classes_to_verify;
+  bool fast_verified = FastVerify(jclass_loader, dex_files, &classes_to_verify, timings);
+  if (fast_verified && classes_to_verify.empty()) {
     return;
   }
 
@@ -1730,17 +1783,17 @@ void CompilerDriver::Verify(jobject jclass_loader,
   // verifier will need it to record the new dependencies. Then dex2oat can update
   // the vdex file with these new dependencies.
   // Dex2oat creates the verifier deps.
-  // Create the main VerifierDeps, and set it to this thread.
+  // After a partial fast verification, the remaining classes are verified and record
+  // their new dependencies into the existing `verifier_deps`.
+  // All threads record into the main VerifierDeps. The dependencies of a class are only
+  // recorded by the thread that verifies it, so this needs no locking and no merging.
   verifier::VerifierDeps* main_verifier_deps =
       Runtime::Current()->GetCompilerCallbacks()->GetVerifierDeps();
   // Verifier deps can be null when unit testing.
   if (main_verifier_deps != nullptr) {
     Thread::Current()->SetVerifierDeps(main_verifier_deps);
-    // Create per-thread VerifierDeps to avoid contention on the main one.
-    // We will merge them after verification.
     for (ThreadPoolWorker* worker : parallel_thread_pool_->GetWorkers()) {
-      worker->GetThread()->SetVerifierDeps(
-          new verifier::VerifierDeps(GetCompilerOptions().GetDexFilesForOatFile()));
+      worker->GetThread()->SetVerifierDeps(main_verifier_deps);
     }
   }
 
@@ -1749,23 +1802,20 @@ void CompilerDriver::Verify(jobject jclass_loader,
   ThreadPool* verify_thread_pool =
       force_determinism ? single_thread_pool_.get() : parallel_thread_pool_.get();
   size_t verify_thread_count = force_determinism ? 1U : parallel_thread_count_;
-  for (const DexFile* dex_file : dex_files) {
-    CHECK(dex_file != nullptr);
+  for (size_t i = 0; i != dex_files.size(); ++i) {
+    CHECK(dex_files[i] != nullptr);
     VerifyDexFile(jclass_loader,
-                  *dex_file,
+                  *dex_files[i],
                   dex_files,
                   verify_thread_pool,
                   verify_thread_count,
+                  fast_verified ? &classes_to_verify[i] : nullptr,
                   timings);
   }
 
   if (main_verifier_deps != nullptr) {
-    // Merge all VerifierDeps into the main one.
     for (ThreadPoolWorker* worker : parallel_thread_pool_->GetWorkers()) {
-      std::unique_ptr<verifier::VerifierDeps> thread_deps(worker->GetThread()->GetVerifierDeps());
-      worker->GetThread()->SetVerifierDeps(nullptr);  // We just took ownership.
-      main_verifier_deps->MergeWith(std::move(thread_deps),
-                                    GetCompilerOptions().GetDexFilesForOatFile());
+      worker->GetThread()->SetVerifierDeps(nullptr);
     }
     Thread::Current()->SetVerifierDeps(nullptr);
   }
@@ -1773,12 +1823,19 @@ void CompilerDriver::Verify(jobject jclass_loader,
 
 class VerifyClassVisitor : public CompilationVisitor {
  public:
-  VerifyClassVisitor(const ParallelCompilationManager* manager, verifier::HardFailLogMode log_level)
+  VerifyClassVisitor(const ParallelCompilationManager* manager,
+                     verifier::HardFailLogMode log_level,
+                     const std::vector<bool>* classes_to_verify)
      : manager_(manager),
        log_level_(log_level),
+       classes_to_verify_(classes_to_verify),
        sdk_version_(Runtime::Current()->GetTargetSdkVersion()) {}
 
   void Visit(size_t class_def_index) REQUIRES(!Locks::mutator_lock_) override {
+    if (classes_to_verify_ != nullptr && !(*classes_to_verify_)[class_def_index]) {
+      // Fast verified.
+      return;
+    }
     ScopedTrace trace(__FUNCTION__);
     ScopedObjectAccess soa(Thread::Current());
     const DexFile& dex_file = *manager_->GetDexFile();
@@ -1917,6 +1974,7 @@ class VerifyClassVisitor : public CompilationVisitor {
  private:
   const ParallelCompilationManager* const manager_;
   const verifier::HardFailLogMode log_level_;
+  const std::vector<bool>* const classes_to_verify_;
   const uint32_t sdk_version_;
 };
 
@@ -1925,17 +1983,18 @@ void CompilerDriver::VerifyDexFile(jobject class_loader,
                                    const std::vector<const DexFile*>& dex_files,
                                    ThreadPool* thread_pool,
                                    size_t thread_count,
+                                   const std::vector<bool>* classes_to_verify,
                                    TimingLogger* timings) {
   TimingLogger::ScopedTiming t("Verify Dex File", timings);
   ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
   ParallelCompilationManager context(class_linker, class_loader, this, &dex_file, dex_files,
-                                     thread_pool);
+                                     thread_pool, timings);
   bool abort_on_verifier_failures = GetCompilerOptions().AbortOnHardVerifierFailure()
                                     || GetCompilerOptions().AbortOnSoftVerifierFailure();
   verifier::HardFailLogMode log_level = abort_on_verifier_failures
                               ? verifier::HardFailLogMode::kLogInternalFatal
                               : verifier::HardFailLogMode::kLogWarning;
-  VerifyClassVisitor visitor(&context, log_level);
+  VerifyClassVisitor visitor(&context, log_level, classes_to_verify);
   context.ForAll(0, dex_file.NumClassDefs(), &visitor, thread_count);
 
   // Make initialized classes visibly initialized.
@@ -2001,7 +2060,7 @@ void CompilerDriver::SetVerifiedDexFile(jobject class_loader,
   }
   ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
   ParallelCompilationManager context(class_linker, class_loader, this, &dex_file, dex_files,
-                                     thread_pool);
+                                     thread_pool, timings);
   SetVerifiedClassVisitor visitor(&context);
   context.ForAll(0, dex_file.NumClassDefs(), &visitor, thread_count);
 }
@@ -2428,7 +2487,7 @@ void CompilerDriver::InitializeClasses(jobject jni_class_loader,
 
   ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
   ParallelCompilationManager context(class_linker, jni_class_loader, this, &dex_file, dex_files,
-                                     init_thread_pool);
+                                     init_thread_pool, timings);
 
   if (GetCompilerOptions().IsBootImage() ||
       GetCompilerOptions().IsBootImageExtension() ||
@@ -2459,6 +2518,78 @@ void CompilerDriver::InitializeClasses(jobject class_loader,
   }
 }
 
+// Estimated cost of the work done for each method even when it is not compiled, relative
+// to the size of the code of the compiled methods in code units.
+static constexpr uint64_t kMethodBaseCompileCost = 8u;
+
+// The methods of a class are split into several work items when compiling them all at once
+// would cost more than this, so that a single huge class does not delay the end of the phase.
+static constexpr uint64_t kMaxCompileWorkItemCost = 4096u;
+
+static uint64_t EstimateCompileCost(const CompilerOptions& compiler_options,
+                                    ProfileCompilationInfo::ProfileIndexType profile_index,
+                                    const ClassAccessor::Method& method) {
+  uint64_t cost = kMethodBaseCompileCost;
+  if (method.GetCodeItem() == nullptr) {
+    return cost;
+  }
+  bool compiled;
+  if (profile_index == ProfileCompilationInfo::MaxProfileIndex()) {
+    compiled = !CompilerFilter::DependsOnProfile(compiler_options.GetCompilerFilter());
+  } else {
+    compiled = compiler_options.GetProfileCompilationInfo()->IsHotMethod(profile_index,
+                                                                          method.GetIndex());
+  }
+  if (compiled) {
+    cost += method.GetInstructions().InsnsSizeInCodeUnits();
+  }
+  return cost;
+}
+
+static ProfileCompilationInfo::ProfileIndexType GetCompileProfileIndex(
+    const CompilerOptions& compiler_options, const DexFile& dex_file) {
+  bool have_profile = (compiler_options.GetProfileCompilationInfo() != nullptr);
+  bool use_profile = CompilerFilter::DependsOnProfile(compiler_options.GetCompilerFilter());
+  return (have_profile && use_profile)
+      ? compiler_options.GetProfileCompilationInfo()->FindDexFile(dex_file)
+      : ProfileCompilationInfo::MaxProfileIndex();
+}
+
+std::vector<CompileWorkItem> CompilerDriver::GetCompileWorkItems(
+    const CompilerOptions& compiler_options,
+    const DexFile& dex_file,
+    uint64_t max_cost) {
+  ProfileCompilationInfo::ProfileIndexType profile_index =
+      GetCompileProfileIndex(compiler_options, dex_file);
+  std::vector<CompileWorkItem> work_items;
+  work_items.reserve(dex_file.NumClassDefs());
+  for (uint32_t class_def_index = 0; class_def_index != dex_file.NumClassDefs(); ++class_def_index) {
+    ClassAccessor accessor(dex_file, class_def_index);
+    CompileWorkItem item = { class_def_index, 0u, 0u, 0u };
+    uint32_t position = 0u;
+    for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+      uint64_t cost = EstimateCompileCost(compiler_options, profile_index, method);
+      if (item.method_end != item.method_begin && item.cost + cost > max_cost) {
+        work_items.push_back(item);
+        item = { class_def_index, position, position, 0u };
+      }
+      ++position;
+      item.method_end = position;
+      item.cost += cost;
+    }
+    if (item.method_end != item.method_begin) {
+      work_items.push_back(item);
+    }
+  }
+  // Use a stable sort to keep the order deterministic.
+  std::stable_sort(work_items.begin(),
+                   work_items.end(),
+                   [](const CompileWorkItem& lhs, const CompileWorkItem& rhs) {
+                     return lhs.cost > rhs.cost;
+                   });
+  return work_items;
+}
+
 template <typename CompileFn>
 static void CompileDexFile(CompilerDriver* driver,
                            jobject class_loader,
@@ -2475,15 +2606,18 @@ static void CompileDexFile(CompilerDriver* driver,
                                      driver,
                                      &dex_file,
                                      dex_files,
-                                     thread_pool);
+                                     thread_pool,
+                                     timings);
   const CompilerOptions& compiler_options = driver->GetCompilerOptions();
-  bool have_profile = (compiler_options.GetProfileCompilationInfo() != nullptr);
-  bool use_profile = CompilerFilter::DependsOnProfile(compiler_options.GetCompilerFilter());
-  ProfileCompilationInfo::ProfileIndexType profile_index = (have_profile && use_profile)
-      ? compiler_options.GetProfileCompilationInfo()->FindDexFile(dex_file)
-      : ProfileCompilationInfo::MaxProfileIndex();
+  ProfileCompilationInfo::ProfileIndexType profile_index =
+      GetCompileProfileIndex(compiler_options, dex_file);
+
+  std::vector<CompileWorkItem> work_items =
+      CompilerDriver::GetCompileWorkItems(compiler_options, dex_file, kMaxCompileWorkItemCost);
 
-  auto compile = [&context, &compile_fn, profile_index](size_t class_def_index) {
+  auto compile = [&context, &compile_fn, &work_items, profile_index](size_t work_item_index) {
+    const CompileWorkItem& work_item = work_items[work_item_index];
+    const uint32_t class_def_index = work_item.class_def_index;
     const DexFile& dex_file = *context.GetDexFile();
     SCOPED_TRACE << "compile " << dex_file.GetLocation() << "@" << class_def_index;
     ClassLinker* class_linker = context.GetClassLinker();
@@ -2517,38 +2651,31 @@ static void CompileDexFile(CompilerDriver* driver,
       dex_cache = hs.NewHandle(klass->GetDexCache());
     }
 
-    // Avoid suspension if there are no methods to compile.
-    if (accessor.NumDirectMethods() + accessor.NumVirtualMethods() == 0) {
-      return;
-    }
+    // Work items only exist for classes with methods.
+    DCHECK_LT(work_item.method_begin, work_item.method_end);
 
     // Go to native so that we don't block GC during compilation.
     ScopedThreadSuspension sts(soa.Self(), ThreadState::kNative);
 
-    // Compile direct and virtual methods.
-    int64_t previous_method_idx = -1;
-    for (const ClassAccessor::Method& method : accessor.GetMethods()) {
-      const uint32_t method_idx = method.GetIndex();
-      if (method_idx == previous_method_idx) {
-        // smali can create dex files with two encoded_methods sharing the same method_idx
-        // http://code.google.com/p/smali/issues/detail?id=119
-        continue;
-      }
-      previous_method_idx = method_idx;
-      compile_fn(soa.Self(),
-                 driver,
-                 method.GetCodeItem(),
-                 method.GetAccessFlags(),
-                 method.GetInvokeType(class_def.access_flags_),
-                 class_def_index,
-                 method_idx,
-                 class_loader,
-                 dex_file,
-                 dex_cache,
-                 profile_index);
-    }
+    // Compile the direct and virtual methods of the work item.
+    CompilerDriver::ForEachMethodOfWorkItem(
+        accessor.GetMethods(),
+        work_item,
+        [&](const ClassAccessor::Method& method) {
+          compile_fn(soa.Self(),
+                     driver,
+                     method.GetCodeItem(),
+                     method.GetAccessFlags(),
+                     method.GetInvokeType(class_def.access_flags_),
+                     class_def_index,
+                     method.GetIndex(),
+                     class_loader,
+                     dex_file,
+                     dex_cache,
+                     profile_index);
+        });
   };
-  context.ForAllLambda(0, dex_file.NumClassDefs(), compile, thread_count);
+  context.ForAllLambda(0, work_items.size(), compile, thread_count);
 }
 
 void CompilerDriver::Compile(jobject class_loader,
@@ -58,6 +58,7 @@ class VerifierDepsTest;
 
 class ArtField;
 class BitVector;
+class CompileCache;
 class CompiledMethod;
 class CompilerOptions;
 class DexCompilationUnit;
@@ -77,17 +78,28 @@ class TimingLogger;
 class VdexFile;
 class VerificationResults;
 
+// A unit of work of the compilation phase: a range of the methods of a class, by position
+// in the class data, with an estimate of the cost of compiling them.
+struct CompileWorkItem {
+  uint32_t class_def_index;
+  uint32_t method_begin;
+  uint32_t method_end;
+  uint64_t cost;
+};
+
 class CompilerDriver {
  public:
   // Create a compiler targeting the requested "instruction_set".
   // "image" should be true if image specific optimizations should be
   // enabled.  "image_classes" lets the compiler know what classes it
   // can assume will be in the image, with null implying all available
-  // classes.
+  // classes. If "code_stream_fd" is not -1, compiled code and stack maps are
+  // streamed out to that file as they are produced, see CodeStream.
   CompilerDriver(const CompilerOptions* compiler_options,
                  Compiler::Kind compiler_kind,
                  size_t thread_count,
-                 int swap_fd);
+                 int swap_fd,
+                 int code_stream_fd = -1);
 
   ~CompilerDriver();
 
@@ -221,6 +233,31 @@ class CompilerDriver {
     return &compiled_method_storage_;
   }
 
+  // Set the cache of compiled code from previous compilations, or null to compile everything.
+  void SetCompileCache(CompileCache* compile_cache) {
+    compile_cache_ = compile_cache;
+  }
+
+  CompileCache* GetCompileCache() const {
+    return compile_cache_;
+  }
+
+  // Returns the work items for compiling the methods of `dex_file`, the most expensive first,
+  // so that the threads are not left waiting for a late expensive item at the end of the phase.
+  // The methods of a class are split into several work items once one would cost more than
+  // `max_cost`.
+  static std::vector<CompileWorkItem> GetCompileWorkItems(const CompilerOptions& compiler_options,
+                                                          const DexFile& dex_file,
+                                                          uint64_t max_cost);
+
+  // Calls `fn` for each of the `methods` of a class that `work_item` covers. A method with the
+  // same method_idx as the method before it is skipped, even if that one is in another work
+  // item, so that each method is compiled exactly once.
+  template <typename Methods, typename Fn>
+  static void ForEachMethodOfWorkItem(const Methods& methods,
+                                      const CompileWorkItem& work_item,
+                                      Fn fn);
+
  private:
   void LoadImageClasses(TimingLogger* timings, /*inout*/ HashSet<std::string>* image_classes)
       REQUIRES(!Locks::mutator_lock_);
@@ -241,20 +278,25 @@ class CompilerDriver {
       REQUIRES(!Locks::mutator_lock_);
 
   // Do fast verification through VerifierDeps if possible. Return whether
-  // verification was successful.
+  // verification was successful. Classes whose dependencies no longer hold are
+  // not fast verified but marked in `classes_to_verify`, which is left empty if
+  // there are none.
   bool FastVerify(jobject class_loader,
                   const std::vector<const DexFile*>& dex_files,
+                  /*out*/ std::vector<std::vector<bool>>* classes_to_verify,
                   TimingLogger* timings);
 
   void Verify(jobject class_loader,
               const std::vector<const DexFile*>& dex_files,
               TimingLogger* timings);
 
+  // Verify the classes of `dex_file`, or only those set in `classes_to_verify` if not null.
   void VerifyDexFile(jobject class_loader,
                      const DexFile& dex_file,
                      const std::vector<const DexFile*>& dex_files,
                      ThreadPool* thread_pool,
                      size_t thread_count,
+                     const std::vector<bool>* classes_to_verify,
                      TimingLogger* timings)
       REQUIRES(!Locks::mutator_lock_);
 
@@ -326,6 +368,8 @@ class CompilerDriver {
 
   CompiledMethodStorage compiled_method_storage_;
 
+  CompileCache* compile_cache_;
+
   size_t max_arena_alloc_;
 
   friend class CommonCompilerDriverTest;
@@ -16,18 +16,22 @@
 
 #include "driver/compiler_driver.h"
 
+#include <algorithm>
 #include <limits>
 #include <stdint.h>
 #include <stdio.h>
 #include <memory>
+#include <numeric>
 
 #include "art_method-inl.h"
 #include "base/casts.h"
 #include "class_linker-inl.h"
 #include "common_compiler_driver_test.h"
 #include "compiler_callbacks.h"
+#include "dex/class_accessor-inl.h"
 #include "dex/dex_file.h"
 #include "dex/dex_file_types.h"
+#include "driver/compiler_driver-inl.h"
 #include "gc/heap.h"
 #include "handle_scope-inl.h"
 #include "mirror/class-inl.h"
@@ -193,6 +197,136 @@ TEST_F(CompilerDriverTest, AbstractMethodErrorStub) {
   }
 }
 
+// Checks that `work_items` cover the methods of every class of `dex_file` exactly once and
+// are sorted by decreasing cost, keeping the class and method order for equal costs.
+static void CheckCompileWorkItems(const DexFile& dex_file,
+                                  const std::vector<CompileWorkItem>& work_items) {
+  for (size_t i = 1; i < work_items.size(); ++i) {
+    const CompileWorkItem& previous = work_items[i - 1];
+    const CompileWorkItem& current = work_items[i];
+    ASSERT_GE(previous.cost, current.cost);
+    if (previous.cost == current.cost) {
+      ASSERT_TRUE(previous.class_def_index < current.class_def_index ||
+                  (previous.class_def_index == current.class_def_index &&
+                   previous.method_end <= current.method_begin));
+    }
+  }
+  for (uint32_t class_def_index = 0; class_def_index != dex_file.NumClassDefs(); ++class_def_index) {
+    std::vector<CompileWorkItem> class_items;
+    for (const CompileWorkItem& work_item : work_items) {
+      if (work_item.class_def_index == class_def_index) {
+        ASSERT_LT(work_item.method_begin, work_item.method_end);
+        class_items.push_back(work_item);
+      }
+    }
+    std::sort(class_items.begin(),
+              class_items.end(),
+              [](const CompileWorkItem& lhs, const CompileWorkItem& rhs) {
+                return lhs.method_begin < rhs.method_begin;
+              });
+    uint32_t position = 0u;
+    for (const CompileWorkItem& work_item : class_items) {
+      ASSERT_EQ(position, work_item.method_begin);
+      position = work_item.method_end;
+    }
+    ASSERT_EQ(ClassAccessor(dex_file, class_def_index).NumMethods(), position);
+  }
+}
+
+TEST_F(CompilerDriverTest, CompileWorkItems) {
+  std::unique_ptr<const DexFile> dex_file = OpenTestDexFile("ManyMethods");
+  ASSERT_TRUE(dex_file != nullptr);
+
+  // Without a cap, each class with methods is a single work item.
+  std::vector<CompileWorkItem> whole_classes = CompilerDriver::GetCompileWorkItems(
+      *compiler_options_, *dex_file, std::numeric_limits<uint64_t>::max());
+  CheckCompileWorkItems(*dex_file, whole_classes);
+  size_t number_of_classes_with_methods = 0u;
+  for (ClassAccessor accessor : dex_file->GetClasses()) {
+    if (accessor.NumMethods() != 0u) {
+      ++number_of_classes_with_methods;
+    }
+  }
+  ASSERT_EQ(number_of_classes_with_methods, whole_classes.size());
+
+  // With a cap below the cost of any method, each method is a work item of its own.
+  std::vector<CompileWorkItem> single_methods =
+      CompilerDriver::GetCompileWorkItems(*compiler_options_, *dex_file, 0u);
+  CheckCompileWorkItems(*dex_file, single_methods);
+  std::vector<std::vector<uint64_t>> method_costs(dex_file->NumClassDefs());
+  for (uint32_t class_def_index = 0; class_def_index != dex_file->NumClassDefs(); ++class_def_index) {
+    method_costs[class_def_index].resize(ClassAccessor(*dex_file, class_def_index).NumMethods());
+  }
+  uint64_t max_method_cost = 0u;
+  for (const CompileWorkItem& work_item : single_methods) {
+    ASSERT_EQ(work_item.method_begin + 1u, work_item.method_end);
+    ASSERT_NE(0u, work_item.cost);
+    method_costs[work_item.class_def_index][work_item.method_begin] = work_item.cost;
+    max_method_cost = std::max(max_method_cost, work_item.cost);
+  }
+  for (const CompileWorkItem& work_item : whole_classes) {
+    const std::vector<uint64_t>& costs = method_costs[work_item.class_def_index];
+    ASSERT_EQ(std::accumulate(costs.begin(), costs.end(), uint64_t{0u}), work_item.cost);
+  }
+
+  // With a cap in between, a class is split when adding its next method to the current work
+  // item would exceed the cap.
+  const uint64_t max_cost = 2u * max_method_cost;
+  std::vector<CompileWorkItem> split_classes =
+      CompilerDriver::GetCompileWorkItems(*compiler_options_, *dex_file, max_cost);
+  CheckCompileWorkItems(*dex_file, split_classes);
+  ASSERT_GT(split_classes.size(), whole_classes.size());
+  for (const CompileWorkItem& work_item : split_classes) {
+    const std::vector<uint64_t>& costs = method_costs[work_item.class_def_index];
+    ASSERT_EQ(std::accumulate(costs.begin() + work_item.method_begin,
+                              costs.begin() + work_item.method_end,
+                              uint64_t{0u}),
+              work_item.cost);
+    ASSERT_LE(work_item.cost, max_cost);
+    if (work_item.method_end != costs.size()) {
+      ASSERT_GT(work_item.cost + costs[work_item.method_end], max_cost);
+    }
+  }
+
+  // The order does not depend on anything but the dex file and the cap.
+  std::vector<CompileWorkItem> split_again =
+      CompilerDriver::GetCompileWorkItems(*compiler_options_, *dex_file, max_cost);
+  ASSERT_EQ(split_classes.size(), split_again.size());
+  for (size_t i = 0; i != split_classes.size(); ++i) {
+    ASSERT_EQ(split_classes[i].class_def_index, split_again[i].class_def_index);
+    ASSERT_EQ(split_classes[i].method_begin, split_again[i].method_begin);
+  }
+}
+
+TEST_F(CompilerDriverTest, CompileWorkItemDuplicateMethods) {
+  // Stands for the encoded methods of a class, where smali can repeat a method_idx.
+  struct EncodedMethod {
+    uint32_t GetIndex() const { return method_idx; }
+    uint32_t method_idx;
+  };
+  const std::vector<EncodedMethod> methods = {{1u}, {2u}, {2u}, {2u}, {3u}, {4u}, {4u}};
+  const uint32_t number_of_methods = static_cast<uint32_t>(methods.size());
+
+  // Whatever the position of the split, including between two duplicates, each method_idx
+  // is visited exactly once, at its first encoded method.
+  for (uint32_t split = 1u; split != number_of_methods; ++split) {
+    std::vector<uint32_t> positions;
+    for (const CompileWorkItem& work_item : { CompileWorkItem{ 0u, 0u, split, 0u },
+                                              CompileWorkItem{ 0u, split, number_of_methods, 0u } }) {
+      CompilerDriver::ForEachMethodOfWorkItem(
+          methods,
+          work_item,
+          [&](const EncodedMethod& method) {
+            uint32_t position = static_cast<uint32_t>(&method - methods.data());
+            ASSERT_GE(position, work_item.method_begin);
+            ASSERT_LT(position, work_item.method_end);
+            positions.push_back(position);
+          });
+    }
+    EXPECT_EQ((std::vector<uint32_t>{0u, 1u, 4u, 5u}), positions) << "split at " << split;
+  }
+}
+
 class CompilerDriverProfileTest : public CompilerDriverTest {
  protected:
   ProfileCompilationInfo* GetProfileCompilationInfo() override {
@@ -38,6 +38,16 @@ void ImageWriteReadTest::TestWriteRead(ImageHeader::StorageMode storage_mode,
     const auto& bitmap_section = image_header.GetImageBitmapSection();
     ASSERT_GE(bitmap_section.Offset(), sizeof(image_header));
     ASSERT_NE(0U, bitmap_section.Size());
+    if (storage_mode != ImageHeader::kStorageModeUncompressed) {
+      // Blocks must not straddle a multiple of the maximum block size.
+      std::vector<uint8_t> data(file->GetLength());
+      ASSERT_TRUE(file->PreadFully(data.data(), data.size(), /*offset=*/ 0));
+      for (const ImageHeader::Block& block : image_header.GetBlocks(data.data())) {
+        ASSERT_NE(0u, block.GetImageSize());
+        EXPECT_EQ(block.GetImageOffset() / max_image_block_size,
+                  (block.GetImageOffset() + block.GetImageSize() - 1u) / max_image_block_size);
+      }
+    }
 
     gc::Heap* heap = Runtime::Current()->GetHeap();
     ASSERT_TRUE(heap->HaveContinuousSpaces());
@@ -156,5 +166,9 @@ TEST_F(ImageWriteReadTest, WriteReadLZ4HCKBBlock) {
   TestWriteRead(ImageHeader::kStorageModeLZ4HC, /*max_image_block_size=*/KB);
 }
 
+TEST_F(ImageWriteReadTest, WriteReadLZ4DefaultBlock) {
+  TestWriteRead(ImageHeader::kStorageModeLZ4, CompilerOptions::kDefaultMaxImageBlockSize);
+}
+
 }  // namespace linker
 }  // namespace art
@@ -504,10 +504,14 @@ bool ImageWriter::Write(int image_fd,
     dchecked_vector<ImageHeader::Block> blocks;
 
     // Add a set of solid blocks such that no block is larger than the maximum size. A solid block
-    // is a block that must be decompressed all at once.
+    // is a block that must be decompressed all at once. Blocks end at multiples of the maximum
+    // size within the image, so with the default size each block decompresses into whole pages
+    // of its own and the blocks can be decompressed in parallel without sharing any page.
     auto add_blocks = [&](uint32_t offset, uint32_t size) {
+      const uint32_t max_block_size = compiler_options_.MaxImageBlockSize();
       while (size != 0u) {
-        const uint32_t cur_size = std::min(size, compiler_options_.MaxImageBlockSize());
+        const uint32_t to_boundary = max_block_size - offset % max_block_size;
+        const uint32_t cur_size = std::min(size, to_boundary);
         block_sources.emplace_back(offset, cur_size);
         offset += cur_size;
         size -= cur_size;
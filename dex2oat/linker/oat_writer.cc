@@ -2929,6 +2929,8 @@ size_t OatWriter::WriteMaps(OutputStream* out, size_t file_offset, size_t relati
     relative_offset += code_info_data_.size();
     size_vmap_table_ = code_info_data_.size();
     DCHECK_OFFSET();
+    // The maps are not needed anymore, release the memory before writing the code.
+    std::vector<uint8_t>().swap(code_info_data_);
   }
 
   return relative_offset;
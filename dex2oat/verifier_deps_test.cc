@@ -581,6 +581,60 @@ TEST_F(VerifierDepsTest, VerifyDeps) {
       << error_msg;
 }
 
+TEST_F(VerifierDepsTest, InvalidateStaleClasses) {
+  VerifyDexFile();
+  ASSERT_EQ(1u, NumberOfCompiledDexFiles());
+
+  std::vector<uint8_t> buffer;
+  verifier_deps_->Encode(dex_files_, &buffer);
+  ASSERT_FALSE(buffer.empty());
+
+  ScopedObjectAccess soa(Thread::Current());
+  jobject second_loader = LoadDex("VerifierDeps");
+  const auto& second_dex_files = GetDexFiles(second_loader);
+  const DexFile& dex_file = *second_dex_files.front();
+  VerifierDeps decoded_deps(second_dex_files, /*output_only=*/ false);
+  ASSERT_TRUE(decoded_deps.ParseStoredData(second_dex_files, ArrayRef<const uint8_t>(buffer)));
+  VerifierDeps::DexFileDeps* decoded_dex_deps = decoded_deps.GetDexFileDeps(dex_file);
+
+  // Record a dependency of LMySimpleTimeZone; which does not hold.
+  const dex::TypeId* time_zone_type = dex_file.FindTypeId("LMySimpleTimeZone;");
+  ASSERT_TRUE(time_zone_type != nullptr);
+  const dex::ClassDef* time_zone_def =
+      dex_file.FindClassDef(dex_file.GetIndexForTypeId(*time_zone_type));
+  ASSERT_TRUE(time_zone_def != nullptr);
+  uint16_t time_zone_index = dex_file.GetIndexForClassDef(*time_zone_def);
+  decoded_dex_deps->assignable_types_[time_zone_index].emplace(
+      decoded_deps.GetIdFromString(dex_file, "Ljava/lang/Thread;"),
+      decoded_deps.GetIdFromString(dex_file, "Ljava/util/SimpleTimeZone;"));
+
+  StackHandleScope<1> hs(soa.Self());
+  Handle<mirror::ClassLoader> new_class_loader =
+      hs.NewHandle<mirror::ClassLoader>(soa.Decode<mirror::ClassLoader>(second_loader));
+  std::vector<std::vector<bool>> invalidated_classes;
+  std::string error_msg;
+  size_t num_invalidated = decoded_deps.InvalidateStaleClasses(soa.Self(),
+                                                               new_class_loader,
+                                                               second_dex_files,
+                                                               &invalidated_classes,
+                                                               &error_msg);
+
+  // The subclass LMyErroneousTimeZone; is invalidated with its superclass, other classes
+  // keep their recorded status.
+  ASSERT_EQ(1u, invalidated_classes.size());
+  ASSERT_EQ(dex_file.NumClassDefs(), invalidated_classes[0].size());
+  EXPECT_EQ(2u, num_invalidated) << error_msg;
+  for (uint32_t i = 0; i != dex_file.NumClassDefs(); ++i) {
+    std::string_view descriptor = dex_file.GetClassDescriptor(dex_file.GetClassDef(i));
+    bool expected = descriptor == "LMySimpleTimeZone;" || descriptor == "LMyErroneousTimeZone;";
+    EXPECT_EQ(expected, invalidated_classes[0][i]) << descriptor;
+    if (expected) {
+      EXPECT_FALSE(decoded_dex_deps->verified_classes_[i]);
+      EXPECT_TRUE(decoded_dex_deps->assignable_types_[i].empty());
+    }
+  }
+}
+
 TEST_F(VerifierDepsTest, CompilerDriver) {
   SetupCompilerDriver();
 
@@ -16,6 +16,7 @@
 
 #include "dexoptanalyzer.h"
 
+#include <cstdlib>
 #include <iostream>
 #include <string>
 #include <string_view>
@@ -34,12 +35,17 @@
 #include "dex/dex_file.h"
 #include "gc/heap.h"
 #include "gc/space/image_space.h"
+#include "handle_scope-inl.h"
+#include "mirror/class_loader.h"
 #include "noop_compiler_callbacks.h"
 #include "oat.h"
+#include "oat_file.h"
 #include "oat_file_assistant.h"
 #include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
 #include "thread-inl.h"
 #include "vdex_file.h"
+#include "verifier/verifier_deps.h"
 
 namespace art {
 namespace dexoptanalyzer {
@@ -125,6 +131,16 @@ NO_RETURN static void Usage(const char *fmt, ...) {
   UsageError("  --validate-bcp: validates the boot class path files (.art, .oat, .vdex).");
   UsageError("      Requires --isa and --image options to locate artifacts.");
   UsageError("");
+  UsageError("  --check-verifier-deps: if the oat file is only out of date with respect to the");
+  UsageError("      boot image, check the verifier dependencies of its vdex file against the");
+  UsageError("      current boot class path and class loader context, and print the number of");
+  UsageError("      classes dex2oat needs to verify again to standard output, in the form");
+  UsageError("      <classes to verify>/<classes>. The return code is not affected.");
+  UsageError("      The check opens the dex files of the app and of its class loader context,");
+  UsageError("      creates their class loader and loads the classes that the dependencies");
+  UsageError("      refer to. It can take a noticeable fraction of the time of a verify");
+  UsageError("      compilation, do not use it on latency-sensitive paths.");
+  UsageError("");
   UsageError("Return code:");
   UsageError("  To make it easier to integrate with the internal tools this command will make");
   UsageError("    available its result (dexoptNeeded) as the exit/return code. i.e. it will not");
@@ -150,6 +166,7 @@ class DexoptAnalyzer final {
   DexoptAnalyzer() :
       only_flatten_context_(false),
       only_validate_bcp_(false),
+      check_verifier_deps_(false),
       downgrade_(false) {}
 
   void ParseArgs(int argc, char **argv) {
@@ -238,6 +255,8 @@ class DexoptAnalyzer final {
         only_flatten_context_ = true;
       } else if (option == "--validate-bcp") {
         only_validate_bcp_ = true;
+      } else if (option == "--check-verifier-deps") {
+        check_verifier_deps_ = true;
       } else {
         Usage("Unknown argument '%s'", raw_option);
       }
@@ -305,12 +324,11 @@ class DexoptAnalyzer final {
         Usage("Invalid --class-loader-context '%s'", context_str_.c_str());
       }
     }
+    size_t dir_index = dex_file_.rfind('/');
+    std::string classpath_dir = (dir_index != std::string::npos)
+        ? dex_file_.substr(0, dir_index)
+        : "";
     if (class_loader_context != nullptr) {
-      size_t dir_index = dex_file_.rfind('/');
-      std::string classpath_dir = (dir_index != std::string::npos)
-          ? dex_file_.substr(0, dir_index)
-          : "";
-
       if (!class_loader_context->OpenDexFiles(classpath_dir,
                                               context_fds_,
                                               /*only_read_checksums=*/ true)) {
@@ -347,6 +365,10 @@ class DexoptAnalyzer final {
                                                            assume_profile_changed,
                                                            downgrade_);
 
+    if (check_verifier_deps_ && std::abs(dexoptNeeded) == OatFileAssistant::kDex2OatForBootImage) {
+      PrintClassesToVerify(oat_file_assistant.get(), classpath_dir);
+    }
+
     // Convert OatFileAssistant codes to dexoptanalyzer codes.
     switch (dexoptNeeded) {
       case OatFileAssistant::kNoDexOptNeeded: return ReturnCode::kNoDexOptNeeded;
@@ -362,6 +384,62 @@ class DexoptAnalyzer final {
     }
   }
 
+  // Prints how many classes of the vdex file dex2oat would need to verify again because their
+  // recorded dependencies no longer hold. The vdex file is used as input when recompiling for
+  // a new boot image, so the other classes keep their verification status. Checking the
+  // dependencies loads the classes they refer to, which is not free, see the usage.
+  void PrintClassesToVerify(OatFileAssistant* oat_file_assistant,
+                            const std::string& classpath_dir) const {
+    const OatFile* oat_file = oat_file_assistant->GetBestOatFileForAnalysis();
+    if (oat_file == nullptr || oat_file->GetVdexFile() == nullptr) {
+      LOG(INFO) << "No vdex file to check for " << dex_file_;
+      return;
+    }
+    std::vector<std::unique_ptr<const DexFile>> owned_dex_files;
+    if (!OatFileAssistant::LoadDexFiles(*oat_file, dex_file_, &owned_dex_files)) {
+      LOG(WARNING) << "Failed to load dex files of " << oat_file->GetLocation();
+      return;
+    }
+    std::vector<const DexFile*> dex_files;
+    size_t num_classes = 0u;
+    for (const std::unique_ptr<const DexFile>& dex_file : owned_dex_files) {
+      dex_files.push_back(dex_file.get());
+      num_classes += dex_file->NumClassDefs();
+    }
+
+    // The class loader needs fully opened dex files, unlike the context used for checksums.
+    std::unique_ptr<ClassLoaderContext> context = context_str_.empty()
+        ? ClassLoaderContext::Default()
+        : ClassLoaderContext::Create(context_str_);
+    if (context == nullptr || !context->OpenDexFiles(classpath_dir, context_fds_)) {
+      LOG(WARNING) << "Failed to open class loader context '" << context_str_ << "'";
+      return;
+    }
+    verifier::VerifierDeps verifier_deps(dex_files, /*output_only=*/ false);
+    if (!verifier_deps.ParseStoredData(dex_files,
+                                       oat_file->GetVdexFile()->GetVerifierDepsData())) {
+      LOG(WARNING) << "Failed to parse verifier dependencies of " << oat_file->GetLocation();
+      return;
+    }
+    jobject jclass_loader = context->CreateClassLoader(dex_files);
+
+    ScopedObjectAccess soa(Thread::Current());
+    StackHandleScope<1> hs(soa.Self());
+    Handle<mirror::ClassLoader> class_loader(
+        hs.NewHandle(soa.Decode<mirror::ClassLoader>(jclass_loader)));
+    std::vector<std::vector<bool>> classes_to_verify;
+    std::string error_msg;
+    size_t num_classes_to_verify = verifier_deps.InvalidateStaleClasses(soa.Self(),
+                                                                        class_loader,
+                                                                        dex_files,
+                                                                        &classes_to_verify,
+                                                                        &error_msg);
+    if (num_classes_to_verify != 0u) {
+      LOG(INFO) << "Verifier dependencies changed for " << dex_file_ << ": " << error_msg;
+    }
+    std::cout << num_classes_to_verify << "/" << num_classes << std::flush;
+  }
+
   // Validates the boot classpath and boot classpath extensions by checking the image checksums,
   // the oat files and the vdex files.
   //
@@ -470,6 +548,7 @@ class DexoptAnalyzer final {
   std::string context_str_;
   bool only_flatten_context_;
   bool only_validate_bcp_;
+  bool check_verifier_deps_;
   ProfileAnalysisResult profile_analysis_result_;
   bool downgrade_;
   std::string image_;
@@ -16,6 +16,7 @@
 
 #include <gtest/gtest.h>
 
+#include <regex>
 #include <string>
 
 #include "arch/instruction_set.h"
@@ -37,11 +38,11 @@ class DexoptAnalyzerTest : public DexoptTest {
     return file_path;
   }
 
-  int Analyze(const std::string& dex_file,
-              CompilerFilter::Filter compiler_filter,
-              ProfileAnalysisResult profile_analysis_result,
-              const char* class_loader_context,
-              bool downgrade = false) {
+  std::vector<std::string> GetAnalyzeArgs(const std::string& dex_file,
+                                          CompilerFilter::Filter compiler_filter,
+                                          ProfileAnalysisResult profile_analysis_result,
+                                          const char* class_loader_context,
+                                          bool downgrade) {
     std::string dexoptanalyzer_cmd = GetDexoptAnalyzerCmd();
     std::vector<std::string> argv_str;
     argv_str.push_back(dexoptanalyzer_cmd);
@@ -63,11 +64,51 @@ class DexoptAnalyzerTest : public DexoptTest {
     if (class_loader_context != nullptr) {
       argv_str.push_back("--class-loader-context=" + std::string(class_loader_context));
     }
+    return argv_str;
+  }
 
+  int Analyze(const std::string& dex_file,
+              CompilerFilter::Filter compiler_filter,
+              ProfileAnalysisResult profile_analysis_result,
+              const char* class_loader_context,
+              bool downgrade = false) {
+    std::vector<std::string> argv_str = GetAnalyzeArgs(
+        dex_file, compiler_filter, profile_analysis_result, class_loader_context, downgrade);
     std::string error;
     return ExecAndReturnCode(argv_str, &error);
   }
 
+  // Runs dexoptanalyzer with --check-verifier-deps and returns its return code. Sets
+  // `classes_to_verify` and `classes` to the numbers it printed, or to -1 if it printed none.
+  int AnalyzeVerifierDeps(const std::string& dex_file,
+                          CompilerFilter::Filter compiler_filter,
+                          /*out*/ int* classes_to_verify,
+                          /*out*/ int* classes) {
+    std::vector<std::string> argv_str = GetAnalyzeArgs(
+        dex_file,
+        compiler_filter,
+        ProfileAnalysisResult::kDontOptimizeSmallDelta,
+        /*class_loader_context=*/ "PCL[]",
+        /*downgrade=*/ false);
+    argv_str.push_back("--check-verifier-deps");
+    std::string output;
+    ForkAndExecResult res = ForkAndExec(argv_str, []() { return true; }, &output);
+    EXPECT_EQ(res.stage, ForkAndExecResult::kFinished) << output;
+    EXPECT_TRUE(WIFEXITED(res.status_code)) << output;
+    // The numbers are printed to standard output without a newline, and logs to standard
+    // error may follow them on the same line.
+    std::regex count_regex("(^|\\n)([0-9]+)/([0-9]+)");
+    std::smatch count_match;
+    if (std::regex_search(output, count_match, count_regex)) {
+      *classes_to_verify = std::stoi(count_match[2].str());
+      *classes = std::stoi(count_match[3].str());
+    } else {
+      *classes_to_verify = -1;
+      *classes = -1;
+    }
+    return WEXITSTATUS(res.status_code);
+  }
+
   int DexoptanalyzerToOatFileAssistant(int dexoptanalyzerResult) {
     switch (dexoptanalyzerResult) {
       case 0: return OatFileAssistant::kNoDexOptNeeded;
@@ -258,6 +299,50 @@ TEST_F(DexoptAnalyzerTest, OatImageOutOfDate) {
   Verify(dex_location, CompilerFilter::kSpeed);
 }
 
+// Case: We have a DEX file and an ODEX file out of date with respect to the
+// boot image, and we check its verifier dependencies. They still hold with the
+// same boot class path, so no class needs to be verified again.
+TEST_F(DexoptAnalyzerTest, CheckVerifierDepsImageOutOfDate) {
+  std::string dex_location = GetScratchDir() + "/CheckVerifierDepsImageOutOfDate.jar";
+  std::string odex_location = GetOdexDir() + "/CheckVerifierDepsImageOutOfDate.odex";
+
+  Copy(GetDexSrc1(), dex_location);
+  GenerateOatForTest(dex_location.c_str(),
+                     odex_location.c_str(),
+                     CompilerFilter::kSpeed,
+                     /*with_alternate_image=*/true);
+
+  size_t number_of_classes = 0u;
+  for (const std::unique_ptr<const DexFile>& dex_file : OpenTestDexFiles("Main")) {
+    number_of_classes += dex_file->NumClassDefs();
+  }
+  int classes_to_verify;
+  int classes;
+  // The return code is the same as without --check-verifier-deps.
+  EXPECT_EQ(static_cast<int>(ReturnCode::kDex2OatForBootImageOdex),
+            AnalyzeVerifierDeps(
+                dex_location, CompilerFilter::kSpeed, &classes_to_verify, &classes));
+  EXPECT_EQ(0, classes_to_verify);
+  EXPECT_EQ(static_cast<int>(number_of_classes), classes);
+}
+
+// Case: We have a DEX file and an up-to-date ODEX file. The verifier dependencies
+// are only checked when the ODEX file is out of date with respect to the boot image.
+TEST_F(DexoptAnalyzerTest, CheckVerifierDepsUpToDate) {
+  std::string dex_location = GetScratchDir() + "/CheckVerifierDepsUpToDate.jar";
+  std::string odex_location = GetOdexDir() + "/CheckVerifierDepsUpToDate.odex";
+  Copy(GetDexSrc1(), dex_location);
+  GenerateOdexForTest(dex_location.c_str(), odex_location.c_str(), CompilerFilter::kSpeed);
+
+  int classes_to_verify;
+  int classes;
+  EXPECT_EQ(static_cast<int>(ReturnCode::kNoDexOptNeeded),
+            AnalyzeVerifierDeps(
+                dex_location, CompilerFilter::kSpeed, &classes_to_verify, &classes));
+  EXPECT_EQ(-1, classes_to_verify);
+  EXPECT_EQ(-1, classes);
+}
+
 // Case: We have a DEX file and a verify-at-runtime OAT file out of date with
 // respect to the boot image.
 // It shouldn't matter that the OAT file is out of date, because it is
@@ -44,6 +44,7 @@ const char* const ArenaAllocatorStatsImpl<kCount>::kAllocNames[] = {
   "BlockList    ",
   "RevPostOrder ",
   "LinearOrder  ",
+  "BlockFreq    ",
   "Reachability ",
   "ConstantsMap ",
   "Predecessors ",
@@ -76,6 +77,7 @@ const char* const ArenaAllocatorStatsImpl<kCount>::kAllocNames[] = {
   "CFRE         ",
   "LICM         ",
   "LoopOpt      ",
+  "SuperwordVec ",
   "SsaLiveness  ",
   "SsaPhiElim   ",
   "RefTypeProp  ",
@@ -53,6 +53,7 @@ enum ArenaAllocKind {
   kArenaAllocBlockList,
   kArenaAllocReversePostOrder,
   kArenaAllocLinearOrder,
+  kArenaAllocBlockFrequency,
   kArenaAllocReachabilityGraph,
   kArenaAllocConstantsMap,
   kArenaAllocPredecessors,
@@ -85,6 +86,7 @@ enum ArenaAllocKind {
   kArenaAllocCFRE,
   kArenaAllocLICM,
   kArenaAllocLoopOptimization,
+  kArenaAllocSuperwordVectorizer,
   kArenaAllocSsaLiveness,
   kArenaAllocSsaPhiElimination,
   kArenaAllocReferenceTypePropagation,
@@ -238,6 +240,9 @@ class ArenaPool {
   virtual void LockReclaimMemory() = 0;
   // Trim the maps in arenas by madvising, used by JIT to reduce memory usage.
   virtual void TrimMaps() = 0;
+  // Like TrimMaps(), but leave the most recently freed arenas resident until `warm_bytes`
+  // of them are kept, so that the next allocation can reuse pages without faulting them in.
+  virtual void TrimColdMaps(size_t warm_bytes) = 0;
 
  protected:
   ArenaPool() = default;
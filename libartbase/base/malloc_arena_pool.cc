@@ -122,6 +122,10 @@ void MallocArenaPool::TrimMaps() {
   // Nop, because there is no way to do madvise here.
 }
 
+void MallocArenaPool::TrimColdMaps(size_t warm_bytes ATTRIBUTE_UNUSED) {
+  // Nop, because there is no way to do madvise here.
+}
+
 size_t MallocArenaPool::GetBytesAllocated() const {
   size_t total = 0;
   std::lock_guard<std::mutex> lock(lock_);
@@ -34,6 +34,8 @@ class MallocArenaPool final : public ArenaPool {
   void LockReclaimMemory() override;
   // Is a nop for malloc pools.
   void TrimMaps() override;
+  // Is a nop for malloc pools.
+  void TrimColdMaps(size_t warm_bytes) override;
 
  private:
   Arena* free_arenas_;
@@ -55,7 +55,8 @@
   METRIC(YoungGcThroughput, MetricsHistogram, 15, 0, 10'000)            \
   METRIC(FullGcThroughput, MetricsHistogram, 15, 0, 10'000)             \
   METRIC(YoungGcTracingThroughput, MetricsHistogram, 15, 0, 10'000)     \
-  METRIC(FullGcTracingThroughput, MetricsHistogram, 15, 0, 10'000)
+  METRIC(FullGcTracingThroughput, MetricsHistogram, 15, 0, 10'000)      \
+  METRIC(JitMethodCompileArenaPeakKb, MetricsHistogram, 15, 0, 131'072)
 
 // A lot of the metrics implementation code is generated by passing one-off macros into ART_COUNTERS
 // and ART_HISTOGRAMS. This means metrics.h and metrics.cc are very #define-heavy, which can be
@@ -125,6 +125,21 @@ void MemMapArenaPool::TrimMaps() {
   }
 }
 
+void MemMapArenaPool::TrimColdMaps(size_t warm_bytes) {
+  ScopedTrace trace(__PRETTY_FUNCTION__);
+  std::lock_guard<std::mutex> lock(lock_);
+  // Freed chains are pushed at the front of `free_arenas_` and AllocArena() pops from the
+  // front, so the arenas at the head are both the warmest and the first to be reused.
+  size_t retained_bytes = 0;
+  for (Arena* arena = free_arenas_; arena != nullptr; arena = arena->next_) {
+    if (retained_bytes < warm_bytes) {
+      retained_bytes += arena->GetBytesAllocated();
+    } else {
+      arena->Release();
+    }
+  }
+}
+
 size_t MemMapArenaPool::GetBytesAllocated() const {
   size_t total = 0;
   std::lock_guard<std::mutex> lock(lock_);
@@ -32,6 +32,8 @@ class MemMapArenaPool final : public ArenaPool {
   void LockReclaimMemory() override;
   // Trim the maps in arenas by madvising, used by JIT to reduce memory usage.
   void TrimMaps() override;
+  // Trim the maps of free arenas past the first `warm_bytes` of recently used ones.
+  void TrimColdMaps(size_t warm_bytes) override;
 
  private:
   const bool low_4gb_;
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mem_map_arena_pool.h"
+
+#include "base/arena_allocator-inl.h"
+#include "gtest/gtest.h"
+
+namespace art {
+
+TEST(MemMapArenaPoolTest, TrimColdMaps) {
+  if (arena_allocator::kArenaAllocatorPreciseTracking) {
+    printf("WARNING: TEST DISABLED FOR precise arena tracking\n");
+    return;
+  }
+
+  MemMapArenaPool pool(/* low_4gb= */ false, "MemMapArenaPoolTest");
+  {
+    // Fill four arenas and give them back to the pool.
+    ArenaAllocator allocator(&pool);
+    for (size_t i = 0; i != 4u; ++i) {
+      allocator.Alloc(arena_allocator::kArenaDefaultSize * 3 / 4);
+    }
+  }
+  size_t allocated = pool.GetBytesAllocated();
+  ASSERT_GE(allocated, 3 * arena_allocator::kArenaDefaultSize);
+
+  // All the arenas fit in the warm budget.
+  pool.TrimColdMaps(allocated);
+  EXPECT_EQ(allocated, pool.GetBytesAllocated());
+
+  // Only the most recently freed arena stays resident.
+  pool.TrimColdMaps(1u);
+  size_t warm = pool.GetBytesAllocated();
+  EXPECT_GE(warm, arena_allocator::kArenaDefaultSize / 2);
+  EXPECT_LT(warm, allocated);
+
+  pool.TrimColdMaps(0u);
+  EXPECT_EQ(0u, pool.GetBytesAllocated());
+}
+
+}  // namespace art
@@ -149,6 +149,15 @@ void TimingLogger::EndTiming() {
   ATraceEnd();
 }
 
+void TimingLogger::AddTiming(const char* label, uint64_t start_time, uint64_t end_time) {
+  DCHECK(label != nullptr);
+  DCHECK(kind_ == TimingKind::kMonotonic);
+  DCHECK_LE(start_time, end_time);
+  DCHECK(timings_.empty() || timings_.back().GetTime() <= start_time);
+  timings_.push_back(Timing(start_time, label));
+  timings_.push_back(Timing(end_time, nullptr));
+}
+
 uint64_t TimingLogger::GetTotalNs() const {
   if (timings_.size() < 2) {
     return 0;
@@ -110,6 +110,7 @@ class TimingLogger {
           break;
        }
     }
+    Timing(uint64_t time, const char* name) : time_(time), name_(name) {}
     bool IsStartTiming() const {
       return !IsEndTiming();
     }
@@ -171,6 +172,10 @@ class TimingLogger {
     EndTiming();
     StartTiming(new_split_label);
   }
+  // Adds a timing that took place within the current timing, between `start_time` and
+  // `end_time` as returned by NanoTime(), for example one measured on other threads.
+  // Only valid for monotonic timing loggers.
+  void AddTiming(const char* label, uint64_t start_time, uint64_t end_time);
   // Returns the total duration of the timings (sum of total times).
   uint64_t GetTotalNs() const;
   // Find the index of a timing by name.
@@ -158,6 +158,27 @@ TEST_F(TimingLoggerTest, ScopedAndExplicit) {
   EXPECT_LE(timings[idx_innerinnersplit1].GetTime(), timings[idx_innerinnersplit2].GetTime());
 }
 
+TEST_F(TimingLoggerTest, AddTiming) {
+  const char* outersplit = "Outer Split";
+  const char* addedsplit = "Added Split";
+  TimingLogger logger("AddTiming", true, false);
+  logger.StartTiming(outersplit);
+  uint64_t start_time = NanoTime();
+  uint64_t end_time = NanoTime();
+  logger.AddTiming(addedsplit, start_time, end_time);
+  logger.EndTiming();  // Ends outersplit.
+  const auto& timings = logger.GetTimings();
+  EXPECT_EQ(4U, timings.size());
+  const size_t idx_addedsplit = logger.FindTimingIndex(addedsplit, 0);
+  EXPECT_EQ(1U, idx_addedsplit);
+  EXPECT_TRUE(timings[1].IsStartTiming());
+  EXPECT_EQ(start_time, timings[1].GetTime());
+  EXPECT_TRUE(timings[2].IsEndTiming());
+  EXPECT_EQ(end_time, timings[2].GetTime());
+  TimingLogger::TimingData timing_data = logger.CalculateTimingData();
+  EXPECT_EQ(end_time - start_time, timing_data.GetTotalTime(idx_addedsplit));
+}
+
 TEST_F(TimingLoggerTest, ThreadCpuAndMonotonic) {
   TimingLogger mon_logger("Scoped", true, false, TimingLogger::TimingKind::kMonotonic);
   TimingLogger cpu_logger("Scoped", true, false, TimingLogger::TimingKind::kThreadCpu);
@@ -2364,6 +2364,7 @@ void ClassLinker::DeleteClassLoader(Thread* self, const ClassLoaderData& data, b
       // For the JIT case, RemoveMethodsIn removes the CHA dependencies.
       code_cache->RemoveMethodsIn(self, *data.allocator);
     }
+    runtime->GetJit()->RemoveMethodsIn(self, *data.allocator);
   } else if (cha_ != nullptr) {
     // If we don't have a JIT, we need to manually remove the CHA dependencies manually.
     cha_->RemoveDependenciesForLinearAlloc(data.allocator);
@@ -987,25 +987,38 @@ class ImageSpace::Loader {
         const uint64_t start = NanoTime();
         Thread* const self = Thread::Current();
         static constexpr size_t kMinBlocks = 2u;
+        // Images are usually split into many small blocks. Give each task a run of consecutive
+        // blocks of at least this decompressed size to keep the task overhead low.
+        static constexpr size_t kMinTaskImageSize = 512 * KB;
         const bool use_parallel = pool != nullptr && image_header.GetBlockCount() >= kMinBlocks;
-        for (const ImageHeader::Block& block : image_header.GetBlocks(temp_map.Begin())) {
-          auto function = [&](Thread*) {
+        auto blocks = image_header.GetBlocks(temp_map.Begin());
+        for (const ImageHeader::Block* task_begin = blocks.begin(); task_begin != blocks.end(); ) {
+          const ImageHeader::Block* task_end = task_begin;
+          size_t task_image_size = 0u;
+          do {
+            task_image_size += task_end->GetImageSize();
+            ++task_end;
+          } while (task_end != blocks.end() && task_image_size < kMinTaskImageSize);
+          auto function = [&, task_begin, task_end, task_image_size](Thread*) {
             const uint64_t start2 = NanoTime();
-            ScopedTrace trace("LZ4 decompress block");
-            bool result = block.Decompress(/*out_ptr=*/map.Begin(),
-                                           /*in_ptr=*/temp_map.Begin(),
-                                           error_msg);
-            if (!result && error_msg != nullptr) {
-              *error_msg = "Failed to decompress image block " + *error_msg;
+            ScopedTrace trace("LZ4 decompress blocks");
+            for (const ImageHeader::Block* block = task_begin; block != task_end; ++block) {
+              bool result = block->Decompress(/*out_ptr=*/map.Begin(),
+                                              /*in_ptr=*/temp_map.Begin(),
+                                              error_msg);
+              if (!result && error_msg != nullptr) {
+                *error_msg = "Failed to decompress image block " + *error_msg;
+              }
             }
-            VLOG(image) << "Decompress block " << block.GetDataSize() << " -> "
-                        << block.GetImageSize() << " in " << PrettyDuration(NanoTime() - start2);
+            VLOG(image) << "Decompress " << (task_end - task_begin) << " blocks to "
+                        << task_image_size << " in " << PrettyDuration(NanoTime() - start2);
           };
           if (use_parallel) {
             pool->AddTask(self, new FunctionTask(std::move(function)));
           } else {
             function(self);
           }
+          task_begin = task_end;
         }
         if (use_parallel) {
           ScopedTrace trace("Waiting for workers");
@@ -106,6 +106,10 @@ class PACKED(8) ImageHeader {
       return data_size_;
     }
 
+    uint32_t GetImageOffset() const {
+      return image_offset_;
+    }
+
     uint32_t GetImageSize() const {
       return image_size_;
     }
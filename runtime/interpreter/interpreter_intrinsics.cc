@@ -262,6 +262,9 @@ SIMPLE_STRING_INTRINSIC(StringIsEmpty, SetZ(str->GetLength() == 0))
 // java.lang.String.length()I
 SIMPLE_STRING_INTRINSIC(StringLength, SetI(str->GetLength()))
 
+// java.lang.String.hashCode()I
+SIMPLE_STRING_INTRINSIC(StringHashCode, SetI(str->GetHashCode()))
+
 // java.lang.String.getCharsNoCheck(II[CI)V
 static ALWAYS_INLINE bool MterpStringGetCharsNoCheck(ShadowFrame* shadow_frame,
                                                      const Instruction* inst,
@@ -507,6 +510,14 @@ bool MterpHandleIntrinsic(ShadowFrame* shadow_frame,
     UNIMPLEMENTED_CASE(SystemArrayCopyChar /* ([CI[CII)V */)
     UNIMPLEMENTED_CASE(SystemArrayCopyInt /* ([II[III)V */)
     UNIMPLEMENTED_CASE(SystemArrayCopy /* (Ljava/lang/Object;ILjava/lang/Object;II)V */)
+    UNIMPLEMENTED_CASE(ArraysEqualsByte /* ([B[B)Z */)
+    UNIMPLEMENTED_CASE(ArraysEqualsInt /* ([I[I)Z */)
+    UNIMPLEMENTED_CASE(ArraysFillByte /* ([BB)V */)
+    UNIMPLEMENTED_CASE(ArraysFillInt /* ([II)V */)
+    UNIMPLEMENTED_CASE(ArraysHashCodeByte /* ([B)I */)
+    UNIMPLEMENTED_CASE(ArraysHashCodeInt /* ([I)I */)
+    UNIMPLEMENTED_CASE(ArraysSupportMismatchByte /* ([B[BI)I */)
+    UNIMPLEMENTED_CASE(ArraysSupportMismatchInt /* ([I[II)I */)
     UNIMPLEMENTED_CASE(ThreadCurrentThread /* ()Ljava/lang/Thread; */)
     UNIMPLEMENTED_CASE(MemoryPeekByte /* (J)B */)
     UNIMPLEMENTED_CASE(MemoryPeekIntNative /* (J)I */)
@@ -521,6 +532,7 @@ bool MterpHandleIntrinsic(ShadowFrame* shadow_frame,
     INTRINSIC_CASE(StringCompareTo)
     INTRINSIC_CASE(StringEquals)
     INTRINSIC_CASE(StringGetCharsNoCheck)
+    INTRINSIC_CASE(StringHashCode)
     INTRINSIC_CASE(StringIndexOf)
     INTRINSIC_CASE(StringIndexOfAfter)
     UNIMPLEMENTED_CASE(StringStringIndexOf /* (Ljava/lang/String;)I */)
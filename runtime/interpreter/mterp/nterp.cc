@@ -706,11 +706,14 @@ extern "C" jit::OsrData* NterpHotMethod(ArtMethod* method, uint16_t* dex_pc_ptr,
       // This could be a loop back edge, check if we can OSR.
       CodeItemInstructionAccessor accessor(method->DexInstructions());
       uint32_t dex_pc = dex_pc_ptr - accessor.Insns();
-      jit::OsrData* osr_data = jit->PrepareForOsr(
-          method->GetInterfaceMethodIfProxy(kRuntimePointerSize), dex_pc, vregs);
+      ArtMethod* osr_method = method->GetInterfaceMethodIfProxy(kRuntimePointerSize);
+      jit::OsrData* osr_data = jit->PrepareForOsr(osr_method, dex_pc, vregs);
       if (osr_data != nullptr) {
         return osr_data;
       }
+      // The method may be stuck in this loop, compile an OSR version of it
+      // that we can jump to from this frame.
+      jit->MaybeEnqueueOsrCompilation(osr_method, dex_pc, Thread::Current());
     }
     jit->MaybeEnqueueCompilation(method, Thread::Current());
   }
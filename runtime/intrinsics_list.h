@@ -163,6 +163,14 @@
   V(SystemArrayCopyChar, kStatic, kNeedsEnvironment, kAllSideEffects, kCanThrow, "Ljava/lang/System;", "arraycopy", "([CI[CII)V") \
   V(SystemArrayCopyInt, kStatic, kNeedsEnvironment, kAllSideEffects, kCanThrow, "Ljava/lang/System;", "arraycopy", "([II[III)V") \
   V(SystemArrayCopy, kStatic, kNeedsEnvironment, kAllSideEffects, kCanThrow, "Ljava/lang/System;", "arraycopy", "(Ljava/lang/Object;ILjava/lang/Object;II)V") \
+  V(ArraysEqualsByte, kStatic, kNeedsEnvironment, kReadSideEffects, kNoThrow, "Ljava/util/Arrays;", "equals", "([B[B)Z") \
+  V(ArraysEqualsInt, kStatic, kNeedsEnvironment, kReadSideEffects, kNoThrow, "Ljava/util/Arrays;", "equals", "([I[I)Z") \
+  V(ArraysFillByte, kStatic, kNeedsEnvironment, kAllSideEffects, kCanThrow, "Ljava/util/Arrays;", "fill", "([BB)V") \
+  V(ArraysFillInt, kStatic, kNeedsEnvironment, kAllSideEffects, kCanThrow, "Ljava/util/Arrays;", "fill", "([II)V") \
+  V(ArraysHashCodeByte, kStatic, kNeedsEnvironment, kReadSideEffects, kNoThrow, "Ljava/util/Arrays;", "hashCode", "([B)I") \
+  V(ArraysHashCodeInt, kStatic, kNeedsEnvironment, kReadSideEffects, kNoThrow, "Ljava/util/Arrays;", "hashCode", "([I)I") \
+  V(ArraysSupportMismatchByte, kStatic, kNeedsEnvironment, kAllSideEffects, kCanThrow, "Ljdk/internal/util/ArraysSupport;", "mismatch", "([B[BI)I") \
+  V(ArraysSupportMismatchInt, kStatic, kNeedsEnvironment, kAllSideEffects, kCanThrow, "Ljdk/internal/util/ArraysSupport;", "mismatch", "([I[II)I") \
   V(ThreadCurrentThread, kStatic, kNeedsEnvironment, kNoSideEffects, kNoThrow, "Ljava/lang/Thread;", "currentThread", "()Ljava/lang/Thread;") \
   V(MemoryPeekByte, kStatic, kNeedsEnvironment, kReadSideEffects, kCanThrow, "Llibcore/io/Memory;", "peekByte", "(J)B") \
   V(MemoryPeekIntNative, kStatic, kNeedsEnvironment, kReadSideEffects, kCanThrow, "Llibcore/io/Memory;", "peekIntNative", "(J)I") \
@@ -188,6 +196,7 @@
   V(StringCompareTo, kVirtual, kNeedsEnvironment, kReadSideEffects, kCanThrow, "Ljava/lang/String;", "compareTo", "(Ljava/lang/String;)I") \
   V(StringEquals, kVirtual, kNeedsEnvironment, kReadSideEffects, kCanThrow, "Ljava/lang/String;", "equals", "(Ljava/lang/Object;)Z") \
   V(StringGetCharsNoCheck, kVirtual, kNeedsEnvironment, kReadSideEffects, kCanThrow, "Ljava/lang/String;", "getCharsNoCheck", "(II[CI)V") \
+  V(StringHashCode, kVirtual, kNeedsEnvironment, kReadSideEffects, kNoThrow, "Ljava/lang/String;", "hashCode", "()I") \
   V(StringIndexOf, kVirtual, kNeedsEnvironment, kReadSideEffects, kNoThrow, "Ljava/lang/String;", "indexOf", "(I)I") \
   V(StringIndexOfAfter, kVirtual, kNeedsEnvironment, kReadSideEffects, kNoThrow, "Ljava/lang/String;", "indexOf", "(II)I") \
   V(StringStringIndexOf, kVirtual, kNeedsEnvironment, kReadSideEffects, kCanThrow, "Ljava/lang/String;", "indexOf", "(Ljava/lang/String;)I") \
@@ -26,6 +26,7 @@
 #include "base/memory_tool.h"
 #include "base/runtime_debug.h"
 #include "base/scoped_flock.h"
+#include "base/stl_util.h"
 #include "base/utils.h"
 #include "class_root-inl.h"
 #include "compilation_kind.h"
@@ -39,6 +40,7 @@
 #include "jit-inl.h"
 #include "jit_code_cache.h"
 #include "jni/java_vm_ext.h"
+#include "linear_alloc.h"
 #include "mirror/method_handle_impl.h"
 #include "mirror/var_handle.h"
 #include "oat_file.h"
@@ -90,6 +92,8 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
   jit_options->use_jit_compilation_ = options.GetOrDefault(RuntimeArgumentMap::UseJitCompilation);
   jit_options->use_profiled_jit_compilation_ =
       options.GetOrDefault(RuntimeArgumentMap::UseProfiledJitCompilation);
+  jit_options->use_code_affinity_layout_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITCodeAffinityLayout);
 
   jit_options->code_cache_initial_capacity_ =
       options.GetOrDefault(RuntimeArgumentMap::JITCodeCacheInitialCapacity);
@@ -185,7 +189,8 @@ Jit::Jit(JitCodeCache* code_cache, JitOptions* options)
       lock_("JIT memory use lock"),
       zygote_mapping_methods_(),
       fd_methods_(-1),
-      fd_methods_size_(0) {}
+      fd_methods_size_(0),
+      only_osr_compile_hot_loops_(false) {}
 
 Jit* Jit::Create(JitCodeCache* code_cache, JitOptions* options) {
   if (jit_load_ == nullptr) {
@@ -454,12 +459,6 @@ OsrData* Jit::PrepareForOsr(ArtMethod* method, uint32_t dex_pc, uint32_t* vregs)
     return nullptr;
   }
 
-  // Cheap check if the method has been compiled already. That's an indicator that we should
-  // osr into it.
-  if (!GetCodeCache()->ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
-    return nullptr;
-  }
-
   // Fetch some data before looking up for an OSR method. We don't want thread
   // suspension once we hold an OSR method, as the JIT code cache could delete the OSR
   // method while we are being suspended.
@@ -577,6 +576,13 @@ bool Jit::MaybeDoOnStackReplacement(Thread* thread,
     return false;
   }
 
+  // Cheap check if the method has been compiled already. That's an indicator that we should
+  // osr into it. This is called on every branch of the switch interpreter, so we avoid
+  // looking up the OSR code when the method has no JIT code at all.
+  if (!jit->GetCodeCache()->ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
+    return false;
+  }
+
   ShadowFrame* shadow_frame = thread->GetManagedStack()->GetTopShadowFrame();
   OsrData* osr_data = jit->PrepareForOsr(method,
                                          dex_pc + dex_pc_offset,
@@ -782,11 +788,20 @@ class JitCompileTask final : public Task {
       switch (kind_) {
         case TaskKind::kCompile:
         case TaskKind::kPreCompile: {
-          Runtime::Current()->GetJit()->CompileMethod(
+          Jit* jit = Runtime::Current()->GetJit();
+          bool success = jit->CompileMethod(
               method_,
               self,
               compilation_kind_,
               /* prejit= */ (kind_ == TaskKind::kPreCompile));
+          if (success &&
+              kind_ == TaskKind::kCompile &&
+              compilation_kind_ == CompilationKind::kOptimized) {
+            jit->MaybeCompileAffineCallees(method_, self);
+          }
+          if (compilation_kind_ == CompilationKind::kOsr) {
+            jit->RemovePendingOsrCompilation(method_, self);
+          }
           break;
         }
       }
@@ -1483,6 +1498,93 @@ void Jit::EnqueueOptimizedCompilation(ArtMethod* method, Thread* self) {
   }
 }
 
+void Jit::MaybeCompileAffineCallees(ArtMethod* caller, Thread* self) {
+  if (!options_->UseCodeAffinityLayout() || options_->UseBaselineCompiler()) {
+    return;
+  }
+  // Compiled code cannot be moved once installed, so instead of relaying out the code
+  // cache we steer where the callees get allocated: compiling them right after the caller
+  // places them next to it. Like Pettis-Hansen, heaviest call edges are placed first.
+  static constexpr size_t kMaxAffineCallees = 4;
+  // Call edges colder than this are not worth an early optimized compilation.
+  static constexpr uint32_t kMinAffineCallCount = 1000;
+
+  VariableSizedHandleScope handles(self);
+  std::vector<std::pair<uint32_t, ArtMethod*>> edges;
+  {
+    ScopedProfilingInfoUse spiu(this, caller, self);
+    ProfilingInfo* info = spiu.GetProfilingInfo();
+    if (info == nullptr) {
+      return;
+    }
+    ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+    for (const DexInstructionPcPair& inst : caller->DexInstructions()) {
+      switch (inst->Opcode()) {
+        case Instruction::INVOKE_VIRTUAL:
+        case Instruction::INVOKE_VIRTUAL_RANGE:
+        case Instruction::INVOKE_INTERFACE:
+        case Instruction::INVOKE_INTERFACE_RANGE:
+          break;
+        default:
+          continue;
+      }
+      StackHandleScope<InlineCache::kIndividualCacheSize> classes(self);
+      std::array<uint32_t, InlineCache::kIndividualCacheSize> counts;
+      code_cache_->CopyInlineCacheInto(*info->GetInlineCache(inst.DexPc()), &classes, &counts);
+      size_t number_of_types = InlineCache::kIndividualCacheSize - classes.RemainingSlots();
+      if (number_of_types == 0) {
+        continue;
+      }
+      size_t dominant = 0;
+      for (size_t i = 1; i != number_of_types; ++i) {
+        if (counts[i] > counts[dominant]) {
+          dominant = i;
+        }
+      }
+      if (counts[dominant] < kMinAffineCallCount) {
+        continue;
+      }
+      ArtMethod* resolved_method = class_linker->LookupResolvedMethod(
+          inst->VRegB(), caller->GetDexCache(), caller->GetClassLoader());
+      if (resolved_method == nullptr) {
+        continue;
+      }
+      ArtMethod* callee = classes.GetReference(dominant)->AsClass()
+          ->FindVirtualMethodForVirtualOrInterface(resolved_method, kRuntimePointerSize);
+      if (callee == nullptr || callee == caller || callee->IsNative() || !callee->IsCompilable()) {
+        continue;
+      }
+      // Only move up the optimized compilation of callees that are already hot enough to
+      // run baseline code; the others may never be compiled at all.
+      const void* entry_point = callee->GetEntryPointFromQuickCompiledCode();
+      if (!code_cache_->ContainsPc(entry_point) ||
+          !CodeInfo::IsBaseline(
+              OatQuickMethodHeader::FromEntryPoint(entry_point)->GetOptimizedCodeInfoPtr())) {
+        continue;
+      }
+      // Keep the callee's class alive until we are done compiling it.
+      handles.NewHandle(callee->GetDeclaringClass());
+      edges.emplace_back(counts[dominant], callee);
+    }
+  }
+
+  std::stable_sort(edges.begin(), edges.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.first > rhs.first;
+  });
+  size_t compiled = 0;
+  for (const std::pair<uint32_t, ArtMethod*>& edge : edges) {
+    if (compiled == kMaxAffineCallees) {
+      break;
+    }
+    // Compiling fails if an earlier edge already led to the same callee.
+    if (CompileMethod(edge.second, self, CompilationKind::kOptimized, /* prejit= */ false)) {
+      VLOG(jit) << "Compiled " << edge.second->PrettyMethod() << " next to its caller "
+                << caller->PrettyMethod() << " (" << edge.first << " calls)";
+      ++compiled;
+    }
+  }
+}
+
 class ScopedSetRuntimeThread {
  public:
   explicit ScopedSetRuntimeThread(Thread* self)
@@ -1723,6 +1825,77 @@ bool Jit::CanAssumeInitialized(ObjPtr<mirror::Class> cls, bool is_for_shared_reg
   }
 }
 
+void Jit::MaybeEnqueueOsrCompilation(ArtMethod* method, uint32_t dex_pc, Thread* self) {
+  // Number of times the hotness counter must expire on the back edge of the same
+  // loop before we OSR compile the method.
+  static constexpr uint16_t kOsrLoopHotnessThreshold = 2;
+  // Bound the memory used by the loop counters, loops that did not get hot by
+  // the time we reach this number of entries are forgotten.
+  static constexpr size_t kMaxLoopHotnessCounters = 1024;
+
+  if (thread_pool_ == nullptr ||
+      JitAtFirstUse() ||
+      !UseJitCompilation() ||
+      method->IsNative() ||
+      IgnoreSamplesForMethod(method) ||
+      code_cache_->IsOsrCompiled(method)) {
+    return;
+  }
+
+  {
+    MutexLock mu(self, lock_);
+    if (ContainsElement(pending_osr_compilations_, method)) {
+      // An OSR compilation is already enqueued or running.
+      return;
+    }
+    auto key = std::make_pair(method, dex_pc);
+    auto it = loop_hotness_counters_.find(key);
+    if (it == loop_hotness_counters_.end()) {
+      if (loop_hotness_counters_.size() == kMaxLoopHotnessCounters) {
+        // Forget one loop to make room. All counters are below the threshold,
+        // so none of them is closer to triggering a compilation.
+        loop_hotness_counters_.erase(loop_hotness_counters_.begin());
+      }
+      loop_hotness_counters_.emplace(key, 1u);
+      return;
+    }
+    if (++it->second < kOsrLoopHotnessThreshold) {
+      return;
+    }
+    loop_hotness_counters_.erase(it);
+    pending_osr_compilations_.insert(method);
+  }
+
+  VLOG(jit) << "Loop at dex pc 0x" << std::hex << dex_pc << std::dec << " in "
+            << method->PrettyMethod() << " is hot, enqueuing OSR compilation";
+  thread_pool_->AddTask(
+      self,
+      new JitCompileTask(method, JitCompileTask::TaskKind::kCompile, CompilationKind::kOsr));
+}
+
+void Jit::RemovePendingOsrCompilation(ArtMethod* method, Thread* self) {
+  MutexLock mu(self, lock_);
+  pending_osr_compilations_.erase(method);
+}
+
+void Jit::RemoveMethodsIn(Thread* self, const LinearAlloc& alloc) {
+  MutexLock mu(self, lock_);
+  for (auto it = loop_hotness_counters_.begin(); it != loop_hotness_counters_.end();) {
+    if (alloc.ContainsUnsafe(it->first.first)) {
+      it = loop_hotness_counters_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  for (auto it = pending_osr_compilations_.begin(); it != pending_osr_compilations_.end();) {
+    if (alloc.ContainsUnsafe(*it)) {
+      it = pending_osr_compilations_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
 void Jit::MaybeEnqueueCompilation(ArtMethod* method, Thread* self) {
   if (thread_pool_ == nullptr) {
     return;
@@ -1737,6 +1910,10 @@ void Jit::MaybeEnqueueCompilation(ArtMethod* method, Thread* self) {
     return;
   }
 
+  if (only_osr_compile_hot_loops_.load(std::memory_order_relaxed)) {
+    return;
+  }
+
   if (IgnoreSamplesForMethod(method)) {
     return;
   }
@@ -17,6 +17,10 @@
 #ifndef ART_RUNTIME_JIT_JIT_H_
 #define ART_RUNTIME_JIT_JIT_H_
 
+#include <atomic>
+#include <map>
+#include <set>
+
 #include <android-base/unique_fd.h>
 
 #include "base/histogram-inl.h"
@@ -38,6 +42,7 @@ namespace art {
 class ArtMethod;
 class ClassLinker;
 class DexFile;
+class LinearAlloc;
 class OatDexFile;
 struct RuntimeArgumentMap;
 union JValue;
@@ -147,6 +152,10 @@ class JitOptions {
     return use_baseline_compiler_;
   }
 
+  bool UseCodeAffinityLayout() const {
+    return use_code_affinity_layout_;
+  }
+
  private:
   // We add the sample in batches of size kJitSamplesBatchSize.
   // This method rounds the threshold so that it is multiple of the batch size.
@@ -155,6 +164,7 @@ class JitOptions {
   bool use_jit_compilation_;
   bool use_profiled_jit_compilation_;
   bool use_baseline_compiler_;
+  bool use_code_affinity_layout_;
   size_t code_cache_initial_capacity_;
   size_t code_cache_max_capacity_;
   uint32_t optimize_threshold_;
@@ -170,6 +180,7 @@ class JitOptions {
       : use_jit_compilation_(false),
         use_profiled_jit_compilation_(false),
         use_baseline_compiler_(false),
+        use_code_affinity_layout_(false),
         code_cache_initial_capacity_(0),
         code_cache_max_capacity_(0),
         optimize_threshold_(0),
@@ -243,6 +254,14 @@ class Jit {
   bool CompileMethod(ArtMethod* method, Thread* self, CompilationKind compilation_kind, bool prejit)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Called after `caller` got optimized code. With -Xjitcodeaffinitylayout, compiles
+  // the baseline compiled callees its inline caches saw the most calls to, so that
+  // their code is likely to be allocated next to the caller's in the code cache.
+  // Placement is best-effort only: the code cache allocator picks the address, and
+  // other threads may allocate code in between.
+  void MaybeCompileAffineCallees(ArtMethod* caller, Thread* self)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   const JitCodeCache* GetCodeCache() const {
     return code_cache_;
   }
@@ -441,6 +460,27 @@ class Jit {
   void MaybeEnqueueCompilation(ArtMethod* method, Thread* self)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Only for tests: stops MaybeEnqueueCompilation() from compiling hot methods, so that
+  // methods only get JIT code through the loop counters of MaybeEnqueueOsrCompilation().
+  void SetOnlyOsrCompileHotLoops(bool value) {
+    only_osr_compile_hot_loops_.store(value, std::memory_order_relaxed);
+  }
+
+  // Called when the hotness counter of `method` expires on a back edge jumping to
+  // `dex_pc`. Counts how many times this happens for the loop at `dex_pc`, and
+  // enqueues an OSR compilation of `method` once the loop alone keeps the method
+  // hot, without waiting for the method to be JIT compiled first.
+  void MaybeEnqueueOsrCompilation(ArtMethod* method, uint32_t dex_pc, Thread* self)
+      REQUIRES(!lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Called once an OSR compilation of `method` has run, whether it succeeded or not.
+  void RemovePendingOsrCompilation(ArtMethod* method, Thread* self) REQUIRES(!lock_);
+
+  // Forget the loop counters of the methods allocated by `alloc`, which is about
+  // to be freed along with its class loader.
+  void RemoveMethodsIn(Thread* self, const LinearAlloc& alloc) REQUIRES(!lock_);
+
  private:
   Jit(JitCodeCache* code_cache, JitOptions* options);
 
@@ -507,6 +547,17 @@ class Jit {
   // between the zygote and apps.
   std::map<ArtMethod*, uint16_t> shared_method_counters_;
 
+  // Number of times the hotness counter of a method expired on the back edge of
+  // a loop, keyed by method and dex pc of the loop header.
+  std::map<std::pair<ArtMethod*, uint32_t>, uint16_t> loop_hotness_counters_ GUARDED_BY(lock_);
+
+  // See SetOnlyOsrCompileHotLoops().
+  std::atomic<bool> only_osr_compile_hot_loops_;
+
+  // Methods for which MaybeEnqueueOsrCompilation enqueued an OSR compilation
+  // that has not run yet.
+  std::set<ArtMethod*> pending_osr_compilations_ GUARDED_BY(lock_);
+
   DISALLOW_COPY_AND_ASSIGN(Jit);
 };
 
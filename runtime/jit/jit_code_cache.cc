@@ -440,6 +440,10 @@ void JitCodeCache::SweepRootTables(IsMarkedVisitor* visitor) {
       InlineCache* cache = &info->cache_[i];
       for (size_t j = 0; j < InlineCache::kIndividualCacheSize; ++j) {
         Runtime::ProcessWeakClass(&cache->classes_[j], visitor, nullptr);
+        if (cache->classes_[j].IsNull()) {
+          // The entry may be reused for another class, forget its calls.
+          cache->counts_[j] = 0u;
+        }
       }
     }
   }
@@ -595,17 +599,25 @@ void JitCodeCache::DisallowInlineCacheAccess() {
 
 void JitCodeCache::CopyInlineCacheInto(
     const InlineCache& ic,
-    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes) {
+    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+    /*out*/std::array<uint32_t, InlineCache::kIndividualCacheSize>* counts) {
   static_assert(arraysize(ic.classes_) == InlineCache::kIndividualCacheSize);
   DCHECK_EQ(classes->NumberOfReferences(), InlineCache::kIndividualCacheSize);
   DCHECK_EQ(classes->RemainingSlots(), InlineCache::kIndividualCacheSize);
   WaitUntilInlineCacheAccessible(Thread::Current());
+  if (counts != nullptr) {
+    counts->fill(0u);
+  }
   // Note that we don't need to lock `lock_` here, the compiler calling
   // this method has already ensured the inline cache will not be deleted.
-  for (const GcRoot<mirror::Class>& root : ic.classes_) {
-    mirror::Class* object = root.Read();
+  for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
+    mirror::Class* object = ic.classes_[i].Read();
     if (object != nullptr) {
       DCHECK_NE(classes->RemainingSlots(), 0u);
+      if (counts != nullptr) {
+        size_t index = InlineCache::kIndividualCacheSize - classes->RemainingSlots();
+        (*counts)[index] = ic.counts_[i];
+      }
       classes->NewHandle(object);
     }
   }
@@ -1455,25 +1467,28 @@ OatQuickMethodHeader* JitCodeCache::LookupOsrMethodHeader(ArtMethod* method) {
 
 ProfilingInfo* JitCodeCache::AddProfilingInfo(Thread* self,
                                               ArtMethod* method,
-                                              const std::vector<uint32_t>& entries) {
+                                              const std::vector<uint32_t>& inline_cache_entries,
+                                              const std::vector<uint32_t>& branch_cache_entries) {
   DCHECK(CanAllocateProfilingInfo());
   ProfilingInfo* info = nullptr;
   {
     MutexLock mu(self, *Locks::jit_lock_);
-    info = AddProfilingInfoInternal(self, method, entries);
+    info = AddProfilingInfoInternal(self, method, inline_cache_entries, branch_cache_entries);
   }
 
   if (info == nullptr) {
     GarbageCollectCache(self);
     MutexLock mu(self, *Locks::jit_lock_);
-    info = AddProfilingInfoInternal(self, method, entries);
+    info = AddProfilingInfoInternal(self, method, inline_cache_entries, branch_cache_entries);
   }
   return info;
 }
 
-ProfilingInfo* JitCodeCache::AddProfilingInfoInternal(Thread* self ATTRIBUTE_UNUSED,
-                                                      ArtMethod* method,
-                                                      const std::vector<uint32_t>& entries) {
+ProfilingInfo* JitCodeCache::AddProfilingInfoInternal(
+    Thread* self ATTRIBUTE_UNUSED,
+    ArtMethod* method,
+    const std::vector<uint32_t>& inline_cache_entries,
+    const std::vector<uint32_t>& branch_cache_entries) {
   // Check whether some other thread has concurrently created it.
   auto it = profiling_infos_.find(method);
   if (it != profiling_infos_.end()) {
@@ -1481,7 +1496,7 @@ ProfilingInfo* JitCodeCache::AddProfilingInfoInternal(Thread* self ATTRIBUTE_UNU
   }
 
   size_t profile_info_size = RoundUp(
-      sizeof(ProfilingInfo) + sizeof(InlineCache) * entries.size(),
+      ProfilingInfo::ComputeSize(inline_cache_entries.size(), branch_cache_entries.size()),
       sizeof(void*));
 
   const uint8_t* data = private_region_.AllocateData(profile_info_size);
@@ -1489,7 +1504,8 @@ ProfilingInfo* JitCodeCache::AddProfilingInfoInternal(Thread* self ATTRIBUTE_UNU
     return nullptr;
   }
   uint8_t* writable_data = private_region_.GetWritableDataAddress(data);
-  ProfilingInfo* info = new (writable_data) ProfilingInfo(method, entries);
+  ProfilingInfo* info =
+      new (writable_data) ProfilingInfo(method, inline_cache_entries, branch_cache_entries);
 
   profiling_infos_.Put(method, info);
   histogram_profiling_info_memory_use_.AddValue(profile_info_size);
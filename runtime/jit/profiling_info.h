@@ -41,6 +41,12 @@ class Class;
 
 // Structure to store the classes seen at runtime for a specific instruction.
 // Once the classes_ array is full, we consider the INVOKE to be megamorphic.
+//
+// Next to the classes, the inline cache records how many times each of them
+// was seen, and how many calls were made with a receiver that did not fit in
+// the cache. The counters are updated without synchronization by baseline
+// compiled code, so they only give an approximate distribution of the receivers.
+// Only the x86-64 and arm64 baseline code and stubs update the counters.
 class InlineCache {
  public:
   // This is hard coded in the assembly stub art_quick_update_inline_cache.
@@ -50,9 +56,30 @@ class InlineCache {
     return MemberOffset(OFFSETOF_MEMBER(InlineCache, classes_));
   }
 
+  static constexpr MemberOffset CountsOffset() {
+    return MemberOffset(OFFSETOF_MEMBER(InlineCache, counts_));
+  }
+
+  static constexpr MemberOffset MegamorphicCountOffset() {
+    return MemberOffset(OFFSETOF_MEMBER(InlineCache, megamorphic_count_));
+  }
+
+  uint32_t GetCount(size_t index) const {
+    DCHECK_LT(index, kIndividualCacheSize);
+    return counts_[index];
+  }
+
+  uint32_t GetMegamorphicCount() const {
+    return megamorphic_count_;
+  }
+
  private:
   uint32_t dex_pc_;
   GcRoot<mirror::Class> classes_[kIndividualCacheSize];
+  // Number of calls seen for the receiver class in the corresponding `classes_` entry.
+  uint32_t counts_[kIndividualCacheSize];
+  // Number of calls seen with a receiver class not in `classes_`.
+  uint32_t megamorphic_count_;
 
   friend class jit::JitCodeCache;
   friend class ProfilingInfo;
@@ -60,6 +87,42 @@ class InlineCache {
   DISALLOW_COPY_AND_ASSIGN(InlineCache);
 };
 
+// Structure to store how many times each outcome of a conditional branch was seen
+// at runtime. The counters saturate rather than wrap around, and are updated
+// without synchronization by baseline compiled code, so they only give an
+// approximate distribution of the outcomes. Only the x86-64 and arm64 baseline
+// code updates the counters.
+class BranchCache {
+ public:
+  static constexpr MemberOffset FalseOffset() {
+    return MemberOffset(OFFSETOF_MEMBER(BranchCache, false_));
+  }
+
+  static constexpr MemberOffset TrueOffset() {
+    return MemberOffset(OFFSETOF_MEMBER(BranchCache, true_));
+  }
+
+  uint16_t GetFalseCount() const {
+    return false_;
+  }
+
+  uint16_t GetTrueCount() const {
+    return true_;
+  }
+
+ private:
+  uint32_t dex_pc_;
+  // Number of times the branch was not taken. Must directly precede `true_`, so
+  // that compiled code can index the counters with the 0/1 value of the condition.
+  uint16_t false_;
+  // Number of times the branch was taken.
+  uint16_t true_;
+
+  friend class ProfilingInfo;
+
+  DISALLOW_COPY_AND_ASSIGN(BranchCache);
+};
+
 /**
  * Profiling info for a method, created and filled by the interpreter once the
  * method is warm, and used by the compiler to drive optimizations.
@@ -83,6 +146,17 @@ class ProfilingInfo {
 
   InlineCache* GetInlineCache(uint32_t dex_pc);
 
+  // Returns the branch cache for the conditional branch at `dex_pc`, or null if
+  // that instruction is not profiled.
+  BranchCache* GetBranchCache(uint32_t dex_pc);
+
+  // Size of a ProfilingInfo with the given number of caches.
+  static size_t ComputeSize(size_t number_of_inline_caches, size_t number_of_branch_caches) {
+    return sizeof(ProfilingInfo) +
+        number_of_inline_caches * sizeof(InlineCache) +
+        number_of_branch_caches * sizeof(BranchCache);
+  }
+
   // Increments the number of times this method is currently being inlined.
   // Returns whether it was successful, that is it could increment without
   // overflowing.
@@ -120,7 +194,13 @@ class ProfilingInfo {
   }
 
  private:
-  ProfilingInfo(ArtMethod* method, const std::vector<uint32_t>& entries);
+  ProfilingInfo(ArtMethod* method,
+                const std::vector<uint32_t>& inline_cache_entries,
+                const std::vector<uint32_t>& branch_cache_entries);
+
+  BranchCache* GetBranchCaches() {
+    return reinterpret_cast<BranchCache*>(&cache_[number_of_inline_caches_]);
+  }
 
   static uint16_t GetOptimizeThreshold();
 
@@ -137,11 +217,15 @@ class ProfilingInfo {
   // Number of instructions we are profiling in the ArtMethod.
   const uint32_t number_of_inline_caches_;
 
+  // Number of conditional branches we are profiling in the ArtMethod.
+  const uint32_t number_of_branch_caches_;
+
   // When the compiler inlines the method associated to this ProfilingInfo,
   // it updates this counter so that the GC does not try to clear the inline caches.
   uint16_t current_inline_uses_;
 
-  // Dynamically allocated array of size `number_of_inline_caches_`.
+  // Dynamically allocated array of size `number_of_inline_caches_`, followed by
+  // an array of `number_of_branch_caches_` branch caches.
   InlineCache cache_[0];
 
   friend class jit::JitCodeCache;
@@ -106,6 +106,9 @@ constexpr std::optional<int32_t> EncodeDatumId(DatumId datum_id) {
     case DatumId::kFullGcTracingThroughputAvg:
       return std::make_optional(
           statsd::ART_DATUM_REPORTED__KIND__ART_DATUM_GC_FULL_HEAP_TRACING_THROUGHPUT_AVG_MB_PER_SEC);
+    case DatumId::kJitMethodCompileArenaPeakKb:
+      // No atom for this yet; it is only available through the other metrics backends.
+      return std::nullopt;
   }
 }
 
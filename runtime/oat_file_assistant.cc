@@ -232,6 +232,10 @@ std::unique_ptr<OatFile> OatFileAssistant::GetBestOatFile() {
   return GetBestInfo().ReleaseFileForUse();
 }
 
+const OatFile* OatFileAssistant::GetBestOatFileForAnalysis() {
+  return GetBestInfo().GetFile();
+}
+
 std::string OatFileAssistant::GetStatusDump() {
   std::ostringstream status;
   bool oat_file_exists = false;
@@ -164,6 +164,12 @@ class OatFileAssistant {
   // the OatFileAssistant object.
   std::unique_ptr<OatFile> GetBestOatFile();
 
+  // Returns the oat file that GetBestOatFile() would consider, whether or not
+  // it is up to date, or null if none could be opened. The oat file remains
+  // owned by the OatFileAssistant. This is meant for inspecting an oat file
+  // that needs to be recompiled, not for loading it.
+  const OatFile* GetBestOatFileForAnalysis();
+
   // Returns a human readable description of the status of the code for the
   // dex file. The returned description is for debugging purposes only.
   std::string GetStatusDump();
@@ -18,6 +18,8 @@
 
 #include <cstring>
 #include <sstream>
+#include <string_view>
+#include <unordered_set>
 
 #include "art_field-inl.h"
 #include "art_method-inl.h"
@@ -47,38 +49,6 @@ VerifierDeps::VerifierDeps(const std::vector<const DexFile*>& dex_files, bool ou
   }
 }
 
-// Perform logical OR on two bit vectors and assign back to LHS, i.e. `to_update |= other`.
-// Size of the two vectors must be equal.
-// Size of `other` must be equal to size of `to_update`.
-static inline void BitVectorOr(std::vector<bool>& to_update, const std::vector<bool>& other) {
-  DCHECK_EQ(to_update.size(), other.size());
-  std::transform(other.begin(),
-                 other.end(),
-                 to_update.begin(),
-                 to_update.begin(),
-                 std::logical_or<bool>());
-}
-
-void VerifierDeps::MergeWith(std::unique_ptr<VerifierDeps> other,
-                             const std::vector<const DexFile*>& dex_files) {
-  DCHECK(other != nullptr);
-  DCHECK_EQ(dex_deps_.size(), other->dex_deps_.size());
-  for (const DexFile* dex_file : dex_files) {
-    DexFileDeps* my_deps = GetDexFileDeps(*dex_file);
-    DexFileDeps& other_deps = *other->GetDexFileDeps(*dex_file);
-    // We currently collect extra strings only on the main `VerifierDeps`,
-    // which should be the one passed as `this` in this method.
-    DCHECK(other_deps.strings_.empty());
-    // Size is the number of class definitions in the dex file, and must be the
-    // same between the two `VerifierDeps`.
-    DCHECK_EQ(my_deps->assignable_types_.size(), other_deps.assignable_types_.size());
-    for (uint32_t i = 0; i < my_deps->assignable_types_.size(); ++i) {
-      my_deps->assignable_types_[i].merge(other_deps.assignable_types_[i]);
-    }
-    BitVectorOr(my_deps->verified_classes_, other_deps.verified_classes_);
-  }
-}
-
 VerifierDeps::DexFileDeps* VerifierDeps::GetDexFileDeps(const DexFile& dex_file) {
   auto it = dex_deps_.find(&dex_file);
   return (it == dex_deps_.end()) ? nullptr : it->second.get();
@@ -242,6 +212,7 @@ void VerifierDeps::AddAssignability(const DexFile& dex_file,
   dex::StringIndex destination_id = GetClassDescriptorStringId(dex_file, destination);
   dex::StringIndex source_id = GetClassDescriptorStringId(dex_file, source);
 
+  // No lock needed, see `DexFileDeps::assignable_types_`.
   uint16_t index = dex_file.GetIndexForClassDef(class_def);
   dex_deps->assignable_types_[index].emplace(TypeAssignability(destination_id, source_id));
 }
@@ -305,6 +276,8 @@ void VerifierDeps::MaybeRecordVerificationStatus(VerifierDeps* verifier_deps,
 void VerifierDeps::RecordClassVerified(const DexFile& dex_file, const dex::ClassDef& class_def) {
   DexFileDeps* dex_deps = GetDexFileDeps(dex_file);
   DCHECK_EQ(dex_deps->verified_classes_.size(), dex_file.NumClassDefs());
+  // The bits of `verified_classes_` share words, so concurrent updates need the lock.
+  WriterMutexLock mu(Thread::Current(), *Locks::verifier_deps_lock_);
   dex_deps->verified_classes_[dex_file.GetIndexForClassDef(class_def)] = true;
 }
 
@@ -312,6 +285,7 @@ bool VerifierDeps::HasRecordedVerifiedStatus(const DexFile& dex_file,
                                              const dex::ClassDef& class_def) {
   DexFileDeps* dex_deps = GetDexFileDeps(dex_file);
   DCHECK_EQ(dex_deps->verified_classes_.size(), dex_file.NumClassDefs());
+  ReaderMutexLock mu(Thread::Current(), *Locks::verifier_deps_lock_);
   return dex_deps->verified_classes_[dex_file.GetIndexForClassDef(class_def)];
 }
 
@@ -709,6 +683,85 @@ bool VerifierDeps::ValidateDependencies(Thread* self,
   return true;
 }
 
+size_t VerifierDeps::InvalidateStaleClasses(
+    Thread* self,
+    Handle<mirror::ClassLoader> class_loader,
+    const std::vector<const DexFile*>& dex_files,
+    /* out */ std::vector<std::vector<bool>>* invalidated_classes,
+    /* out */ std::string* error_msg) {
+  invalidated_classes->clear();
+  invalidated_classes->reserve(dex_files.size());
+  std::unordered_set<std::string_view> invalidated_descriptors;
+  size_t num_invalidated = 0u;
+  auto invalidate = [&](size_t dex_file_index, uint32_t class_def_index) {
+    const DexFile& dex_file = *dex_files[dex_file_index];
+    DexFileDeps* deps = GetDexFileDeps(dex_file);
+    deps->assignable_types_[class_def_index].clear();
+    deps->verified_classes_[class_def_index] = false;
+    (*invalidated_classes)[dex_file_index][class_def_index] = true;
+    invalidated_descriptors.insert(
+        dex_file.GetClassDescriptor(dex_file.GetClassDef(class_def_index)));
+    ++num_invalidated;
+  };
+
+  std::string class_error_msg;
+  for (size_t i = 0; i != dex_files.size(); ++i) {
+    const DexFile& dex_file = *dex_files[i];
+    const DexFileDeps* deps = GetDexFileDeps(dex_file);
+    DCHECK(deps != nullptr);
+    invalidated_classes->emplace_back(dex_file.NumClassDefs(), false);
+    for (uint32_t class_def_index = 0; class_def_index != dex_file.NumClassDefs();
+         ++class_def_index) {
+      if (!VerifyClassAssignability(class_loader,
+                                    dex_file,
+                                    deps->assignable_types_[class_def_index],
+                                    self,
+                                    &class_error_msg)) {
+        if (num_invalidated == 0u) {
+          *error_msg = class_error_msg;
+        }
+        invalidate(i, class_def_index);
+      }
+    }
+  }
+
+  // Propagate to the subclasses and implementers of invalidated classes. Supertypes may be
+  // defined in any of the dex files, so iterate until no more classes get invalidated.
+  bool changed = num_invalidated != 0u;
+  while (changed) {
+    changed = false;
+    for (size_t i = 0; i != dex_files.size(); ++i) {
+      const DexFile& dex_file = *dex_files[i];
+      for (uint32_t class_def_index = 0; class_def_index != dex_file.NumClassDefs();
+           ++class_def_index) {
+        if ((*invalidated_classes)[i][class_def_index]) {
+          continue;
+        }
+        const dex::ClassDef& class_def = dex_file.GetClassDef(class_def_index);
+        dex::TypeIndex superclass_idx = class_def.superclass_idx_;
+        bool depends_on_invalidated =
+            superclass_idx.IsValid() &&
+            invalidated_descriptors.count(dex_file.StringByTypeIdx(superclass_idx)) != 0u;
+        const dex::TypeList* interfaces = dex_file.GetInterfacesList(class_def);
+        if (!depends_on_invalidated && interfaces != nullptr) {
+          for (uint32_t j = 0; j != interfaces->Size(); ++j) {
+            dex::TypeIndex interface_idx = interfaces->GetTypeItem(j).type_idx_;
+            if (invalidated_descriptors.count(dex_file.StringByTypeIdx(interface_idx)) != 0u) {
+              depends_on_invalidated = true;
+              break;
+            }
+          }
+        }
+        if (depends_on_invalidated) {
+          invalidate(i, class_def_index);
+          changed = true;
+        }
+      }
+    }
+  }
+  return num_invalidated;
+}
+
 // TODO: share that helper with other parts of the compiler that have
 // the same lookup pattern.
 static ObjPtr<mirror::Class> FindClassAndClearException(ClassLinker* class_linker,
@@ -729,32 +782,43 @@ bool VerifierDeps::VerifyAssignability(Handle<mirror::ClassLoader> class_loader,
                                        const std::vector<std::set<TypeAssignability>>& assignables,
                                        Thread* self,
                                        /* out */ std::string* error_msg) const {
+  for (const auto& vec : assignables) {
+    if (!VerifyClassAssignability(class_loader, dex_file, vec, self, error_msg)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool VerifierDeps::VerifyClassAssignability(Handle<mirror::ClassLoader> class_loader,
+                                            const DexFile& dex_file,
+                                            const std::set<TypeAssignability>& assignables,
+                                            Thread* self,
+                                            /* out */ std::string* error_msg) const {
   StackHandleScope<2> hs(self);
   ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
   MutableHandle<mirror::Class> source(hs.NewHandle<mirror::Class>(nullptr));
   MutableHandle<mirror::Class> destination(hs.NewHandle<mirror::Class>(nullptr));
 
-  for (const auto& vec : assignables) {
-    for (const auto& entry : vec) {
-      const std::string& destination_desc = GetStringFromId(dex_file, entry.GetDestination());
-      destination.Assign(
-          FindClassAndClearException(class_linker, self, destination_desc.c_str(), class_loader));
-      const std::string& source_desc = GetStringFromId(dex_file, entry.GetSource());
-      source.Assign(
-          FindClassAndClearException(class_linker, self, source_desc.c_str(), class_loader));
-
-      if (destination == nullptr || source == nullptr) {
-        // We currently don't use assignability information for unresolved
-        // types, as the status of the class using unresolved types will be soft
-        // fail in the vdex.
-        continue;
-      }
+  for (const auto& entry : assignables) {
+    const std::string& destination_desc = GetStringFromId(dex_file, entry.GetDestination());
+    destination.Assign(
+        FindClassAndClearException(class_linker, self, destination_desc.c_str(), class_loader));
+    const std::string& source_desc = GetStringFromId(dex_file, entry.GetSource());
+    source.Assign(
+        FindClassAndClearException(class_linker, self, source_desc.c_str(), class_loader));
+
+    if (destination == nullptr || source == nullptr) {
+      // We currently don't use assignability information for unresolved
+      // types, as the status of the class using unresolved types will be soft
+      // fail in the vdex.
+      continue;
+    }
 
-      DCHECK(destination->IsResolved() && source->IsResolved());
-      if (!destination->IsAssignableFrom(source.Get())) {
-        *error_msg = "Class " + destination_desc + " not assignable from " + source_desc;
-        return false;
-      }
+    DCHECK(destination->IsResolved() && source->IsResolved());
+    if (!destination->IsAssignableFrom(source.Get())) {
+      *error_msg = "Class " + destination_desc + " not assignable from " + source_desc;
+      return false;
     }
   }
   return true;
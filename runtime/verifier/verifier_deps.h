@@ -69,10 +69,6 @@ class VerifierDeps {
   // Fill dependencies from stored data. Returns true on success, false on failure.
   bool ParseStoredData(const std::vector<const DexFile*>& dex_files, ArrayRef<const uint8_t> data);
 
-  // Merge `other` into this `VerifierDeps`'. `other` and `this` must be for the
-  // same set of dex files.
-  void MergeWith(std::unique_ptr<VerifierDeps> other, const std::vector<const DexFile*>& dex_files);
-
   // Record information that a class was verified.
   // Note that this function is different from MaybeRecordVerificationStatus() which
   // looks up thread-local VerifierDeps first.
@@ -121,6 +117,19 @@ class VerifierDeps {
                             /* out */ std::string* error_msg) const
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Verify the encoded dependencies of this `VerifierDeps` class by class, and drop the
+  // recorded dependencies and verified status of the classes for which they no longer hold,
+  // so that only these classes need to be verified again. Classes of `dex_files` that extend
+  // or implement a dropped class are dropped too, as they are verified after their supertypes.
+  // Returns the number of dropped classes and marks them in `invalidated_classes`, indexed
+  // like `dex_files` and then by class def index. `error_msg` describes the first failure.
+  size_t InvalidateStaleClasses(Thread* self,
+                                Handle<mirror::ClassLoader> class_loader,
+                                const std::vector<const DexFile*>& dex_files,
+                                /* out */ std::vector<std::vector<bool>>* invalidated_classes,
+                                /* out */ std::string* error_msg)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   const std::vector<bool>& GetVerifiedClasses(const DexFile& dex_file) const {
     return GetDexFileDeps(dex_file)->verified_classes_;
   }
@@ -170,10 +179,14 @@ class VerifierDeps {
 
     // Vector that contains for each class def defined in a dex file, a set of class pairs recording
     // the outcome of assignability test from one of the two types to the other.
+    // Parallel verification records into the same `VerifierDeps` from all threads without
+    // locking. This is safe because the set of a class is only modified by the one thread
+    // that verifies the class, and the class status transitions order that with later readers.
     std::vector<std::set<TypeAssignability>> assignable_types_;
 
     // Bit vector indexed by class def indices indicating whether the corresponding
-    // class was successfully verified.
+    // class was successfully verified. Guarded by `Locks::verifier_deps_lock_` while
+    // verification runs.
     std::vector<bool> verified_classes_;
 
     bool Equals(const DexFileDeps& rhs) const;
@@ -247,6 +260,13 @@ class VerifierDeps {
                            /* out */ std::string* error_msg) const
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  bool VerifyClassAssignability(Handle<mirror::ClassLoader> class_loader,
+                                const DexFile& dex_file,
+                                const std::set<TypeAssignability>& assignables,
+                                Thread* self,
+                                /* out */ std::string* error_msg) const
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Map from DexFiles into dependencies collected from verification of their methods.
   std::map<const DexFile*, std::unique_ptr<DexFileDeps>> dex_deps_;
 
@@ -258,6 +278,7 @@ class VerifierDeps {
   ART_FRIEND_TEST(VerifierDepsTest, EncodeDecode);
   ART_FRIEND_TEST(VerifierDepsTest, EncodeDecodeMulti);
   ART_FRIEND_TEST(VerifierDepsTest, VerifyDeps);
+  ART_FRIEND_TEST(VerifierDepsTest, InvalidateStaleClasses);
   ART_FRIEND_TEST(VerifierDepsTest, CompilerDriver);
 };
 
@@ -62,6 +62,42 @@ public class Main {
     }
   }
 
+  /// CHECK-START-ARM64: void Main.$noinline$testConstantDistance(int[]) loop_optimization (after)
+  /// CHECK-DAG: VecLoad
+  /// CHECK-DAG: VecStore
+  public static void $noinline$testConstantDistance(int[] a) {
+    for (int i = 0; i < a.length - 16; ++i) {
+      a[i] = a[i + 16] + 1;  // distance is at least the vector length
+    }
+  }
+
+  /// CHECK-START-{ARM64,X86_64}: void Main.$noinline$testRuntimeDistance(int[], int) loop_optimization (before)
+  /// CHECK-NOT: VecLoad
+
+  // The distance k is only known at runtime: the vector loop is guarded by a
+  // distance test that zeroes the vector trip count when |k| < VL.
+  /// CHECK-START-{ARM64,X86_64}: void Main.$noinline$testRuntimeDistance(int[], int) loop_optimization (after)
+  /// CHECK-DAG: <<Diff:i\d+>>  Sub                                      loop:none
+  /// CHECK-DAG: <<Bias:i\d+>>  Add [<<Diff>>,{{i\d+}}]                  loop:none
+  /// CHECK-DAG: <<Test:z\d+>>  Above [<<Bias>>,{{i\d+}}]                loop:none
+  /// CHECK-DAG:                Select [{{i\d+}},{{i\d+}},<<Test>>]      loop:none
+  /// CHECK-DAG: <<Load:d\d+>>  VecLoad                                  loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG: <<VAdd:d\d+>>  VecAdd [<<Load>>,{{[dj]\d+}}{{(,j\d+)?}}] loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:                VecStore [{{l\d+}},{{i\d+}},<<VAdd>>{{(,j\d+)?}}] loop:<<Loop>> outer_loop:none
+  public static void $noinline$testRuntimeDistance(int[] a, int k) {
+    for (int i = 0; i < a.length - k; ++i) {
+      a[i + k] = a[i] + 1;  // dependence within a vector unless k is large enough
+    }
+  }
+
+  private static int $noinline$sum(int[] a) {
+    int sum = 0;
+    for (int i = 0; i < a.length; ++i) {
+      sum += a[i];
+    }
+    return sum;
+  }
+
   public static void main(String[] args) {
     // We must not optimize any of the exceptions away.
     try {
@@ -79,5 +115,16 @@ public class Main {
     } catch (java.lang.ArrayIndexOutOfBoundsException e) {
       System.out.println("BoundsCheck");
     }
+    // Same-array references at a (possibly unknown) distance must respect the
+    // loop-carried data dependence, whether vectorized or not.
+    int[] a = new int[100];
+    $noinline$testConstantDistance(a);
+    System.out.println($noinline$sum(a));
+    a = new int[100];
+    $noinline$testRuntimeDistance(a, 1);
+    System.out.println($noinline$sum(a));
+    a = new int[100];
+    $noinline$testRuntimeDistance(a, 20);
+    System.out.println($noinline$sum(a));
   }
 }
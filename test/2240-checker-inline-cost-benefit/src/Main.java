@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  static int sCold;
+
+  // Larger than the default --inline-max-code-units threshold.
+  static int hotCallee(int x) {
+    x = x * 31 + 7;
+    x = x * 31 + 7;
+    x = x * 31 + 7;
+    x = x * 31 + 7;
+    x = x * 31 + 7;
+    x = x * 31 + 7;
+    x = x * 31 + 7;
+    x = x * 31 + 7;
+    x = x * 31 + 7;
+    x = x * 31 + 7;
+    x = x * 31 + 7;
+    x = x * 31 + 7;
+    return x;
+  }
+
+  // Smaller than the default --inline-max-code-units threshold, but not tiny.
+  static int coldCallee(int x) {
+    return (x * 31 + x * 17 + 5) ^ 0x1234;
+  }
+
+  // The call in the loop is hot enough to inline a callee above the threshold.
+
+  /// CHECK-START: int Main.$noinline$hotLoop(int) inliner (before)
+  /// CHECK:       InvokeStaticOrDirect method_name:Main.hotCallee
+
+  /// CHECK-START: int Main.$noinline$hotLoop(int) inliner (after)
+  /// CHECK-NOT:   InvokeStaticOrDirect method_name:Main.hotCallee
+  public static int $noinline$hotLoop(int n) {
+    int sum = 0;
+    for (int i = 0; i < n; i++) {
+      sum += hotCallee(i);
+    }
+    return sum;
+  }
+
+  // The same call outside of a loop is not.
+
+  /// CHECK-START: int Main.$noinline$straightLine(int) inliner (after)
+  /// CHECK:       InvokeStaticOrDirect method_name:Main.hotCallee
+  public static int $noinline$straightLine(int x) {
+    return hotCallee(x);
+  }
+
+  // Calls on a path that always throws are cold, and only get tiny callees inlined.
+
+  /// CHECK-START: int Main.$noinline$coldCall(int) inliner (after)
+  /// CHECK:       InvokeStaticOrDirect method_name:Main.coldCallee
+  public static int $noinline$coldCall(int x) {
+    if (x < 0) {
+      sCold = coldCallee(x);
+      throw new Error("Negative: " + x);
+    }
+    return x;
+  }
+
+  public static void main(String[] args) {
+    assertIntEquals(-333729962, $noinline$hotLoop(100));
+    assertIntEquals(39345605, $noinline$straightLine(5));
+    assertIntEquals(7, $noinline$coldCall(7));
+    boolean caught = false;
+    try {
+      $noinline$coldCall(-3);
+    } catch (Error expected) {
+      caught = true;
+    }
+    if (!caught) {
+      throw new Error("Expected Error");
+    }
+    assertIntEquals(-4799, sCold);
+  }
+
+  public static void assertIntEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+
+#include "arch/instruction_set.h"
+#include "art_method-inl.h"
+#include "base/enums.h"
+#include "dex/code_item_accessors-inl.h"
+#include "dex/dex_instruction-inl.h"
+#include "jit/jit.h"
+#include "jit/profiling_info.h"
+#include "mirror/class-inl.h"
+#include "nativehelper/ScopedUtfChars.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art {
+
+extern "C" JNIEXPORT jintArray JNICALL Java_Main_getInlineCacheCounts(JNIEnv* env,
+                                                                      jclass,
+                                                                      jclass cls,
+                                                                      jstring method_name) {
+  // Only the x86-64 and arm64 baseline code and stubs update the counters.
+  if ((kRuntimeISA != InstructionSet::kX86_64 && kRuntimeISA != InstructionSet::kArm64) ||
+      !Runtime::Current()->UseJitCompilation()) {
+    return nullptr;
+  }
+  std::array<jint, InlineCache::kIndividualCacheSize + 1> counts;
+  {
+    ScopedObjectAccess soa(env);
+    ScopedUtfChars chars(env, method_name);
+    ArtMethod* method = soa.Decode<mirror::Class>(cls)->FindDeclaredDirectMethodByName(
+        chars.c_str(), kRuntimePointerSize);
+    CHECK(method != nullptr) << chars.c_str();
+    // Returns the existing profiling info, which baseline compiled code updates.
+    ProfilingInfo* info = ProfilingInfo::Create(soa.Self(), method);
+    if (info == nullptr) {
+      return nullptr;
+    }
+    const InlineCache* cache = nullptr;
+    for (const DexInstructionPcPair& inst : method->DexInstructions()) {
+      if (inst->Opcode() == Instruction::INVOKE_VIRTUAL) {
+        cache = info->GetInlineCache(inst.DexPc());
+        break;
+      }
+    }
+    CHECK(cache != nullptr) << method->PrettyMethod();
+    for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
+      counts[i] = static_cast<jint>(cache->GetCount(i));
+    }
+    counts[InlineCache::kIndividualCacheSize] = static_cast<jint>(cache->GetMegamorphicCount());
+  }
+  jintArray result = env->NewIntArray(counts.size());
+  if (result != nullptr) {
+    env->SetIntArrayRegion(result, 0, counts.size(), counts.data());
+  }
+  return result;
+}
+
+}  // namespace art
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+class Base {
+  int getValue() { return 0; }
+}
+
+class SubA extends Base {
+  int getValue() { return 42; }
+}
+
+class SubB extends Base {
+  int getValue() { return 1; }
+}
+
+class SubC extends Base {
+  int getValue() { return 2; }
+}
+
+class SubD extends Base {
+  int getValue() { return 3; }
+}
+
+class SubE extends Base {
+  int getValue() { return 4; }
+}
+
+class SubF extends Base {
+  int getValue() { return 5; }
+}
+
+class SubG extends Base {
+  int getValue() { return 6; }
+}
+
+public class Main {
+  // Receivers in the order they first reach the call sites: SubA to SubE fill
+  // the inline cache, SubF and SubG overflow it.
+  static Base[] receivers = {
+    new SubA(), new SubB(), new SubC(), new SubD(), new SubE(), new SubF(), new SubG()
+  };
+
+  /// CHECK-START: int Main.$noinline$dominantReceiver(Base) inliner (before)
+  /// CHECK:       InvokeVirtual method_name:Base.getValue
+
+  /// CHECK-START: int Main.$noinline$dominantReceiver(Base) inliner (after)
+  /// CHECK:  <<SubARet:i\d+>>      IntConstant 42
+  /// CHECK:  <<Obj:l\d+>>          NullCheck
+  /// CHECK:  <<ObjClass:l\d+>>     InstanceFieldGet [<<Obj>>] field_name:java.lang.Object.shadow$_klass_
+  /// CHECK:  <<InlineClass:l\d+>>  LoadClass class_name:SubA
+  /// CHECK:  <<Test:z\d+>>         NotEqual [<<InlineClass>>,<<ObjClass>>]
+  /// CHECK:                        If [<<Test>>]
+  /// CHECK:  <<DefaultRet:i\d+>>   InvokeVirtual [<<Obj>>] method_name:Base.getValue
+
+  /// CHECK:  <<Ret:i\d+>>          Phi [<<SubARet>>,<<DefaultRet>>]
+  /// CHECK:                        Return [<<Ret>>]
+
+  /// CHECK-START: int Main.$noinline$dominantReceiver(Base) inliner (after)
+  /// CHECK-NOT:                    LoadClass class_name:SubB
+
+  /// CHECK-START: int Main.$noinline$dominantReceiver(Base) inliner (after)
+  /// CHECK-NOT:                    Deoptimize
+  public static int $noinline$dominantReceiver(Base b) {
+    return b.getValue();
+  }
+
+  public static int $noinline$countedCall(Base b) {
+    return b.getValue();
+  }
+
+  public static void testDominantReceiver() {
+    ensureJitBaselineCompiled(Main.class, "$noinline$dominantReceiver");
+    // SubA gets 70% of the calls, every other receiver 5%.
+    for (int i = 0; i < 1000; i++) {
+      int index = i % 20;
+      $noinline$dominantReceiver(receivers[index < 14 ? 0 : index - 13]);
+    }
+    ensureJitCompiled(Main.class, "$noinline$dominantReceiver");
+
+    // Both the inlined target and the fallback call must return the right value.
+    if ($noinline$dominantReceiver(receivers[0]) != 42) {
+      throw new Error("Expected 42");
+    }
+    for (int i = 1; i < receivers.length; i++) {
+      if ($noinline$dominantReceiver(receivers[i]) != i) {
+        throw new Error("Expected " + i);
+      }
+    }
+  }
+
+  public static void testCountsOnOverflow() {
+    ensureJitBaselineCompiled(Main.class, "$noinline$countedCall");
+    int[] before = getInlineCacheCounts(Main.class, "$noinline$countedCall");
+    if (before == null) {
+      // The counters are not maintained in this configuration.
+      return;
+    }
+    int[] calls = { 10, 3, 4, 5, 6, 7, 8 };
+    for (int i = 0; i < receivers.length; i++) {
+      for (int j = 0; j < calls[i]; j++) {
+        $noinline$countedCall(receivers[i]);
+      }
+    }
+    int[] after = getInlineCacheCounts(Main.class, "$noinline$countedCall");
+
+    // The first five receivers have their own entry, the others are only
+    // accounted for in the megamorphic count.
+    for (int i = 0; i < 5; i++) {
+      assertEquals(calls[i], after[i] - before[i]);
+    }
+    assertEquals(calls[5] + calls[6], after[5] - before[5]);
+  }
+
+  public static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    testDominantReceiver();
+    testCountsOnOverflow();
+  }
+
+  private static native void ensureJitBaselineCompiled(Class<?> cls, String methodName);
+  private static native void ensureJitCompiled(Class<?> cls, String methodName);
+  // Returns the counts of the inline cache entries of the only virtual call in
+  // `methodName`, followed by its megamorphic count, or null if they are not recorded.
+  private static native int[] getInlineCacheCounts(Class<?> cls, String methodName);
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+interface Shape {
+  int sides();
+}
+
+// Shape.sides() has several implementations, but only Triangle.sides() is
+// reachable from a receiver whose static type is Triangle.
+class Triangle implements Shape {
+  public int sides() { return 3; }
+}
+
+class Square implements Shape {
+  public int sides() { return 4; }
+}
+
+// Only loaded once the callers have been compiled, see Helper.
+class Star extends Triangle {
+  public int sides() { return 6; }
+}
+
+public class Main {
+  static Triangle sTriangle = new Triangle();
+  static Shape sSquare = new Square();
+  static boolean sLoadSubclass;
+
+  /// CHECK-START: int Main.$noinline$staticTypeCall() inliner (before)
+  /// CHECK:       InvokeInterface method_name:Shape.sides
+
+  /// CHECK-START: int Main.$noinline$staticTypeCall() inliner (after)
+  /// CHECK-DAG:   <<Three:i\d+>>  IntConstant 3
+  /// CHECK-DAG:   <<Flag:i\d+>>   ShouldDeoptimizeFlag
+  /// CHECK-DAG:   <<Cond:z\d+>>   NotEqual [<<Flag>>,{{i\d+}}]
+  /// CHECK-DAG:                   Deoptimize [<<Cond>>]
+  /// CHECK-DAG:                   Return [<<Three>>]
+
+  /// CHECK-START: int Main.$noinline$staticTypeCall() inliner (after)
+  /// CHECK-NOT:                   InvokeInterface
+  public static int $noinline$staticTypeCall() {
+    Shape shape = sTriangle;
+    return shape.sides();
+  }
+
+  /// CHECK-START: int Main.$noinline$sidesAroundLoad() inliner (after)
+  /// CHECK:                       ShouldDeoptimizeFlag
+  /// CHECK:                       ShouldDeoptimizeFlag
+
+  /// CHECK-START: int Main.$noinline$sidesAroundLoad() inliner (after)
+  /// CHECK-NOT:                   InvokeInterface method_name:Shape.sides
+  public static int $noinline$sidesAroundLoad() {
+    Shape first = sTriangle;
+    int result = first.sides() * 10;
+    if (sLoadSubclass) {
+      // Links Star, which overrides Triangle.sides(). The frame of this method
+      // must deoptimize before the next call.
+      sTriangle = Helper.createStar();
+    }
+    Shape second = sTriangle;
+    return result + second.sides();
+  }
+
+  public static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+
+    // Make sure Shape.sides() has several implementations before compiling.
+    assertEquals(4, sSquare.sides());
+    assertEquals(3, $noinline$staticTypeCall());
+    assertEquals(33, $noinline$sidesAroundLoad());
+
+    ensureJitCompiled(Main.class, "$noinline$staticTypeCall");
+    ensureJitCompiled(Main.class, "$noinline$sidesAroundLoad");
+    assertEquals(3, $noinline$staticTypeCall());
+    assertEquals(33, $noinline$sidesAroundLoad());
+
+    sLoadSubclass = true;
+    assertEquals(36, $noinline$sidesAroundLoad());
+    assertEquals(6, $noinline$staticTypeCall());
+    assertEquals(4, sSquare.sides());
+  }
+
+  private static native void ensureJitCompiled(Class<?> cls, String methodName);
+}
+
+// Put createStar() in another class to avoid class loading due to verifier.
+class Helper {
+  static Triangle createStar() {
+    return new Star();
+  }
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    // Hot methods no longer get JIT compiled, and without JIT code for the method
+    // the loop can only get OSR code from the loop counters.
+    onlyOsrCompileHotLoops();
+    // The method is called only once, so only its loop can make it hot.
+    System.out.println($noinline$hotLoop());
+  }
+
+  public static long $noinline$hotLoop() {
+    // If we are running in non-JIT mode, or were unlucky enough to get this method
+    // already JITted, skip the wait for OSR code.
+    boolean interpreting = isInInterpreter("$noinline$hotLoop");
+    long sum = 0;
+    int i = 0;
+    for (; i < 1000000; ++i) {
+      sum += i & 1;
+    }
+    if (interpreting) {
+      // Keep looping until the OSR compilation enqueued from the back edge is
+      // installed and entered. The test harness times out otherwise.
+      while (!isInOsrCode("$noinline$hotLoop")) {
+        sum += i & 1;
+        sum -= i & 1;
+      }
+      if (hasJitCompiledEntrypoint(Main.class, "$noinline$hotLoop")) {
+        throw new Error("Expected OSR code without regular JIT code");
+      }
+    }
+    return sum * 2;
+  }
+
+  public static native boolean isInInterpreter(String methodName);
+  public static native boolean isInOsrCode(String methodName);
+  public static native boolean hasJitCompiledEntrypoint(Class<?> cls, String methodName);
+  public static native void onlyOsrCompileHotLoops();
+}
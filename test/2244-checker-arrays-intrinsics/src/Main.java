@@ -0,0 +1,329 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.util.Arrays;
+import java.util.Random;
+
+public class Main {
+  // Lengths 0 to 40, and lengths around multiples of the vector widths used by
+  // the intrinsics (16 bytes, 4 ints, and 8 ints per hashCode iteration).
+  static int[] sLengths;
+
+  static {
+    int[] extra = { 47, 48, 49, 63, 64, 65, 127, 128, 129, 255, 256, 257 };
+    sLengths = new int[41 + extra.length];
+    for (int i = 0; i <= 40; ++i) {
+      sLengths[i] = i;
+    }
+    System.arraycopy(extra, 0, sLengths, 41, extra.length);
+  }
+
+  static Random sRandom = new Random(42);
+
+  /// CHECK-START: boolean Main.$noinline$equals(byte[], byte[]) builder (after)
+  /// CHECK-DAG: <<Result:z\d+>> InvokeStaticOrDirect intrinsic:ArraysEqualsByte
+  /// CHECK-DAG:                 Return [<<Result>>]
+
+  /// CHECK-START-X86_64: boolean Main.$noinline$equals(byte[], byte[]) disassembly (after)
+  /// CHECK:                     InvokeStaticOrDirect intrinsic:ArraysEqualsByte
+  /// CHECK:                     pcmpeqb
+  /// CHECK:                     pmovmskb
+  /// CHECK:                     bsf
+  private static boolean $noinline$equals(byte[] a, byte[] b) {
+    return Arrays.equals(a, b);
+  }
+
+  /// CHECK-START: boolean Main.$noinline$equals(int[], int[]) builder (after)
+  /// CHECK-DAG: <<Result:z\d+>> InvokeStaticOrDirect intrinsic:ArraysEqualsInt
+  /// CHECK-DAG:                 Return [<<Result>>]
+
+  /// CHECK-START-X86_64: boolean Main.$noinline$equals(int[], int[]) disassembly (after)
+  /// CHECK:                     InvokeStaticOrDirect intrinsic:ArraysEqualsInt
+  /// CHECK:                     pcmpeqb
+  /// CHECK:                     pmovmskb
+  /// CHECK:                     bsf
+  private static boolean $noinline$equals(int[] a, int[] b) {
+    return Arrays.equals(a, b);
+  }
+
+  /// CHECK-START: void Main.$noinline$fill(byte[], byte) builder (after)
+  /// CHECK-DAG:                 InvokeStaticOrDirect intrinsic:ArraysFillByte
+  private static void $noinline$fill(byte[] a, byte value) {
+    Arrays.fill(a, value);
+  }
+
+  /// CHECK-START: void Main.$noinline$fill(int[], int) builder (after)
+  /// CHECK-DAG:                 InvokeStaticOrDirect intrinsic:ArraysFillInt
+  private static void $noinline$fill(int[] a, int value) {
+    Arrays.fill(a, value);
+  }
+
+  /// CHECK-START: int Main.$noinline$hashCode(byte[]) builder (after)
+  /// CHECK-DAG: <<Result:i\d+>> InvokeStaticOrDirect intrinsic:ArraysHashCodeByte
+  /// CHECK-DAG:                 Return [<<Result>>]
+
+  /// CHECK-START-X86_64: int Main.$noinline$hashCode(byte[]) disassembly (after)
+  /// CHECK-IF: hasIsaFeature("sse4.1")
+  ///   CHECK:                   InvokeStaticOrDirect intrinsic:ArraysHashCodeByte
+  ///   CHECK:                   pmulld
+  /// CHECK-FI:
+  private static int $noinline$hashCode(byte[] a) {
+    return Arrays.hashCode(a);
+  }
+
+  /// CHECK-START: int Main.$noinline$hashCode(int[]) builder (after)
+  /// CHECK-DAG: <<Result:i\d+>> InvokeStaticOrDirect intrinsic:ArraysHashCodeInt
+  /// CHECK-DAG:                 Return [<<Result>>]
+
+  /// CHECK-START-X86_64: int Main.$noinline$hashCode(int[]) disassembly (after)
+  /// CHECK-IF: hasIsaFeature("sse4.1")
+  ///   CHECK:                   InvokeStaticOrDirect intrinsic:ArraysHashCodeInt
+  ///   CHECK:                   pmulld
+  /// CHECK-FI:
+  private static int $noinline$hashCode(int[] a) {
+    return Arrays.hashCode(a);
+  }
+
+  // ArraysSupport.mismatch is not accessible from here: it is reached through
+  // Arrays.mismatch, whose boot image code calls it with the shorter length.
+  private static int $noinline$mismatch(byte[] a, byte[] b) {
+    return Arrays.mismatch(a, b);
+  }
+
+  private static int $noinline$mismatch(int[] a, int[] b) {
+    return Arrays.mismatch(a, b);
+  }
+
+  private static boolean referenceEquals(byte[] a, byte[] b) {
+    if (a == null || b == null) {
+      return a == b;
+    }
+    if (a.length != b.length) {
+      return false;
+    }
+    for (int i = 0; i < a.length; ++i) {
+      if (a[i] != b[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  private static boolean referenceEquals(int[] a, int[] b) {
+    if (a == null || b == null) {
+      return a == b;
+    }
+    if (a.length != b.length) {
+      return false;
+    }
+    for (int i = 0; i < a.length; ++i) {
+      if (a[i] != b[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  private static int referenceHashCode(byte[] a) {
+    if (a == null) {
+      return 0;
+    }
+    int result = 1;
+    for (int i = 0; i < a.length; ++i) {
+      result = 31 * result + a[i];
+    }
+    return result;
+  }
+
+  private static int referenceHashCode(int[] a) {
+    if (a == null) {
+      return 0;
+    }
+    int result = 1;
+    for (int i = 0; i < a.length; ++i) {
+      result = 31 * result + a[i];
+    }
+    return result;
+  }
+
+  private static int referenceMismatch(byte[] a, byte[] b) {
+    int length = Math.min(a.length, b.length);
+    for (int i = 0; i < length; ++i) {
+      if (a[i] != b[i]) {
+        return i;
+      }
+    }
+    return (a.length == b.length) ? -1 : length;
+  }
+
+  private static int referenceMismatch(int[] a, int[] b) {
+    int length = Math.min(a.length, b.length);
+    for (int i = 0; i < length; ++i) {
+      if (a[i] != b[i]) {
+        return i;
+      }
+    }
+    return (a.length == b.length) ? -1 : length;
+  }
+
+  private static byte[] randomBytes(int length) {
+    byte[] result = new byte[length];
+    sRandom.nextBytes(result);
+    return result;
+  }
+
+  private static int[] randomInts(int length) {
+    int[] result = new int[length];
+    for (int i = 0; i < length; ++i) {
+      result[i] = sRandom.nextInt();
+    }
+    return result;
+  }
+
+  public static void testByteArrays() {
+    for (int length : sLengths) {
+      byte[] a = randomBytes(length);
+      byte[] b = a.clone();
+      assertEquals(true, $noinline$equals(a, b));
+      assertEquals(true, $noinline$equals(a, a));
+      assertEquals(-1, $noinline$mismatch(a, b));
+      assertEquals(referenceHashCode(a), $noinline$hashCode(a));
+
+      // A mismatch at every position, including the last element. Flipping only
+      // the sign bit catches comparisons that ignore part of an element.
+      for (int i = 0; i < length; ++i) {
+        b[i] ^= (byte) 0x80;
+        assertEquals(false, $noinline$equals(a, b));
+        assertEquals(i, $noinline$mismatch(a, b));
+        assertEquals(referenceHashCode(b), $noinline$hashCode(b));
+        b[i] ^= (byte) 0x80;
+      }
+
+      // Arrays that only differ in length: mismatch compares the common prefix.
+      byte[] longer = Arrays.copyOf(a, length + 1);
+      assertEquals(false, $noinline$equals(a, longer));
+      assertEquals(length, $noinline$mismatch(a, longer));
+      assertEquals(length, $noinline$mismatch(longer, a));
+      for (int i = 0; i < length; ++i) {
+        longer[i] ^= 1;
+        assertEquals(referenceMismatch(a, longer), $noinline$mismatch(a, longer));
+        longer[i] ^= 1;
+      }
+
+      byte value = (byte) sRandom.nextInt();
+      $noinline$fill(a, value);
+      for (int i = 0; i < length; ++i) {
+        assertEquals(value, a[i]);
+      }
+      assertEquals(referenceEquals(a, b), $noinline$equals(a, b));
+    }
+
+    byte[] array = randomBytes(17);
+    assertEquals(true, $noinline$equals((byte[]) null, (byte[]) null));
+    assertEquals(false, $noinline$equals(array, null));
+    assertEquals(false, $noinline$equals(null, array));
+    assertEquals(0, $noinline$hashCode((byte[]) null));
+    try {
+      $noinline$fill((byte[]) null, (byte) 1);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+    try {
+      $noinline$mismatch(array, null);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+    try {
+      $noinline$mismatch(null, array);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+  }
+
+  public static void testIntArrays() {
+    for (int length : sLengths) {
+      int[] a = randomInts(length);
+      int[] b = a.clone();
+      assertEquals(true, $noinline$equals(a, b));
+      assertEquals(true, $noinline$equals(a, a));
+      assertEquals(-1, $noinline$mismatch(a, b));
+      assertEquals(referenceHashCode(a), $noinline$hashCode(a));
+
+      // A mismatch at every position, in the lowest and in the highest byte of
+      // the element.
+      for (int i = 0; i < length; ++i) {
+        for (int bit : new int[] { 0x1, 0x80000000 }) {
+          b[i] ^= bit;
+          assertEquals(false, $noinline$equals(a, b));
+          assertEquals(i, $noinline$mismatch(a, b));
+          assertEquals(referenceHashCode(b), $noinline$hashCode(b));
+          b[i] ^= bit;
+        }
+      }
+
+      int[] longer = Arrays.copyOf(a, length + 1);
+      assertEquals(false, $noinline$equals(a, longer));
+      assertEquals(length, $noinline$mismatch(a, longer));
+      assertEquals(length, $noinline$mismatch(longer, a));
+      for (int i = 0; i < length; ++i) {
+        longer[i] ^= 1;
+        assertEquals(referenceMismatch(a, longer), $noinline$mismatch(a, longer));
+        longer[i] ^= 1;
+      }
+
+      int value = sRandom.nextInt();
+      $noinline$fill(a, value);
+      for (int i = 0; i < length; ++i) {
+        assertEquals(value, a[i]);
+      }
+      assertEquals(referenceEquals(a, b), $noinline$equals(a, b));
+    }
+
+    int[] array = randomInts(17);
+    assertEquals(true, $noinline$equals((int[]) null, (int[]) null));
+    assertEquals(false, $noinline$equals(array, null));
+    assertEquals(false, $noinline$equals(null, array));
+    assertEquals(0, $noinline$hashCode((int[]) null));
+    try {
+      $noinline$fill((int[]) null, 1);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+    try {
+      $noinline$mismatch(array, null);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+  }
+
+  public static void main(String[] args) {
+    testByteArrays();
+    testIntArrays();
+    System.out.println("passed");
+  }
+
+  private static void assertEquals(boolean expected, boolean actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  private static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+}
@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.util.Random;
+
+public class Main {
+  // Lengths 0 to 40, and lengths around the 8 and 16 character blocks used by
+  // the intrinsics.
+  static int[] sLengths;
+
+  static {
+    int[] extra = { 47, 48, 49, 63, 64, 65 };
+    sLengths = new int[41 + extra.length];
+    for (int i = 0; i <= 40; ++i) {
+      sLengths[i] = i;
+    }
+    System.arraycopy(extra, 0, sLengths, 41, extra.length);
+  }
+
+  // Needle lengths around the block sizes, so that matches straddle blocks.
+  static int[] sNeedleLengths = { 1, 2, 3, 7, 8, 9, 15, 16, 17 };
+
+  // A character that cannot be stored in a compressed string.
+  static final char UNCOMPRESSED = '\u0101';
+
+  static Random sRandom = new Random(42);
+
+  /// CHECK-START: int Main.$noinline$hashCode(java.lang.String) builder (after)
+  /// CHECK-DAG: <<Result:i\d+>> InvokeVirtual intrinsic:StringHashCode
+  /// CHECK-DAG:                 Return [<<Result>>]
+  private static int $noinline$hashCode(String s) {
+    return s.hashCode();
+  }
+
+  // The store of the computed hash code only caches it, so the second call can
+  // reuse the result of the first one.
+  /// CHECK-START: int Main.$noinline$hashCodeTwice(java.lang.String) GVN (before)
+  /// CHECK:                     InvokeVirtual intrinsic:StringHashCode
+  /// CHECK:                     InvokeVirtual intrinsic:StringHashCode
+
+  /// CHECK-START: int Main.$noinline$hashCodeTwice(java.lang.String) GVN (after)
+  /// CHECK:                     InvokeVirtual intrinsic:StringHashCode
+  /// CHECK-NOT:                 InvokeVirtual intrinsic:StringHashCode
+  private static int $noinline$hashCodeTwice(String s) {
+    return s.hashCode() + s.hashCode();
+  }
+
+  /// CHECK-START: boolean Main.$noinline$equals(java.lang.String, java.lang.Object) builder (after)
+  /// CHECK-DAG: <<Result:z\d+>> InvokeVirtual intrinsic:StringEquals
+  /// CHECK-DAG:                 Return [<<Result>>]
+  private static boolean $noinline$equals(String s, Object o) {
+    return s.equals(o);
+  }
+
+  /// CHECK-START: int Main.$noinline$indexOf(java.lang.String, java.lang.String) builder (after)
+  /// CHECK-DAG: <<Result:i\d+>> InvokeVirtual intrinsic:StringStringIndexOf
+  /// CHECK-DAG:                 Return [<<Result>>]
+  private static int $noinline$indexOf(String haystack, String needle) {
+    return haystack.indexOf(needle);
+  }
+
+  private static int referenceHashCode(String s) {
+    int result = 0;
+    for (int i = 0; i < s.length(); ++i) {
+      result = 31 * result + s.charAt(i);
+    }
+    return result;
+  }
+
+  private static int referenceIndexOf(String haystack, String needle) {
+    outer:
+    for (int i = 0; i + needle.length() <= haystack.length(); ++i) {
+      for (int j = 0; j < needle.length(); ++j) {
+        if (haystack.charAt(i + j) != needle.charAt(j)) {
+          continue outer;
+        }
+      }
+      return i;
+    }
+    return -1;
+  }
+
+  // Returns a new string of `length` characters out of a small alphabet, so that
+  // searches see many partial matches. If `uncompressed`, the string contains at
+  // least one character that needs 16 bits.
+  private static String randomString(int length, boolean uncompressed) {
+    char[] chars = new char[length];
+    for (int i = 0; i < length; ++i) {
+      chars[i] = (char) ('a' + sRandom.nextInt(2));
+    }
+    if (uncompressed && length != 0) {
+      for (int i = 0; i < length; ++i) {
+        if (chars[i] == 'b') {
+          chars[i] = UNCOMPRESSED;
+        }
+      }
+      chars[sRandom.nextInt(length)] = UNCOMPRESSED;
+    }
+    return new String(chars);
+  }
+
+  // Returns a copy of `s` that does not share its cached hash code.
+  private static String copy(String s) {
+    return new String(s.toCharArray());
+  }
+
+  public static void testHashCode() {
+    for (boolean uncompressed : new boolean[] { false, true }) {
+      for (int length : sLengths) {
+        String s = randomString(length, uncompressed);
+        int expected = referenceHashCode(s);
+        // The first call computes the hash code, the second one reads it back.
+        assertEquals(expected, $noinline$hashCode(s));
+        assertEquals(expected, $noinline$hashCode(s));
+        assertEquals(expected, $noinline$hashCode(copy(s)));
+        assertEquals(2 * expected, $noinline$hashCodeTwice(copy(s)));
+      }
+    }
+    // Characters with the top bit set must not be sign extended.
+    String highBytes = new String(new char[] { '\u00ff', '\u0080', '\u00fe' });
+    assertEquals(referenceHashCode(highBytes), $noinline$hashCode(highBytes));
+    String highChars = new String(new char[] { '\uffff', '\u8000', '\u00ff' });
+    assertEquals(referenceHashCode(highChars), $noinline$hashCode(highChars));
+    // A hash code of 0 is never cached, and must be recomputed every time.
+    String zeroHash = new String(new char[] { '\0', '\0' });
+    assertEquals(0, $noinline$hashCode(zeroHash));
+    assertEquals(0, $noinline$hashCode(zeroHash));
+  }
+
+  public static void testEquals() {
+    for (boolean uncompressed : new boolean[] { false, true }) {
+      for (int length : sLengths) {
+        String s = randomString(length, uncompressed);
+        assertEquals(true, $noinline$equals(s, s));
+        assertEquals(true, $noinline$equals(s, copy(s)));
+        assertEquals(false, $noinline$equals(s, null));
+        assertEquals(false, $noinline$equals(s, s.toCharArray()));
+        assertEquals(false, $noinline$equals(s, s + "a"));
+        // A difference at every position, including the last character.
+        char[] chars = s.toCharArray();
+        for (int i = 0; i < length; ++i) {
+          char c = chars[i];
+          chars[i] = (c == 'a') ? 'b' : 'a';
+          assertEquals(false, $noinline$equals(s, new String(chars)));
+          chars[i] = c;
+        }
+      }
+    }
+  }
+
+  private static void checkIndexOf(String haystack, String needle) {
+    assertEquals(referenceIndexOf(haystack, needle), $noinline$indexOf(haystack, needle));
+  }
+
+  public static void testIndexOf() {
+    boolean[] flags = { false, true };
+    for (boolean uncompressedHaystack : flags) {
+      for (int length : sLengths) {
+        String haystack = randomString(length, uncompressedHaystack);
+        checkIndexOf(haystack, "");
+        checkIndexOf(haystack, haystack);
+        checkIndexOf(haystack, haystack + "a");
+        checkIndexOf(haystack, "c");
+        checkIndexOf(haystack, String.valueOf(UNCOMPRESSED));
+        for (int needleLength : sNeedleLengths) {
+          for (int start = 0; start + needleLength <= length; ++start) {
+            // Found at or before `start`, possibly across a block boundary.
+            String needle = copy(haystack.substring(start, start + needleLength));
+            checkIndexOf(haystack, needle);
+            // Same first character, different last one.
+            char[] chars = needle.toCharArray();
+            chars[needleLength - 1] = (chars[needleLength - 1] == 'a') ? 'c' : 'a';
+            checkIndexOf(haystack, new String(chars));
+            // An uncompressed needle is never found in a compressed haystack.
+            chars[needleLength - 1] = UNCOMPRESSED;
+            checkIndexOf(haystack, new String(chars));
+          }
+          // Compressed needles in uncompressed haystacks and vice versa.
+          for (boolean uncompressedNeedle : flags) {
+            checkIndexOf(haystack, randomString(needleLength, uncompressedNeedle));
+          }
+        }
+      }
+    }
+  }
+
+  public static void main(String[] args) {
+    testHashCode();
+    testEquals();
+    testIndexOf();
+    System.out.println("passed");
+  }
+
+  private static void assertEquals(boolean expected, boolean actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  private static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+}
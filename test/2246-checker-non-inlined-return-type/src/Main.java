@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+class Base {
+  int value() { return 1; }
+}
+
+class Sub extends Base {
+  int value() { return 2; }
+}
+
+public class Main {
+  static int sCounter;
+
+  // Too large to be inlined. Declared to return a Base, but every value it returns
+  // is a new Sub.
+  static Base newSub(int value) {
+    Sub obj = new Sub();
+    sCounter += value;
+    sCounter += value;
+    sCounter += value;
+    sCounter += value;
+    sCounter += value;
+    sCounter += value;
+    sCounter += value;
+    sCounter += value;
+    return obj;
+  }
+
+  // Too large to be inlined. Every value it returns is new, but of different classes.
+  static Base newBaseOrSub(int value) {
+    Base obj = (value > 0) ? new Sub() : new Base();
+    sCounter += value;
+    sCounter += value;
+    sCounter += value;
+    sCounter += value;
+    sCounter += value;
+    sCounter += value;
+    sCounter += value;
+    sCounter += value;
+    return obj;
+  }
+
+  /// CHECK-START: int Main.$noinline$subValue(int) inliner (after)
+  /// CHECK:                         InvokeStaticOrDirect method_name:Main.newSub {{.*}}klass:Sub can_be_null:false exact:true
+
+  /// CHECK-START: int Main.$noinline$subValue(int) instruction_simplifier$after_inlining (before)
+  /// CHECK:                         NullCheck
+
+  /// CHECK-START: int Main.$noinline$subValue(int) instruction_simplifier$after_inlining (after)
+  /// CHECK-NOT:                     NullCheck
+  public static int $noinline$subValue(int value) {
+    return newSub(value).value();
+  }
+
+  /// CHECK-START: Base Main.$noinline$subObject(int) inliner (after)
+  /// CHECK:                         InvokeStaticOrDirect method_name:Main.newSub {{.*}}klass:Sub can_be_null:false exact:true
+  public static Base $noinline$subObject(int value) {
+    return newSub(value);
+  }
+
+  /// CHECK-START: int Main.$noinline$baseOrSubValue(int) inliner (after)
+  /// CHECK:                         InvokeStaticOrDirect method_name:Main.newBaseOrSub {{.*}}klass:Base can_be_null:false exact:false
+
+  /// CHECK-START: int Main.$noinline$baseOrSubValue(int) inliner (after)
+  /// CHECK:                         InvokeVirtual method_name:Base.value
+  public static int $noinline$baseOrSubValue(int value) {
+    return newBaseOrSub(value).value();
+  }
+
+  public static void main(String[] args) {
+    assertEquals(2, $noinline$subValue(1));
+    Base obj = $noinline$subObject(1);
+    assertEquals(Sub.class, obj.getClass());
+    assertEquals(2, obj.value());
+    assertEquals(2, $noinline$baseOrSubValue(1));
+    assertEquals(1, $noinline$baseOrSubValue(-1));
+    assertEquals(16, sCounter);
+    System.out.println("passed");
+  }
+
+  private static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  private static void assertEquals(Object expected, Object actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  // Each method branches on a condition computed right before the `if`. Baseline
+  // code updates the branch profile between the two, which must not change the
+  // branch taken.
+
+  public static int $noinline$lessThan(int a, int b) {
+    if (a < b) {
+      return 1;
+    }
+    return 2;
+  }
+
+  public static int $noinline$equal(int a, int b) {
+    if (a == b) {
+      return 3;
+    }
+    return 4;
+  }
+
+  public static int $noinline$longGreaterOrEqual(long a, long b) {
+    if (a >= b) {
+      return 5;
+    }
+    return 6;
+  }
+
+  public static int $noinline$unsignedBelow(int a, int b) {
+    if (Integer.compareUnsigned(a, b) < 0) {
+      return 7;
+    }
+    return 8;
+  }
+
+  public static int $noinline$isNull(Object o) {
+    if (o == null) {
+      return 9;
+    }
+    return 10;
+  }
+
+  public static int $noinline$countBelow(int[] array, int limit) {
+    int count = 0;
+    for (int i = 0; i < array.length; i++) {
+      if (array[i] < limit) {
+        count++;
+      }
+    }
+    return count;
+  }
+
+  public static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  public static void test() {
+    assertEquals(1, $noinline$lessThan(1, 2));
+    assertEquals(2, $noinline$lessThan(2, 1));
+    assertEquals(2, $noinline$lessThan(2, 2));
+    assertEquals(3, $noinline$equal(5, 5));
+    assertEquals(4, $noinline$equal(5, 6));
+    assertEquals(5, $noinline$longGreaterOrEqual(1L << 40, 1L));
+    assertEquals(6, $noinline$longGreaterOrEqual(-1L, 0L));
+    assertEquals(7, $noinline$unsignedBelow(1, -1));
+    assertEquals(8, $noinline$unsignedBelow(-1, 1));
+    assertEquals(9, $noinline$isNull(null));
+    assertEquals(10, $noinline$isNull(new Object()));
+    assertEquals(3, $noinline$countBelow(new int[] { 1, 5, 2, 8, 3, 9 }, 4));
+    assertEquals(0, $noinline$countBelow(new int[] { 4, 5 }, 4));
+  }
+
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    // Check the results in the interpreter first, then in baseline code, where
+    // every branch is profiled.
+    test();
+    ensureJitBaselineCompiled(Main.class, "$noinline$lessThan");
+    ensureJitBaselineCompiled(Main.class, "$noinline$equal");
+    ensureJitBaselineCompiled(Main.class, "$noinline$longGreaterOrEqual");
+    ensureJitBaselineCompiled(Main.class, "$noinline$unsignedBelow");
+    ensureJitBaselineCompiled(Main.class, "$noinline$isNull");
+    ensureJitBaselineCompiled(Main.class, "$noinline$countBelow");
+    // Run enough times for the profile counters of both branches to be non-zero
+    // and to differ.
+    for (int i = 0; i < 100; i++) {
+      test();
+    }
+  }
+
+  private static native void ensureJitBaselineCompiled(Class<?> cls, String methodName);
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "arch/instruction_set.h"
+#include "art_method-inl.h"
+#include "base/enums.h"
+#include "instrumentation.h"
+#include "jit/jit.h"
+#include "jit/jit_code_cache.h"
+#include "mirror/class-inl.h"
+#include "nativehelper/ScopedUtfChars.h"
+#include "oat_quick_method_header.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+#include "stack_map.h"
+
+namespace art {
+
+static ArtMethod* FindMethod(ScopedObjectAccess& soa, jclass cls, jstring method_name) {
+  ScopedUtfChars chars(soa.Env(), method_name);
+  ObjPtr<mirror::Class> klass = soa.Decode<mirror::Class>(cls);
+  ArtMethod* method = klass->FindDeclaredDirectMethodByName(chars.c_str(), kRuntimePointerSize);
+  if (method == nullptr) {
+    method = klass->FindDeclaredVirtualMethodByName(chars.c_str(), kRuntimePointerSize);
+  }
+  CHECK(method != nullptr) << chars.c_str();
+  return method;
+}
+
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_isCodeAffinityLayoutSupported(JNIEnv*, jclass) {
+  Runtime* runtime = Runtime::Current();
+  jit::Jit* jit = runtime->GetJit();
+  // Only the x86-64 and arm64 baseline code and stubs update the inline cache counters,
+  // and the test helpers do not compile methods when entry and exit stubs are installed.
+  return (kRuntimeISA == InstructionSet::kX86_64 || kRuntimeISA == InstructionSet::kArm64) &&
+         jit != nullptr &&
+         jit->UseJitCompilation() &&
+         !runtime->GetJITOptions()->UseBaselineCompiler() &&
+         !runtime->GetInstrumentation()->EntryExitStubsInstalled();
+}
+
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_useCodeAffinityLayout(JNIEnv*, jclass) {
+  return Runtime::Current()->GetJITOptions()->UseCodeAffinityLayout();
+}
+
+// Does what the JIT compiler thread does after compiling `method_name` with optimizations.
+extern "C" JNIEXPORT void JNICALL Java_Main_compileAffineCallees(JNIEnv* env,
+                                                                 jclass,
+                                                                 jclass cls,
+                                                                 jstring method_name) {
+  ScopedObjectAccess soa(env);
+  ArtMethod* method = FindMethod(soa, cls, method_name);
+  Runtime::Current()->GetJit()->MaybeCompileAffineCallees(method, soa.Self());
+}
+
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_hasOptimizedJitCode(JNIEnv* env,
+                                                                   jclass,
+                                                                   jclass cls,
+                                                                   jstring method_name) {
+  ScopedObjectAccess soa(env);
+  ArtMethod* method = FindMethod(soa, cls, method_name);
+  const void* entry_point = method->GetEntryPointFromQuickCompiledCode();
+  if (!Runtime::Current()->GetJit()->GetCodeCache()->ContainsPc(entry_point)) {
+    return false;
+  }
+  const OatQuickMethodHeader* header = OatQuickMethodHeader::FromEntryPoint(entry_point);
+  return !CodeInfo::IsBaseline(header->GetOptimizedCodeInfoPtr());
+}
+
+// Returns the distance in bytes between the compiled code of two methods.
+extern "C" JNIEXPORT jlong JNICALL Java_Main_getCodeDistance(JNIEnv* env,
+                                                             jclass,
+                                                             jclass cls1,
+                                                             jstring method_name1,
+                                                             jclass cls2,
+                                                             jstring method_name2) {
+  ScopedObjectAccess soa(env);
+  uintptr_t code1 = reinterpret_cast<uintptr_t>(
+      FindMethod(soa, cls1, method_name1)->GetEntryPointFromQuickCompiledCode());
+  uintptr_t code2 = reinterpret_cast<uintptr_t>(
+      FindMethod(soa, cls2, method_name2)->GetEntryPointFromQuickCompiledCode());
+  return static_cast<jlong>((code1 > code2) ? code1 - code2 : code2 - code1);
+}
+
+}  // namespace art
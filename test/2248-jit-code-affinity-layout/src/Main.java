@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+class Base {
+  int $noinline$value() { return 1; }
+}
+
+class Impl extends Base {
+  int $noinline$value() { return 2; }
+}
+
+public class Main {
+  // Enough calls through the inline cache for the edge to be considered hot.
+  static final int CALLS = 2000;
+
+  public static int $noinline$caller(Base b) {
+    return b.$noinline$value();
+  }
+
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    boolean enabled = args[1].equals("on");
+    if (useCodeAffinityLayout() != enabled) {
+      throw new Error("Unexpected -Xjitcodeaffinitylayout, expected " + enabled);
+    }
+    if (!isCodeAffinityLayoutSupported()) {
+      return;
+    }
+
+    Base impl = new Impl();
+    ensureJitBaselineCompiled(Impl.class, "$noinline$value");
+    ensureJitBaselineCompiled(Main.class, "$noinline$caller");
+    for (int i = 0; i < CALLS; i++) {
+      assertEquals(2, $noinline$caller(impl));
+    }
+    if (hasOptimizedJitCode(Impl.class, "$noinline$value")) {
+      throw new Error("Callee compiled with optimizations too early");
+    }
+
+    ensureJitCompiled(Main.class, "$noinline$caller");
+    compileAffineCallees(Main.class, "$noinline$caller");
+    if (hasOptimizedJitCode(Impl.class, "$noinline$value") != enabled) {
+      throw new Error("Expected the callee to " + (enabled ? "" : "not ") +
+          "be compiled with optimizations along with its caller");
+    }
+    if (enabled) {
+      // Nothing else runs in this test, so the callee's code is allocated right after or
+      // close to the caller's.
+      long distance =
+          getCodeDistance(Main.class, "$noinline$caller", Impl.class, "$noinline$value");
+      if (distance > 64 * 1024) {
+        throw new Error("Callee compiled " + distance + " bytes away from its caller");
+      }
+    }
+    assertEquals(2, $noinline$caller(impl));
+    assertEquals(1, $noinline$caller(new Base()));
+  }
+
+  public static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  private static native void ensureJitBaselineCompiled(Class<?> cls, String methodName);
+  private static native void ensureJitCompiled(Class<?> cls, String methodName);
+  private static native boolean isCodeAffinityLayoutSupported();
+  private static native boolean useCodeAffinityLayout();
+  // Compiles the callees of `methodName` the way the JIT does after optimizing it.
+  private static native void compileAffineCallees(Class<?> cls, String methodName);
+  private static native boolean hasOptimizedJitCode(Class<?> cls, String methodName);
+  private static native long getCodeDistance(
+      Class<?> cls1, String methodName1, Class<?> cls2, String methodName2);
+}
@@ -775,6 +775,37 @@ public class Main {
     return array;
   }
 
+  static int sCounter;
+
+  // Too large to be inlined, but every value it returns is a new SubclassC.
+  public static Super newSubclassC(int value) {
+    SubclassC obj = new SubclassC();
+    sCounter += value;
+    sCounter += value;
+    sCounter += value;
+    sCounter += value;
+    sCounter += value;
+    sCounter += value;
+    sCounter += value;
+    sCounter += value;
+    return obj;
+  }
+
+  /// CHECK-START: int Main.testNonInlinedReturnType(int) inliner (after)
+  /// CHECK:                         InvokeStaticOrDirect method_name:Main.newSubclassC {{.*}}klass:SubclassC can_be_null:false exact:true
+
+  /// CHECK-START: int Main.testNonInlinedReturnType(int) instruction_simplifier$after_inlining (before)
+  /// CHECK:                         CheckCast
+  /// CHECK:                         NullCheck
+
+  /// CHECK-START: int Main.testNonInlinedReturnType(int) instruction_simplifier$after_inlining (after)
+  /// CHECK-NOT:                     CheckCast
+  /// CHECK-NOT:                     NullCheck
+  public static int testNonInlinedReturnType(int value) {
+    SubclassC obj = (SubclassC) newSubclassC(value);
+    return obj.$noinline$hashCode();
+  }
+
   public static void main(String[] args) {
   }
 }
@@ -25,6 +25,11 @@ public class Main {
     System.out.println($noinline$mulAndIntrinsic());
     System.out.println($noinline$directIntrinsic(-5));
     System.out.println($noinline$deoptimizeArray(new int[100]));
+    Holder holder = new Holder();
+    holder.f = 1;
+    holder.g = 2;
+    System.out.println($noinline$partialRedundancy(holder, true));
+    System.out.println($noinline$partialRedundancy(holder, false));
   }
 
   private static int $inline$add(int a, int b) {
@@ -92,6 +97,38 @@ public class Main {
     return abs1 + abs2;
   }
 
+  public static class Holder {
+    public int f;
+    public int g;
+  }
+
+  // The load of `h.f` after the merge is redundant on the path through the `if`.
+  // PRE moves it to the other path and replaces it with a Phi.
+  /// CHECK-START: int Main.$noinline$partialRedundancy(Main$Holder, boolean) PRE (before)
+  /// CHECK:     InstanceFieldGet field_name:Main$Holder.g
+  /// CHECK:     InstanceFieldGet field_name:Main$Holder.f
+  /// CHECK:     InstanceFieldGet field_name:Main$Holder.f
+  /// CHECK-NOT: InstanceFieldGet
+
+  /// CHECK-START: int Main.$noinline$partialRedundancy(Main$Holder, boolean) PRE (after)
+  /// CHECK-DAG: <<Get1:i\d+>> InstanceFieldGet field_name:Main$Holder.f
+  /// CHECK-DAG: <<Get2:i\d+>> InstanceFieldGet field_name:Main$Holder.f
+  /// CHECK-DAG:               Phi [<<Get1>>,<<Get2>>]
+
+  /// CHECK-START: int Main.$noinline$partialRedundancy(Main$Holder, boolean) PRE (after)
+  /// CHECK:     InstanceFieldGet field_name:Main$Holder.g
+  /// CHECK:     InstanceFieldGet field_name:Main$Holder.f
+  /// CHECK:     InstanceFieldGet field_name:Main$Holder.f
+  /// CHECK-NOT: InstanceFieldGet
+  public static int $noinline$partialRedundancy(Holder h, boolean b) {
+    int g = h.g;
+    int x = 0;
+    if (b) {
+      x = h.f;
+    }
+    return g + x + h.f;
+  }
+
   public static class MyList {
     public int[] arr;
   }
@@ -1253,6 +1253,35 @@ public class Main {
     }
   }
 
+  /// CHECK-START: void Main.unswitchingSimple(int[], boolean) loop_unswitching (before)
+  /// CHECK-DAG: <<Param:z\d+>>     ParameterValue                          loop:none
+  /// CHECK-DAG:                    If [<<Param>>]                          loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG:                    Mul                                     loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:                    Xor                                     loop:<<Loop>>      outer_loop:none
+
+  /// CHECK-START: void Main.unswitchingSimple(int[], boolean) dead_code_elimination$after_unswitching (after)
+  /// CHECK-DAG: <<Param:z\d+>>     ParameterValue                          loop:none
+  /// CHECK-DAG:                    If [<<Param>>]                          loop:none
+  /// CHECK-DAG:                    Mul                                     loop:<<Loop0:B\d+>> outer_loop:none
+  /// CHECK-DAG:                    Xor                                     loop:<<Loop1:B\d+>> outer_loop:none
+  /// CHECK-EVAL: "<<Loop0>>" != "<<Loop1>>"
+
+  // One `if` in front of the two loops, one exit test in each loop.
+  /// CHECK-START: void Main.unswitchingSimple(int[], boolean) dead_code_elimination$after_unswitching (after)
+  /// CHECK:                        If
+  /// CHECK:                        If
+  /// CHECK:                        If
+  /// CHECK-NOT:                    If
+  private static final void unswitchingSimple(int[] a, boolean f) {
+    for (int i = 0; i < LENGTH; i++) {
+      if (f) {
+        a[i] = i * 3;
+      } else {
+        a[i] = i ^ 5;
+      }
+    }
+  }
+
   /// CHECK-START: void Main.unrollingFull(int[]) loop_optimization (before)
   /// CHECK-DAG: <<Param:l\d+>>     ParameterValue                          loop:none
   /// CHECK-DAG: <<Const0:i\d+>>    IntConstant 0                           loop:none
@@ -1361,6 +1390,14 @@ public class Main {
     expectEquals(expected, found);
   }
 
+  public void verifyUnswitching() {
+    int[] c = new int[LENGTH];
+    unswitchingSimple(c, true);
+    expectEquals(3 * (LENGTH - 1), c[LENGTH - 1]);
+    unswitchingSimple(c, false);
+    expectEquals((LENGTH - 1) ^ 5, c[LENGTH - 1]);
+  }
+
   public void verifyPeeling() throws Exception {
     expectEquals(1, peelingHoistOneControl(0));  // anything else loops
     expectEquals(1, peelingHoistOneControl(0, 0));
@@ -1408,6 +1445,7 @@ public class Main {
 
     obj.verifyUnrolling();
     obj.verifyPeeling();
+    obj.verifyUnswitching();
 
     System.out.println("passed");
   }
@@ -331,6 +331,116 @@ public class Main {
     }
   }
 
+  /// CHECK-START-{X86_64,ARM64}: void Main.overlappedTail(int[], int[]) loop_optimization (after)
+  /// CHECK-IF:     not hasIsaFeature("sve")
+  //
+  ///     CHECK-DAG: <<Phi:i\d+>>   Phi                                 loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Min:i\d+>>   Min [<<Phi>>,{{i\d+}}]              loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Load:d\d+>>  VecLoad [{{l\d+}},<<Min>>]          loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Add:d\d+>>   VecAdd [<<Load>>,{{d\d+}}]          loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                VecStore [{{l\d+}},<<Min>>,<<Add>>] loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-FI:
+  static void overlappedTail(int[] x, int[] y) {
+    for (int i = 0; i < 19; i++) {
+      x[i] = y[i] + 1;
+    }
+  }
+
+  /// CHECK-START: void Main.straightLine(int[], int[], int[]) superword_vectorizer (before)
+  /// CHECK-NOT: VecStore
+  //
+  /// CHECK-START-{X86_64,ARM64}: void Main.straightLine(int[], int[], int[]) superword_vectorizer (after)
+  /// CHECK-IF:     not hasIsaFeature("sve")
+  //
+  ///     CHECK-DAG: <<Rep:d\d+>>   VecReplicateScalar
+  ///     CHECK-DAG: <<Ld1:d\d+>>   VecLoad
+  ///     CHECK-DAG: <<Ld2:d\d+>>   VecLoad
+  ///     CHECK-DAG: <<Mul:d\d+>>   VecMul [<<Ld2>>,<<Rep>>]
+  ///     CHECK-DAG: <<Add:d\d+>>   VecAdd [<<Ld1>>,<<Mul>>]
+  ///     CHECK-DAG:                VecStore [{{l\d+}},{{i\d+}},<<Add>>]
+  //
+  ///     CHECK-NOT:                ArraySet
+  //
+  /// CHECK-FI:
+  static void straightLine(int[] x, int[] y, int[] z) {
+    x[0] = y[0] + z[0] * 3;
+    x[1] = y[1] + z[1] * 3;
+    x[2] = y[2] + z[2] * 3;
+    x[3] = y[3] + z[3] * 3;
+  }
+
+  // The loads of `a` read either the element stored by the same lane, or elements
+  // at least a vector away from all the stores, so the stores can be packed.
+  //
+  /// CHECK-START-{X86_64,ARM64}: void Main.inPlace(int[]) superword_vectorizer (after)
+  /// CHECK-IF:     not hasIsaFeature("sve")
+  //
+  ///     CHECK-DAG: <<Ld1:d\d+>>   VecLoad
+  ///     CHECK-DAG: <<Ld2:d\d+>>   VecLoad
+  ///     CHECK-DAG: <<Add:d\d+>>   VecAdd [<<Ld1>>,<<Ld2>>]
+  ///     CHECK-DAG:                VecStore [{{l\d+}},{{i\d+}},<<Add>>]
+  //
+  ///     CHECK-NOT:                ArraySet
+  //
+  /// CHECK-FI:
+  static void inPlace(int[] a) {
+    a[0] = a[0] + a[4];
+    a[1] = a[1] + a[5];
+    a[2] = a[2] + a[6];
+    a[3] = a[3] + a[7];
+  }
+
+  // The loads are zero-extended (Uint8) and the stores signed (Int8), but
+  // both access the same byte[]: each store feeds the next load.
+  //
+  /// CHECK-START: void Main.byteOverlap(byte[]) superword_vectorizer (after)
+  /// CHECK-NOT: VecStore
+  static void byteOverlap(byte[] a) {
+    a[1] = (byte) ((a[0] & 0xff) * 3);
+    a[2] = (byte) ((a[1] & 0xff) * 3);
+    a[3] = (byte) ((a[2] & 0xff) * 3);
+    a[4] = (byte) ((a[3] & 0xff) * 3);
+    a[5] = (byte) ((a[4] & 0xff) * 3);
+    a[6] = (byte) ((a[5] & 0xff) * 3);
+    a[7] = (byte) ((a[6] & 0xff) * 3);
+    a[8] = (byte) ((a[7] & 0xff) * 3);
+    a[9] = (byte) ((a[8] & 0xff) * 3);
+    a[10] = (byte) ((a[9] & 0xff) * 3);
+    a[11] = (byte) ((a[10] & 0xff) * 3);
+    a[12] = (byte) ((a[11] & 0xff) * 3);
+    a[13] = (byte) ((a[12] & 0xff) * 3);
+    a[14] = (byte) ((a[13] & 0xff) * 3);
+    a[15] = (byte) ((a[14] & 0xff) * 3);
+    a[16] = (byte) ((a[15] & 0xff) * 3);
+  }
+
+  /// CHECK-START: void Main.shortOverlap(short[]) superword_vectorizer (after)
+  /// CHECK-NOT: VecStore
+  static void shortOverlap(short[] a) {
+    a[1] = (short) ((a[0] & 0xffff) * 3);
+    a[2] = (short) ((a[1] & 0xffff) * 3);
+    a[3] = (short) ((a[2] & 0xffff) * 3);
+    a[4] = (short) ((a[3] & 0xffff) * 3);
+    a[5] = (short) ((a[4] & 0xffff) * 3);
+    a[6] = (short) ((a[5] & 0xffff) * 3);
+    a[7] = (short) ((a[6] & 0xffff) * 3);
+    a[8] = (short) ((a[7] & 0xffff) * 3);
+  }
+
+  /// CHECK-START: void Main.charOverlap(char[]) superword_vectorizer (after)
+  /// CHECK-NOT: VecStore
+  static void charOverlap(char[] a) {
+    a[1] = (char) (a[0] * 3);
+    a[2] = (char) (a[1] * 3);
+    a[3] = (char) (a[2] * 3);
+    a[4] = (char) (a[3] * 3);
+    a[5] = (char) (a[4] * 3);
+    a[6] = (char) (a[5] * 3);
+    a[7] = (char) (a[6] * 3);
+    a[8] = (char) (a[7] * 3);
+  }
+
   static void testUnroll() {
     float[] x = new float[100];
     float[] y = new float[100];
@@ -405,12 +515,94 @@ public class Main {
     }
   }
 
+  static void testOverlappedTail() {
+    int[] a = new int[20];
+    int[] b = new int[20];
+    for (int i = 0; i < 20; i++) {
+      b[i] = i;
+    }
+    overlappedTail(a, b);
+    for (int i = 0; i < 19; i++) {
+      expectEquals(i + 1, a[i]);
+    }
+    expectEquals(0, a[19]);
+    // Aliased operands must take the scalar loop.
+    overlappedTail(b, b);
+    for (int i = 0; i < 19; i++) {
+      expectEquals(i + 1, b[i]);
+    }
+    expectEquals(19, b[19]);
+  }
+
+  static void testStraightLine() {
+    int[] x = new int[5];
+    int[] y = { 1, 2, 3, 4, 5 };
+    int[] z = { 10, 20, 30, 40, 50 };
+    straightLine(x, y, z);
+    for (int i = 0; i < 4; i++) {
+      expectEquals(y[i] + z[i] * 3, x[i]);
+    }
+    expectEquals(0, x[4]);
+    // Aliased operands must observe the scalar evaluation order.
+    straightLine(y, y, y);
+    for (int i = 0; i < 4; i++) {
+      expectEquals((i + 1) * 4, y[i]);
+    }
+  }
+
+  static void testInPlace() {
+    int[] a = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    inPlace(a);
+    for (int i = 0; i < 4; i++) {
+      expectEquals((i + 1) + (i + 5), a[i]);
+    }
+    for (int i = 4; i < 9; i++) {
+      expectEquals(i + 1, a[i]);
+    }
+  }
+
+  static void testNarrowOverlap() {
+    byte[] b = new byte[18];
+    b[0] = (byte) 0x85;
+    byteOverlap(b);
+    int e = 0x85;
+    for (int i = 1; i <= 16; i++) {
+      e = (byte) (e * 3) & 0xff;
+      expectEquals((byte) e, b[i]);
+    }
+    expectEquals(0, b[17]);
+
+    short[] s = new short[10];
+    s[0] = (short) 0x8765;
+    shortOverlap(s);
+    e = 0x8765;
+    for (int i = 1; i <= 8; i++) {
+      e = (short) (e * 3) & 0xffff;
+      expectEquals((short) e, s[i]);
+    }
+    expectEquals(0, s[9]);
+
+    char[] c = new char[10];
+    c[0] = (char) 0x8765;
+    charOverlap(c);
+    e = 0x8765;
+    for (int i = 1; i <= 8; i++) {
+      e = (char) (e * 3);
+      expectEquals(e, c[i]);
+    }
+    expectEquals(0, c[9]);
+  }
+
   public static void main(String[] args) {
     testUnroll();
     testStencil1();
     testStencil2();
     testStencil3();
     testTypes();
+    testOverlappedTail();
+    testStraightLine();
+    testInPlace();
+    testNarrowOverlap();
     System.out.println("passed");
   }
 